@@ -0,0 +1,282 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CAutodetectJob.h"
+
+#include <core/CDataAdder.h>
+#include <core/CDataSearcher.h>
+#include <core/CJsonOutputStreamWrapper.h>
+#include <core/CLogger.h>
+#include <core/CStatistics.h>
+
+#include <model/CAnomalyDetectorModelConfig.h>
+#include <model/ModelTypes.h>
+
+#include <api/CAnomalyJob.h>
+#include <api/CBackgroundPersister.h>
+#include <api/CCmdSkeleton.h>
+#include <api/CCsvInputParser.h>
+#include <api/CFieldDataTyper.h>
+#include <api/CIoManager.h>
+#include <api/CJsonOutputWriter.h>
+#include <api/CLengthEncodedInputParser.h>
+#include <api/CModelSnapshotJsonWriter.h>
+#include <api/COutputChainer.h>
+#include <api/CSingleStreamDataAdder.h>
+#include <api/CSingleStreamSearcher.h>
+#include <api/CStateRestoreStreamFilter.h>
+
+#include "CCmdLineParser.h"
+
+#include <boost/bind.hpp>
+
+#include <stdio.h>
+
+namespace ml {
+namespace autodetect {
+
+CAutodetectJob::CAutodetectJob()
+    : m_BucketSpan(0), m_Latency(0), m_Delimiter('\t'), m_LengthEncodedInput(false),
+      m_TimeField(api::CAnomalyJob::DEFAULT_TIME_FIELD_NAME),
+      m_DeleteStateFiles(false), m_PersistInterval(-1), m_MaxQuantileInterval(-1),
+      m_IsInputFileNamedPipe(false), m_IsOutputFileNamedPipe(false),
+      m_IsRestoreFileNamedPipe(false), m_IsPersistFileNamedPipe(false),
+      m_MaxAnomalyRecords(100u), m_MemoryUsage(false), m_BucketResultsDelay(0),
+      m_MultivariateByFields(false), m_IsHost(false), m_NumberThreads(0),
+      m_FirstProcessor(nullptr) {
+}
+
+CAutodetectJob::~CAutodetectJob() {
+}
+
+bool CAutodetectJob::parse(int argc, const char* const* argv) {
+    return CCmdLineParser::parse(
+        argc, argv, m_LimitConfigFile, m_ModelConfigFile, m_FieldConfigFile,
+        m_ModelPlotConfigFile, m_JobId, m_LogProperties, m_LogPipe, m_BucketSpan,
+        m_Latency, m_SummaryCountFieldName, m_Delimiter, m_LengthEncodedInput,
+        m_TimeField, m_TimeFormat, m_QuantilesStateFile, m_DeleteStateFiles,
+        m_PersistInterval, m_MaxQuantileInterval, m_InputFileName,
+        m_IsInputFileNamedPipe, m_OutputFileName, m_IsOutputFileNamedPipe,
+        m_RestoreFileName, m_IsRestoreFileNamedPipe, m_PersistFileName,
+        m_IsPersistFileNamedPipe, m_MaxAnomalyRecords, m_MemoryUsage,
+        m_BucketResultsDelay, m_MultivariateByFields, m_IsHost, m_CommandPipe,
+        m_NumberThreads, m_ClauseTokens);
+}
+
+void CAutodetectJob::createIoManager() {
+    m_IoMgr = std::make_unique<api::CIoManager>(
+        m_InputFileName, m_IsInputFileNamedPipe, m_OutputFileName,
+        m_IsOutputFileNamedPipe, m_RestoreFileName, m_IsRestoreFileNamedPipe,
+        m_PersistFileName, m_IsPersistFileNamedPipe);
+}
+
+bool CAutodetectJob::init() {
+    if (m_IoMgr->initIo() == false) {
+        LOG_FATAL(<< "Failed to initialise IO");
+        return false;
+    }
+
+    if (m_JobId.empty()) {
+        LOG_FATAL(<< "No job ID specified");
+        return false;
+    }
+
+    if (!m_LimitConfigFile.empty() && m_Limits.init(m_LimitConfigFile) == false) {
+        LOG_FATAL(<< "Ml limit config file '" << m_LimitConfigFile << "' could not be loaded");
+        return false;
+    }
+
+    model_t::ESummaryMode summaryMode(m_SummaryCountFieldName.empty() ? model_t::E_None
+                                                                      : model_t::E_Manual);
+    m_ModelConfig = std::make_unique<model::CAnomalyDetectorModelConfig>(
+        model::CAnomalyDetectorModelConfig::defaultConfig(
+            m_BucketSpan, summaryMode, m_SummaryCountFieldName, m_Latency,
+            m_BucketResultsDelay, m_MultivariateByFields));
+    m_ModelConfig->detectionRules(model::CAnomalyDetectorModelConfig::TIntDetectionRuleVecUMapCRef(
+        m_FieldConfig.detectionRules()));
+    m_ModelConfig->scheduledEvents(model::CAnomalyDetectorModelConfig::TStrDetectionRulePrVecCRef(
+        m_FieldConfig.scheduledEvents()));
+
+    if (!m_ModelConfigFile.empty() && m_ModelConfig->init(m_ModelConfigFile) == false) {
+        LOG_FATAL(<< "Ml model config file '" << m_ModelConfigFile << "' could not be loaded");
+        return false;
+    }
+
+    if (!m_ModelPlotConfigFile.empty() &&
+        m_ModelConfig->configureModelPlot(m_ModelPlotConfigFile) == false) {
+        LOG_FATAL(<< "Ml model plot config file '" << m_ModelPlotConfigFile
+                  << "' could not be loaded");
+        return false;
+    }
+
+    if (m_IoMgr->restoreStream()) {
+        // Check whether state is restored from a file, if so we assume that
+        // this is a debugging case and therefore does not originate from X-Pack.
+        if (!m_IsRestoreFileNamedPipe) {
+            // apply a filter to overcome differences in the way persistence vs. restore works
+            auto strm = std::make_shared<boost::iostreams::filtering_istream>();
+            strm->push(api::CStateRestoreStreamFilter());
+            strm->push(*m_IoMgr->restoreStream());
+            m_RestoreSearcher = std::make_unique<api::CSingleStreamSearcher>(strm);
+        } else {
+            m_RestoreSearcher =
+                std::make_unique<api::CSingleStreamSearcher>(m_IoMgr->restoreStream());
+        }
+    }
+
+    if (m_IoMgr->persistStream()) {
+        m_Persister = std::make_unique<api::CSingleStreamDataAdder>(m_IoMgr->persistStream());
+    }
+
+    if (m_PersistInterval >= 0 && m_Persister == nullptr) {
+        LOG_FATAL(<< "Periodic persistence cannot be enabled using the 'persistInterval' "
+                     "argument unless a place to persist to has been specified using the "
+                     "'persist' argument");
+        return false;
+    }
+
+    if (m_PersistInterval >= 0) {
+        m_PeriodicPersister =
+            std::make_unique<api::CBackgroundPersister>(m_PersistInterval, *m_Persister);
+    }
+
+    if (m_LengthEncodedInput) {
+        m_InputParser = std::make_unique<api::CLengthEncodedInputParser>(m_IoMgr->inputStream());
+    } else {
+        m_InputParser = std::make_unique<api::CCsvInputParser>(m_IoMgr->inputStream(), m_Delimiter);
+    }
+
+    m_WrappedOutputStream =
+        std::make_unique<core::CJsonOutputStreamWrapper>(m_IoMgr->outputStream());
+
+    m_ModelSnapshotWriter =
+        std::make_unique<api::CModelSnapshotJsonWriter>(m_JobId, *m_WrappedOutputStream);
+    if (m_FieldConfig.initFromCmdLine(m_FieldConfigFile, m_ClauseTokens) == false) {
+        LOG_FATAL(<< "Field config could not be interpreted");
+        return false;
+    }
+
+    // The anomaly job knows how to detect anomalies
+    m_Job = std::make_unique<api::CAnomalyJob>(
+        m_JobId, m_Limits, m_FieldConfig, *m_ModelConfig, *m_WrappedOutputStream,
+        boost::bind(&api::CModelSnapshotJsonWriter::write, m_ModelSnapshotWriter.get(), _1),
+        m_PeriodicPersister.get(), m_MaxQuantileInterval, m_TimeField,
+        m_TimeFormat, m_MaxAnomalyRecords);
+
+    if (!m_QuantilesStateFile.empty()) {
+        if (m_Job->initNormalizer(m_QuantilesStateFile) == false) {
+            LOG_FATAL(<< "Failed to restore quantiles and initialize normalizer");
+            return false;
+        }
+        if (m_DeleteStateFiles) {
+            ::remove(m_QuantilesStateFile.c_str());
+        }
+    }
+
+    m_FirstProcessor = m_Job.get();
+
+    // Chain the categorizer's output to the anomaly detector's input
+    m_OutputChainer = std::make_unique<api::COutputChainer>(*m_Job);
+
+    m_FieldDataTyperOutputWriter =
+        std::make_unique<api::CJsonOutputWriter>(m_JobId, *m_WrappedOutputStream);
+
+    // The typer knows how to assign categories to records
+    m_Typer = std::make_unique<api::CFieldDataTyper>(
+        m_JobId, m_FieldConfig, m_Limits, *m_OutputChainer, *m_FieldDataTyperOutputWriter);
+
+    if (m_FieldConfig.fieldNameSuperset().count(api::CFieldDataTyper::MLCATEGORY_NAME) > 0) {
+        LOG_DEBUG(<< "Applying the categorization typer for anomaly detection");
+        m_FirstProcessor = m_Typer.get();
+    }
+
+    if (m_PeriodicPersister != nullptr) {
+        m_PeriodicPersister->firstProcessorPeriodicPersistFunc(boost::bind(
+            &api::CDataProcessor::periodicPersistState, m_FirstProcessor, _1));
+    }
+
+    return true;
+}
+
+bool CAutodetectJob::run() {
+    bool ioLoopSucceeded(false);
+    {
+        // The skeleton avoids the need to duplicate a lot of boilerplate code
+        api::CCmdSkeleton skeleton(m_RestoreSearcher.get(), m_Persister.get(),
+                                   *m_InputParser, *m_FirstProcessor);
+        ioLoopSucceeded = skeleton.ioLoop();
+    }
+    this->finished(ioLoopSucceeded);
+    return ioLoopSucceeded;
+}
+
+void CAutodetectJob::excludeSharedMemory() {
+    m_Limits.resourceMonitor().includeStringStores(false);
+}
+
+const std::string& CAutodetectJob::jobId() const {
+    return m_JobId;
+}
+
+const std::string& CAutodetectJob::logProperties() const {
+    return m_LogProperties;
+}
+
+const std::string& CAutodetectJob::logPipe() const {
+    return m_LogPipe;
+}
+
+bool CAutodetectJob::isHost() const {
+    return m_IsHost;
+}
+
+const std::string& CAutodetectJob::commandPipe() const {
+    return m_CommandPipe;
+}
+
+std::size_t CAutodetectJob::numberThreads() const {
+    return m_NumberThreads;
+}
+
+bool CAutodetectJob::usesStandardStreams() const {
+    return m_InputFileName.empty() || m_OutputFileName.empty();
+}
+
+core::CDataSearcher* CAutodetectJob::restoreSearcher() {
+    return m_RestoreSearcher.get();
+}
+
+core::CDataAdder* CAutodetectJob::persister() {
+    return m_Persister.get();
+}
+
+api::CInputParser& CAutodetectJob::inputParser() {
+    return *m_InputParser;
+}
+
+api::CDataProcessor& CAutodetectJob::processor() {
+    return *m_FirstProcessor;
+}
+
+void CAutodetectJob::finished(bool succeeded) {
+    // Unfortunately we cannot rely on destruction to finalise the output
+    // writer as it must be finalised before anything which writes to it
+    // is destroyed.
+    m_FieldDataTyperOutputWriter->finalise();
+
+    if (!succeeded) {
+        LOG_FATAL(<< "Ml anomaly detector job failed");
+        return;
+    }
+
+    if (m_MemoryUsage) {
+        m_Job->descriptionAndDebugMemoryUsage();
+    }
+
+    // Print out the runtime stats generated by this job
+    LOG_DEBUG(<< core::CStatistics::instance());
+}
+}
+}
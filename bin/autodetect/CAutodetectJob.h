@@ -0,0 +1,219 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_autodetect_CAutodetectJob_h
+#define INCLUDED_ml_autodetect_CAutodetectJob_h
+
+#include <core/CoreTypes.h>
+
+#include <model/CLimits.h>
+
+#include <api/CFieldConfig.h>
+#include <api/CJobHost.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ml {
+namespace core {
+class CJsonOutputStreamWrapper;
+}
+namespace model {
+class CAnomalyDetectorModelConfig;
+}
+namespace api {
+class CAnomalyJob;
+class CBackgroundPersister;
+class CFieldDataTyper;
+class CIoManager;
+class CJsonOutputWriter;
+class CModelSnapshotJsonWriter;
+class COutputChainer;
+}
+namespace autodetect {
+
+//! \brief
+//! Everything needed to run one anomaly detection job.
+//!
+//! DESCRIPTION:\n
+//! Holds the options from one job's command line and the objects which
+//! are built from them: the IO manager, the configuration, the anomaly
+//! job and, if the job categorizes, the categorizer in front of it.
+//!
+//! A job either runs on its own in this process, by calling run(), or is
+//! handed to an api::CJobHost which runs it alongside other jobs.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Setting up a job is split into steps because, when it runs on its own,
+//! the IO manager must be created before the logger is reconfigured and
+//! the rest of the initialisation must happen after the system call filter
+//! is installed.
+//!
+//! The members are declared in the order the objects were created in the
+//! original autodetect main, so they are destroyed in the reverse order.
+class CAutodetectJob : public api::CJobHost::CJob {
+public:
+    using TStrVec = std::vector<std::string>;
+
+public:
+    CAutodetectJob();
+    virtual ~CAutodetectJob();
+
+    //! Parse the job's command line.
+    bool parse(int argc, const char* const* argv);
+
+    //! Create the IO manager.
+    void createIoManager();
+
+    //! Open the job's streams and create the objects which process its
+    //! data.  Returns false, having logged why, if this fails.
+    bool init();
+
+    //! Run the job to completion on the calling thread.
+    bool run();
+
+    //! Leave the string stores, which are shared by every job in the
+    //! process, out of this job's memory usage.  Call this before init()
+    //! if the job is hosted.
+    void excludeSharedMemory();
+
+    //! \name Options
+    //@{
+    //! Get the job ID.
+    const std::string& jobId() const;
+
+    //! Get the log properties file.
+    const std::string& logProperties() const;
+
+    //! Get the named pipe to log to.
+    const std::string& logPipe() const;
+
+    //! Check if this is the command line of a host for many jobs.
+    bool isHost() const;
+
+    //! Get the named pipe from which a host reads its jobs' command lines.
+    const std::string& commandPipe() const;
+
+    //! Get the number of threads a host uses to process its jobs.
+    std::size_t numberThreads() const;
+
+    //! Check if the job reads its input from STDIN or writes its output
+    //! to STDOUT.
+    bool usesStandardStreams() const;
+    //@}
+
+    //! \name api::CJobHost::CJob Interface
+    //@{
+    virtual core::CDataSearcher* restoreSearcher();
+    virtual core::CDataAdder* persister();
+    virtual api::CInputParser& inputParser();
+    virtual api::CDataProcessor& processor();
+    virtual void finished(bool succeeded);
+    //@}
+
+private:
+    using TIoManagerUPtr = std::unique_ptr<api::CIoManager>;
+    using TModelConfigUPtr = std::unique_ptr<model::CAnomalyDetectorModelConfig>;
+    using TDataSearcherUPtr = std::unique_ptr<core::CDataSearcher>;
+    using TDataAdderUPtr = std::unique_ptr<core::CDataAdder>;
+    using TBackgroundPersisterUPtr = std::unique_ptr<api::CBackgroundPersister>;
+    using TInputParserUPtr = std::unique_ptr<api::CInputParser>;
+    using TJsonOutputStreamWrapperUPtr = std::unique_ptr<core::CJsonOutputStreamWrapper>;
+    using TModelSnapshotJsonWriterUPtr = std::unique_ptr<api::CModelSnapshotJsonWriter>;
+    using TAnomalyJobUPtr = std::unique_ptr<api::CAnomalyJob>;
+    using TOutputChainerUPtr = std::unique_ptr<api::COutputChainer>;
+    using TJsonOutputWriterUPtr = std::unique_ptr<api::CJsonOutputWriter>;
+    using TFieldDataTyperUPtr = std::unique_ptr<api::CFieldDataTyper>;
+
+private:
+    //! \name Options
+    //@{
+    std::string m_LimitConfigFile;
+    std::string m_ModelConfigFile;
+    std::string m_FieldConfigFile;
+    std::string m_ModelPlotConfigFile;
+    std::string m_JobId;
+    std::string m_LogProperties;
+    std::string m_LogPipe;
+    core_t::TTime m_BucketSpan;
+    core_t::TTime m_Latency;
+    std::string m_SummaryCountFieldName;
+    char m_Delimiter;
+    bool m_LengthEncodedInput;
+    std::string m_TimeField;
+    std::string m_TimeFormat;
+    std::string m_QuantilesStateFile;
+    bool m_DeleteStateFiles;
+    core_t::TTime m_PersistInterval;
+    core_t::TTime m_MaxQuantileInterval;
+    std::string m_InputFileName;
+    bool m_IsInputFileNamedPipe;
+    std::string m_OutputFileName;
+    bool m_IsOutputFileNamedPipe;
+    std::string m_RestoreFileName;
+    bool m_IsRestoreFileNamedPipe;
+    std::string m_PersistFileName;
+    bool m_IsPersistFileNamedPipe;
+    std::size_t m_MaxAnomalyRecords;
+    bool m_MemoryUsage;
+    std::size_t m_BucketResultsDelay;
+    bool m_MultivariateByFields;
+    bool m_IsHost;
+    std::string m_CommandPipe;
+    std::size_t m_NumberThreads;
+    TStrVec m_ClauseTokens;
+    //@}
+
+    //! Manages the job's streams.
+    TIoManagerUPtr m_IoMgr;
+
+    //! The job's resource limits, including its memory limit.
+    model::CLimits m_Limits;
+
+    //! The detectors' configuration.
+    api::CFieldConfig m_FieldConfig;
+
+    //! The models' configuration.
+    TModelConfigUPtr m_ModelConfig;
+
+    //! Restores state, if the job has a place to restore from.
+    TDataSearcherUPtr m_RestoreSearcher;
+
+    //! Persists state, if the job has a place to persist to.
+    TDataAdderUPtr m_Persister;
+
+    //! Persists state periodically, if requested.
+    TBackgroundPersisterUPtr m_PeriodicPersister;
+
+    //! Parses the job's input.
+    TInputParserUPtr m_InputParser;
+
+    //! Serialises writes to the job's output stream.
+    TJsonOutputStreamWrapperUPtr m_WrappedOutputStream;
+
+    //! Writes model snapshots.
+    TModelSnapshotJsonWriterUPtr m_ModelSnapshotWriter;
+
+    //! Detects the anomalies.
+    TAnomalyJobUPtr m_Job;
+
+    //! Chains the categorizer's output to the anomaly detector's input.
+    TOutputChainerUPtr m_OutputChainer;
+
+    //! Writes the categorizer's output.
+    TJsonOutputWriterUPtr m_FieldDataTyperOutputWriter;
+
+    //! Assigns categories to records.
+    TFieldDataTyperUPtr m_Typer;
+
+    //! The first processor in the chain.
+    api::CDataProcessor* m_FirstProcessor;
+};
+}
+}
+
+#endif // INCLUDED_ml_autodetect_CAutodetectJob_h
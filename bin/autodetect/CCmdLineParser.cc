@@ -52,6 +52,9 @@ bool CCmdLineParser::parse(int argc,
                            bool& memoryUsage,
                            std::size_t& bucketResultsDelay,
                            bool& multivariateByFields,
+                           bool& isHost,
+                           std::string& commandPipe,
+                           std::size_t& numberThreads,
                            TStrVec& clauseTokens) {
     try {
         boost::program_options::options_description desc(DESCRIPTION);
@@ -115,6 +118,14 @@ bool CCmdLineParser::parse(int argc,
                         "The numer of half buckets to store before choosing which overlapping bucket has the biggest anomaly")
             ("multivariateByFields",
                         "Optional flag to enable multi-variate analysis of correlated by fields")
+            ("host",
+                        "Run many jobs in this process - each line read from the command pipe "
+                        "holds the tab separated options of one job")
+            ("commandPipe", boost::program_options::value<std::string>(),
+                        "Named pipe to read job command lines from when running as a host")
+            ("numberThreads", boost::program_options::value<std::size_t>(),
+                        "Optional number of threads a host uses to process its jobs - default is "
+                        "the number of cores")
         ;
         // clang-format on
 
@@ -228,6 +239,15 @@ bool CCmdLineParser::parse(int argc,
         if (vm.count("multivariateByFields") > 0) {
             multivariateByFields = true;
         }
+        if (vm.count("host") > 0) {
+            isHost = true;
+        }
+        if (vm.count("commandPipe") > 0) {
+            commandPipe = vm["commandPipe"].as<std::string>();
+        }
+        if (vm.count("numberThreads") > 0) {
+            numberThreads = vm["numberThreads"].as<std::size_t>();
+        }
 
         boost::program_options::collect_unrecognized(
             parsed.options, boost::program_options::include_positional)
@@ -64,6 +64,9 @@ public:
                       bool& memoryUsage,
                       std::size_t& bucketResultsDelay,
                       bool& multivariateByFields,
+                      bool& isHost,
+                      std::string& commandPipe,
+                      std::size_t& numberThreads,
                       TStrVec& clauseTokens);
 
 private:
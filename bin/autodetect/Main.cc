@@ -10,274 +10,192 @@
 //! Expects to be streamed CSV or length encoded data on STDIN or a named pipe,
 //! and sends its JSON results to STDOUT or another named pipe.
 //!
+//! With the --host option many jobs run in the one process.  Each line read
+//! from the command pipe holds the tab separated options of one job, which
+//! must read its input from and write its output to its own files or named
+//! pipes.  The host exits once the command pipe is closed and all the jobs
+//! it started have finished.
+//!
 //! IMPLEMENTATION DECISIONS:\n
 //! Standalone program.
 //!
-#include <core/CDataAdder.h>
-#include <core/CDataSearcher.h>
-#include <core/CJsonOutputStreamWrapper.h>
 #include <core/CLogger.h>
 #include <core/CProcessPriority.h>
-#include <core/CStatistics.h>
-#include <core/CoreTypes.h>
+#include <core/CStringUtils.h>
 
 #include <ver/CBuildInfo.h>
 
-#include <model/CAnomalyDetectorModelConfig.h>
-#include <model/CLimits.h>
-#include <model/ModelTypes.h>
+#include <model/CStringStore.h>
 
-#include <api/CAnomalyJob.h>
-#include <api/CBackgroundPersister.h>
-#include <api/CCmdSkeleton.h>
-#include <api/CCsvInputParser.h>
-#include <api/CFieldConfig.h>
-#include <api/CFieldDataTyper.h>
 #include <api/CIoManager.h>
-#include <api/CJsonOutputWriter.h>
-#include <api/CLengthEncodedInputParser.h>
-#include <api/CModelSnapshotJsonWriter.h>
-#include <api/COutputChainer.h>
-#include <api/CSingleStreamDataAdder.h>
-#include <api/CSingleStreamSearcher.h>
-#include <api/CStateRestoreStreamFilter.h>
+#include <api/CJobHost.h>
 
 #include <seccomp/CSystemCallFilter.h>
 
-#include "CCmdLineParser.h"
-
-#include <boost/bind.hpp>
+#include "CAutodetectJob.h"
 
+#include <algorithm>
+#include <functional>
+#include <istream>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
-#include <stdio.h>
 #include <stdlib.h>
 
-int main(int argc, char** argv) {
-    using TStrVec = ml::autodetect::CCmdLineParser::TStrVec;
-
-    // Read command line options
-    std::string limitConfigFile;
-    std::string modelConfigFile;
-    std::string fieldConfigFile;
-    std::string modelPlotConfigFile;
-    std::string jobId;
-    std::string logProperties;
-    std::string logPipe;
-    ml::core_t::TTime bucketSpan(0);
-    ml::core_t::TTime latency(0);
-    std::string summaryCountFieldName;
-    char delimiter('\t');
-    bool lengthEncodedInput(false);
-    std::string timeField(ml::api::CAnomalyJob::DEFAULT_TIME_FIELD_NAME);
-    std::string timeFormat;
-    std::string quantilesStateFile;
-    bool deleteStateFiles(false);
-    ml::core_t::TTime persistInterval(-1);
-    ml::core_t::TTime maxQuantileInterval(-1);
-    std::string inputFileName;
-    bool isInputFileNamedPipe(false);
-    std::string outputFileName;
-    bool isOutputFileNamedPipe(false);
-    std::string restoreFileName;
-    bool isRestoreFileNamedPipe(false);
-    std::string persistFileName;
-    bool isPersistFileNamedPipe(false);
-    size_t maxAnomalyRecords(100u);
-    bool memoryUsage(false);
-    std::size_t bucketResultsDelay(0);
-    bool multivariateByFields(false);
-    TStrVec clauseTokens;
-    if (ml::autodetect::CCmdLineParser::parse(
-            argc, argv, limitConfigFile, modelConfigFile, fieldConfigFile,
-            modelPlotConfigFile, jobId, logProperties, logPipe, bucketSpan, latency,
-            summaryCountFieldName, delimiter, lengthEncodedInput, timeField,
-            timeFormat, quantilesStateFile, deleteStateFiles, persistInterval,
-            maxQuantileInterval, inputFileName, isInputFileNamedPipe, outputFileName,
-            isOutputFileNamedPipe, restoreFileName, isRestoreFileNamedPipe,
-            persistFileName, isPersistFileNamedPipe, maxAnomalyRecords, memoryUsage,
-            bucketResultsDelay, multivariateByFields, clauseTokens) == false) {
-        return EXIT_FAILURE;
-    }
+namespace {
+using TAutodetectJobUPtr = std::unique_ptr<ml::autodetect::CAutodetectJob>;
+using TStrVec = std::vector<std::string>;
+using TCharCPtrVec = std::vector<const char*>;
+using TThreadVec = std::vector<std::thread>;
 
-    // Construct the IO manager before reconfiguring the logger, as it performs
-    // std::ios actions that only work before first use
-    ml::api::CIoManager ioMgr(inputFileName, isInputFileNamedPipe, outputFileName,
-                              isOutputFileNamedPipe, restoreFileName, isRestoreFileNamedPipe,
-                              persistFileName, isPersistFileNamedPipe);
+const std::string TAB(1, '\t');
 
-    if (ml::core::CLogger::instance().reconfigure(logPipe, logProperties) == false) {
-        LOG_FATAL(<< "Could not reconfigure logging");
-        return EXIT_FAILURE;
+//! Create the job whose options are on one line of \p command.
+//!
+//! \return Null, having logged why, if the command isn't a valid hosted job.
+TAutodetectJobUPtr createJob(const std::string& command) {
+    TStrVec tokens;
+    std::string remainder;
+    ml::core::CStringUtils::tokenise(TAB, command, tokens, remainder);
+    if (!remainder.empty()) {
+        tokens.push_back(remainder);
     }
+    // Multiple consecutive tabs might have caused empty tokens
+    tokens.erase(std::remove(tokens.begin(), tokens.end(), std::string()), tokens.end());
 
-    // Log the program version immediately after reconfiguring the logger.  This
-    // must be done from the program, and NOT a shared library, as each program
-    // statically links its own version library.
-    LOG_DEBUG(<< ml::ver::CBuildInfo::fullInfo());
-
-    ml::core::CProcessPriority::reducePriority();
-
-    ml::seccomp::CSystemCallFilter::installSystemCallFilter();
-
-    if (ioMgr.initIo() == false) {
-        LOG_FATAL(<< "Failed to initialise IO");
-        return EXIT_FAILURE;
+    TCharCPtrVec argv{"autodetect"};
+    for (const auto& token : tokens) {
+        argv.push_back(token.c_str());
     }
 
-    if (jobId.empty()) {
-        LOG_FATAL(<< "No job ID specified");
-        return EXIT_FAILURE;
+    TAutodetectJobUPtr job{std::make_unique<ml::autodetect::CAutodetectJob>()};
+    if (job->parse(static_cast<int>(argv.size()), argv.data()) == false) {
+        LOG_ERROR(<< "Invalid job command '" << command << "'");
+        return nullptr;
     }
-
-    ml::model::CLimits limits;
-    if (!limitConfigFile.empty() && limits.init(limitConfigFile) == false) {
-        LOG_FATAL(<< "Ml limit config file '" << limitConfigFile << "' could not be loaded");
-        return EXIT_FAILURE;
+    if (job->isHost()) {
+        LOG_ERROR(<< "A hosted job cannot itself be a host: '" << command << "'");
+        return nullptr;
+    }
+    if (job->usesStandardStreams()) {
+        LOG_ERROR(<< "A hosted job must have its own input and output: '"
+                  << command << "'");
+        return nullptr;
+    }
+    if (!job->logPipe().empty() || !job->logProperties().empty()) {
+        LOG_WARN(<< "Hosted job '" << job->jobId() << "' logs via the host");
     }
 
-    ml::api::CFieldConfig fieldConfig;
-
-    ml::model_t::ESummaryMode summaryMode(
-        summaryCountFieldName.empty() ? ml::model_t::E_None : ml::model_t::E_Manual);
-    ml::model::CAnomalyDetectorModelConfig modelConfig =
-        ml::model::CAnomalyDetectorModelConfig::defaultConfig(
-            bucketSpan, summaryMode, summaryCountFieldName, latency,
-            bucketResultsDelay, multivariateByFields);
-    modelConfig.detectionRules(ml::model::CAnomalyDetectorModelConfig::TIntDetectionRuleVecUMapCRef(
-        fieldConfig.detectionRules()));
-    modelConfig.scheduledEvents(ml::model::CAnomalyDetectorModelConfig::TStrDetectionRulePrVecCRef(
-        fieldConfig.scheduledEvents()));
+    job->createIoManager();
+    job->excludeSharedMemory();
+    return job;
+}
 
-    if (!modelConfigFile.empty() && modelConfig.init(modelConfigFile) == false) {
-        LOG_FATAL(<< "Ml model config file '" << modelConfigFile << "' could not be loaded");
-        return EXIT_FAILURE;
+//! Open \p job's streams and start it running in \p host.
+void startJob(TAutodetectJobUPtr job, ml::api::CJobHost& host) {
+    if (job->init() == false) {
+        LOG_ERROR(<< "Failed to start job '" << job->jobId() << "'");
+        return;
     }
 
-    if (!modelPlotConfigFile.empty() &&
-        modelConfig.configureModelPlot(modelPlotConfigFile) == false) {
-        LOG_FATAL(<< "Ml model plot config file '" << modelPlotConfigFile
-                  << "' could not be loaded");
-        return EXIT_FAILURE;
-    }
+    std::string jobId{job->jobId()};
+    host.start(jobId, std::move(job));
+}
 
-    using TDataSearcherUPtr = std::unique_ptr<ml::core::CDataSearcher>;
-    const TDataSearcherUPtr restoreSearcher{[isRestoreFileNamedPipe, &ioMgr]() -> TDataSearcherUPtr {
-        if (ioMgr.restoreStream()) {
-            // Check whether state is restored from a file, if so we assume that this is a debugging case
-            // and therefore does not originate from X-Pack.
-            if (!isRestoreFileNamedPipe) {
-                // apply a filter to overcome differences in the way persistence vs. restore works
-                auto strm = std::make_shared<boost::iostreams::filtering_istream>();
-                strm->push(ml::api::CStateRestoreStreamFilter());
-                strm->push(*ioMgr.restoreStream());
-                return std::make_unique<ml::api::CSingleStreamSearcher>(strm);
+//! Start a job for each command read from \p commands then wait for them
+//! all to finish.
+void runJobs(std::istream& commands, std::size_t numberThreads) {
+    if (numberThreads == 0) {
+        numberThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    LOG_DEBUG(<< "Hosting jobs using " << numberThreads << " threads");
+
+    ml::api::CJobHost host(numberThreads);
+
+    // Opening a job's named pipes blocks until the other end connects, so
+    // each job is started on its own thread.  Otherwise a job whose pipes
+    // are never connected would stop every later job from starting.
+    TThreadVec starters;
+    std::string command;
+    while (std::getline(commands, command)) {
+        if (!command.empty()) {
+            TAutodetectJobUPtr job{createJob(command)};
+            if (job != nullptr) {
+                starters.emplace_back(startJob, std::move(job), std::ref(host));
             }
-            return std::make_unique<ml::api::CSingleStreamSearcher>(ioMgr.restoreStream());
-        }
-        return nullptr;
-    }()};
-
-    using TDataAdderUPtr = std::unique_ptr<ml::core::CDataAdder>;
-    const TDataAdderUPtr persister{[&ioMgr]() -> TDataAdderUPtr {
-        if (ioMgr.persistStream()) {
-            return std::make_unique<ml::api::CSingleStreamDataAdder>(ioMgr.persistStream());
         }
-        return nullptr;
-    }()};
-
-    if (persistInterval >= 0 && persister == nullptr) {
-        LOG_FATAL(<< "Periodic persistence cannot be enabled using the 'persistInterval' argument "
-                     "unless a place to persist to has been specified using the 'persist' argument");
-        return EXIT_FAILURE;
     }
+    for (auto& starter : starters) {
+        starter.join();
+    }
+    host.waitForAll();
 
-    using TBackgroundPersisterUPtr = std::unique_ptr<ml::api::CBackgroundPersister>;
-    const TBackgroundPersisterUPtr periodicPersister{[persistInterval, &persister]() -> TBackgroundPersisterUPtr {
-        if (persistInterval >= 0) {
-            return std::make_unique<ml::api::CBackgroundPersister>(persistInterval, *persister);
-        }
-        return nullptr;
-    }()};
-
-    using InputParserCUPtr = std::unique_ptr<ml::api::CInputParser>;
-    const InputParserCUPtr inputParser{[lengthEncodedInput, &ioMgr, delimiter]() -> InputParserCUPtr {
-        if (lengthEncodedInput) {
-            return std::make_unique<ml::api::CLengthEncodedInputParser>(ioMgr.inputStream());
-        }
-        return std::make_unique<ml::api::CCsvInputParser>(ioMgr.inputStream(), delimiter);
-    }()};
+    // The string stores are shared by all the jobs, so they are left out
+    // of each job's memory usage and reported once here instead.
+    LOG_DEBUG(<< "String stores shared by the hosted jobs used "
+              << ml::model::CStringStore::names().memoryUsage() +
+                     ml::model::CStringStore::influencers().memoryUsage()
+              << " bytes");
 
-    ml::core::CJsonOutputStreamWrapper wrappedOutputStream(ioMgr.outputStream());
+    if (host.numberFailed() > 0) {
+        LOG_ERROR(<< host.numberFailed() << " hosted jobs failed");
+    }
+}
+}
 
-    ml::api::CModelSnapshotJsonWriter modelSnapshotWriter(jobId, wrappedOutputStream);
-    if (fieldConfig.initFromCmdLine(fieldConfigFile, clauseTokens) == false) {
-        LOG_FATAL(<< "Field config could not be interpreted");
+int main(int argc, char** argv) {
+    // Read command line options
+    TAutodetectJobUPtr job{std::make_unique<ml::autodetect::CAutodetectJob>()};
+    if (job->parse(argc, argv) == false) {
         return EXIT_FAILURE;
     }
 
-    // The anomaly job knows how to detect anomalies
-    ml::api::CAnomalyJob job(jobId, limits, fieldConfig, modelConfig, wrappedOutputStream,
-                             boost::bind(&ml::api::CModelSnapshotJsonWriter::write,
-                                         &modelSnapshotWriter, _1),
-                             periodicPersister.get(), maxQuantileInterval,
-                             timeField, timeFormat, maxAnomalyRecords);
-
-    if (!quantilesStateFile.empty()) {
-        if (job.initNormalizer(quantilesStateFile) == false) {
-            LOG_FATAL(<< "Failed to restore quantiles and initialize normalizer");
+    // Construct the IO manager before reconfiguring the logger, as it performs
+    // std::ios actions that only work before first use.  A host's only input
+    // is the pipe its commands arrive on.
+    std::unique_ptr<ml::api::CIoManager> commandIoMgr;
+    if (job->isHost()) {
+        if (job->commandPipe().empty()) {
+            LOG_FATAL(<< "A host must have a command pipe");
             return EXIT_FAILURE;
         }
-        if (deleteStateFiles) {
-            ::remove(quantilesStateFile.c_str());
-        }
+        commandIoMgr = std::make_unique<ml::api::CIoManager>(job->commandPipe(),
+                                                             true, "", false);
+    } else {
+        job->createIoManager();
     }
 
-    ml::api::CDataProcessor* firstProcessor(&job);
-
-    // Chain the categorizer's output to the anomaly detector's input
-    ml::api::COutputChainer outputChainer(job);
-
-    ml::api::CJsonOutputWriter fieldDataTyperOutputWriter(jobId, wrappedOutputStream);
-
-    // The typer knows how to assign categories to records
-    ml::api::CFieldDataTyper typer(jobId, fieldConfig, limits, outputChainer,
-                                   fieldDataTyperOutputWriter);
-
-    if (fieldConfig.fieldNameSuperset().count(ml::api::CFieldDataTyper::MLCATEGORY_NAME) > 0) {
-        LOG_DEBUG(<< "Applying the categorization typer for anomaly detection");
-        firstProcessor = &typer;
-    }
-
-    if (periodicPersister != nullptr) {
-        periodicPersister->firstProcessorPeriodicPersistFunc(boost::bind(
-            &ml::api::CDataProcessor::periodicPersistState, firstProcessor, _1));
+    if (ml::core::CLogger::instance().reconfigure(job->logPipe(), job->logProperties()) == false) {
+        LOG_FATAL(<< "Could not reconfigure logging");
+        return EXIT_FAILURE;
     }
 
-    // The skeleton avoids the need to duplicate a lot of boilerplate code
-    ml::api::CCmdSkeleton skeleton(restoreSearcher.get(), persister.get(),
-                                   *inputParser, *firstProcessor);
-    bool ioLoopSucceeded(skeleton.ioLoop());
+    // Log the program version immediately after reconfiguring the logger.  This
+    // must be done from the program, and NOT a shared library, as each program
+    // statically links its own version library.
+    LOG_DEBUG(<< ml::ver::CBuildInfo::fullInfo());
 
-    // Unfortunately we cannot rely on destruction to finalise the output writer
-    // as it must be finalised before the skeleton is destroyed, and C++
-    // destruction order means the skeleton will be destroyed before the output
-    // writer as it was constructed last.
-    fieldDataTyperOutputWriter.finalise();
+    ml::core::CProcessPriority::reducePriority();
 
-    if (!ioLoopSucceeded) {
-        LOG_FATAL(<< "Ml anomaly detector job failed");
-        return EXIT_FAILURE;
-    }
+    ml::seccomp::CSystemCallFilter::installSystemCallFilter();
 
-    if (memoryUsage) {
-        job.descriptionAndDebugMemoryUsage();
+    if (commandIoMgr != nullptr) {
+        if (commandIoMgr->initIo() == false) {
+            LOG_FATAL(<< "Failed to initialise IO");
+            return EXIT_FAILURE;
+        }
+        runJobs(commandIoMgr->inputStream(), job->numberThreads());
+    } else {
+        if (job->init() == false) {
+            return EXIT_FAILURE;
+        }
+        if (job->run() == false) {
+            return EXIT_FAILURE;
+        }
     }
 
-    // Print out the runtime stats generated during this execution context
-    LOG_DEBUG(<< ml::core::CStatistics::instance());
-
     // This message makes it easier to spot process crashes in a log file - if
     // this isn't present in the log for a given PID and there's no other log
     // message indicating early exit then the process has probably core dumped
@@ -30,7 +30,9 @@ bool CCmdLineParser::parse(int argc,
                            bool& isOutputFileNamedPipe,
                            std::string& quantilesState,
                            bool& deleteStateFiles,
-                           bool& writeCsv) {
+                           bool& writeCsv,
+                           std::size_t& blockSize,
+                           std::size_t& numberThreads) {
     try {
         boost::program_options::options_description desc(DESCRIPTION);
         // clang-format off
@@ -59,6 +61,12 @@ bool CCmdLineParser::parse(int argc,
                         "If this flag is set then delete the normalizer state files once they have been read")
             ("writeCsv",
                         "Write the results in CSV format (default is lineified JSON)")
+            ("blockSize", boost::program_options::value<std::size_t>(),
+                        "Optional number of records to normalize together - default is 0, "
+                        "which normalizes each record as it is read")
+            ("numberThreads", boost::program_options::value<std::size_t>(),
+                        "Optional number of threads to use to normalize each block of records - "
+                        "default is 1")
         ;
         // clang-format on
 
@@ -111,6 +119,12 @@ bool CCmdLineParser::parse(int argc,
         if (vm.count("writeCsv") > 0) {
             writeCsv = true;
         }
+        if (vm.count("blockSize") > 0) {
+            blockSize = vm["blockSize"].as<std::size_t>();
+        }
+        if (vm.count("numberThreads") > 0) {
+            numberThreads = vm["numberThreads"].as<std::size_t>();
+        }
     } catch (std::exception& e) {
         std::cerr << "Error processing command line: " << e.what() << std::endl;
         return false;
@@ -43,7 +43,9 @@ public:
                       bool& isOutputFileNamedPipe,
                       std::string& quantilesState,
                       bool& deleteStateFiles,
-                      bool& writeCsv);
+                      bool& writeCsv,
+                      std::size_t& blockSize,
+                      std::size_t& numberThreads);
 
 private:
     static const std::string DESCRIPTION;
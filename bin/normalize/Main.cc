@@ -54,10 +54,13 @@ int main(int argc, char** argv) {
     std::string quantilesStateFile;
     bool deleteStateFiles(false);
     bool writeCsv(false);
+    std::size_t blockSize(0);
+    std::size_t numberThreads(1);
     if (ml::normalize::CCmdLineParser::parse(
-            argc, argv, modelConfigFile, logProperties, logPipe, bucketSpan, lengthEncodedInput,
-            inputFileName, isInputFileNamedPipe, outputFileName, isOutputFileNamedPipe,
-            quantilesStateFile, deleteStateFiles, writeCsv) == false) {
+            argc, argv, modelConfigFile, logProperties, logPipe, bucketSpan,
+            lengthEncodedInput, inputFileName, isInputFileNamedPipe, outputFileName,
+            isOutputFileNamedPipe, quantilesStateFile, deleteStateFiles, writeCsv,
+            blockSize, numberThreads) == false) {
         return EXIT_FAILURE;
     }
 
@@ -115,7 +118,7 @@ int main(int argc, char** argv) {
     }()};
 
     // This object will do the work
-    ml::api::CResultNormalizer normalizer(modelConfig, *outputWriter);
+    ml::api::CResultNormalizer normalizer(modelConfig, *outputWriter, blockSize, numberThreads);
 
     // Restore state
     if (!quantilesStateFile.empty()) {
@@ -134,6 +137,10 @@ int main(int argc, char** argv) {
         LOG_FATAL(<< "Failed to handle input to be normalized");
         return EXIT_FAILURE;
     }
+    if (normalizer.finalise() == false) {
+        LOG_FATAL(<< "Failed to write normalized output");
+        return EXIT_FAILURE;
+    }
 
     // This message makes it easier to spot process crashes in a log file - if
     // this isn't present in the log for a given PID and there's no other log
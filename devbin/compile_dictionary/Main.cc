@@ -0,0 +1,45 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CLogger.h>
+#include <core/CWordDictionary.h>
+
+#include <fstream>
+#include <iostream>
+
+#include <stdlib.h>
+
+using namespace ml;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Utility to compile a word dictionary into the binary image "
+                     "which is memory mapped at runtime"
+                  << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <dictionary file> <image file>" << std::endl;
+        std::cerr << "e.g. " << argv[0] << " lib/core/ml-en.dict lib/core/ml-en.dict.bin"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream text(argv[1]);
+    if (text.is_open() == false) {
+        LOG_FATAL(<< "Unable to open " << argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream image(argv[2], std::ios::binary | std::ios::trunc);
+    if (image.is_open() == false) {
+        LOG_FATAL(<< "Unable to open " << argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    if (core::CWordDictionary::compile(text, image) == false) {
+        LOG_FATAL(<< "Failed to compile " << argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
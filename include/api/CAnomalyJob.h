@@ -8,8 +8,11 @@
 
 #include <core/CJsonOutputStreamWrapper.h>
 #include <core/CStopWatch.h>
+#include <core/CTimeFormatParser.h>
 #include <core/CoreTypes.h>
 
+#include <maths/CSampling.h>
+
 #include <model/CAnomalyDetector.h>
 #include <model/CAnomalyDetectorModelConfig.h>
 #include <model/CBucketQueue.h>
@@ -46,6 +49,7 @@ namespace core {
 class CDataAdder;
 class CDataSearcher;
 class CStateRestoreTraverser;
+class CStatistics;
 }
 namespace model {
 class CHierarchicalResults;
@@ -145,6 +149,12 @@ public:
         core_t::TTime s_LatestRecordTime;
         core_t::TTime s_LastResultsTime;
         TKeyCRefAnomalyDetectorPtrPrVec s_Detectors;
+        //! The statistics and random number generator which are current
+        //! when the arguments are created. These belong to the job, which
+        //! may not be the only one in the process, and are persisted with
+        //! its simple count detector.
+        core::CStatistics* s_Statistics;
+        maths::CSampling::CContext* s_SamplingContext;
     };
 
     using TBackgroundPersistArgsPtr = std::shared_ptr<SBackgroundPersistArgs>;
@@ -330,6 +340,9 @@ private:
 
     //! Generate the model plot for the models of the specified detector in the
     //! specified time range.
+    //!
+    //! If results aren't delayed the model plot is written as it's generated,
+    //! otherwise it's queued until the results for the bucket are written.
     void generateModelPlot(core_t::TTime startTime,
                            core_t::TTime endTime,
                            const model::CAnomalyDetector& detector);
@@ -442,6 +455,9 @@ private:
     //! string to a number.
     std::string m_TimeFieldFormat;
 
+    //! Converts time fields in m_TimeFieldFormat to epoch times.
+    core::CTimeFormatParser m_TimeFieldParser;
+
     //! License restriction on the number of detectors allowed
     size_t m_MaxDetectors;
 
@@ -42,6 +42,14 @@ public:
     //! Pass input to the processor until it's consumed as much as it can.
     bool ioLoop();
 
+    //! Restore the processor's state, if there's a place to restore from.
+    //! This is the first step of ioLoop().
+    bool restoreState();
+
+    //! Finalise the processor and persist its state, if there's a place
+    //! to persist to.  This is the last step of ioLoop().
+    bool finalise();
+
 private:
     //! Persists the state of the models
     bool persistState();
@@ -0,0 +1,221 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_api_CJobHost_h
+#define INCLUDED_ml_api_CJobHost_h
+
+#include <core/CNonCopyable.h>
+
+#include <api/ImportExport.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ml {
+namespace core {
+class CDataAdder;
+class CDataSearcher;
+}
+namespace api {
+class CDataProcessor;
+class CInputParser;
+
+//! \brief Runs many jobs in one process on a shared pool of threads.
+//!
+//! DESCRIPTION:\n
+//! Each job is exactly what a single job process would run: an input
+//! parser reading records from the job's own input stream, the chain of
+//! processors which analyse them and optional places to restore state
+//! from and persist state to. The host does what CCmdSkeleton::ioLoop
+//! does for each job, i.e. restores state, passes every record to the
+//! processor, then finalises it and persists its state, but the jobs
+//! share one set of processing threads. This means the overheads which
+//! don't depend on the job, such as the word dictionary, timezone
+//! database, string stores, logger and thread stacks, are paid once for
+//! all the jobs rather than once per job.
+//!
+//! Scheduling is fair: the jobs which have records waiting take turns
+//! in round robin order and each turn processes at most quantum()
+//! records, so a busy job can't starve the others.
+//!
+//! Failures are isolated: if restoring, processing, finalising or
+//! persisting a job throws, fails or its input can't be parsed, only
+//! that job is stopped. Its finished() function is called to say it
+//! failed and it is removed as soon as its input reaches end-of-file.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The input parsers pull records from blocking streams, and a parser
+//! can't be suspended part way through a stream, so each job has its own
+//! reader thread which does nothing but parse records into a bounded
+//! queue. The reader threads spend almost all their time waiting for
+//! input. All the analysis happens on the processing threads. Because
+//! the queue is bounded a job which can't keep up exerts back pressure
+//! on its input exactly as it would in its own process.
+//!
+//! A job is only ever processed by one thread at a time and its records
+//! are processed in the order they were read. Whilst a thread processes
+//! a job its ID is pushed onto the logger's nested diagnostic context so
+//! every message it logs can be attributed to it.
+//!
+//! Each job has its own memory limit because that is enforced by the
+//! resource monitor of the job's CLimits object. The string stores of
+//! person, attribute and influencer names are shared by every job in
+//! the process, so they are left out of each hosted job's memory usage,
+//! see model::CResourceMonitor::includeStringStores, and the program
+//! hosting the jobs reports them once.
+//!
+//! The scratch space the models reuse to avoid allocating when they're
+//! updated isn't in any job's memory usage either. It is thread local in
+//! the maths library, so it belongs to the processing threads rather
+//! than to the jobs. This is a deliberate trade-off. Member buffers
+//! would be accounted, but every one of a job's, possibly millions of,
+//! models would keep their capacity. There is one copy per processing
+//! thread and its size is bounded by the largest single update, so the
+//! process can use a little more memory than the sum of its jobs' limits.
+//!
+//! The state which is persisted with a job must only depend on that
+//! job, so each job has its own core::CStatistics and
+//! maths::CSampling::CContext, which are made current whilst a thread
+//! processes it. Each anomaly detector owns its maintenance scheduler
+//! context. A crash, as opposed to an exception, still takes down every
+//! job in the process.
+class API_EXPORT CJobHost : private core::CNonCopyable {
+public:
+    //! \brief The components of a job.
+    //!
+    //! DESCRIPTION:\n
+    //! Owns everything the job needs, including its input and output
+    //! streams, for as long as the host runs it.
+    class API_EXPORT CJob {
+    public:
+        virtual ~CJob() = default;
+
+        //! Get the source to restore state from or null if there isn't one.
+        virtual core::CDataSearcher* restoreSearcher() = 0;
+
+        //! Get the sink to persist state to or null if there isn't one.
+        virtual core::CDataAdder* persister() = 0;
+
+        //! Get the parser of the job's input.
+        virtual CInputParser& inputParser() = 0;
+
+        //! Get the first processor in the job's chain.
+        virtual CDataProcessor& processor() = 0;
+
+        //! Called once when the job has finished, or failed, and all its
+        //! processing is done.
+        virtual void finished(bool succeeded) = 0;
+    };
+    using TJobUPtr = std::unique_ptr<CJob>;
+
+public:
+    //! The default maximum number of records processed in one turn.
+    static const std::size_t DEFAULT_QUANTUM;
+
+public:
+    //! \param[in] numberThreads The number of threads which process the
+    //! jobs. This is at least one.
+    //! \param[in] quantum The maximum number of records a job processes
+    //! in one turn.
+    explicit CJobHost(std::size_t numberThreads, std::size_t quantum = DEFAULT_QUANTUM);
+
+    //! Waits for all jobs to finish.
+    ~CJobHost();
+
+    //! Start running \p job with \p id.
+    //!
+    //! \return False if a job with \p id is already running, in which
+    //! case \p job is discarded.
+    bool start(const std::string& id, TJobUPtr job);
+
+    //! Wait until every job has finished and been removed.
+    void waitForAll();
+
+    //! Get the number of jobs which haven't yet been removed.
+    std::size_t numberJobs() const;
+
+    //! Get the number of jobs which have failed.
+    std::size_t numberFailed() const;
+
+    //! Get the maximum number of records a job processes in one turn.
+    std::size_t quantum() const;
+
+private:
+    using TStrStrUMap = boost::unordered_map<std::string, std::string>;
+    struct SJobState;
+    using TJobStateUPtr = std::unique_ptr<SJobState>;
+    using TStrJobStateUPtrMap = std::map<std::string, TJobStateUPtr>;
+    using TJobStatePtrDeque = std::deque<SJobState*>;
+    using TThreadVec = std::vector<std::thread>;
+
+private:
+    //! Parse \p job's input until end-of-file or the job finishes.
+    void read(SJobState& job);
+
+    //! Queue \p record for \p job, waiting if its queue is full.
+    bool add(SJobState& job, const TStrStrUMap& record);
+
+    //! Add \p job to the back of the queue of jobs with work to do.
+    void schedule(SJobState& job);
+
+    //! Process jobs until shutdown.
+    void worker();
+
+    //! Take a turn processing \p job.
+    void process(SJobState& job);
+
+    //! Restore \p job if necessary, process its turn of records and, if
+    //! its input is \p complete, finalise it. Returns false if the job
+    //! fails.
+    bool processTurn(SJobState& job, bool complete, bool inputFailed);
+
+    //! Record that \p job has finished.
+    void finish(SJobState& job, bool succeeded);
+
+    //! Remove \p job from the host.
+    void remove(SJobState& job);
+
+private:
+    //! The maximum number of records a job processes in one turn.
+    std::size_t m_Quantum;
+
+    //! Protects the host's state.
+    mutable std::mutex m_Mutex;
+
+    //! Signalled when there is a job to process or shutdown is requested.
+    std::condition_variable m_WorkAvailable;
+
+    //! Signalled when a job is removed.
+    std::condition_variable m_JobRemoved;
+
+    //! The jobs keyed by their IDs.
+    TStrJobStateUPtrMap m_Jobs;
+
+    //! The jobs which have work to do, in the order they take turns.
+    TJobStatePtrDeque m_RunQueue;
+
+    //! The number of jobs which have failed.
+    std::size_t m_NumberFailed;
+
+    //! Set to stop the processing threads.
+    bool m_Shutdown;
+
+    //! The threads which process the jobs.
+    TThreadVec m_Workers;
+};
+}
+}
+
+#endif // INCLUDED_ml_api_CJobHost_h
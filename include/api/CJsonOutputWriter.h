@@ -69,15 +69,15 @@ namespace api {
 //!
 //! Empty string fields are not written to the output.
 //!
-//! Memory for values added to the output documents is allocated from a pool (to
-//! reduce allocation cost and memory fragmentation).  This pool is cleared
-//! between buckets to avoid excessive accumulation of memory over long periods.
-//! It is crucial that the pool is only cleared when no documents reference
-//! memory within it.  This is achieved by only clearing the pool
-//! (m_JsonPoolAllocator) when the m_BucketDataByTime vector is empty.  Care
-//! must be taken if the memory pool is used to allocate memory for long-lived
-//! documents that are not stored within m_BucketDataByTime.  (It might be
-//! better to have a separate pool if this situation ever arises in the future.)
+//! Memory for values added to the result documents is allocated from a pool (to
+//! reduce allocation cost and memory fragmentation).  Each output batch has its
+//! own pool (m_BatchAllocator) which is created when the first result for the
+//! batch is accepted.  When endOutputBatch() is called the documents and the
+//! pool which owns their memory are handed over to the output stream's thread,
+//! which serialises them and then frees the pool.  This means the expensive
+//! serialisation doesn't happen on the analysis thread.  Because the stream's
+//! thread processes everything written to the stream in order, the order of
+//! the output, including flush acknowledgements, is unchanged.
 //!
 //! Population anomalies consist of overall results and breakdown results.
 //! There is an assumption that the overall result for a population anomaly
@@ -120,6 +120,7 @@ public:
     using TStringDoublePrVec = std::vector<TStringDoublePr>;
 
     using TValuePtr = std::shared_ptr<rapidjson::Value>;
+    using TPoolAllocatorPtr = core::CRapidJsonConcurrentLineWriter::TPoolAllocatorPtr;
 
     //! Structure to buffer up information about each bucket that we have
     //! unwritten results for
@@ -269,12 +270,19 @@ private:
     void popAllocator();
 
 private:
+    //! Sort the JSON documents that have been built up for a particular
+    //! bucket and add the fields common to the bucket
+    void addBucketFields(bool isInterim, core_t::TTime bucketTime, SBucketData& bucketData);
+
     //! Write out all the JSON documents that have been built up for
     //! a particular bucket
-    void writeBucket(bool isInterim,
-                     core_t::TTime bucketTime,
-                     SBucketData& bucketData,
-                     uint64_t bucketProcessingTime);
+    //! \note This is called on the output stream's thread.
+    static void writeBucket(const std::string& jobId,
+                            bool isInterim,
+                            core_t::TTime bucketTime,
+                            const SBucketData& bucketData,
+                            uint64_t bucketProcessingTime,
+                            core::CJsonOutputStreamWrapper::CAsyncLineWriter& writer);
 
     //! Add the fields for a metric detector
     void addMetricFields(const CHierarchicalResultsWriter::TResults& results,
@@ -305,6 +313,9 @@ private:
     //! The job ID
     std::string m_JobId;
 
+    //! The stream to which output is written
+    core::CJsonOutputStreamWrapper& m_OutputStream;
+
     //! JSON line writer
     core::CRapidJsonConcurrentLineWriter m_Writer;
 
@@ -317,16 +328,17 @@ private:
     //! Max number of records to write for each bucket/detector
     size_t m_RecordOutputLimit;
 
+    //! The memory pool for the documents of the current output batch.
+    TPoolAllocatorPtr m_BatchAllocator;
+
     //! Vector for building up documents representing nested sub-results.
     //! The documents in this vector will reference memory owned by
-    //! m_JsonPoolAllocator.  (Hence this is declared after the memory pool
-    //! so that it's destroyed first when the destructor runs.)
+    //! m_BatchAllocator.
     TDocumentWeakPtrVec m_NestedDocs;
 
     //! Bucket data waiting to be written.  The map is keyed on bucket time.
     //! The documents in this map will reference memory owned by
-    //! m_JsonPoolAllocator.  (Hence this is declared after the memory pool
-    //! so that it's destroyed first when the destructor runs.)
+    //! m_BatchAllocator.
     TTimeBucketDataMap m_BucketDataByTime;
 };
 }
@@ -68,6 +68,7 @@ public:
     using TStrByFieldDataUMapCItr = TStrByFieldDataUMap::const_iterator;
     using TFeatureStrByFieldDataUMapUMapCItr = model::CModelPlotData::TFeatureStrByFieldDataUMapUMapCItr;
     using TStrDoublePr = model::CModelPlotData::TStrDoublePr;
+    using TRow = model::CModelPlotData::SRow;
 
 public:
     //! Constructor that causes to be written to the specified stream
@@ -75,18 +76,15 @@ public:
 
     void writeFlat(const std::string& jobId, const model::CModelPlotData& data);
 
-private:
-    void writeFlatRow(core_t::TTime time,
-                      const std::string& jobId,
-                      int detectorIndex,
-                      const std::string& partitionFieldName,
-                      const std::string& partitionFieldValue,
-                      const std::string& feature,
-                      const std::string& byFieldName,
-                      const std::string& byFieldValue,
-                      const TByFieldData& byData,
-                      core_t::TTime bucketSpan,
-                      rapidjson::Value& doc);
+    //! Write a single row of model plot data.
+    //!
+    //! \param[in] jobId The job identifier.
+    //! \param[in] series The time, detector and partition of \p row.
+    //! Any data it holds is ignored.
+    //! \param[in] row The row to write.
+    void writeRow(const std::string& jobId,
+                  const model::CModelPlotData& series,
+                  const TRow& row);
 
 private:
     //! JSON line writer
@@ -7,6 +7,7 @@
 #define INCLUDED_ml_api_CResultNormalizer_h
 
 #include <core/CLogger.h>
+#include <core/CThreadPool.h>
 
 #include <model/CAnomalyDetectorModelConfig.h>
 #include <model/CHierarchicalResultsNormalizer.h>
@@ -40,6 +41,13 @@ namespace api {
 //! The state required to initialize the normalizers is a JSON document
 //! as created by model::CHierarchicalResultsNormalizer::toJson().
 //!
+//! Records can optionally be normalized in blocks. This is intended
+//! for renormalizing large numbers of historic results. The records
+//! in a block are grouped by normalizer, each group is normalized in
+//! one pass, groups are normalized on multiple threads and the output
+//! is written in input order. The normalized scores are identical to
+//! those produced by normalizing one record at a time.
+//!
 //! IMPLEMENTATION DECISIONS:\n
 //! Does not support processor chaining functionality as it is unlikely
 //! that this class would ever be chained to another data processor.
@@ -76,8 +84,16 @@ public:
     using TStrStrUMapCItr = TStrStrUMap::const_iterator;
 
 public:
+    //! \param[in] modelConfig The model configuration.
+    //! \param[in] outputHandler The object to which to write results.
+    //! \param[in] blockSize If non-zero records are buffered and are
+    //! normalized in blocks of this size.
+    //! \param[in] numberThreads The number of threads to use to normalize
+    //! each block of records.
     CResultNormalizer(const model::CAnomalyDetectorModelConfig& modelConfig,
-                      COutputHandler& outputHandler);
+                      COutputHandler& outputHandler,
+                      std::size_t blockSize = 0,
+                      std::size_t numberThreads = 1);
 
     //! Initialise the system change normalizer
     bool initNormalizer(const std::string& stateFileName);
@@ -85,16 +101,50 @@ public:
     //! Handle a record to be normalized
     bool handleRecord(const TStrStrUMap& dataRowFields);
 
+    //! Normalize and write any buffered records.
+    //!
+    //! \note This must be called after the last record has been handled
+    //! if records are normalized in blocks.
+    bool finalise();
+
+private:
+    //! \brief The information needed to normalize one record.
+    struct SRecord {
+        std::string s_Level;
+        std::string s_Partition;
+        std::string s_PartitionValue;
+        std::string s_Person;
+        std::string s_PersonValue;
+        std::string s_Function;
+        std::string s_ValueFieldName;
+        double s_Probability = 0.0;
+        //! Could the record's fields be parsed?
+        bool s_IsNormalizable = false;
+        //! The score, which is normalized in place.
+        double s_Score = 0.0;
+        //! The normalizer to use or null if the score shouldn't be
+        //! normalized.
+        const model::CAnomalyScore::CNormalizer* s_Normalizer = nullptr;
+    };
+
+    using TRecordVec = std::vector<SRecord>;
+    using TStrStrUMapVec = std::vector<TStrStrUMap>;
+    using TDoubleVec = std::vector<double>;
+
 private:
-    bool parseDataFields(const TStrStrUMap& dataRowFields,
-                         std::string& level,
-                         std::string& partition,
-                         std::string& partitionValue,
-                         std::string& person,
-                         std::string& personValue,
-                         std::string& function,
-                         std::string& valueFieldName,
-                         double& probability);
+    //! Parse \p dataRowFields and choose the normalizer for the record.
+    void initRecord(const TStrStrUMap& dataRowFields, SRecord& record) const;
+
+    //! Normalize the score of a single \p record.
+    void normalize(SRecord& record) const;
+
+    //! Write the record \p dataRowFields with the normalized score.
+    bool writeRecord(const TStrStrUMap& dataRowFields, const SRecord& record);
+
+    //! Normalize and write the buffered records.
+    bool normalizeBlock();
+
+    bool parseDataFields(const TStrStrUMap& dataRowFields, SRecord& record) const;
 
     template<typename T>
     bool parseDataField(const TStrStrUMap& dataRowFields,
@@ -129,6 +179,15 @@ private:
 
     //! The hierarchical results normalizer
     model::CHierarchicalResultsNormalizer m_Normalizer;
+
+    //! The number of records to normalize together.
+    std::size_t m_BlockSize;
+
+    //! The threads used to normalize a block.
+    core::CThreadPool m_ThreadPool;
+
+    //! The buffered records.
+    TStrStrUMapVec m_Block;
 };
 }
 }
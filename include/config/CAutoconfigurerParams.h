@@ -124,6 +124,15 @@ public:
 
     //! The minimum permitted detector score.
     double minimumDetectorScore() const;
+
+    //! The maximum number of records in the time stratified sample used
+    //! to compute the detector count statistics. Zero means use every
+    //! record.
+    std::size_t sampleSize() const;
+
+    //! The number of threads to use to update the detector count statistics
+    //! and scores.
+    std::size_t numberThreads() const;
     //@}
 
     //! A number of by field values which is considered high so
@@ -327,6 +336,12 @@ private:
 
     //! The minimum permitted detector score.
     double m_MinimumDetectorScore;
+
+    //! The maximum number of records to sample or zero to use every record.
+    std::size_t m_SampleSize;
+
+    //! The number of threads to use.
+    std::size_t m_NumberThreads;
     //@}
 
     //! \name Field Role Scoring
@@ -0,0 +1,111 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_config_CColumnarRecordBuffer_h
+#define INCLUDED_ml_config_CColumnarRecordBuffer_h
+
+#include <core/CoreTypes.h>
+
+#include <config/ImportExport.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace ml {
+namespace config {
+
+//! \brief A compact buffer of records.
+//!
+//! DESCRIPTION:\n
+//! Stores a sequence of records, i.e. their times and field values,
+//! by column. The distinct values of each field are stored once and
+//! each record holds an index into its field's values. Field values
+//! typically repeat a lot so this is much more compact than storing
+//! a copy of each record's field value map.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! Records needn't all have the same fields. A field which is missing
+//! from a record is marked as such in the field's column. A column is
+//! added the first time a field is seen and is back filled with this
+//! marker for the records already in the buffer.
+//!
+//! The columns are stored in a deque so that the pointers from their
+//! value vectors into their value indices remain valid as columns are
+//! added.
+class CONFIG_EXPORT CColumnarRecordBuffer {
+public:
+    using TStrStrUMap = boost::unordered_map<std::string, std::string>;
+
+public:
+    //! Add a record with \p time and \p fieldValues.
+    void add(core_t::TTime time, const TStrStrUMap& fieldValues);
+
+    //! Get the number of records.
+    std::size_t size() const;
+
+    //! Check if there are no records.
+    bool empty() const;
+
+    //! Get the time of the \p i'th record.
+    core_t::TTime time(std::size_t i) const;
+
+    //! Get the field values of the \p i'th record.
+    //!
+    //! \note To avoid allocations \p result's existing entries are
+    //! reused, so it is cheapest to pass the same map for a sequence
+    //! of records.
+    void fieldValues(std::size_t i, TStrStrUMap& result) const;
+
+    //! Remove all the records.
+    void clear();
+
+private:
+    using TTimeVec = std::vector<core_t::TTime>;
+    using TUInt32Vec = std::vector<uint32_t>;
+    using TStrCPtrVec = std::vector<const std::string*>;
+    using TStrUInt32UMap = boost::unordered_map<std::string, uint32_t>;
+    using TStrSizeUMap = boost::unordered_map<std::string, std::size_t>;
+
+    //! \brief The values of a single field.
+    struct SColumn {
+        explicit SColumn(const std::string& name) : s_Name(name) {}
+
+        //! The field name.
+        std::string s_Name;
+        //! The distinct values of the field and their indices.
+        TStrUInt32UMap s_Index;
+        //! The distinct values of the field by index.
+        TStrCPtrVec s_Values;
+        //! The index of each record's value.
+        TUInt32Vec s_Records;
+    };
+
+    using TColumnDeque = std::deque<SColumn>;
+
+private:
+    //! Get the column for \p name, creating it if necessary.
+    SColumn& column(const std::string& name);
+
+private:
+    //! The record times.
+    TTimeVec m_Times;
+
+    //! The field values by column.
+    TColumnDeque m_Columns;
+
+    //! The index of each field's column.
+    TStrSizeUMap m_ColumnIndex;
+};
+}
+}
+
+#endif // INCLUDED_ml_config_CColumnarRecordBuffer_h
@@ -28,6 +28,9 @@
 #include <vector>
 
 namespace ml {
+namespace core {
+class CThreadPool;
+}
 namespace config {
 class CAutoconfigurerParams;
 class CDetectorRecord;
@@ -66,8 +69,9 @@ public:
              TDetectorRecordCItr beginRecords,
              TDetectorRecordCItr endRecords);
 
-    //! Capture the current bucket statistics.
-    void capture();
+    //! Capture the current bucket statistics counting the bucket
+    //! \p weight times.
+    void capture(uint64_t weight);
 
     //! Get the total count of distinct partitions and buckets seen to date.
     uint64_t bucketPartitionCount() const;
@@ -152,6 +156,18 @@ public:
     //! Update the statistics with [\p beginRecords, \p endRecords).
     virtual void add(TDetectorRecordCItr beginRecords, TDetectorRecordCItr endRecords) = 0;
 
+    //! Set the number of times to count each complete bucket. This is
+    //! the reciprocal of the fraction of buckets which are sampled.
+    void setBucketWeight(uint64_t weight);
+
+    //! Skip the interval [\p begin, \p end) because its records aren't
+    //! sampled. This completes the current buckets but doesn't count the
+    //! buckets in the interval.
+    //!
+    //! \note \p begin and \p end should be multiples of all the candidate
+    //! bucket lengths.
+    void skip(core_t::TTime begin, core_t::TTime end);
+
     //! Get the total count of records added.
     uint64_t recordCount() const;
 
@@ -213,6 +229,9 @@ private:
     //! Fill in the last bucket end times if they are empty.
     void fillLastBucketEndTimes(core_t::TTime time);
 
+    //! Capture the statistics of the buckets which end before \p time.
+    void completeBuckets(core_t::TTime time);
+
 private:
     //! The parameters.
     TAutoconfigurerParamsCRef m_Params;
@@ -253,6 +272,9 @@ private:
     //! The bucket sampling masks.
     TBoolVecVec m_BucketMasks;
 
+    //! The number of times to count each complete bucket.
+    uint64_t m_BucketWeight;
+
     //! The total count of complete buckets seen.
     TUInt64Vec m_BucketCounts;
 
@@ -319,6 +341,7 @@ private:
 class CONFIG_EXPORT CDataCountStatisticsDirectAddressTable {
 public:
     using TDetectorRecordVec = std::vector<CDetectorRecord>;
+    using TDetectorRecordVecVec = std::vector<TDetectorRecordVec>;
     using TDetectorSpecificationVec = std::vector<CDetectorSpecification>;
 
 public:
@@ -333,6 +356,19 @@ public:
     //! Update the statistics with \p records.
     void add(const TDetectorRecordVec& records);
 
+    //! Update the statistics with each of \p records in turn using the
+    //! threads in \p pool.
+    //!
+    //! \note Each statistic is updated by a single thread so the result
+    //! is the same as adding the records one at a time.
+    void add(const TDetectorRecordVecVec& records, core::CThreadPool& pool);
+
+    //! Set the number of times to count each complete bucket.
+    void setBucketWeight(uint64_t weight);
+
+    //! Skip the interval [\p begin, \p end) whose records aren't sampled.
+    void skip(core_t::TTime begin, core_t::TTime end);
+
     //! Get the detector \p spec's statistics.
     const CDataCountStatistics& statistics(const CDetectorSpecification& spec) const;
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_config_CTimeStratifiedSample_h
+#define INCLUDED_ml_config_CTimeStratifiedSample_h
+
+#include <core/CoreTypes.h>
+
+#include <config/CColumnarRecordBuffer.h>
+#include <config/ImportExport.h>
+
+#include <cstddef>
+#include <map>
+
+#include <stdint.h>
+
+namespace ml {
+namespace config {
+
+//! \brief A bounded size random sample of the records in whole intervals
+//! of time.
+//!
+//! DESCRIPTION:\n
+//! The data are divided into strata, which are consecutive intervals of
+//! time of a fixed length, and a random subset of the strata is sampled.
+//! Every record in a sampled stratum is kept so any bucket which fits in
+//! a stratum is either completely sampled or not at all. Statistics of
+//! bucketed data, such as the distribution of bucket counts, computed
+//! from the sample are therefore unbiased estimates of those for all the
+//! data, provided counts of buckets are weighted by weight(), which is
+//! the reciprocal of the probability a stratum is sampled.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The total number of records isn't known up front so the sampling rate
+//! is adapted as the records are added, as for a reservoir sample. This
+//! uses the scheme from adaptive distinct sampling: a stratum is sampled
+//! at level l if the low l bits of its hash are zero. When the sample
+//! size exceeds the maximum, the level is increased and strata which are
+//! no longer sampled are discarded. Since the strata sampled at level
+//! l + 1 are a subset of those sampled at level l, every stratum is kept
+//! with probability 2^-l where l is the final level, independent of its
+//! content and of the order in which records arrive. This also means the
+//! weights are integers.
+//!
+//! A single stratum can exceed the maximum size in which case the sample
+//! will contain more records than requested.
+//!
+//! The records of each stratum are stored compactly in their own columnar
+//! buffer so discarding a stratum frees all its memory.
+class CONFIG_EXPORT CTimeStratifiedSample {
+public:
+    using TStrStrUMap = CColumnarRecordBuffer::TStrStrUMap;
+    using TTimeRecordBufferMap = std::map<core_t::TTime, CColumnarRecordBuffer>;
+
+public:
+    CTimeStratifiedSample(core_t::TTime stratumLength, std::size_t maximumSize);
+
+    //! Add a record with \p time and \p fieldValues.
+    void add(core_t::TTime time, const TStrStrUMap& fieldValues);
+
+    //! Get the length of the strata.
+    core_t::TTime stratumLength() const;
+
+    //! Get the number of records in the sample.
+    std::size_t size() const;
+
+    //! Get the reciprocal of the probability that a stratum is sampled.
+    uint64_t weight() const;
+
+    //! Get the sampled strata keyed by their start times.
+    const TTimeRecordBufferMap& strata() const;
+
+    //! Check if any records have been added.
+    bool empty() const;
+
+    //! Get the earliest time of any record added.
+    core_t::TTime earliest() const;
+
+    //! Get the latest time of any record added.
+    core_t::TTime latest() const;
+
+private:
+    //! Check if the stratum starting at \p start is sampled.
+    bool sampled(core_t::TTime start) const;
+
+    //! Increase the level until the sample is small enough.
+    void reduce();
+
+private:
+    //! The length of the strata.
+    core_t::TTime m_StratumLength;
+
+    //! The maximum number of records to sample.
+    std::size_t m_MaximumSize;
+
+    //! The current sampling level.
+    std::size_t m_Level;
+
+    //! The number of records in the sample.
+    std::size_t m_Size;
+
+    //! The earliest record time.
+    core_t::TTime m_Earliest;
+
+    //! The latest record time.
+    core_t::TTime m_Latest;
+
+    //! The records of the sampled strata.
+    TTimeRecordBufferMap m_Strata;
+};
+}
+}
+
+#endif // INCLUDED_ml_config_CTimeStratifiedSample_h
@@ -0,0 +1,99 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_core_CAhoCorasickMatcher_h
+#define INCLUDED_ml_core_CAhoCorasickMatcher_h
+
+#include <core/ImportExport.h>
+
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace ml {
+namespace core {
+
+//! \brief Checks if a string contains any of a set of substrings.
+//!
+//! DESCRIPTION:\n
+//! A compiled Aho-Corasick automaton for a set of patterns. It checks
+//! whether a key contains any of the patterns in a single pass over the
+//! key, i.e. in time proportional to the length of the key independent
+//! of the number and length of the patterns. Incremental updates are not
+//! supported. Updating the patterns requires rebuilding the automaton.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! As with CFlatPrefixTree the automaton is packed into vectors for
+//! spatial locality. The nodes of the trie of the patterns are stored
+//! in breadth first order, each with the range of its outgoing edges
+//! in a separate vector of edges sorted by character. The next state
+//! for a character is found by a binary search of the current node's
+//! edges and, failing that, by following failure links which point to
+//! the node for the longest proper suffix of the current node's string
+//! which is in the trie. Since we only need to know if some pattern
+//! matches, a node is terminal if any pattern is a suffix of its string.
+class CORE_EXPORT CAhoCorasickMatcher {
+public:
+    using TStrVec = std::vector<std::string>;
+
+public:
+    //! Builds the automaton from \p patterns. Empty patterns are ignored.
+    //! Returns true if the automaton was built successfully.
+    bool build(const TStrVec& patterns);
+
+    //! Returns true if \p key contains any of the patterns.
+    bool matches(const std::string& key) const;
+
+    //! Returns true if there are no patterns.
+    bool empty() const;
+
+    //! Clears the automaton.
+    void clear();
+
+private:
+    struct SNode {
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+
+        //! The index of the first outgoing edge.
+        uint32_t s_FirstEdge;
+        //! The index of the end of the outgoing edges.
+        uint32_t s_EndEdge;
+        //! The node for the longest proper suffix in the trie.
+        uint32_t s_Failure;
+        //! True if a pattern is a suffix of this node's string.
+        bool s_Terminal;
+    };
+
+    struct SEdge {
+        //! See CMemory.
+        static bool dynamicSizeAlwaysZero() { return true; }
+
+        bool operator<(char rhs) const { return s_Char < rhs; }
+
+        char s_Char;
+        uint32_t s_Target;
+    };
+
+    using TNodeVec = std::vector<SNode>;
+    using TEdgeVec = std::vector<SEdge>;
+
+private:
+    //! Get the child of \p node for \p c if there is one.
+    uint32_t child(uint32_t node, char c) const;
+
+private:
+    //! The nodes in breadth first order.
+    TNodeVec m_Nodes;
+
+    //! The edges grouped by source node and sorted by character.
+    TEdgeVec m_Edges;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CAhoCorasickMatcher_h
@@ -15,6 +15,7 @@
 
 #include <rapidjson/stringbuffer.h>
 
+#include <functional>
 #include <ostream>
 
 namespace ml {
@@ -50,6 +51,40 @@ public:
     using TOStreamConcurrentWrapper = core::CConcurrentWrapper<std::ostream>;
     using TGenericLineWriter = core::CRapidJsonLineWriter<rapidjson::StringBuffer>;
 
+    //! \brief
+    //! A Json line writer which is used on the thread which writes to the
+    //! stream.
+    //!
+    //! DESCRIPTION:\n
+    //! Each complete top level object is written straight to the stream.
+    class CORE_EXPORT CAsyncLineWriter final : public TGenericLineWriter {
+    public:
+        CAsyncLineWriter(CJsonOutputStreamWrapper& outStream, std::ostream& stream);
+
+        //! Hooks into end object to write the object to the stream if it
+        //! is complete.
+        //! Note: This is a non-virtual overwrite
+        bool EndObject(rapidjson::SizeType memberCount = 0);
+
+        //! Write JSON document to the stream
+        //! Note this non-virtual overwrite is needed to avoid slicing of the writer
+        //! and hence ensure the correct EndObject is called
+        //! \p doc reference to rapidjson document value
+        void write(rapidjson::Value& doc) { doc.Accept(*this); }
+
+    private:
+        //! The wrapper of the stream.
+        CJsonOutputStreamWrapper& m_OutputStreamWrapper;
+
+        //! The stream.
+        std::ostream& m_Stream;
+
+        //! The buffer for the current object.
+        rapidjson::StringBuffer m_StringBuffer;
+    };
+
+    using TAsyncWriteFunc = std::function<void(CAsyncLineWriter&)>;
+
 public:
     //! wrap a given ostream for concurrent access
     //! \param[in] outStream The stream to write to
@@ -76,6 +111,17 @@ public:
     //! a sync flush, that blocks until flush has actually happened
     void syncFlush();
 
+    //! Write JSON objects on the thread which writes to the stream.
+    //!
+    //! This moves the cost of serialising the objects off the calling
+    //! thread. The objects are written after everything which has been
+    //! flushed to the stream by any writer before this is called, so the
+    //! order of the output is the same as if they were written directly.
+    //!
+    //! \note \p write must only reference data which outlives the call,
+    //! typically by capturing shared pointers.
+    void writeAsync(const TAsyncWriteFunc& write);
+
     //! Debug the memory used by this component.
     void debugMemoryUsage(CMemoryUsage::TMemoryUsagePtr mem) const;
 
@@ -85,6 +131,10 @@ public:
 private:
     void returnAndCheckBuffer(rapidjson::StringBuffer* buffer);
 
+    //! Write \p buffer as the next element of the array of objects.
+    //! Note: must only be called on the thread which writes to the stream.
+    void writeElement(std::ostream& stream, const rapidjson::StringBuffer& buffer);
+
 private:
     //! the pool of buffers
     rapidjson::StringBuffer m_StringBuffers[BUFFER_POOL_SIZE];
@@ -7,12 +7,15 @@
 #ifndef INCLUDED_ml_model_CPatternSet_h
 #define INCLUDED_ml_model_CPatternSet_h
 
+#include <core/CAhoCorasickMatcher.h>
 #include <core/CFlatPrefixTree.h>
 #include <core/ImportExport.h>
 
 #include <string>
 #include <vector>
 
+#include <stdint.h>
+
 namespace ml {
 namespace core {
 
@@ -29,12 +32,15 @@ namespace core {
 //!
 //! IMPLEMENTATION DECISIONS:\n
 //! Upon building the set, patterns are categorised in the aforementioned 4
-//! categories. They are then stored in a corresponding prefix tree that allows
-//! efficient lookups. In particular a key is contained in the set if:
+//! categories. The full, prefix and suffix patterns are then stored in a
+//! corresponding prefix tree that allows efficient lookups. The contains
+//! patterns are compiled into an Aho-Corasick automaton so that checking
+//! them is a single pass over the key however many patterns there are.
+//! In particular a key is contained in the set if:
 //!   - its start matches a prefix pattern
 //!   - its end matched a suffix pattern
 //!   - it matches fully against a full pattern
-//!   - the start of any of its substrings ending at its end matches a contains pattern
+//!   - any of its substrings matches a contains pattern
 class CORE_EXPORT CPatternSet {
 public:
     using TStrVec = std::vector<std::string>;
@@ -54,9 +60,17 @@ public:
     //! Clears the set.
     void clear();
 
+    //! Get an identifier which is unique to the current contents of this
+    //! set, i.e. it changes whenever the set is updated and is never
+    //! shared with another set unless it is a copy of this one.
+    uint64_t uniqueId() const;
+
 private:
     void sortAndPruneDuplicates(TStrVec& keys);
 
+    //! Generate a new unique identifier.
+    void newUniqueId();
+
 private:
     //! The prefix tree containing full patterns (no wildcard).
     CFlatPrefixTree m_FullMatchPatterns;
@@ -68,8 +82,11 @@ private:
     //! (note that the suffixes are stored reverted).
     CFlatPrefixTree m_SuffixPatterns;
 
-    //! The prefix tree containing the contains patterns.
-    CFlatPrefixTree m_ContainsPatterns;
+    //! The automaton for the contains patterns.
+    CAhoCorasickMatcher m_ContainsPatterns;
+
+    //! The identifier of the current contents of the set.
+    uint64_t m_UniqueId;
 };
 }
 }
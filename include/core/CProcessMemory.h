@@ -0,0 +1,54 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_core_CProcessMemory_h
+#define INCLUDED_ml_core_CProcessMemory_h
+
+#include <core/CNonInstantiatable.h>
+#include <core/ImportExport.h>
+
+#include <cstddef>
+
+namespace ml {
+namespace core {
+
+//! \brief
+//! Functions related to the memory the operating system has given the process
+//!
+//! DESCRIPTION:\n
+//! The memory usage we account for is an estimate of what the models need.
+//! What the process actually holds can be much larger because the heap keeps
+//! memory which has been freed, for example after pruning models or after a
+//! background persist discards its copy of the models, in case the process
+//! asks for it again. On a heap which has become fragmented by millions of
+//! small model objects little of this is ever handed back to the operating
+//! system.
+//!
+//! These functions measure what the process holds and release the memory
+//! the heap is holding on to but no longer using.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! This is a static class - it's not possible to construct an instance of it.
+//!
+//! The basic implementation does nothing and can't measure the resident set
+//! size.  Currently the only platform-specific implementation is for Linux.
+//!
+class CORE_EXPORT CProcessMemory : private CNonInstantiatable {
+public:
+    //! Get the number of bytes of the process's memory which are resident
+    //! in RAM, or zero if this can't be determined on the current OS.
+    static std::size_t residentSetSize();
+
+    //! Return to the operating system whatever memory the heap holds which
+    //! isn't in use.
+    //!
+    //! \note This walks the whole heap, so it should only be called after
+    //! something has freed a lot of memory and not on every free.
+    static void releaseFreeMemory();
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CProcessMemory_h
@@ -131,6 +131,18 @@ public:
         }
     }
 
+    //! Push an allocator which is owned by the caller on to the stack
+    void pushAllocator(const TPoolAllocatorPtr& allocator) {
+        m_JsonPoolAllocators.push(allocator);
+    }
+
+    //! Remove the last pushed allocator from the stack without clearing it
+    void removeAllocator() {
+        if (!m_JsonPoolAllocators.empty()) {
+            m_JsonPoolAllocators.pop();
+        }
+    }
+
     //! Get a valid allocator from the stack
     //! If no valid allocator can be found then store and return a freshly minted one
     std::shared_ptr<CRapidJsonPoolAllocator> getAllocator() const {
@@ -38,6 +38,9 @@ public:
     //! Remove the value 1 from this stat
     void decrement();
 
+    //! Remove some value from this stat
+    void decrement(uint64_t value);
+
     //! Set the stat to this new value
     void set(uint64_t value);
 
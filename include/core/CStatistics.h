@@ -83,6 +83,18 @@ enum EStatTypes {
     //! The number of times partial memory estimates have been carried out
     E_NumberMemoryUsageEstimates,
 
+    //! The number of maintenance tasks, such as periodicity tests, deferred
+    //! in the last bucket because they were over budget
+    E_MaintenanceQueueDepth,
+
+    //! The number of lookups in the probability result caches of
+    //! individual models
+    E_NumberProbabilityCacheLookups,
+
+    //! The number of probability calculations which were found in the
+    //! probability result caches of individual models
+    E_NumberProbabilityCacheHits,
+
     // Add any new values here
 
     //! This MUST be last
@@ -106,11 +118,31 @@ class CStatePersistInserter;
 //! description to the ostream<< operator function in the implementation file
 //!
 //! IMPLEMENTATION DECISIONS:\n
-//! A singleton class: there should only be one collection of global stats
+//! There is one collection of statistics for the process, which is used by every
+//! thread which hasn't set another one.  When one process hosts many jobs, each
+//! job owns a collection of statistics and makes it the current collection, with
+//! CScopedContext, whilst it runs so the statistics, which are persisted with the
+//! job's state, only count that job's activity.
 //!
 class CORE_EXPORT CStatistics : private CNonCopyable {
 public:
-    //! Singleton pattern
+    //! \brief Makes a collection of statistics the current collection of the
+    //! calling thread for the lifetime of this object.
+    class CORE_EXPORT CScopedContext : private CNonCopyable {
+    public:
+        explicit CScopedContext(CStatistics& statistics);
+        ~CScopedContext();
+
+    private:
+        //! The collection which was current before this one.
+        CStatistics* m_Previous;
+    };
+
+public:
+    //! Create a collection of statistics, all zero, for one job.
+    CStatistics();
+
+    //! Get the current collection of statistics of the calling thread.
     static CStatistics& instance();
 
     //! Provide access to the relevant stat from the collection
@@ -118,10 +150,10 @@ public:
 
     //! \name Persistence
     //@{
-    //! Restore the static members of this class from persisted state
+    //! Restore the current collection of statistics from persisted state
     static bool staticsAcceptRestoreTraverser(CStateRestoreTraverser& traverser);
 
-    //! Persist the static members of this class
+    //! Persist the current collection of statistics
     static void staticsAcceptPersistInserter(CStatePersistInserter& inserter);
     //@}
 
@@ -129,10 +161,7 @@ private:
     using TStatArray = boost::array<CStat, stat_t::E_LastEnumStat>;
 
 private:
-    //! Constructor of a Singleton is private
-    CStatistics();
-
-    //! The unique instance.
+    //! The collection used by threads which haven't set one.
     static CStatistics ms_Instance;
 
     //! Collection of statistics
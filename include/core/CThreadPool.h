@@ -0,0 +1,72 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_core_CThreadPool_h
+#define INCLUDED_ml_core_CThreadPool_h
+
+#include <core/CNonCopyable.h>
+#include <core/ImportExport.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace ml {
+namespace core {
+
+//! \brief A fixed size pool of threads for running parallel loops.
+//!
+//! DESCRIPTION:\n
+//! Runs a function for each index in a range using a fixed set of
+//! threads, which are created once up front, and waits for all the
+//! calls to finish. This suits running many short parallel loops in
+//! succession, for which the cost of starting new threads for each
+//! loop would be significant.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The calling thread does its share of the work so the pool holds
+//! one fewer thread than the requested parallelism. A pool of size
+//! one runs everything on the calling thread.
+//!
+//! The indices are claimed one at a time so the work is load balanced
+//! even if the cost per index is very uneven.
+//!
+//! The worker threads are managed by boost::threadpool, which is not
+//! exposed in this header.
+class CORE_EXPORT CThreadPool : private CNonCopyable {
+public:
+    using TSizeFunc = std::function<void(std::size_t)>;
+
+public:
+    explicit CThreadPool(std::size_t numberThreads);
+    ~CThreadPool();
+
+    //! Get the number of threads, including the calling thread, which
+    //! run each loop.
+    std::size_t numberThreads() const;
+
+    //! Call \p f for each index in [0, \p n) and wait for all the calls
+    //! to finish. The order of the calls is unspecified.
+    //!
+    //! \warning \p f is called concurrently so it must be safe to call
+    //! it for distinct indices at the same time.
+    void parallelForEach(std::size_t n, const TSizeFunc& f);
+
+private:
+    class CWorkers;
+    using TWorkersUPtr = std::unique_ptr<CWorkers>;
+
+private:
+    //! The number of threads which run each loop.
+    std::size_t m_NumberThreads;
+
+    //! The worker threads.
+    TWorkersUPtr m_Workers;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CThreadPool_h
@@ -0,0 +1,165 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_ml_core_CTimeFormatParser_h
+#define INCLUDED_ml_core_CTimeFormatParser_h
+
+#include <core/CoreTypes.h>
+#include <core/ImportExport.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ml {
+namespace core {
+class CTimezone;
+
+//! \brief
+//! Converts date times in a fixed strptime format to epoch times.
+//!
+//! DESCRIPTION:\n
+//! Gives identical results to CTimeUtils::strptimeSilent for the format
+//! supplied to the constructor, but is much cheaper when converting many
+//! date times, for example the time field of every input record.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The format is compiled once into a sequence of tokens. Formats which
+//! only use the directives %Y, %m, %d, %H, %M, %S, %T, %F, %% and a
+//! trailing %z, or which are just %s, are parsed directly. This covers
+//! the ISO 8601 style formats. Any other format falls back to calling
+//! CTimeUtils::strptimeSilent, as do formats without a year since the
+//! year must then be guessed.
+//!
+//! The conversion from local time to UTC needs the timezone database
+//! which is expensive. Instead the UTC time of the start of the current
+//! hour is cached. Input times are usually ordered so this almost always
+//! hits and converting a date time then costs a few integer operations.
+//! The cache is filled by calling CTimeUtils::strptimeSilent for the
+//! first and last second of the hour, and isn't used for hours which
+//! contain a daylight saving transition, so results never differ from
+//! CTimeUtils::strptimeSilent. The cache is invalidated if the timezone
+//! is changed via CTimezone, which is detected by comparing its lock free
+//! generation count so that cache hits don't contend on its mutex.
+//!
+//! This class is not thread safe.
+//!
+class CORE_EXPORT CTimeFormatParser {
+public:
+    explicit CTimeFormatParser(const std::string& format);
+
+    //! Get the format.
+    const std::string& format() const;
+
+    //! Check if the format can be parsed directly.
+    bool isCompiled() const;
+
+    //! Convert \p dateTime to the UTC epoch time \p result.
+    //!
+    //! \note This doesn't log errors.
+    bool parse(const std::string& dateTime, core_t::TTime& result);
+
+private:
+    //! The different types of format token.
+    enum EToken {
+        E_Literal,
+        E_Space,
+        E_Year,
+        E_Month,
+        E_Day,
+        E_Hour,
+        E_Minute,
+        E_Second,
+        E_Offset,
+        E_Epoch
+    };
+
+    //! \brief A format token.
+    struct SToken {
+        EToken s_Type;
+        char s_Literal;
+    };
+
+    //! The indices of the fields in an SFields object's values.
+    enum EField {
+        E_YearField = 0,
+        E_MonthField,
+        E_DayField,
+        E_HourField,
+        E_OffsetField,
+        E_MinuteField,
+        E_SecondField,
+        E_NumberFields
+    };
+
+    //! \brief The values parsed from a date time.
+    //!
+    //! For the epoch format the hour field holds the number of whole
+    //! hours since the epoch and the second field the remainder.
+    struct SFields {
+        using TInt64Ary = std::array<std::int64_t, E_NumberFields>;
+
+        //! The number of fields identifying the hour.
+        static const std::size_t HOUR_KEY_SIZE = E_OffsetField + 1;
+
+        SFields();
+
+        //! Check if the fields are in the same hour as \p other.
+        bool sameHour(const SFields& other) const;
+
+        TInt64Ary s_Values;
+    };
+
+    using TTokenVec = std::vector<SToken>;
+
+private:
+    //! Compile the format into tokens, returning false if it can't be
+    //! parsed directly.
+    bool compile();
+
+    //! Parse \p dateTime into \p fields, returning false if it should
+    //! be handled by strptimeSilent.
+    bool parseFields(const char* dateTime, SFields& fields) const;
+
+    //! Write the date time in the format for \p fields.
+    std::string print(const SFields& fields) const;
+
+    //! Update the cached start of the hour of \p fields.
+    void updateCache(const SFields& fields);
+
+private:
+    //! The format.
+    std::string m_Format;
+
+    //! The compiled format.
+    TTokenVec m_Tokens;
+
+    //! True if the format was compiled.
+    bool m_Compiled;
+
+    //! The largest number of seconds after the start of the hour which
+    //! can be represented by the format.
+    core_t::TTime m_MaximumSecondOfHour;
+
+    //! The timezone singleton.
+    const CTimezone* m_Timezone;
+
+    //! The timezone generation for which the cache is valid.
+    std::uint64_t m_CachedTimezoneGeneration;
+
+    //! The fields of the last hour to be cached.
+    SFields m_CachedHour;
+
+    //! True if the cached hour has a constant offset from UTC.
+    bool m_CachedHourIsRegular;
+
+    //! The UTC time of the start of the cached hour.
+    core_t::TTime m_CachedHourStart;
+};
+}
+}
+
+#endif // INCLUDED_ml_core_CTimeFormatParser_h
@@ -13,6 +13,8 @@
 
 #include <boost/date_time/local_time/local_time.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #include <time.h>
@@ -73,6 +75,12 @@ public:
     //! in an OS dependent manner).
     bool timezoneName(const std::string& name);
 
+    //! Get a number which changes whenever the timezone is set.
+    //!
+    //! \note This doesn't lock so is cheap enough to check for every
+    //! date time parsed in order to validate cached conversions.
+    std::uint64_t generation() const;
+
     //! Convenience wrapper around the setter for timezone name
     static bool setTimezone(const std::string& timezone);
 
@@ -115,6 +123,9 @@ private:
     //! use the current operating system settings
     std::string m_Name;
 
+    //! Incremented whenever the timezone is set.
+    std::atomic<std::uint64_t> m_Generation{0};
+
 #ifdef Windows
     //! Boost timezone database
     boost::local_time::tz_database m_TimezoneDb;
@@ -10,11 +10,18 @@
 #include <core/CNonCopyable.h>
 #include <core/ImportExport.h>
 
-#include <boost/unordered_map.hpp>
-
-#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
 #include <string>
 
+namespace boost {
+namespace iostreams {
+class mapped_file_source;
+}
+}
+
 namespace ml {
 namespace core {
 
@@ -40,6 +47,22 @@ namespace core {
 //!
 //! All checks are case-insensitive.
 //!
+//! The words are looked up in a binary image of the dictionary which
+//! is a minimal perfect hash table of the words.  The image is in the
+//! host byte order, so it isn't checked in: the build compiles it from
+//! the text file with the compile_dictionary program in devbin and
+//! installs it alongside the text file.  It is memory mapped read only,
+//! so the operating system shares a single copy between all the
+//! processes using it and there is nothing to parse at startup.  If the
+//! image is missing or invalid, for example when cross compiling, it is
+//! compiled from the text file.
+//!
+//! The table uses the hash and displace scheme: words are first hashed
+//! into small buckets and then each bucket has a displacement, found
+//! when the image is compiled, which maps its words to distinct slots.
+//! A lookup is therefore a case-folding hash of the word, two table
+//! reads and a single comparison, and doesn't allocate.
+//!
 //! TODO - extend this to cope with different dictionaries for
 //! different languages.
 //!
@@ -131,26 +154,39 @@ public:
     //! aren't in the dictionary.
     EPartOfSpeech partOfSpeech(const std::string& str) const;
 
+    //! Write the binary image of the dictionary whose text is read from
+    //! \p text to \p image.  Returns false if this fails.
+    static bool compile(std::istream& text, std::ostream& image);
+
 private:
     //! Constructor for a singleton is private
     CWordDictionary();
     ~CWordDictionary();
 
-private:
-    class CStrHashIgnoreCase : std::unary_function<std::string, bool> {
-    public:
-        size_t operator()(const std::string& str) const;
-    };
+    //! Memory map the precompiled image in \p fileName.
+    bool mapImage(const std::string& fileName);
 
-    class CStrEqualIgnoreCase : std::binary_function<std::string, std::string, bool> {
-    public:
-        bool operator()(const std::string& lhs, const std::string& rhs) const;
-    };
+    //! Compile the dictionary text in \p fileName into memory.
+    bool compileText(const std::string& fileName);
+
+    //! Set up the lookup tables from the image at \p image which has
+    //! \p size bytes.  Returns false if the image is invalid.
+    bool attach(const char* image, std::size_t size);
+
+    //! Get the part of speech of the \p length character word \p word.
+    EPartOfSpeech lookup(const char* word, std::size_t length) const;
+
+private:
+    struct SSlot;
+    using TMappedFileSourceUPtr = std::unique_ptr<boost::iostreams::mapped_file_source>;
 
 private:
     //! Name of the file to load that contains the dictionary words.
     static const char* const DICTIONARY_FILE;
 
+    //! Name of the file containing the precompiled image of the dictionary.
+    static const char* const DICTIONARY_IMAGE_FILE;
+
     //! The constructor loads a file, and hence may take a while.  This
     //! mutex prevents the singleton object being constructed simultaneously
     //! in different threads.
@@ -162,15 +198,30 @@ private:
     //! its way into every thread).
     static volatile CWordDictionary* ms_Instance;
 
-    //! Stores the dictionary words - using a multi-index even though
-    //! there's only one index, because of its flexible key extractors.
-    //! The key is the string, but hashed and compared ignoring case.
-    using TStrUMap =
-        boost::unordered_map<std::string, EPartOfSpeech, CStrHashIgnoreCase, CStrEqualIgnoreCase>;
-    using TStrUMapCItr = TStrUMap::const_iterator;
+    //! The memory mapped precompiled image.
+    TMappedFileSourceUPtr m_MappedImage;
+
+    //! The image compiled from the text file if there's no precompiled
+    //! image.
+    std::string m_CompiledImage;
+
+    //! The number of words, which is also the number of slots.
+    std::uint32_t m_NumberWords;
+
+    //! The number of buckets.
+    std::uint32_t m_NumberBuckets;
+
+    //! The size of the pool of word characters.
+    std::uint32_t m_PoolSize;
+
+    //! The displacement of each bucket.
+    const std::uint32_t* m_Displacements;
+
+    //! The slots of the hash table.
+    const SSlot* m_Slots;
 
-    //! Our dictionary of words
-    TStrUMap m_DictionaryWords;
+    //! The characters of the words.
+    const char* m_Pool;
 };
 }
 }
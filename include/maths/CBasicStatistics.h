@@ -72,6 +72,36 @@ public:
     //! Compute the sample median.
     static double median(const TDoubleVec& data);
 
+    //! Compute the sample median reordering \p data in the process.
+    //!
+    //! \note Unlike median this doesn't copy \p data, so it doesn't
+    //! allocate, and it works for any random access container.
+    template<typename VECTOR>
+    static double medianInPlace(VECTOR& data) {
+        std::size_t size{data.size()};
+
+        // If sample size is even (1,2,3,4) then take mean of 2,3 = 2.5
+        // If sample size is odd (1,2,3,4,5) then take middle value = 3
+        bool useMean{size % 2 == 0};
+
+        // For an odd number of elements, this will get the median element
+        // into place. For an even number of elements, it will get the second
+        // element of the middle pair into place.
+        std::size_t index{size / 2};
+        std::nth_element(data.begin(), data.begin() + index, data.end());
+
+        if (useMean) {
+            // Since the nth element is the second of the two we need to
+            // average, the first element to be averaged will be the largest
+            // of all those before the nth one in the vector.
+            auto left = std::max_element(data.begin(), data.begin() + index);
+
+            return (*left + data[index]) / 2.0;
+        }
+
+        return data[index];
+    }
+
     //! Compute the median absolute deviation.
     static double mad(const TDoubleVec& data);
 
@@ -796,14 +826,8 @@ public:
             s_Mean = beta * mean + alpha * x;
 
             TVector r{x - s_Mean};
-            TMatrix r2{E_OuterProduct, r};
             TVector dMean{mean - s_Mean};
-            TMatrix dMean2{E_OuterProduct, dMean};
-
-            s_Covariances += dMean2;
-            scaleCovariances(beta, s_Covariances);
-            scaleCovariances(alpha, r2);
-            s_Covariances += r2;
+            updateCovariances(alpha, beta, r, dMean, s_Covariances);
         }
 
         //! Combine two moments. This is equivalent to running
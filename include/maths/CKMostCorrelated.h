@@ -49,6 +49,14 @@ namespace maths {
 //! components are the projected normalised residuals, finding the
 //! most correlated variables amounts to a collection neighbourhood
 //! searches around each point.
+//!
+//! For large numbers of variables the neighbourhood search uses locality
+//! sensitive hashing of the projected residuals: each of a number of bands
+//! hashes a point to the signs of its inner products with a collection of
+//! random vectors and only pairs of variables which collide in some band
+//! are evaluated. The number of bands and bits per band trade off the
+//! chance of finding the most correlated pairs against the number of
+//! candidate pairs evaluated, see setHashingParameters.
 class MATHS_EXPORT CKMostCorrelated {
 public:
     //! The number of projections of the data to maintain
@@ -70,6 +78,18 @@ public:
 public:
     CKMostCorrelated(std::size_t k, double decayRate, bool initialize = true);
 
+    //! Set the number of hash bands and bits per band used to generate
+    //! candidate pairs when searching many variables.
+    //!
+    //! More bands increases the chance of finding the most correlated
+    //! pairs and more bits per band reduces the number of uncorrelated
+    //! candidate pairs which need to be evaluated.
+    //!
+    //! \note \p bitsPerBand must be in the range [1, 32]. Zero bands
+    //! disables hashing.
+    //! \note These are persisted so are preserved by restoring.
+    void setHashingParameters(std::size_t bands, std::size_t bitsPerBand);
+
     //! Create from part of a state document.
     bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
 
@@ -120,6 +140,17 @@ protected:
     static const double MINIMUM_SPARSENESS;
     //! The proportion of values to replace for each projection.
     static const double REPLACE_FRACTION;
+    //! The minimum number of variables for which we search for the most
+    //! correlated pairs using locality sensitive hashing.
+    static const std::size_t MINIMUM_VARIABLES_TO_HASH;
+    //! The default number of hash bands.
+    static const std::size_t DEFAULT_HASH_BANDS;
+    //! The default number of bits per hash band.
+    static const std::size_t DEFAULT_HASH_BITS_PER_BAND;
+    //! The maximum number of variables following each variable in a hash
+    //! bucket with which it is paired. This bounds the cost of degenerate
+    //! buckets.
+    static const std::size_t MAXIMUM_BUCKET_NEIGHBOURS;
 
 protected:
     using TMeanVarAccumulator = CBasicStatistics::SSampleMeanVar<double>::TAccumulator;
@@ -224,6 +255,12 @@ private:
     //! The number of correlations to find.
     std::size_t m_K;
 
+    //! The number of hash bands to use when searching many variables.
+    std::size_t m_HashBands;
+
+    //! The number of bits per hash band to use when searching many variables.
+    std::size_t m_HashBitsPerBand;
+
     //! The rate at which to forget about historical correlations.
     double m_DecayRate;
 
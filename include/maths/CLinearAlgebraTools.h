@@ -669,6 +669,180 @@ void scaleCovariances(const CVectorNx1<T, N>& scale, CSymmetricMatrixNxN<T, N>&
     }
 }
 
+//! Efficiently update the sample covariance matrix \p m for a shift
+//! \p dMean in the sample mean and a new point at \p r from the updated
+//! mean, where the existing points have relative weights \p beta and
+//! the new point has relative weights \p alpha.
+//!
+//! This performs exactly the same floating point operations as
+//! \code{.cpp}
+//!   m += CSymmetricMatrixNxN<T, N>(E_OuterProduct, dMean);
+//!   scaleCovariances(beta, m);
+//!   CSymmetricMatrixNxN<T, N> r2(E_OuterProduct, r);
+//!   scaleCovariances(alpha, r2);
+//!   m += r2;
+//! \endcode
+//! but in a single pass over the lower triangle of \p m and without
+//! creating the outer product matrices.
+template<typename T, std::size_t N>
+void updateCovariances(const CVectorNx1<T, N>& alpha,
+                       const CVectorNx1<T, N>& beta,
+                       const CVectorNx1<T, N>& r,
+                       const CVectorNx1<T, N>& dMean,
+                       CSymmetricMatrixNxN<T, N>& m) {
+    T alpha_[N];
+    T beta_[N];
+    for (std::size_t i = 0u; i < N; ++i) {
+        alpha_[i] = std::sqrt(alpha(i));
+        beta_[i] = std::sqrt(beta(i));
+    }
+    for (std::size_t i = 0u; i < N; ++i) {
+        for (std::size_t j = 0u; j <= i; ++j) {
+            T mij{m(i, j)};
+            mij += T(dMean(i) * dMean(j));
+            mij *= beta_[j];
+            mij *= beta_[i];
+            T r2ij(r(i) * r(j));
+            r2ij *= alpha_[j];
+            r2ij *= alpha_[i];
+            mij += r2ij;
+            m(i, j) = mij;
+        }
+    }
+}
+
+//! \brief Cholesky factorization of a small symmetric positive definite
+//! matrix.
+//!
+//! DESCRIPTION:\n
+//! Computes the factorization \f$M = LL^t\f$ of a CSymmetricMatrixNxN
+//! and uses it to compute the inverse quadratic form, log-determinant
+//! and inverse of \f$M\f$.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The general purpose functions in this file use Jacobi SVD so that
+//! they handle matrices which are singular to working precision. This
+//! needs the matrix to be copied into an Eigen matrix and, for the small
+//! matrices we use in the multivariate priors, dominates the cost of an
+//! update. Almost all the matrices we see are comfortably positive
+//! definite, so this computes the factorization in place in packed lower
+//! triangular storage with loops whose bounds are known at compile time
+//! so the compiler can fully unroll and vectorize them.
+//!
+//! The factor and its inverse are used to bound the condition number of
+//! \f$M\f$. A matrix is only considered well conditioned if this bound
+//! is small enough that the SVD would find it has full rank, in which
+//! case the two only differ by rounding. If it isn't, callers should fall
+//! back to the SVD, which handles the singular subspace.
+template<std::size_t N>
+class CCholeskyNxN {
+public:
+    //! The maximum bound on the condition number of a well conditioned
+    //! matrix.
+    static constexpr double MAXIMUM_CONDITION = 1e12;
+
+public:
+    template<typename T>
+    explicit CCholeskyNxN(const CSymmetricMatrixNxN<T, N>& m)
+        : m_WellConditioned(false) {
+        double trace{0.0};
+        for (std::size_t i = 0u, i_ = 0u; i < N; ++i, i_ += i) {
+            for (std::size_t j = 0u, j_ = 0u; j <= i; ++j, j_ += j) {
+                double lij{m(i, j)};
+                for (std::size_t k = 0u; k < j; ++k) {
+                    lij -= m_L[i_ + k] * m_L[j_ + k];
+                }
+                if (i == j) {
+                    // This also fails for NaN.
+                    if (!(lij > 0.0)) {
+                        return;
+                    }
+                    trace += m(i, i);
+                    m_L[i_ + i] = std::sqrt(lij);
+                } else {
+                    m_L[i_ + j] = lij / m_L[j_ + j];
+                }
+            }
+        }
+
+        // Since ||M||_2 <= trace(M) and ||M^{-1}||_2 = ||L^{-1}||_2^2 <=
+        // ||L^{-1}||_F^2 their product bounds the condition number of M.
+        double norm{0.0};
+        for (std::size_t i = 0u, i_ = 0u; i < N; ++i, i_ += i) {
+            double lii{m_L[i_ + i]};
+            for (std::size_t j = 0u; j < i; ++j) {
+                double lij{0.0};
+                for (std::size_t k = j, k_ = j * (j + 1) / 2; k < i; ++k, k_ += k) {
+                    lij -= m_L[i_ + k] * m_LInverse[k_ + j];
+                }
+                m_LInverse[i_ + j] = lij / lii;
+                norm += m_LInverse[i_ + j] * m_LInverse[i_ + j];
+            }
+            m_LInverse[i_ + i] = 1.0 / lii;
+            norm += m_LInverse[i_ + i] * m_LInverse[i_ + i];
+        }
+        m_WellConditioned = trace * norm < MAXIMUM_CONDITION;
+    }
+
+    //! Check if the matrix is positive definite and well conditioned.
+    //!
+    //! \note The other functions must only be called if this is true.
+    bool wellConditioned() const { return m_WellConditioned; }
+
+    //! Compute \f$x^tM^{-1}x\f$.
+    template<typename T>
+    double inverseQuadraticForm(const CVectorNx1<T, N>& x) const {
+        // This is ||L^{-1}x||^2.
+        double result{0.0};
+        for (std::size_t i = 0u, i_ = 0u; i < N; ++i, i_ += i) {
+            double yi{0.0};
+            for (std::size_t j = 0u; j <= i; ++j) {
+                yi += m_LInverse[i_ + j] * x(j);
+            }
+            result += yi * yi;
+        }
+        return result;
+    }
+
+    //! Compute \f$\log(|M|)\f$.
+    double logDeterminant() const {
+        double result{0.0};
+        for (std::size_t i = 0u, i_ = 0u; i < N; ++i, i_ += i) {
+            result += std::log(m_L[i_ + i]);
+        }
+        return 2.0 * result;
+    }
+
+    //! Compute \f$M^{-1}\f$.
+    template<typename T>
+    void inverse(CSymmetricMatrixNxN<T, N>& result) const {
+        // This is L^{-t}L^{-1}.
+        for (std::size_t i = 0u; i < N; ++i) {
+            for (std::size_t j = 0u; j <= i; ++j) {
+                double rij{0.0};
+                for (std::size_t k = i, k_ = i * (i + 1) / 2; k < N; ++k, k_ += k) {
+                    rij += m_LInverse[k_ + i] * m_LInverse[k_ + j];
+                }
+                result(i, j) = rij;
+            }
+        }
+    }
+
+private:
+    using TDoubleAry = boost::array<double, N*(N + 1) / 2>;
+
+private:
+    //! True if the matrix is positive definite and well conditioned.
+    bool m_WellConditioned;
+    //! The packed lower triangle of the Cholesky factor L.
+    TDoubleAry m_L;
+    //! The packed lower triangle of L^{-1}.
+    TDoubleAry m_LInverse;
+};
+
+template<std::size_t N>
+constexpr double CCholeskyNxN<N>::MAXIMUM_CONDITION;
+
 //! Efficiently scale the \p i'th row and column by \p scale.
 template<typename T>
 void scaleCovariances(std::size_t i, T scale, CSymmetricMatrix<T>& m) {
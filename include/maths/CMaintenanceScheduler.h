@@ -0,0 +1,174 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_ml_maths_CMaintenanceScheduler_h
+#define INCLUDED_ml_maths_CMaintenanceScheduler_h
+
+#include <core/CFastMutex.h>
+#include <core/CNonCopyable.h>
+#include <core/CNonInstantiatable.h>
+#include <core/CoreTypes.h>
+
+#include <maths/ImportExport.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ml {
+namespace core {
+class CStatePersistInserter;
+class CStateRestoreTraverser;
+}
+namespace maths {
+
+//! \brief Staggers expensive per-series maintenance work over buckets.
+//!
+//! DESCRIPTION:\n
+//! Tests such as the periodicity and calendar cyclic tests in the time
+//! series decomposition become due at times which are derived from the
+//! bucket alignment of the series. For a job with many series they all
+//! become due in the same bucket and that bucket takes far longer to
+//! process than the others. This spreads the work in two ways:
+//!   -# If more than budget() tasks become due in a bucket the excess
+//!      are delayed by a jitter in whole buckets which is a deterministic
+//!      function of a key supplied by the series.
+//!   -# At most budget() tasks are run in any one bucket. Tasks which
+//!      are over budget are deferred to a later bucket, but never by
+//!      more than MAXIMUM_DEFERRAL buckets or one day.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The budget is a count of tasks rather than wall clock time so that
+//! which tasks run in which bucket only depends on the data and the
+//! order in which series are updated. Results are therefore reproducible.
+//!
+//! The state is held in a CContext. Each anomaly detector owns a context
+//! and makes it the current context, with CScopedContext, whilst it updates
+//! its models. So detectors' budgets are independent and which tasks run
+//! in which bucket doesn't depend on other detectors or jobs in the same
+//! process. The context is persisted with the detector, as are the times
+//! at which each series' tasks are scheduled, so restoring a job doesn't
+//! change when any task runs. Threads which haven't set a context use one
+//! which is shared by the whole process.
+//!
+//! The number of tasks deferred in the last complete bucket, i.e. the
+//! depth of the queue of outstanding work, is published as the statistic
+//! stat_t::E_MaintenanceQueueDepth. A job's statistics are shared by all
+//! its detectors, so each context adds the change in its own depth to
+//! the statistic, which is therefore the total over the job's detectors.
+class MATHS_EXPORT CMaintenanceScheduler : private core::CNonInstantiatable {
+public:
+    //! The time used to denote that no task is scheduled.
+    static const core_t::TTime NOT_SCHEDULED;
+    //! The default maximum number of tasks to run per bucket.
+    static const std::size_t DEFAULT_BUDGET;
+    //! The maximum number of buckets by which to jitter a task.
+    static const core_t::TTime MAXIMUM_JITTER;
+    //! The maximum interval over which to jitter a task.
+    static const core_t::TTime MAXIMUM_JITTER_INTERVAL;
+    //! The maximum number of buckets by which to defer a task which
+    //! is over budget.
+    static const core_t::TTime MAXIMUM_DEFERRAL;
+    //! The maximum interval by which to defer a task which is over
+    //! budget.
+    static const core_t::TTime MAXIMUM_DEFERRAL_INTERVAL;
+
+    //! \brief The scheduler state for one detector.
+    class MATHS_EXPORT CContext {
+    public:
+        CContext();
+        CContext(const CContext& other);
+        CContext& operator=(const CContext&) = delete;
+
+        //! Initialize by reading state from \p traverser.
+        bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
+
+        //! Persist state by passing information to \p inserter.
+        void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
+
+    private:
+        //! Protects the state.
+        mutable core::CFastMutex m_Lock;
+        //! The maximum number of tasks to run in any one bucket.
+        std::size_t m_Budget;
+        //! The start of the latest bucket for which a task was run.
+        core_t::TTime m_Bucket;
+        //! The number of tasks which became due in the latest bucket.
+        std::size_t m_Scheduled;
+        //! The number of tasks run in the latest bucket.
+        std::size_t m_Run;
+        //! The number of tasks deferred in the latest bucket.
+        std::size_t m_Deferred;
+        //! The number of tasks deferred in the last complete bucket.
+        std::size_t m_QueueDepth;
+
+        friend class CMaintenanceScheduler;
+    };
+
+    //! \brief Makes a context the current context of the calling thread
+    //! for the lifetime of this object.
+    class MATHS_EXPORT CScopedContext : private core::CNonCopyable {
+    public:
+        explicit CScopedContext(CContext& context);
+        ~CScopedContext();
+
+    private:
+        //! The context which was current before this one.
+        CContext* m_Previous;
+    };
+
+public:
+    //! Get the time at which to run a task which becomes due at \p time.
+    //!
+    //! This is \p time unless more than budget() tasks have already
+    //! become due in the same bucket in which case it is jittered.
+    //! \param[in] time The time the task becomes due.
+    //! \param[in] bucketLength The series' bucket length.
+    //! \param[in] key A key for the series which is used to jitter
+    //! the task's start time.
+    static core_t::TTime
+    schedule(core_t::TTime time, core_t::TTime bucketLength, std::uint64_t key);
+
+    //! Check whether to run the task scheduled for \p scheduled now.
+    //!
+    //! If the task should run then \p scheduled is reset to NOT_SCHEDULED.
+    //!
+    //! \param[in,out] scheduled The time the task is scheduled.
+    //! \param[in] time The current time.
+    //! \param[in] bucketLength The series' bucket length.
+    static bool run(core_t::TTime& scheduled, core_t::TTime time, core_t::TTime bucketLength);
+
+    //! Set the maximum number of tasks to run in any one bucket.
+    static void budget(std::size_t budget);
+
+    //! Get the maximum number of tasks to run in any one bucket.
+    static std::size_t budget();
+
+    //! Get the number of tasks deferred in the last complete bucket.
+    static std::size_t queueDepth();
+
+    //! Reset to the initial state.
+    static void reset();
+
+private:
+    //! Get the current context of the calling thread.
+    static CContext& context();
+
+    //! Roll \p context over to the bucket starting at \p bucket if it
+    //! is newer.
+    static void startBucket(CContext& context, core_t::TTime bucket);
+
+    //! Set the queue depth of \p context to \p depth and update the
+    //! statistic by the change.
+    static void publishQueueDepth(CContext& context, std::size_t depth);
+
+private:
+    //! The context used by threads which haven't set one.
+    static CContext ms_DefaultContext;
+};
+}
+}
+
+#endif // INCLUDED_ml_maths_CMaintenanceScheduler_h
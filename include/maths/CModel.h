@@ -18,6 +18,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace ml {
 namespace core {
@@ -253,6 +254,9 @@ struct MATHS_EXPORT SModelProbabilityResult {
     //! has the smallest probability in the current bucket (if and only
     //! if the result depends on the correlation structure).
     TSize1Vec s_MostAnomalousCorrelate;
+    //! True if the calculation started or extended an anomaly in the
+    //! anomaly model, so repeating it would update the model again.
+    bool s_AnomalyModelUpdated = false;
 };
 
 //! \brief The model interface.
@@ -271,7 +275,9 @@ struct MATHS_EXPORT SModelProbabilityResult {
 //! for univariate and multivariate time series.
 class MATHS_EXPORT CModel {
 public:
+    using TBoolVec = std::vector<bool>;
     using TBool2Vec = core::CSmallVector<bool, 2>;
+    using TBool2Vec1Vec = core::CSmallVector<TBool2Vec, 1>;
     using TDouble2Vec = core::CSmallVector<double, 2>;
     using TDouble10Vec = core::CSmallVector<double, 10>;
     using TDouble2Vec1Vec = core::CSmallVector<TDouble2Vec, 1>;
@@ -288,6 +294,7 @@ public:
     using TDouble2VecWeightsAry = maths_t::TDouble2VecWeightsAry;
     using TDouble2VecWeightsAry1Vec = maths_t::TDouble2VecWeightsAry1Vec;
     using TTail2Vec = core::CSmallVector<maths_t::ETail, 2>;
+    using TModelProbabilityResultVec = std::vector<SModelProbabilityResult>;
 
     //! Possible statuses for updating a model.
     enum EUpdateResult {
@@ -335,7 +342,7 @@ public:
 
     //! Update the model with new samples.
     virtual EUpdateResult addSamples(const CModelAddSamplesParams& params,
-                                     TTimeDouble2VecSizeTrVec samples) = 0;
+                                     const TTimeDouble2VecSizeTrVec& samples) = 0;
 
     //! Advance time by \p gap.
     virtual void skipTime(core_t::TTime gap) = 0;
@@ -388,6 +395,24 @@ public:
                              const TDouble2Vec1Vec& value,
                              SModelProbabilityResult& result) const = 0;
 
+    //! Compute the probabilities of drawing each of \p values at \p time.
+    //!
+    //! This is equivalent to calling probability for each value in turn
+    //! with the weights and bucket empty flags in \p params replaced by
+    //! the corresponding elements of \p weights and \p bucketEmpty, but
+    //! lets implementations share work between the values.
+    //!
+    //! \param[out] results Filled in with the probability of each value.
+    //! \param[out] successes Filled in with false for each value whose
+    //! probability couldn't be computed and true otherwise.
+    virtual void probabilities(const CModelProbabilityParams& params,
+                               const TTime2Vec1Vec& time,
+                               const TDouble2Vec1Vec& values,
+                               const TDouble2VecWeightsAry1Vec& weights,
+                               const TBool2Vec1Vec& bucketEmpty,
+                               TModelProbabilityResultVec& results,
+                               TBoolVec& successes) const;
+
     //! Get the Winsorisation weight to apply to \p value,
     //! if appropriate.
     virtual TDouble2Vec winsorisationWeight(double derate,
@@ -412,6 +437,14 @@ public:
     //! Get the type of data being modeled.
     virtual maths_t::EDataType dataType() const = 0;
 
+    //! Get the model which should replace this one, if any, passing
+    //! ownership to the caller.
+    //!
+    //! This is null unless this stands in for another model which has
+    //! now been created. Once this returns non-null the caller must not
+    //! use this model again.
+    virtual CModel* promote();
+
     //! Get read only model parameters.
     const CModelParams& params() const;
 
@@ -488,7 +521,7 @@ public:
 
     //! No-op.
     virtual EUpdateResult addSamples(const CModelAddSamplesParams& params,
-                                     TTimeDouble2VecSizeTrVec samples);
+                                     const TTimeDouble2VecSizeTrVec& samples);
 
     //! No-op.
     virtual void skipTime(core_t::TTime gap);
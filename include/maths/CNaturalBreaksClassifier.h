@@ -184,7 +184,7 @@ public:
     //! \note This finds the optimum partition using a dynamic
     //! programming approach in complexity \f$O(N^2n)\f$ where
     //! \f$N\f$ the number of tuples and \f$n\f$ is the desired
-    //! size for the partition.
+    //! size for the partition. The 2-split is \f$O(N)\f$.
     bool categories(std::size_t n, std::size_t p, TTupleVec& result, bool append = false);
 
     //! Get the categories corresponding to \p split.
@@ -251,7 +251,9 @@ public:
     //! \note This finds the optimum partition using a dynamic
     //! programming approach in complexity \f$O(N^2n)\f$ where
     //! \f$N\f$ the number of tuples and \f$n\f$ is the desired
-    //! size for the partition.
+    //! size for the partition. The 2-split is \f$O(N)\f$ and the
+    //! variation objective, whose optimal breaks are monotonic,
+    //! is \f$O(nN\log(N))\f$.
     static bool naturalBreaks(const TTupleVec& categories,
                               std::size_t n,
                               std::size_t p,
@@ -43,6 +43,16 @@ namespace maths {
 //! the first bit in the vector and can deduce all other values by the
 //! number of runs in between. In practice we store one extra bit, the
 //! vector parity to allow us to extend the vector efficiently.
+//!
+//! If the runs are short, i.e. the vector is dense in bit flips, the
+//! run length encoding is both larger and slower to scan than simply
+//! packing the bits into 64 bit words. In this case the vector switches
+//! to a packed representation for which the inner products reduce to
+//! a population count of the bitwise and, or and exclusive or of the
+//! words. The representation is chosen based on the average run length,
+//! with some hysteresis, and is invisible to the caller. In particular,
+//! the persisted state, equality, ordering and checksum are all defined
+//! in terms of the run length encoding.
 class MATHS_EXPORT CPackedBitVector
     : private boost::equality_comparable<CPackedBitVector, boost::partially_ordered<CPackedBitVector>> {
 public:
@@ -56,6 +66,12 @@ public:
     explicit CPackedBitVector(bool bit);
     CPackedBitVector(std::size_t dimension, bool bit);
     CPackedBitVector(const TBoolVec& bits);
+    CPackedBitVector(const CPackedBitVector& other);
+    CPackedBitVector(CPackedBitVector&& other) noexcept;
+    ~CPackedBitVector();
+
+    CPackedBitVector& operator=(const CPackedBitVector& other);
+    CPackedBitVector& operator=(CPackedBitVector&& other) noexcept;
 
     //! Contract the vector by popping a component from the start.
     void contract();
@@ -108,17 +124,51 @@ public:
     //! Get the memory used by this object.
     std::size_t memoryUsage() const;
 
+    //! Check if the vector is currently stored as packed words.
+    bool packed() const;
+
 private:
     using TUInt8Vec = std::vector<uint8_t>;
+    using TUInt64Vec = std::vector<uint64_t>;
 
 private:
     //! The maximum permitted run length. Longer runs are encoded
     //! by stringing together a number of maximum length runs.
     static const uint8_t MAX_RUN_LENGTH;
 
+    //! The minimum dimension for which we'll use the packed
+    //! representation.
+    static const std::size_t MINIMUM_PACKED_DIMENSION;
+
+private:
+    //! Get the run length encoding of the vector.
+    void runLengths(bool& first, bool& parity, TUInt8Vec& runLengths) const;
+
+    //! Count the number of ones in the packed vector in [\p a, \p b).
+    std::size_t countOnes(std::size_t a, std::size_t b) const;
+
+    //! Compute the inner product of a packed and a run length encoded
+    //! vector.
+    double mixedInner(const CPackedBitVector& covector, EOperation op) const;
+
+    //! Choose the cheaper of the packed and run length representations.
+    void adapt();
+
+    //! Switch to the packed representation.
+    void pack();
+
+    //! Switch to the run length encoded representation.
+    void unpack();
+
+    //! Make \p words the storage of the packed representation.
+    void packedStorage(TUInt64Vec&& words);
+
+    //! Make \p runLengths the storage of the run length representation.
+    void runLengthStorage(TUInt8Vec&& runLengths);
+
 private:
     // Note that the bools are 1 byte aligned so the following
-    // three variables will be packed into the 64 bits.
+    // four variables will be packed into the 64 bits.
 
     //! The dimension of the vector.
     uint32_t m_Dimension;
@@ -131,9 +181,23 @@ private:
     //! with m_First this determines the value of the last component.
     bool m_Parity;
 
-    //! The length of each run. Note that if the length of a run
-    //! exceeds 255 then this is encoded in multiple run lengths.
-    TUInt8Vec m_RunLengths;
+    //! True if the vector is stored in m_Words and false if it is
+    //! stored in m_RunLengths. If the vector is packed m_First and
+    //! m_Parity are not used.
+    bool m_Packed;
+
+    //! Only one representation is stored at a time so they share storage,
+    //! which keeps sparse vectors as small as they were before the packed
+    //! representation was added. m_Packed identifies the active member.
+    union {
+        //! The length of each run. Note that if the length of a run
+        //! exceeds 255 then this is encoded in multiple run lengths.
+        TUInt8Vec m_RunLengths;
+
+        //! The bits of the vector packed into words, least significant
+        //! bit first. Any bits beyond the dimension are zero.
+        TUInt64Vec m_Words;
+    };
 };
 
 //! Output for debug.
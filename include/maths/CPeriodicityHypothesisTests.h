@@ -201,6 +201,9 @@ private:
         STestStats();
         //! Set the various test thresholds.
         void setThresholds(double vt, double at, double Rt);
+        //! Check if the test statistics were computed for buckets with
+        //! at least one measurement.
+        bool populated() const;
         //! Check if the null hypothesis is good enough to not need an
         //! alternative.
         bool nullHypothesisGoodEnough() const;
@@ -347,6 +350,10 @@ private:
                                                           std::size_t period) const;
 
     //! Compute various ancillary statistics for testing.
+    //!
+    //! \note Every test in a collection of nested hypotheses uses the
+    //! same buckets so these are computed once by the null hypothesis,
+    //! which is always tested first, and shared by the alternatives.
     bool testStatisticsFor(const TFloatMeanAccumulatorCRng& buckets, STestStats& stats) const;
 
     //! Get the variance and degrees freedom for the null hypothesis
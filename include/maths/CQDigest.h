@@ -7,6 +7,7 @@
 #ifndef INCLUDED_ml_maths_CQDigest_h
 #define INCLUDED_ml_maths_CQDigest_h
 
+#include <core/CMemoryUsage.h>
 #include <core/CNonCopyable.h>
 
 #include <maths/ImportExport.h>
@@ -192,6 +193,12 @@ public:
     //! Get a checksum of this object.
     uint64_t checksum(uint64_t seed) const;
 
+    //! Debug the memory used by this object.
+    void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+    //! Get the memory used by this object.
+    std::size_t memoryUsage() const;
+
     //! \name Test Methods
     //@{
     //! Check the digest invariants.
@@ -300,6 +307,9 @@ private:
         //! Create from an XML node tree.
         bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
 
+        //! Get the memory used by this node's descendants collection.
+        std::size_t memoryUsage() const;
+
         //! Check the node invariants in the q-digest rooted at this node.
         bool checkInvariants(uint64_t compressionFactor) const;
 
@@ -367,8 +377,18 @@ private:
     };
 
     //! Manages the creation and recycling of nodes.
+    //!
+    //! Nodes are allocated in blocks. The first block is small and
+    //! subsequent blocks grow geometrically up to \p size nodes, so
+    //! digests which only ever hold a few nodes, which is typical of
+    //! those used for normalization, don't pay for the maximum.
     class MATHS_EXPORT CNodeAllocator {
     public:
+        //! The size of the first block.
+        static const std::size_t MINIMUM_BLOCK_SIZE;
+
+    public:
+        //! \param[in] size The maximum number of nodes in a block.
         CNodeAllocator(std::size_t size);
 
         //! Create a new node.
@@ -377,6 +397,9 @@ private:
         //! Recycle \p node.
         void release(CNode& node);
 
+        //! Get the memory used by the allocator.
+        std::size_t memoryUsage() const;
+
     private:
         using TNodePtrVecVec = std::vector<TNodePtrVec>;
         using TNodeVec = std::vector<CNode>;
@@ -390,11 +413,16 @@ private:
         std::size_t findBlock(const CNode& node) const;
 
     private:
+        //! The maximum number of nodes in a block.
+        std::size_t m_MaximumBlockSize;
         TNodeVecList m_Nodes;
         TNodePtrVecVec m_FreeNodes;
     };
 
 private:
+    //! Recycle all the nodes in the q-digest.
+    void releaseNodes();
+
     //! Compress the q-digest bottom up in level order.
     void compress();
 
@@ -33,6 +33,14 @@ namespace maths {
 //!
 //! DEFINITION:\n
 //! This is a place holder for random sampling utilities and algorithms.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The functions which don't take a generator use the random number
+//! generator of the current CContext. Threads which haven't set one use
+//! a context shared by the whole process. When one process hosts many
+//! jobs each job owns a context and makes it current, with CScopedContext,
+//! whilst it runs, so the generator state which is persisted with a job
+//! only depends on that job's data.
 class MATHS_EXPORT CSampling : private core::CNonInstantiatable {
 public:
     using TDoubleVec = std::vector<double>;
@@ -110,16 +118,45 @@ public:
         ~CScopeMockRandomNumberGenerator();
     };
 
+    //! \brief The random number generator state for one job.
+    class MATHS_EXPORT CContext : private core::CNonCopyable {
+    private:
+        //! The mutex for protecting access to the random number generator.
+        core::CFastMutex m_Lock;
+
+        //! The uniform random number generator.
+        CRandomNumberGenerator m_Rng;
+
+        friend class CSampling;
+        friend class CScopeMockRandomNumberGenerator;
+    };
+
+    //! \brief Makes a context the current context of the calling thread
+    //! for the lifetime of this object.
+    class MATHS_EXPORT CScopedContext : private core::CNonCopyable {
+    public:
+        explicit CScopedContext(CContext& context);
+        ~CScopedContext();
+
+    private:
+        //! The context which was current before this one.
+        CContext* m_Previous;
+    };
+
 public:
     //! \name Persistence
     //@{
-    //! Restore the static members of this class from persisted state
+    //! Restore the current context's random number generator from
+    //! persisted state
     static bool staticsAcceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
 
-    //! Persist the static members of this class
+    //! Persist the current context's random number generator
     static void staticsAcceptPersistInserter(core::CStatePersistInserter& inserter);
     //@}
 
+    //! Get the current context of the calling thread.
+    static CContext& context();
+
     //! Reinitialize the random number generator.
     static void seed();
 
@@ -376,8 +413,9 @@ public:
     //! internal random number generator to provide a random distribution.
     template<typename ITR>
     static void random_shuffle(ITR first, ITR last) {
-        core::CScopedFastLock scopedLock(ms_Lock);
-        random_shuffle(ms_Rng, first, last);
+        CContext& context_ = context();
+        core::CScopedFastLock scopedLock(context_.m_Lock);
+        random_shuffle(context_.m_Rng, first, last);
     }
 
     //! Optimal (in a sense to be defined below) weighted sampling
@@ -422,11 +460,8 @@ private:
     };
 
 private:
-    //! The mutex for protecting access to the random number generator.
-    static core::CFastMutex ms_Lock;
-
-    //! The uniform random number generator.
-    static CRandomNumberGenerator ms_Rng;
+    //! The context used by threads which haven't set one.
+    static CContext ms_DefaultContext;
 };
 }
 }
@@ -16,6 +16,7 @@
 #include <maths/ImportExport.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -137,6 +138,13 @@ private:
     using TSeasonalTimePtr = std::unique_ptr<CSeasonalTime>;
 
     //! \brief The state maintained for each bucket.
+    //!
+    //! IMPLEMENTATION DECISIONS:\n
+    //! There is one of these for every bucket of every seasonal component
+    //! of every time series so we store the last update time as a 32 bit
+    //! offset from the first update time. This is exact for any interval
+    //! shorter than 68 years and, with the members in this order, means
+    //! the struct has no padding.
     struct SBucket {
         SBucket();
         SBucket(const TRegression& regression,
@@ -147,12 +155,18 @@ private:
         bool acceptRestoreTraverser(core::CStateRestoreTraverser& traverser);
         void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
 
+        //! Get the time of the last update.
+        core_t::TTime lastUpdate() const;
+
+        //! Set the times of the first and last updates.
+        void updateTimes(core_t::TTime firstUpdate, core_t::TTime lastUpdate);
+
         uint64_t checksum(uint64_t seed) const;
 
         TRegression s_Regression;
         CFloatStorage s_Variance;
+        std::int32_t s_LastUpdateOffset;
         core_t::TTime s_FirstUpdate;
-        core_t::TTime s_LastUpdate;
     };
     using TBucketVec = std::vector<SBucket>;
 
@@ -7,12 +7,14 @@
 #ifndef INCLUDED_ml_maths_CSignal_h
 #define INCLUDED_ml_maths_CSignal_h
 
+#include <core/CFastMutex.h>
 #include <core/CVectorRange.h>
 
 #include <maths/CBasicStatistics.h>
 #include <maths/ImportExport.h>
 
 #include <complex>
+#include <memory>
 #include <vector>
 
 namespace ml {
@@ -22,13 +24,123 @@ namespace maths {
 class MATHS_EXPORT CSignal {
 public:
     using TDoubleVec = std::vector<double>;
+    using TSizeVec = std::vector<std::size_t>;
     using TComplex = std::complex<double>;
     using TComplexVec = std::vector<TComplex>;
     using TFloatMeanAccumulator = CBasicStatistics::SSampleMean<CFloatStorage>::TAccumulator;
     using TFloatMeanAccumulatorVec = std::vector<TFloatMeanAccumulator>;
     using TFloatMeanAccumulatorCRng = core::CVectorRange<const TFloatMeanAccumulatorVec>;
 
+    //! \brief A plan for computing DFTs of a fixed length.
+    //!
+    //! DESCRIPTION:\n
+    //! This caches everything about the transform which depends only on the
+    //! length, i.e. the input permutation, the twiddle factors and, for lengths
+    //! with large prime factors, the chirp and transformed kernel used by
+    //! Bluestein's algorithm. Repeated transforms of the same length therefore
+    //! don't need to evaluate any trigonometric functions.
+    //!
+    //! A plan for length n can also transform real sequences of length 2n by
+    //! packing the even and odd terms into the real and imaginary parts of a
+    //! complex sequence of length n.
+    //!
+    //! IMPLEMENTATION:\n
+    //! Lengths whose prime factors are all at most MAXIMUM_RADIX use a mixed
+    //! radix decimation in time. The input is permuted into digit reversed
+    //! order, which generalises the bit reversal permutation of radix 2, and
+    //! then the butterflies are applied in place level by level over contiguous
+    //! blocks. Radix 2 and 4 butterflies are specialised. Other lengths use
+    //! Bluestein's trick to reformulate the transform as a convolution which
+    //! is computed with a power of 2 plan.
+    //!
+    //! A plan is immutable once constructed so can be shared between threads.
+    class MATHS_EXPORT CFftPlan {
+    public:
+        //! The largest prime factor for which we use a mixed radix transform.
+        static const std::size_t MAXIMUM_RADIX;
+
+    public:
+        explicit CFftPlan(std::size_t n);
+
+        CFftPlan(const CFftPlan&) = delete;
+        CFftPlan& operator=(const CFftPlan&) = delete;
+
+        //! Get the length of the complex sequences this transforms.
+        std::size_t size() const;
+
+        //! Compute the DFT of \p f in-place.
+        //!
+        //! \note \p f must have length size().
+        void fft(TComplexVec& f) const;
+
+        //! Compute the inverse DFT of \p f in-place.
+        //!
+        //! \note \p f must have length size().
+        void ifft(TComplexVec& f) const;
+
+        //! Compute the DFT of the real sequence \p x.
+        //!
+        //! Since the DFT of a real sequence is conjugate symmetric only the
+        //! coefficients 0, 1, ..., size() are computed.
+        //!
+        //! \note \p x must have length 2 * size().
+        void fft(const TDoubleVec& x, TComplexVec& f) const;
+
+        //! Compute the real sequence whose DFT has coefficients \p f.
+        //!
+        //! This is the inverse of the real fft, i.e. \p f should hold the
+        //! coefficients 0, 1, ..., size() of a conjugate symmetric DFT.
+        void ifft(const TComplexVec& f, TDoubleVec& x) const;
+
+    private:
+        using TFftPlanUPtr = std::unique_ptr<CFftPlan>;
+
+    private:
+        //! Fill in the input permutation for the mixed radix transform.
+        void permutation(std::size_t in,
+                         std::size_t out,
+                         std::size_t stride,
+                         std::size_t level);
+
+        //! Permute \p f into digit reversed order in-place.
+        void permute(TComplexVec& f) const;
+
+        //! Apply the mixed radix butterflies to \p f which must have been
+        //! permuted into digit reversed order.
+        void butterflies(TComplexVec& f) const;
+
+        //! Compute the transform using Bluestein's trick.
+        void bluestein(TComplexVec& f) const;
+
+    private:
+        //! The transform length.
+        std::size_t m_Size;
+        //! The radix at each level of the mixed radix transform.
+        TSizeVec m_Radixes;
+        //! The digit reversal permutation of the input.
+        TSizeVec m_Permutation;
+        //! The smallest index in each cycle of the permutation. These let
+        //! us permute in-place so the plan needs no scratch space.
+        TSizeVec m_Cycles;
+        //! The twiddle factors \f$e^{-2\pi i k / n}\f$.
+        TComplexVec m_Twiddles;
+        //! The twiddle factors \f$e^{-\pi i k / n}\f$ for real transforms.
+        TComplexVec m_RealTwiddles;
+        //! The chirp \f$e^{\pi i k^2 / n}\f$ for Bluestein's algorithm.
+        TComplexVec m_Chirp;
+        //! The DFT of the chirp convolution kernel for Bluestein's algorithm.
+        TComplexVec m_Kernel;
+        //! The power of 2 plan for the convolution for Bluestein's algorithm.
+        TFftPlanUPtr m_Convolution;
+    };
+    using TFftPlanCPtr = std::shared_ptr<const CFftPlan>;
+
 public:
+    //! Get a plan to compute DFTs of length \p n.
+    //!
+    //! \note Plans are cached for the most recently used lengths.
+    static TFftPlanCPtr fftPlan(std::size_t n);
+
     //! Compute the conjugate of \p f.
     static void conj(TComplexVec& f);
 
@@ -37,16 +149,28 @@ public:
 
     //! Cooley-Tukey fast DFT transform implementation.
     //!
-    //! \note This is a simple implementation radix 2 DIT which uses the chirp-z
-    //! idea to handle the case that the length of \p fx is not a power of 2. As
-    //! such it is definitely not a highly optimized FFT implementation. It should
-    //! be sufficiently fast for our needs.
+    //! \note This uses a cached plan for the length of \p f, see CFftPlan for
+    //! details.
     static void fft(TComplexVec& f);
 
     //! This uses conjugate of the conjugate of the series is the inverse DFT trick
     //! to compute this using fft.
     static void ifft(TComplexVec& f);
 
+    //! Compute the DFT of the real sequence \p x.
+    //!
+    //! \param[in] x The sequence to transform.
+    //! \param[out] f Filled in with the DFT coefficients 0, 1, ..., n/2 where
+    //! n is the length of \p x.
+    //!
+    //! \note If the length of \p x is even this uses a complex transform of
+    //! half the length.
+    static void fft(const TDoubleVec& x, TComplexVec& f);
+
+    //! Compute the real sequence of length \p n whose DFT coefficients
+    //! 0, 1, ..., n/2 are \p f.
+    static void ifft(const TComplexVec& f, std::size_t n, TDoubleVec& x);
+
     //! Compute the discrete cyclic autocorrelation of \p values for the offset
     //! \p offset.
     //!
@@ -71,6 +195,18 @@ public:
     //! \param[in] result Filled in with the autocorrelations of \p values for
     //! offsets 1, 2, ..., length \p values - 1.
     static void autocorrelations(const TFloatMeanAccumulatorVec& values, TDoubleVec& result);
+
+private:
+    using TSizeFftPlanCPtrPr = std::pair<std::size_t, TFftPlanCPtr>;
+    using TSizeFftPlanCPtrPrVec = std::vector<TSizeFftPlanCPtrPr>;
+
+private:
+    //! The maximum number of plans to cache.
+    static const std::size_t MAXIMUM_CACHED_PLANS;
+    //! Protects the plan cache.
+    static core::CFastMutex ms_PlansMutex;
+    //! The cached plans in order of most recent use.
+    static TSizeFftPlanCPtrPrVec ms_Plans;
 };
 }
 }
@@ -246,7 +246,7 @@ public:
         void apply(std::size_t symbol, const SMessage& message);
 
         //! Check if we should run the periodicity test on \p window.
-        bool shouldTest(ETest test, core_t::TTime time) const;
+        bool shouldTest(ETest test, core_t::TTime time);
 
         //! Get a new \p test. (Warning: this is owned by the caller.)
         CExpandingWindow* newWindow(ETest test, bool deflate = true) const;
@@ -267,6 +267,12 @@ public:
 
         //! Expanding windows on the "recent" time series values.
         TExpandingWindowPtrAry m_Windows;
+
+        //! The times at which the next scheduled tests will run.
+        TTimeAry m_ScheduledTests;
+
+        //! The buckets in which the scheduled tests last became due.
+        TTimeAry m_LastDueBuckets;
     };
 
     //! \brief Tests for cyclic calendar components explaining large prediction
@@ -332,9 +338,15 @@ public:
         //! Controls the rate at which information is lost.
         double m_DecayRate;
 
+        //! The raw data bucketing interval.
+        core_t::TTime m_BucketLength;
+
         //! The last month for which the test was run.
         int m_LastMonth;
 
+        //! The time at which the next test will run.
+        core_t::TTime m_ScheduledTest;
+
         //! The test for arbitrary periodic components.
         TCalendarCyclicTestPtr m_Test;
     };
@@ -111,7 +111,7 @@ public:
 
     //! Update the model with new samples.
     virtual EUpdateResult addSamples(const CModelAddSamplesParams& params,
-                                     TTimeDouble2VecSizeTrVec samples);
+                                     const TTimeDouble2VecSizeTrVec& samples);
 
     //! Advance time by \p gap.
     virtual void skipTime(core_t::TTime gap);
@@ -160,6 +160,17 @@ public:
                              const TDouble2Vec1Vec& value,
                              SModelProbabilityResult& result) const;
 
+    //! Compute the probabilities of drawing each of \p values at \p time.
+    //!
+    //! The trend is only computed once for all the values.
+    virtual void probabilities(const CModelProbabilityParams& params,
+                               const TTime2Vec1Vec& time,
+                               const TDouble2Vec1Vec& values,
+                               const TDouble2VecWeightsAry1Vec& weights,
+                               const TBool2Vec1Vec& bucketEmpty,
+                               TModelProbabilityResultVec& results,
+                               TBoolVec& successes) const;
+
     //! Get the Winsorisation weight to apply to \p value.
     virtual TDouble2Vec
     winsorisationWeight(double derate, core_t::TTime time, const TDouble2Vec& value) const;
@@ -320,6 +331,235 @@ private:
 
     //! Models the correlations between time series.
     CTimeSeriesCorrelations* m_Correlations;
+
+    friend class CNewbornTimeSeriesModel;
+};
+
+//! \brief A lightweight stand in for a new univariate time series model.
+//!
+//! DESCRIPTION:\n
+//! Most of the time series in a job with many partition, by or over field
+//! values only ever see a handful of values. Until a CUnivariateTimeSeriesModel
+//! has seen enough data its residual model is non-informative and nearly all
+//! its answers are trivial, but it still has a full trend decomposition, one
+//! of n prior and anomaly model.
+//!
+//! This shares one immutable template for all its time series and records
+//! the updates it receives. Whilst the full model would still be trivial it
+//! answers the hot queries, i.e. the Winsorisation and seasonal weights and
+//! the probabilities, directly. As soon as the full model would have seen
+//! too much data, or a query which needs the full model is made, it creates
+//! it by cloning the template and replaying the updates. The full model is
+//! then identical to one which had been updated all along. Owners should
+//! call promote() after adding samples and replace this by the full model
+//! if one is returned.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! The template residual model must be non-informative until it has seen
+//! more than MAXIMUM_COUNT values, as CGammaRateConjugate and so COneOfNPrior
+//! are, and its multi-bucket feature, if it has one, must be empty for the
+//! first MAXIMUM_NUMBER_UPDATES updates. The template must not model
+//! correlations. It is up to the creator of this model to check this.
+//!
+//! This is always persisted as the full model so state is unchanged and
+//! models always restore as a CUnivariateTimeSeriesModel.
+class MATHS_EXPORT CNewbornTimeSeriesModel : public CModel {
+public:
+    using TUnivariateTimeSeriesModelCPtr = std::shared_ptr<const CUnivariateTimeSeriesModel>;
+
+public:
+    //! The maximum number of updates before the full model is created.
+    static const std::size_t MAXIMUM_NUMBER_UPDATES;
+
+    //! The maximum count of values before the full model is created.
+    static const double MAXIMUM_COUNT;
+
+public:
+    //! \param[in] model The template for the full model.
+    //! \param[in] id The identifier for the time series.
+    CNewbornTimeSeriesModel(const TUnivariateTimeSeriesModelCPtr& model, std::size_t id);
+
+    const CNewbornTimeSeriesModel& operator=(const CNewbornTimeSeriesModel&) = delete;
+
+    //! Get the model identifier.
+    virtual std::size_t identifier() const;
+
+    //! Create a copy of this model passing ownership to the caller.
+    virtual CModel* clone(std::size_t id) const;
+
+    //! Create a copy of the state we need to persist passing ownership
+    //! to the caller.
+    virtual CModel* cloneForPersistence() const;
+
+    //! Create a copy of the state we need to run forecasting.
+    virtual CModel* cloneForForecast() const;
+
+    //! Returns false because the residual model is non-informative.
+    virtual bool isForecastPossible() const;
+
+    //! Tell this to model correlations.
+    virtual void modelCorrelations(CTimeSeriesCorrelations& model);
+
+    //! Returns empty because the template doesn't model correlations.
+    virtual TSize2Vec1Vec correlates() const;
+
+    //! Update the model with the bucket \p value.
+    virtual void addBucketValue(const TTimeDouble2VecSizeTrVec& value);
+
+    //! Update the model with new samples.
+    virtual EUpdateResult addSamples(const CModelAddSamplesParams& params,
+                                     const TTimeDouble2VecSizeTrVec& samples);
+
+    //! Advance time by \p gap.
+    virtual void skipTime(core_t::TTime gap);
+
+    //! Get the most likely value for the time series at \p time.
+    virtual TDouble2Vec mode(core_t::TTime time, const TDouble2VecWeightsAry& weights) const;
+
+    //! Returns empty because the template doesn't model correlations.
+    virtual TDouble2Vec1Vec
+    correlateModes(core_t::TTime time, const TDouble2VecWeightsAry1Vec& weights) const;
+
+    //! Get the local maxima of the residual distribution.
+    virtual TDouble2Vec1Vec residualModes(const TDouble2VecWeightsAry& weights) const;
+
+    //! Remove any trend components from \p value.
+    virtual void detrend(const TTime2Vec1Vec& time,
+                         double confidenceInterval,
+                         TDouble2Vec1Vec& value) const;
+
+    //! Get the best (least MSE) predicted value at \p time.
+    virtual TDouble2Vec predict(core_t::TTime time,
+                                const TSizeDoublePr1Vec& correlated = TSizeDoublePr1Vec(),
+                                TDouble2Vec hint = TDouble2Vec()) const;
+
+    //! Get the prediction and \p confidenceInterval percentage
+    //! confidence interval for the time series at \p time.
+    virtual TDouble2Vec3Vec confidenceInterval(core_t::TTime time,
+                                               double confidenceInterval,
+                                               const TDouble2VecWeightsAry& weights) const;
+
+    //! Forecast the time series and get its \p confidenceInterval
+    //! percentage confidence interval between \p startTime and
+    //! \p endTime.
+    virtual bool forecast(core_t::TTime startTime,
+                          core_t::TTime endTime,
+                          double confidenceInterval,
+                          const TDouble2Vec& minimum,
+                          const TDouble2Vec& maximum,
+                          const TForecastPushDatapointFunc& forecastPushDataPointFunc,
+                          std::string& messageOut);
+
+    //! Compute the probability of drawing \p value at \p time.
+    virtual bool probability(const CModelProbabilityParams& params,
+                             const TTime2Vec1Vec& time,
+                             const TDouble2Vec1Vec& value,
+                             SModelProbabilityResult& result) const;
+
+    //! Get the Winsorisation weight to apply to \p value.
+    virtual TDouble2Vec
+    winsorisationWeight(double derate, core_t::TTime time, const TDouble2Vec& value) const;
+
+    //! Get the seasonal variance scale at \p time.
+    virtual TDouble2Vec seasonalWeight(double confidence, core_t::TTime time) const;
+
+    //! Compute a checksum for this object.
+    //!
+    //! This is the checksum of the full model.
+    virtual uint64_t checksum(uint64_t seed = 0) const;
+
+    //! Debug the memory used by this object.
+    virtual void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+    //! Get the memory used by this object.
+    virtual std::size_t memoryUsage() const;
+
+    //! Persist the full model by passing information to \p inserter.
+    virtual void acceptPersistInserter(core::CStatePersistInserter& inserter) const;
+
+    //! Get the type of data being modeled.
+    virtual maths_t::EDataType dataType() const;
+
+    //! Get the full model if it has been created passing ownership to
+    //! the caller.
+    virtual CModel* promote();
+
+    //! Check if the full model has been created.
+    bool isPromoted() const;
+
+    //! Get the full model creating it if necessary.
+    const CUnivariateTimeSeriesModel& fullModel() const;
+
+private:
+    using TDoubleWeightsAry = maths_t::TDoubleWeightsAry;
+    using TUnivariateTimeSeriesModelPtr = std::unique_ptr<CUnivariateTimeSeriesModel>;
+
+    //! The maximum number of updates which are recorded.
+    static const std::size_t MAXIMUM_NUMBER_RECORDED_UPDATES;
+
+    //! \brief A value passed to one of the update functions.
+    struct SValue {
+        SValue(core_t::TTime time,
+               double value,
+               std::size_t tag,
+               const TDoubleWeightsAry& trendWeight,
+               const TDoubleWeightsAry& priorWeight);
+
+        core_t::TTime s_Time;
+        double s_Value;
+        std::size_t s_Tag;
+        TDoubleWeightsAry s_TrendWeight;
+        TDoubleWeightsAry s_PriorWeight;
+    };
+    using TValueVec = std::vector<SValue>;
+
+    //! \brief One call to an update function.
+    struct SUpdate {
+        //! The update functions.
+        enum EType { E_AddBucketValue, E_AddSamples, E_SkipTime };
+
+        explicit SUpdate(EType type);
+
+        //! Get the memory used by this update.
+        std::size_t memoryUsage() const;
+
+        EType s_Type;
+        maths_t::EDataType s_DataType;
+        bool s_IsNonNegative;
+        double s_PropagationInterval;
+        core_t::TTime s_Gap;
+        TValueVec s_Values;
+    };
+    using TUpdateVec = std::vector<SUpdate>;
+
+private:
+    CNewbornTimeSeriesModel(const CNewbornTimeSeriesModel& other, std::size_t id);
+
+    //! Create the full model from the template and the updates so far.
+    CUnivariateTimeSeriesModel* replay() const;
+
+    //! Get the full model creating it if necessary.
+    CUnivariateTimeSeriesModel& full() const;
+
+private:
+    //! The identifier for this time series.
+    std::size_t m_Id;
+
+    //! The template for the full model which is shared by all clones.
+    TUnivariateTimeSeriesModelCPtr m_Template;
+
+    //! The updates so far. These are discarded once the full model
+    //! has been created.
+    mutable TUpdateVec m_Updates;
+
+    //! The number of updates which added samples.
+    std::size_t m_NumberUpdates;
+
+    //! The count of the values added to the residual model.
+    double m_Count;
+
+    //! The full model, once it has been created.
+    mutable TUnivariateTimeSeriesModelPtr m_Full;
 };
 
 //! \brief Manages the creation correlate models.
@@ -590,7 +830,7 @@ public:
 
     //! Update the model with new samples.
     virtual EUpdateResult addSamples(const CModelAddSamplesParams& params,
-                                     TTimeDouble2VecSizeTrVec samples);
+                                     const TTimeDouble2VecSizeTrVec& samples);
 
     //! Advance time by \p gap.
     virtual void skipTime(core_t::TTime gap);
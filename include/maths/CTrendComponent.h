@@ -48,6 +48,7 @@ public:
     using TDoubleVec = std::vector<double>;
     using TDoubleVecVec = std::vector<TDoubleVec>;
     using TDouble3Vec = core::CSmallVector<double, 3>;
+    using TDouble8Vec = core::CSmallVector<double, 8>;
     using TDouble3VecVec = std::vector<TDouble3Vec>;
     using TVector = CVectorNx1<double, 3>;
     using TVectorVec = std::vector<TVector>;
@@ -211,7 +212,10 @@ private:
 
 private:
     //! Get the factors by which to age the different regression models.
-    TDoubleVec factors(core_t::TTime interval) const;
+    //!
+    //! \note This is called for every value added so the result has room
+    //! for the factors of all the models without allocating.
+    TDouble8Vec factors(core_t::TTime interval) const;
 
     //! Get the initial weights to use for forecast predictions.
     TDoubleVec initialForecastModelWeights() const;
@@ -10,6 +10,8 @@
 #include <core/CSmallVector.h>
 #include <core/CoreTypes.h>
 
+#include <maths/CMaintenanceScheduler.h>
+
 #include <model/CAnomalyDetectorModel.h>
 #include <model/CAnomalyDetectorModelConfig.h>
 #include <model/CEventData.h>
@@ -75,6 +77,8 @@ public:
     using TModelPtr = std::unique_ptr<CAnomalyDetectorModel>;
     using TOutputModelPlotDataFunc =
         std::function<void(const std::string&, const std::string&, const std::string&, const std::string&, const CModelPlotData&)>;
+    using TOutputModelPlotRowFunc =
+        std::function<void(const CModelPlotData&, const CModelPlotData::SRow&)>;
     using TStrSet = CAnomalyDetectorModelConfig::TStrSet;
 
 public:
@@ -225,6 +229,19 @@ public:
                            const TStrSet& terms,
                            TModelPlotDataVec& modelPlots) const;
 
+    //! Generate the model plot rows for the time series identified by
+    //! \p terms and pass each one to \p output together with the time,
+    //! detector and partition they belong to.
+    //!
+    //! \note The rows are not retained, so unlike the overload which
+    //! fills in CModelPlotData objects memory doesn't grow with the
+    //! number of time series.
+    void generateModelPlot(core_t::TTime bucketStartTime,
+                           core_t::TTime bucketEndTime,
+                           double boundsPercentile,
+                           const TStrSet& terms,
+                           const TOutputModelPlotRowFunc& output) const;
+
     //! Generate ForecastPrerequistes, e.g. memory requirements
     CForecastDataSink::SForecastModelPrerequisites getForecastPrerequisites() const;
 
@@ -352,6 +369,10 @@ private:
     // The model of the data in which we are detecting anomalies.
     TModelPtr m_Model;
 
+    //! Staggers the model maintenance tasks, such as periodicity tests,
+    //! which become due in the same bucket.
+    maths::CMaintenanceScheduler::CContext m_SchedulerContext;
+
     //! Is this a cloned detector containing the bare minimum information
     //! necessary to create a valid persisted state?
     bool m_IsForPersistence;
@@ -18,6 +18,7 @@
 #include <model/CMemoryUsageEstimator.h>
 #include <model/CModelParams.h>
 #include <model/CPartitioningFields.h>
+#include <model/CRuleScope.h>
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
 
@@ -493,6 +494,13 @@ public:
     //! Get the descriptions of any occurring scheduled event descriptions for the bucket time
     virtual const TStr1Vec& scheduledEventDescriptions(core_t::TTime time) const;
 
+    //! Get the memoised filter lookups of the rule scopes for this model.
+    CRuleScope::CCache& ruleScopeCache() const;
+
+    //! Clear the memoised filter lookups of the rule scopes, for example
+    //! because the filters have been updated.
+    void clearRuleScopeCache();
+
 protected:
     using TStrCRef = boost::reference_wrapper<const std::string>;
     using TSizeSize1VecUMap = boost::unordered_map<std::size_t, TSize1Vec>;
@@ -720,6 +728,10 @@ private:
     //! The influence calculators to use for each feature which is being
     //! modeled.
     TFeatureInfluenceCalculatorCPtrPrVecVec m_InfluenceCalculators;
+
+    //! The memoised filter lookups of the rule scopes. (This is not
+    //! persisted.)
+    mutable CRuleScope::CCache m_RuleScopeCache;
 };
 }
 }
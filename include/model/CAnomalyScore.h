@@ -8,6 +8,7 @@
 #define INCLUDED_ml_model_CAnomalyScore_h
 
 #include <core/CCompressedDictionary.h>
+#include <core/CMemoryUsage.h>
 #include <core/CoreTypes.h>
 
 #include <maths/CBasicStatistics.h>
@@ -52,6 +53,8 @@ public:
     using TOptionalDouble = boost::optional<double>;
     using TOptionalDoubleVec = std::vector<TOptionalDouble>;
     using TStrVec = std::vector<std::string>;
+    using TStrCRef = std::reference_wrapper<const std::string>;
+    using TStrCRefVec = std::vector<TStrCRef>;
 
     //! Attributes for a persisted normalizer
     static const std::string MLCUE_ATTRIBUTE;
@@ -133,6 +136,24 @@ public:
                        const std::string& personName,
                        const std::string& personValue) const;
 
+        //! Normalize each of the pre-aggregated \p scores.
+        //!
+        //! This is equivalent to normalizing each score in turn, but
+        //! the terms which only depend on the quantile summaries are
+        //! computed once for all the scores.
+        //!
+        //! \param[in,out] scores The raw scores to normalize. Filled
+        //! in with the normalized scores.
+        //! \param[in] partitionName The name of a partition attribute.
+        //! \param[in] partitionValues The partition of each score.
+        //! \param[in] personName The name of the person field attribute.
+        //! \param[in] personValues The person of each score.
+        bool normalizeEach(TDoubleVec& scores,
+                           const std::string& partitionName,
+                           const TStrCRefVec& partitionValues,
+                           const std::string& personName,
+                           const TStrCRefVec& personValues) const;
+
         //! Estimate the quantile range including the \p score.
         //!
         //! \param[in] score The score to estimate.
@@ -187,6 +208,12 @@ public:
         //! Get a checksum of the object.
         uint64_t checksum() const;
 
+        //! Debug the memory used by this object.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
     private:
         using TDoubleDoublePr = std::pair<double, double>;
         using TDoubleDoublePrVec = std::vector<TDoubleDoublePr>;
@@ -221,7 +248,29 @@ public:
         //! big change when updating the quantiles.
         static const double BIG_CHANGE_FACTOR;
 
+        //! \brief The terms of the noise ceiling on the normalized
+        //! score which only depend on the quantile summary.
+        struct SNoiseCeiling {
+            //! The noise percentile raw discrete score.
+            uint32_t s_NoiseScore;
+            //! The normalized score of the noise percentile.
+            double s_NoiseNormalizedScore;
+            //! The offset to apply if the noise percentile is zero.
+            double s_Offset;
+        };
+
     private:
+        //! Compute the noise ceiling terms from the quantile summary.
+        SNoiseCeiling noiseCeiling() const;
+
+        //! Normalize the non-zero \p score given the \p noiseCeiling.
+        void normalize(const SNoiseCeiling& noiseCeiling,
+                       double& score,
+                       const std::string& partitionName,
+                       const std::string& partitionValue,
+                       const std::string& personName,
+                       const std::string& personValue) const;
+
         //! Compute the discrete score from a raw score.
         uint32_t discreteScore(double rawScore) const;
 
@@ -100,6 +100,29 @@ public:
         this->push(item);
     }
 
+    //! Moves the time forward by bucket length reusing the earliest
+    //! item in the queue as the latest item. This avoids creating and
+    //! copying a new item, but the caller must reset the latest item.
+    //! If the \p time is earlier than the latest bucket end, this is
+    //! ignored and returns false.
+    //!
+    //! \param[in] time The time to which the latest item corresponds.
+    bool recycle(core_t::TTime time) {
+        if (time <= m_LatestBucketEnd) {
+            LOG_ERROR(<< "Recycle was called with early time = " << time
+                      << ", latest bucket end time = " << m_LatestBucketEnd);
+            return false;
+        }
+        m_LatestBucketEnd += m_BucketLength;
+        if (m_Queue.full()) {
+            // This is constant time for a full buffer.
+            m_Queue.rotate(m_Queue.end() - 1);
+        } else {
+            m_Queue.push_front(T());
+        }
+        return true;
+    }
+
     //! Pushes an item to the queue. This is only intended to be used
     //! internally and from clients that perform restoration of the queue.
     void push(const T& item) {
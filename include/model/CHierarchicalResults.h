@@ -17,13 +17,17 @@
 #include <model/ImportExport.h>
 #include <model/ModelTypes.h>
 
+#include <boost/iterator/iterator_facade.hpp>
 #include <boost/optional.hpp>
 #include <boost/ref.hpp>
 
+#include <array>
 #include <cstddef>
-#include <deque>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class CHierarchicalResultsTest;
@@ -219,6 +223,140 @@ struct MODEL_EXPORT SNode {
 MODEL_EXPORT
 void swap(SNode& node1, SNode& node2);
 
+//! \brief Block storage for the nodes of the hierarchical results.
+//!
+//! DESCRIPTION:\n
+//! The nodes are created in fixed size blocks of raw memory. This means
+//! their addresses are stable, as the tree requires, and the nodes which
+//! are created one after another, i.e. the leaves and then each layer of
+//! aggregate nodes, are contiguous in memory so visiting the tree bottom
+//! up or top down breadth first reads memory in order.
+//!
+//! Clearing the store destroys the nodes but keeps the blocks. So an
+//! object which is reused for every bucket only allocates for the nodes
+//! when a bucket has more results than any it has seen before, and the
+//! nodes of a bucket are released all at once.
+//!
+//! IMPLEMENTATION DECISIONS:\n
+//! This only implements the parts of the std::deque interface which we
+//! need. In particular, nodes can only be erased from the back.
+class MODEL_EXPORT CNodeStore {
+private:
+    //! The number of nodes in a block.
+    static const std::size_t BLOCK_SIZE = 64;
+
+    using TNodeStorage = std::aligned_storage<sizeof(SNode), alignof(SNode)>::type;
+    using TNodeStorageAry = std::array<TNodeStorage, BLOCK_SIZE>;
+    using TNodeStorageAryPtr = std::unique_ptr<TNodeStorageAry>;
+    using TNodeStorageAryPtrVec = std::vector<TNodeStorageAryPtr>;
+
+    //! \brief A random access iterator over the nodes.
+    template<typename NODE, typename STORE>
+    class CIterator : public boost::iterator_facade<CIterator<NODE, STORE>,
+                                                    NODE,
+                                                    std::random_access_iterator_tag> {
+    public:
+        CIterator() : m_Store(nullptr), m_Index(0) {}
+        CIterator(STORE* store, std::size_t index)
+            : m_Store(store), m_Index(index) {}
+
+        //! Allow conversion from a non-const to a const iterator.
+        template<typename OTHER_NODE, typename OTHER_STORE>
+        CIterator(const CIterator<OTHER_NODE, OTHER_STORE>& other)
+            : m_Store(other.m_Store), m_Index(other.m_Index) {}
+
+    private:
+        NODE& dereference() const { return (*m_Store)[m_Index]; }
+        template<typename OTHER_NODE, typename OTHER_STORE>
+        bool equal(const CIterator<OTHER_NODE, OTHER_STORE>& other) const {
+            return m_Index == other.m_Index;
+        }
+        void increment() { ++m_Index; }
+        void decrement() { --m_Index; }
+        void advance(std::ptrdiff_t n) { m_Index += n; }
+        template<typename OTHER_NODE, typename OTHER_STORE>
+        std::ptrdiff_t distance_to(const CIterator<OTHER_NODE, OTHER_STORE>& other) const {
+            return static_cast<std::ptrdiff_t>(other.m_Index) -
+                   static_cast<std::ptrdiff_t>(m_Index);
+        }
+
+    private:
+        STORE* m_Store;
+        std::size_t m_Index;
+
+        friend class boost::iterator_core_access;
+        template<typename, typename>
+        friend class CIterator;
+    };
+
+public:
+    using iterator = CIterator<SNode, CNodeStore>;
+    using const_iterator = CIterator<const SNode, const CNodeStore>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+public:
+    CNodeStore();
+    CNodeStore(const CNodeStore& other);
+    CNodeStore(CNodeStore&& other);
+    ~CNodeStore();
+
+    CNodeStore& operator=(const CNodeStore& other);
+    CNodeStore& operator=(CNodeStore&& other);
+
+    iterator begin() { return {this, 0}; }
+    iterator end() { return {this, m_Size}; }
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, m_Size}; }
+    reverse_iterator rbegin() { return reverse_iterator(this->end()); }
+    reverse_iterator rend() { return reverse_iterator(this->begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(this->end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(this->begin());
+    }
+
+    SNode& operator[](std::size_t i) {
+        return reinterpret_cast<SNode&>((*m_Blocks[i / BLOCK_SIZE])[i % BLOCK_SIZE]);
+    }
+    const SNode& operator[](std::size_t i) const {
+        return reinterpret_cast<const SNode&>((*m_Blocks[i / BLOCK_SIZE])[i % BLOCK_SIZE]);
+    }
+    SNode& front() { return (*this)[0]; }
+    const SNode& front() const { return (*this)[0]; }
+    SNode& back() { return (*this)[m_Size - 1]; }
+    const SNode& back() const { return (*this)[m_Size - 1]; }
+
+    std::size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+
+    //! Create a new node at the back of the store.
+    template<typename... ARGS>
+    SNode& emplace_back(ARGS&&... args) {
+        if (m_Size == m_Blocks.size() * BLOCK_SIZE) {
+            m_Blocks.emplace_back(new TNodeStorageAry);
+        }
+        SNode* result{new (&(*m_Blocks[m_Size / BLOCK_SIZE])[m_Size % BLOCK_SIZE])
+                          SNode(std::forward<ARGS>(args)...)};
+        ++m_Size;
+        return *result;
+    }
+
+    //! Remove the nodes from \p first to the back of the store.
+    void erase(iterator first);
+
+    //! Remove all the nodes, but keep the memory for reuse.
+    void clear();
+
+private:
+    //! The blocks of node storage.
+    TNodeStorageAryPtrVec m_Blocks;
+
+    //! The number of nodes.
+    std::size_t m_Size;
+};
+
 } // hierarchical_results_detail::
 
 class CHierarchicalResultsVisitor;
@@ -264,7 +402,7 @@ public:
     using TNode = hierarchical_results_detail::SNode;
     using TNodePtrSizeUMap = hierarchical_results_detail::SNode::TNodePtrSizeUMap;
     using TSizeNodePtrUMap = hierarchical_results_detail::SNode::TSizeNodePtrUMap;
-    using TNodeDeque = std::deque<TNode>;
+    using TNodeStore = hierarchical_results_detail::CNodeStore;
     using TStoredStringPtrStoredStringPtrPrNodeMap =
         std::map<TStoredStringPtrStoredStringPtrPr, TNode, maths::COrderings::SLexicographicalCompare>;
     using TStoredStringPtrNodeMap =
@@ -375,6 +513,10 @@ public:
     //! simple count result.
     std::size_t resultCount() const;
 
+    //! Remove all the results, but keep the memory allocated for
+    //! the nodes so it can be reused.
+    void clear();
+
     //! Sets the result to be interm
     void setInterim();
 
@@ -408,7 +550,7 @@ private:
 
 private:
     //! Storage for the nodes.
-    TNodeDeque m_Nodes;
+    TNodeStore m_Nodes;
 
     //! Storage for the pivot nodes.
     TStoredStringPtrStoredStringPtrPrNodeMap m_PivotNodes;
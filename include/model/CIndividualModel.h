@@ -14,6 +14,7 @@
 
 #include <model/CAnomalyDetectorModel.h>
 #include <model/CMemoryUsageEstimator.h>
+#include <model/CModelTools.h>
 #include <model/ImportExport.h>
 
 #include <boost/unordered_set.hpp>
@@ -246,8 +247,19 @@ protected:
     const maths::CModel* model(model_t::EFeature feature, std::size_t pid) const;
 
     //! Get a writable model corresponding to \p feature of the person \p pid.
+    //!
+    //! \note This invalidates any cached probability for the model.
     maths::CModel* model(model_t::EFeature feature, std::size_t pid);
 
+    //! Replace the model corresponding to \p feature of the person \p pid
+    //! by its full model if it was newborn and has been promoted.
+    //!
+    //! \note This invalidates any pointer to the model.
+    void promoteModel(model_t::EFeature feature, std::size_t pid);
+
+    //! Get the cache of the results of probability calculations.
+    CModelTools::CProbabilityResultCache& probabilityResultCache() const;
+
     //! Sample the correlate models.
     void sampleCorrelateModels();
 
@@ -310,6 +322,10 @@ private:
 
     //! The memory estimator.
     mutable CMemoryUsageEstimator m_MemoryEstimator;
+
+    //! The cached results of probability calculations for the person
+    //! models which haven't been updated since they were calculated.
+    mutable CModelTools::CProbabilityResultCache m_ProbabilityResults;
 };
 }
 }
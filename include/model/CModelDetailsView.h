@@ -60,23 +60,49 @@ public:
                    const TStrSet& terms,
                    CModelPlotData& modelPlotData) const;
 
+    //! Generate the same model plot rows as the overload which fills in
+    //! a CModelPlotData object, but pass each one to \p output as soon as
+    //! it is available.
+    //!
+    //! \note Only the model bounds for the feature being processed are
+    //! held in memory.
+    void modelPlot(core_t::TTime time,
+                   double boundsPercentile,
+                   const TStrSet& terms,
+                   const CModelPlotData::TRowFunc& output) const;
+
     //! Get the feature prior for the specified by field \p byFieldId.
     virtual const maths::CModel* model(model_t::EFeature feature,
                                        std::size_t byFieldId) const = 0;
 
 private:
-    //! Add the model plot data for all by field values which match \p terms.
+    //! \brief The model bounds for a single by field value.
+    struct SByFieldBounds {
+        //! True if the bounds have been computed.
+        bool s_Valid = false;
+        //! True if a row with an actual value has been output.
+        bool s_HasActual = false;
+        double s_LowerBound = 0.0;
+        double s_UpperBound = 0.0;
+        double s_Median = 0.0;
+    };
+    using TByFieldBoundsVec = std::vector<SByFieldBounds>;
+
+private:
+    //! Output a row for each current bucket value whose by field value
+    //! matches \p terms.
     void addCurrentBucketValues(core_t::TTime time,
                                 model_t::EFeature feature,
                                 const TStrSet& terms,
-                                CModelPlotData& modelPlotData) const;
+                                TByFieldBoundsVec& bounds,
+                                const CModelPlotData::TRowFunc& output) const;
 
-    //! Get the model plot data for the specified by field value.
+    //! Get the model bounds for the specified by field value.
     void modelPlotForByFieldId(core_t::TTime,
                                double boundsPercentile,
                                model_t::EFeature feature,
                                std::size_t byFieldId,
-                               CModelPlotData& modelPlotData) const;
+                               SByFieldBounds& bounds) const;
 
     //! Get the underlying model.
     virtual const CAnomalyDetectorModel& base() const = 0;
@@ -95,6 +121,8 @@ private:
     std::size_t maxByFieldId() const;
     //! Try to get the by field identifier corresponding to \p byFieldValue.
     bool byFieldId(const std::string& byFieldValue, std::size_t& result) const;
+    //! Get the by field identifier corresponding to (\p pid, \p cid).
+    std::size_t byFieldId(std::size_t pid, std::size_t cid) const;
     //! Get the by field value corresponding to \p byFieldId.
     const std::string& byFieldValue(std::size_t byFieldId) const;
     //! Get the by field corresponding to (\p pid, \p cid).
@@ -13,6 +13,7 @@
 
 #include <boost/unordered_map.hpp>
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -46,6 +47,28 @@ public:
         TStrDoublePrVec s_ValuesPerOverField;
     };
 
+    //! \brief A single row of model plot data.
+    //!
+    //! DESCRIPTION:\n
+    //! This references the field values rather than copying them so rows
+    //! can be passed on as they are generated without allocating. They
+    //! are only valid for the duration of the call they are passed to.
+    struct MODEL_EXPORT SRow {
+        //! The feature.
+        model_t::EFeature s_Feature;
+        //! The by field value.
+        const std::string* s_ByFieldValue;
+        double s_LowerBound;
+        double s_UpperBound;
+        double s_Median;
+        //! The over field value of the actual value or null if the
+        //! row only has the model bounds.
+        const std::string* s_OverFieldValue;
+        //! The actual value of the current bucket.
+        double s_Actual;
+    };
+    using TRowFunc = std::function<void(const SRow&)>;
+
 public:
     using TStrByFieldDataUMap = boost::unordered_map<std::string, SByFieldData>;
     using TFeatureStrByFieldDataUMapPr = std::pair<model_t::EFeature, TStrByFieldDataUMap>;
@@ -68,6 +91,10 @@ public:
     TFeatureStrByFieldDataUMapUMapCItr begin() const;
     TFeatureStrByFieldDataUMapUMapCItr end() const;
     SByFieldData& get(const model_t::EFeature& feature, const std::string& byFieldValue);
+    //! Add \p row to the data.
+    void addRow(const SRow& row);
+    //! Call \p f for each row of the data.
+    void forEachRow(const TRowFunc& f) const;
     const std::string& partitionFieldName() const;
     const std::string& partitionFieldValue() const;
     const std::string& overFieldName() const;
@@ -280,6 +280,130 @@ public:
         //! The univariate probability cache.
         TFeatureSizePrProbabilityCacheUMap m_Caches;
     };
+
+    //! \brief A cache of the exact results of probability calculations for
+    //! models which haven't changed since the calculation.
+    //!
+    //! DESCRIPTION:\n
+    //! Individual models often compute the probability of the same value
+    //! with an unchanged model, for example for each interim result in a
+    //! bucket or for series whose value is constant. This remembers the
+    //! last result for each feature and model and returns it if the model
+    //! is asked for the probability of the same value again. The caller
+    //! must invalidate a model's results whenever it updates the model.
+    //!
+    //! IMPLEMENTATION DECISIONS:\n
+    //! The result of an uncorrelated univariate calculation only depends
+    //! on time through the trend, so we key on the detrended as well as
+    //! the actual value and results can be reused in later buckets.
+    //!
+    //! The anomaly model is updated by a probability calculation whose
+    //! result is significant. We only cache results which are too large
+    //! to be significant so using the cache has no side effects.
+    //!
+    //! Only the probability and tail of a result are cached, which is all
+    //! CProbabilityAndInfluenceCalculator uses for individual models.
+    //!
+    //! Lookups and hits are counted in the program statistics.
+    class MODEL_EXPORT CProbabilityResultCache {
+    public:
+        //! Clear the cache.
+        void clear();
+
+        //! Remove any result for the model of \p feature and \p id.
+        void invalidate(model_t::EFeature feature, std::size_t id);
+
+        //! Add the result of a probability calculation.
+        //!
+        //! \param[in] id The unique model identifier.
+        //! \param[in] params The parameters of the calculation.
+        //! \param[in] value The value.
+        //! \param[in] detrended The detrended value.
+        //! \param[in] result The result of the model probability calculation.
+        void add(model_t::EFeature feature,
+                 std::size_t id,
+                 const maths::CModelProbabilityParams& params,
+                 const TDouble2Vec1Vec& value,
+                 const TDouble2Vec1Vec& detrended,
+                 const maths::SModelProbabilityResult& result);
+
+        //! Try to lookup the result of a probability calculation.
+        //!
+        //! \param[in] id The unique model identifier.
+        //! \param[in] params The parameters of the calculation.
+        //! \param[in] value The value.
+        //! \param[in] detrended The detrended value.
+        //! \param[out] result Filled in with the cached result if there
+        //! is one.
+        //! \return True if there is a cached result and false otherwise.
+        bool lookup(model_t::EFeature feature,
+                    std::size_t id,
+                    const maths::CModelProbabilityParams& params,
+                    const TDouble2Vec1Vec& value,
+                    const TDouble2Vec1Vec& detrended,
+                    maths::SModelProbabilityResult& result) const;
+
+        //! Check if the result of a calculation with \p params for \p value
+        //! can be cached.
+        static bool cacheable(const maths::CModelProbabilityParams& params,
+                              const TDouble2Vec1Vec& value);
+
+        //! Get the number of results in the cache.
+        std::size_t size() const;
+
+        //! Debug the memory used by this object.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+    private:
+        //! \brief The key and result of a probability calculation.
+        //!
+        //! Only the parts of the result used by CProbabilityAndInfluenceCalculator
+        //! are kept and, since only univariate calculations are cached, this
+        //! stores scalars in place of the parameters' vectors. There is one
+        //! of these per person so it is worth keeping it small.
+        struct MODEL_EXPORT SResult {
+            //! Set the key from the supplied calculation.
+            void key(const maths::CModelProbabilityParams& params,
+                     double value,
+                     double detrended);
+
+            //! Check if this is the result for the supplied calculation.
+            bool matches(const maths::CModelProbabilityParams& params,
+                         double value,
+                         double detrended) const;
+
+            //! The calculation style.
+            maths_t::EProbabilityCalculation s_Calculation;
+            //! Whether or not the bucket was empty.
+            bool s_BucketEmpty;
+            //! Whether or not multibucket features were used.
+            bool s_UseMultibucketFeatures;
+            //! Whether or not the anomaly model was used.
+            bool s_UseAnomalyModel;
+            //! The tail of the result.
+            maths_t::ETail s_Tail;
+            //! The confidence interval used to detrend.
+            double s_SeasonalConfidenceInterval;
+            //! The value weights.
+            maths_t::TDoubleWeightsAry s_Weights;
+            //! The value.
+            double s_Value;
+            //! The detrended value.
+            double s_Detrended;
+            //! The probability.
+            double s_Probability;
+        };
+
+        using TFeatureSizePr = std::pair<model_t::EFeature, std::size_t>;
+        using TFeatureSizePrResultUMap = boost::unordered_map<TFeatureSizePr, SResult>;
+
+    private:
+        //! The cached results.
+        TFeatureSizePrResultUMap m_Results;
+    };
 };
 }
 }
@@ -194,6 +194,13 @@ public:
     //! Add a cache for the two probability calculations.
     void addCache(CModelTools::CProbabilityCache& cache);
 
+    //! Add a cache of the results of probability calculations for
+    //! models which haven't changed.
+    //!
+    //! \note Results are cached against \p id, which should identify
+    //! the person, rather than the attribute passed to addProbability.
+    void addCache(CModelTools::CProbabilityResultCache& cache, std::size_t id);
+
     //! Add the probabilities and influences from \p other.
     void add(const CProbabilityAndInfluenceCalculator& other, double weight = 1.0);
 
@@ -330,6 +337,12 @@ private:
     //! The probability calculation cache if there is one.
     CModelTools::CProbabilityCache* m_ProbabilityCache;
 
+    //! The probability calculation result cache if there is one.
+    CModelTools::CProbabilityResultCache* m_ProbabilityResultCache;
+
+    //! The identifier of the results in the result cache.
+    std::size_t m_ProbabilityResultCacheId;
+
     //! The influence probability calculator.
     CModelTools::TStoredStringPtrStoredStringPtrPrProbabilityAggregatorUMap m_InfluencerProbabilities;
 
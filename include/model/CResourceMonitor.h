@@ -129,6 +129,16 @@ public:
     //! Clears all extra memory
     void clearExtraMemory();
 
+    //! Set whether the total memory usage includes the string stores.
+    //!
+    //! The string stores are shared by every job in the process so, when
+    //! several jobs are hosted in one process, they are reported once by
+    //! the host rather than charged to each job.
+    //!
+    //! \note This resets the peak usage, so it should be called before
+    //! any detectors are registered.
+    void includeStringStores(bool include);
+
     //! Decrease the margin on the memory limit.
     //!
     //! We start off applying a margin to the memory limit because
@@ -184,6 +194,9 @@ private:
     //! Extra memory to enable accounting of soon to be allocated memory
     std::size_t m_ExtraMemory;
 
+    //! True if the total memory usage includes the string stores.
+    bool m_IncludeStringStores;
+
     //! The total memory usage on the previous usage report
     std::size_t m_PreviousTotal;
 
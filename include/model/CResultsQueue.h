@@ -38,6 +38,11 @@ public:
     //! Push to the underlying queue
     void push(const CHierarchicalResults& item);
 
+    //! Push empty results for \p time to the underlying queue.
+    //!
+    //! \note This reuses the memory of the earliest results.
+    void pushEmpty(core_t::TTime time);
+
     //! Get a result from the queue
     const CHierarchicalResults& get(core_t::TTime time) const;
 
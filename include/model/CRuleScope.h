@@ -8,10 +8,12 @@
 
 #include <model/ImportExport.h>
 
+#include <core/CMemoryUsage.h>
 #include <core/CPatternSet.h>
 #include <core/CTriple.h>
 
 #include <boost/ref.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <string>
 #include <vector>
@@ -39,6 +41,56 @@ public:
         core::CTriple<std::string, TPatternSetCRef, ERuleScopeFilterType>;
     using TStrPatternSetCRefFilterTypeTripleVec = std::vector<TStrPatternSetCRefFilterTypeTriple>;
 
+    //! \brief Memoises whether a model's series are in the filters of
+    //! rule scopes.
+    //!
+    //! DESCRIPTION:\n
+    //! Rules are checked for every sample and result in every bucket and
+    //! checking a scope means looking up the partition, person or attribute
+    //! name in filters which can have thousands of patterns. Whether a filter
+    //! contains a name only changes if the filter is updated or the person
+    //! or attribute identifier is recycled.
+    //!
+    //! IMPLEMENTATION DECISIONS:\n
+    //! Results are keyed by the filter's unique identifier, which changes
+    //! whenever it is updated, so results for out-of-date filters are never
+    //! used. The model which owns the cache must clear it when identifiers
+    //! are recycled and it should be cleared when the filters are updated
+    //! to free the out-of-date results.
+    class MODEL_EXPORT CCache {
+    public:
+        //! The fields which can be in scope.
+        enum EField { E_PartitionField, E_PersonField, E_AttributeField };
+
+    public:
+        //! Check if \p filter contains \p value, which is the name of
+        //! \p field for the identifier \p id.
+        bool contains(const core::CPatternSet& filter,
+                      EField field,
+                      std::size_t id,
+                      const std::string& value);
+
+        //! Clear the cache.
+        void clear();
+
+        //! Get the number of results in the cache.
+        std::size_t size() const;
+
+        //! Debug the memory used by this object.
+        void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
+
+        //! Get the memory used by this object.
+        std::size_t memoryUsage() const;
+
+    private:
+        using TUInt64FieldSizeTr = core::CTriple<uint64_t, EField, std::size_t>;
+        using TUInt64FieldSizeTrBoolUMap = boost::unordered_map<TUInt64FieldSizeTr, bool>;
+
+    private:
+        //! Whether a filter contains a partition, person or attribute.
+        TUInt64FieldSizeTrBoolUMap m_Contains;
+    };
+
 public:
     //! Default constructor.
     CRuleScope() = default;
@@ -50,6 +102,8 @@ public:
     void exclude(const std::string& field, const core::CPatternSet& filter);
 
     //! Check whether the given series is in the rule scope.
+    //!
+    //! \note The filter lookups are memoised in \p model's rule scope cache.
     bool check(const CAnomalyDetectorModel& model, std::size_t pid, std::size_t cid) const;
 
     //! Pretty-print the scope.
@@ -47,7 +47,9 @@ namespace model {
 //! A singleton class: there should only be one collection strings for
 //! person names/attributes, and a separate collection for influencer
 //! strings.
-//! Write access is locked for the benefit of future threading.
+//! Write access is locked and lookups are fenced from writes so that the
+//! stores can be shared by jobs running on different threads in the same
+//! process.
 //!
 class MODEL_EXPORT CStringStore : private core::CNonCopyable {
 public:
@@ -66,7 +68,7 @@ public:
 
 public:
     //! Call this to tidy up any strings no longer needed.
-    static void tidyUpNotThreadSafe();
+    static void tidyUp();
 
     //! Singleton pattern for person/attribute names.
     static CStringStore& names();
@@ -84,10 +86,10 @@ public:
     void remove(const std::string& value);
 
     //! Prune strings which have been removed.
-    void pruneRemovedNotThreadSafe();
+    void pruneRemoved();
 
     //! Iterate over the string store and remove unused entries.
-    void pruneNotThreadSafe();
+    void prune();
 
     //! Get the memory used by this string store
     void debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const;
@@ -107,6 +109,15 @@ private:
     //! Bludgeoning device to delete all objects in store.
     void clearEverythingTestOnly();
 
+    //! Wait for any lookups in progress to finish and make new ones
+    //! bypass the set until stopExcludingReaders is called.
+    //!
+    //! \note The caller must hold m_Mutex.
+    void excludeReaders();
+
+    //! Allow lookups in the set again.
+    void stopExcludingReaders();
+
 private:
     //! Fence for reading operations (in which case we "leak" a string
     //! if we try to write at the same time). See get for details.
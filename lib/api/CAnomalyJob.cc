@@ -104,6 +104,7 @@ CAnomalyJob::CAnomalyJob(const std::string& jobId,
       m_ModelConfig(modelConfig), m_NumRecordsHandled(0),
       m_LastFinalisedBucketEndTime(0), m_PersistCompleteFunc(persistCompleteFunc),
       m_TimeFieldName(timeFieldName), m_TimeFieldFormat(timeFieldFormat),
+      m_TimeFieldParser(timeFieldFormat),
       m_MaxDetectors(std::numeric_limits<size_t>::max()),
       m_PeriodicPersister(periodicPersister),
       m_MaxQuantileInterval(maxQuantileInterval),
@@ -153,9 +154,10 @@ bool CAnomalyJob::handleRecord(const TStrStrUMap& dataRowFields) {
             return true;
         }
     } else {
-        // Use this library function instead of raw strptime() as it works
-        // around many operating system specific issues.
-        if (core::CTimeUtils::strptime(m_TimeFieldFormat, iter->second, time) == false) {
+        // This gives the same results as CTimeUtils::strptime(), which
+        // works around many operating system specific issues, but caches
+        // the conversion to UTC so is much faster.
+        if (m_TimeFieldParser.parse(iter->second, time) == false) {
             core::CStatistics::stat(stat_t::E_NumberTimeFieldConversionErrors).increment();
             LOG_ERROR(<< "Cannot interpret " << m_TimeFieldName << " field using format "
                       << m_TimeFieldFormat << " in record:" << core_t::LINE_ENDING
@@ -371,6 +373,19 @@ void CAnomalyJob::updateConfig(const std::string& config) {
     if (configUpdater.update(config) == false) {
         LOG_ERROR(<< "Failed to update configuration");
     }
+
+    // The models memoise which of their series are in the filters of
+    // rule scopes. Any results for filters which have been updated or
+    // rules which have been replaced are no longer used so free them.
+    for (const auto& detector_ : m_Detectors) {
+        model::CAnomalyDetector* detector(detector_.second.get());
+        if (detector == nullptr) {
+            LOG_ERROR(<< "Unexpected NULL pointer for key '"
+                      << pairDebug(detector_.first) << '\'');
+            continue;
+        }
+        detector->model()->clearRuleScopeCache();
+    }
 }
 
 void CAnomalyJob::advanceTime(const std::string& time_) {
@@ -590,7 +605,7 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
         m_ModelPlotQueue.reset(bucketStartTime - m_ModelPlotQueue.bucketLength());
     }
 
-    m_ResultsQueue.push(model::CHierarchicalResults(), bucketStartTime);
+    m_ResultsQueue.pushEmpty(bucketStartTime);
     model::CHierarchicalResults& results = m_ResultsQueue.get(bucketStartTime);
     m_ModelPlotQueue.push(TModelPlotDataVec(), bucketStartTime);
 
@@ -648,7 +663,7 @@ void CAnomalyJob::outputResults(core_t::TTime bucketStartTime) {
     }
 
     m_Limits.resourceMonitor().pruneIfRequired(bucketStartTime);
-    model::CStringStore::tidyUpNotThreadSafe();
+    model::CStringStore::tidyUp();
 }
 
 void CAnomalyJob::outputInterimResults(core_t::TTime bucketStartTime) {
@@ -1123,6 +1138,11 @@ bool CAnomalyJob::runBackgroundPersist(TBackgroundPersistArgsPtr args,
         return false;
     }
 
+    // This runs in the background persistence thread so the job's statistics
+    // and random number generator must be made current again.
+    core::CStatistics::CScopedContext statistics(*args->s_Statistics);
+    maths::CSampling::CScopedContext sampling(*args->s_SamplingContext);
+
     return this->persistState(
         "Periodic background persist at ", args->s_ResultsQueue,
         args->s_ModelPlotQueue, args->s_Time, args->s_Detectors, args->s_ModelSizeStats,
@@ -1316,9 +1336,21 @@ void CAnomalyJob::generateModelPlot(core_t::TTime startTime,
     double modelPlotBoundsPercentile(m_ModelConfig.modelPlotBoundsPercentile());
     if (modelPlotBoundsPercentile > 0.0) {
         LOG_TRACE(<< "Generating model debug data at " << startTime);
-        detector.generateModelPlot(
-            startTime, endTime, m_ModelConfig.modelPlotBoundsPercentile(),
-            m_ModelConfig.modelPlotTerms(), m_ModelPlotQueue.get(startTime));
+        if (m_ModelConfig.bucketResultsDelay() == 0) {
+            // The results for this bucket are written straight after the
+            // model plot so there's no need to hold on to it.
+            CModelPlotDataJsonWriter modelPlotWriter(m_OutputStream);
+            detector.generateModelPlot(
+                startTime, endTime, modelPlotBoundsPercentile, m_ModelConfig.modelPlotTerms(),
+                [&](const model::CModelPlotData& series,
+                    const model::CModelPlotData::SRow& row) {
+                    modelPlotWriter.writeRow(m_JobId, series, row);
+                });
+        } else {
+            detector.generateModelPlot(startTime, endTime, modelPlotBoundsPercentile,
+                                       m_ModelConfig.modelPlotTerms(),
+                                       m_ModelPlotQueue.get(startTime));
+        }
     }
 }
 
@@ -1515,7 +1547,9 @@ CAnomalyJob::SBackgroundPersistArgs::SBackgroundPersistArgs(
     : s_ResultsQueue(resultsQueue), s_ModelPlotQueue(modelPlotQueue),
       s_Time(time), s_ModelSizeStats(modelSizeStats),
       s_InterimBucketCorrector(interimBucketCorrector), s_Aggregator(aggregator),
-      s_LatestRecordTime(latestRecordTime), s_LastResultsTime(lastResultsTime) {
+      s_LatestRecordTime(latestRecordTime), s_LastResultsTime(lastResultsTime),
+      s_Statistics(&core::CStatistics::instance()),
+      s_SamplingContext(&maths::CSampling::context()) {
 }
 }
 }
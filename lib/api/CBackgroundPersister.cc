@@ -6,6 +6,7 @@
 #include <api/CBackgroundPersister.h>
 
 #include <core/CLogger.h>
+#include <core/CProcessMemory.h>
 #include <core/CScopedFastLock.h>
 #include <core/CTimeUtils.h>
 
@@ -208,6 +209,10 @@ void CBackgroundPersister::CBackgroundThread::run() {
         m_Owner.m_PersistFuncs.pop_front();
     }
 
+    // Popping the functions freed the copies of the state they persisted,
+    // which can be as large as the models, so give that memory back.
+    core::CProcessMemory::releaseFreeMemory();
+
     core::CScopedFastLock lock(m_Owner.m_Mutex);
     m_Owner.m_IsBusy = false;
 }
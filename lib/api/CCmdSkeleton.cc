@@ -26,14 +26,8 @@ CCmdSkeleton::CCmdSkeleton(core::CDataSearcher* restoreSearcher,
 }
 
 bool CCmdSkeleton::ioLoop() {
-    if (m_RestoreSearcher == nullptr) {
-        LOG_DEBUG(<< "No restoration source specified - will not attempt to restore state");
-    } else {
-        core_t::TTime completeToTime(0);
-        if (m_Processor.restoreState(*m_RestoreSearcher, completeToTime) == false) {
-            LOG_FATAL(<< "Failed to restore state");
-            return false;
-        }
+    if (this->restoreState() == false) {
+        return false;
     }
 
     if (m_InputParser.readStream(boost::bind(&CDataProcessor::handleRecord,
@@ -42,6 +36,25 @@ bool CCmdSkeleton::ioLoop() {
         return false;
     }
 
+    return this->finalise();
+}
+
+bool CCmdSkeleton::restoreState() {
+    if (m_RestoreSearcher == nullptr) {
+        LOG_DEBUG(<< "No restoration source specified - will not attempt to restore state");
+        return true;
+    }
+
+    core_t::TTime completeToTime(0);
+    if (m_Processor.restoreState(*m_RestoreSearcher, completeToTime) == false) {
+        LOG_FATAL(<< "Failed to restore state");
+        return false;
+    }
+
+    return true;
+}
+
+bool CCmdSkeleton::finalise() {
     LOG_INFO(<< "Handled " << m_Processor.numRecordsHandled() << " records");
 
     // Finalise the processor so it gets a chance to write any remaining results
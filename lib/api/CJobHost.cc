@@ -0,0 +1,368 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <api/CJobHost.h>
+
+#include <core/CLogger.h>
+#include <core/CStatistics.h>
+
+#include <maths/CSampling.h>
+
+#include <api/CCmdSkeleton.h>
+#include <api/CDataProcessor.h>
+#include <api/CInputParser.h>
+
+#include <log4cxx/ndc.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace ml {
+namespace api {
+namespace {
+//! The maximum number of turns of records to queue for each job.
+const std::size_t MAXIMUM_QUEUED_TURNS{2};
+}
+
+//! \brief The state of one job.
+struct CJobHost::SJobState : private core::CNonCopyable {
+    using TStrStrUMapDeque = std::deque<TStrStrUMap>;
+    using TStrStrUMapVec = std::vector<TStrStrUMap>;
+
+    SJobState(const std::string& id, TJobUPtr job)
+        : s_Id(id), s_Job(std::move(job)),
+          s_Skeleton(s_Job->restoreSearcher(), s_Job->persister(),
+                     s_Job->inputParser(), s_Job->processor()),
+          s_Scheduled(false), s_Restored(false), s_EndOfInput(false),
+          s_InputFailed(false), s_Finished(false) {}
+
+    //! The job's ID.
+    std::string s_Id;
+    //! The job's statistics. These and the sampling context are declared
+    //! before the job so they outlive everything the job owns.
+    core::CStatistics s_Statistics;
+    //! The job's random number generator.
+    maths::CSampling::CContext s_SamplingContext;
+    //! The job.
+    TJobUPtr s_Job;
+    //! Restores, finalises and persists the job.
+    CCmdSkeleton s_Skeleton;
+    //! The thread which reads the job's input.
+    std::thread s_Reader;
+
+    //! Protects the state shared by the reader and processing threads.
+    std::mutex s_Mutex;
+    //! Signalled when there is space in the queue or the job finishes.
+    std::condition_variable s_SpaceAvailable;
+    //! The records waiting to be processed.
+    TStrStrUMapDeque s_Records;
+    //! The records being processed in the current turn.
+    TStrStrUMapVec s_Batch;
+    //! Processed records whose maps are reused to avoid allocations.
+    TStrStrUMapVec s_Spare;
+    //! True if the job is in the run queue or being processed.
+    bool s_Scheduled;
+    //! True if the job's state has been restored.
+    bool s_Restored;
+    //! True if the reader has stopped.
+    bool s_EndOfInput;
+    //! True if the job's input couldn't be parsed.
+    bool s_InputFailed;
+    //! True if the job has finished or failed.
+    bool s_Finished;
+};
+
+const std::size_t CJobHost::DEFAULT_QUANTUM{1000};
+
+CJobHost::CJobHost(std::size_t numberThreads, std::size_t quantum)
+    : m_Quantum(std::max(quantum, std::size_t(1))), m_NumberFailed(0), m_Shutdown(false) {
+    numberThreads = std::max(numberThreads, std::size_t(1));
+    m_Workers.reserve(numberThreads);
+    for (std::size_t i = 0; i < numberThreads; ++i) {
+        m_Workers.emplace_back([this] { this->worker(); });
+    }
+}
+
+CJobHost::~CJobHost() {
+    this->waitForAll();
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Shutdown = true;
+    }
+    m_WorkAvailable.notify_all();
+    for (auto& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+bool CJobHost::start(const std::string& id, TJobUPtr job) {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        if (m_Jobs.count(id) > 0) {
+            LOG_ERROR(<< "Job '" << id << "' is already running");
+            return false;
+        }
+
+        TJobStateUPtr state(std::make_unique<SJobState>(id, std::move(job)));
+        SJobState& state_(*state);
+        m_Jobs.emplace(id, std::move(state));
+
+        // The first turn restores the job's state whilst its first records
+        // are being read.
+        state_.s_Scheduled = true;
+        m_RunQueue.push_back(&state_);
+
+        // This is assigned with the lock held so that remove() can't join
+        // the thread before the assignment is complete.
+        state_.s_Reader = std::thread([this, &state_] { this->read(state_); });
+    }
+    m_WorkAvailable.notify_one();
+
+    LOG_DEBUG(<< "Started job '" << id << "'");
+    return true;
+}
+
+void CJobHost::waitForAll() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobRemoved.wait(lock, [this] { return m_Jobs.empty(); });
+}
+
+std::size_t CJobHost::numberJobs() const {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_Jobs.size();
+}
+
+std::size_t CJobHost::numberFailed() const {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_NumberFailed;
+}
+
+std::size_t CJobHost::quantum() const {
+    return m_Quantum;
+}
+
+void CJobHost::read(SJobState& job) {
+    log4cxx::NDC context(job.s_Id);
+
+    bool succeeded(false);
+    try {
+        succeeded = job.s_Job->inputParser().readStream(
+            [this, &job](const TStrStrUMap& record) { return this->add(job, record); });
+    } catch (const std::exception& e) {
+        LOG_ERROR(<< "Failed to read input: " << e.what());
+    }
+
+    bool schedule(false);
+    {
+        std::unique_lock<std::mutex> lock(job.s_Mutex);
+        job.s_EndOfInput = true;
+        // Reading stops early if the job has already finished, but that
+        // doesn't mean its input is bad.
+        job.s_InputFailed = (succeeded == false && job.s_Finished == false);
+        schedule = (job.s_Scheduled == false);
+        job.s_Scheduled = true;
+    }
+    if (schedule) {
+        this->schedule(job);
+    }
+}
+
+bool CJobHost::add(SJobState& job, const TStrStrUMap& record) {
+    bool schedule(false);
+    {
+        std::unique_lock<std::mutex> lock(job.s_Mutex);
+        job.s_SpaceAvailable.wait(lock, [this, &job] {
+            return job.s_Finished || job.s_Records.size() < MAXIMUM_QUEUED_TURNS * m_Quantum;
+        });
+        if (job.s_Finished) {
+            return false;
+        }
+
+        if (job.s_Spare.empty()) {
+            job.s_Records.push_back(record);
+        } else {
+            job.s_Records.push_back(std::move(job.s_Spare.back()));
+            job.s_Spare.pop_back();
+            job.s_Records.back() = record;
+        }
+        schedule = (job.s_Scheduled == false);
+        job.s_Scheduled = true;
+    }
+    if (schedule) {
+        this->schedule(job);
+    }
+    return true;
+}
+
+void CJobHost::schedule(SJobState& job) {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_RunQueue.push_back(&job);
+    }
+    m_WorkAvailable.notify_one();
+}
+
+void CJobHost::worker() {
+    for (;;) {
+        SJobState* job(nullptr);
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [this] {
+                return m_Shutdown || m_RunQueue.empty() == false;
+            });
+            if (m_RunQueue.empty()) {
+                return;
+            }
+            job = m_RunQueue.front();
+            m_RunQueue.pop_front();
+        }
+        this->process(*job);
+    }
+}
+
+void CJobHost::process(SJobState& job) {
+    bool finished(false);
+    bool complete(false);
+    bool inputFailed(false);
+    {
+        std::unique_lock<std::mutex> lock(job.s_Mutex);
+        std::size_t n(std::min(m_Quantum, job.s_Records.size()));
+        for (std::size_t i = 0; i < n; ++i) {
+            job.s_Batch.push_back(std::move(job.s_Records.front()));
+            job.s_Records.pop_front();
+        }
+        finished = job.s_Finished;
+        complete = (job.s_EndOfInput && job.s_Records.empty());
+        inputFailed = job.s_InputFailed;
+    }
+    job.s_SpaceAvailable.notify_one();
+
+    if (finished == false) {
+        bool succeeded(this->processTurn(job, complete, inputFailed));
+        if (succeeded == false || complete) {
+            this->finish(job, succeeded);
+        }
+    }
+
+    bool remove(false);
+    bool reschedule(false);
+    {
+        std::unique_lock<std::mutex> lock(job.s_Mutex);
+        for (auto& record : job.s_Batch) {
+            job.s_Spare.push_back(std::move(record));
+        }
+        job.s_Batch.clear();
+        if (job.s_Finished) {
+            job.s_Records.clear();
+            // If the reader is still running it schedules the job again
+            // when it stops.
+            remove = job.s_EndOfInput;
+            job.s_Scheduled = remove;
+        } else if (job.s_Records.empty() == false || job.s_EndOfInput) {
+            reschedule = true;
+        } else {
+            job.s_Scheduled = false;
+        }
+    }
+
+    if (remove) {
+        this->remove(job);
+    } else if (reschedule) {
+        this->schedule(job);
+    }
+}
+
+bool CJobHost::processTurn(SJobState& job, bool complete, bool inputFailed) {
+    log4cxx::NDC context(job.s_Id);
+    core::CStatistics::CScopedContext statistics(job.s_Statistics);
+    maths::CSampling::CScopedContext sampling(job.s_SamplingContext);
+
+    try {
+        if (job.s_Restored == false) {
+            job.s_Restored = true;
+            if (job.s_Skeleton.restoreState() == false) {
+                return false;
+            }
+        }
+
+        CDataProcessor& processor(job.s_Job->processor());
+        for (const auto& record : job.s_Batch) {
+            if (processor.handleRecord(record) == false) {
+                LOG_FATAL(<< "Record handler function forced exit");
+                return false;
+            }
+        }
+
+        if (complete) {
+            if (inputFailed) {
+                LOG_FATAL(<< "Failed to handle all input data");
+                return false;
+            }
+            return job.s_Skeleton.finalise();
+        }
+    } catch (const std::exception& e) {
+        LOG_FATAL(<< "Job failed: " << e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void CJobHost::finish(SJobState& job, bool succeeded) {
+    {
+        log4cxx::NDC context(job.s_Id);
+        core::CStatistics::CScopedContext statistics(job.s_Statistics);
+        maths::CSampling::CScopedContext sampling(job.s_SamplingContext);
+        try {
+            job.s_Job->finished(succeeded);
+        } catch (const std::exception& e) {
+            LOG_ERROR(<< "Failed to finish job: " << e.what());
+            succeeded = false;
+        }
+        if (succeeded) {
+            LOG_DEBUG(<< "Job finished");
+        } else {
+            LOG_ERROR(<< "Job failed");
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(job.s_Mutex);
+        job.s_Finished = true;
+    }
+    // Wake the reader if it's waiting for space so it stops.
+    job.s_SpaceAvailable.notify_all();
+
+    if (succeeded == false) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        ++m_NumberFailed;
+    }
+}
+
+void CJobHost::remove(SJobState& job) {
+    std::string id(job.s_Id);
+
+    TJobStateUPtr state;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        state = std::move(m_Jobs[id]);
+    }
+
+    // The reader has stopped so this doesn't block for long. The job's
+    // ID stays reserved until everything it owns has been destroyed.
+    state->s_Reader.join();
+    state.reset();
+
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Jobs.erase(id);
+    }
+    m_JobRemoved.notify_all();
+
+    LOG_DEBUG(<< "Removed job '" << id << "'");
+}
+}
+}
@@ -141,11 +141,47 @@ private:
 
 const CInfluencerGreater INFLUENCER_GREATER = CInfluencerGreater(INITIAL_INFLUENCER_SCORE);
 const CInfluencerGreater BUCKET_INFLUENCER_GREATER = CInfluencerGreater(INITIAL_SCORE);
+
+//! \brief Makes a writer allocate from the memory pool for the current
+//! output batch whilst in scope, creating the pool if necessary.
+class CScopedBatchAllocator {
+public:
+    CScopedBatchAllocator(core::CRapidJsonConcurrentLineWriter& writer,
+                          CJsonOutputWriter::TPoolAllocatorPtr& allocator)
+        : m_Writer(writer) {
+        if (allocator == nullptr) {
+            allocator = std::make_shared<core::CRapidJsonPoolAllocator>();
+        }
+        m_Writer.pushAllocator(allocator);
+    }
+
+    ~CScopedBatchAllocator() { m_Writer.removeAllocator(); }
+
+    CScopedBatchAllocator(const CScopedBatchAllocator&) = delete;
+    CScopedBatchAllocator& operator=(const CScopedBatchAllocator&) = delete;
+
+private:
+    core::CRapidJsonConcurrentLineWriter& m_Writer;
+};
+
+//! \brief The results of an output batch which are ready to be written.
+struct SOutputBatch {
+    //! The job ID.
+    std::string s_JobId;
+    //! Are the results interim?
+    bool s_IsInterim;
+    //! The time taken to process the bucket.
+    uint64_t s_BucketProcessingTime;
+    //! The memory pool which owns the documents.
+    CJsonOutputWriter::TPoolAllocatorPtr s_Allocator;
+    //! The documents to write keyed on bucket time.
+    CJsonOutputWriter::TTimeBucketDataMap s_BucketDataByTime;
+};
 }
 
 CJsonOutputWriter::CJsonOutputWriter(const std::string& jobId,
                                      core::CJsonOutputStreamWrapper& strmOut)
-    : m_JobId(jobId), m_Writer(strmOut), m_LastNonInterimBucketTime(0),
+    : m_JobId(jobId), m_OutputStream(strmOut), m_Writer(strmOut), m_LastNonInterimBucketTime(0),
       m_Finalised(false), m_RecordOutputLimit(0) {
     // Don't write any output in the constructor because, the way things work at
     // the moment, the output stream might be redirected after construction
@@ -167,6 +203,8 @@ void CJsonOutputWriter::finalise() {
 }
 
 bool CJsonOutputWriter::acceptResult(const CHierarchicalResultsWriter::TResults& results) {
+    CScopedBatchAllocator scopedAllocator(m_Writer, m_BatchAllocator);
+
     SBucketData& bucketData = m_BucketDataByTime[results.s_BucketStartTime];
 
     if (results.s_ResultType == CHierarchicalResultsWriter::E_SimpleCountResult) {
@@ -250,6 +288,8 @@ bool CJsonOutputWriter::acceptResult(const CHierarchicalResultsWriter::TResults&
 bool CJsonOutputWriter::acceptInfluencer(core_t::TTime time,
                                          const model::CHierarchicalResults::TNode& node,
                                          bool isBucketInfluencer) {
+    CScopedBatchAllocator scopedAllocator(m_Writer, m_BatchAllocator);
+
     TDocumentWeakPtr newDoc = m_Writer.makeStorableDoc();
     SBucketData& bucketData = m_BucketDataByTime[time];
     TDocumentWeakPtrVec& documents = (isBucketInfluencer)
@@ -308,6 +348,8 @@ void CJsonOutputWriter::acceptBucketTimeInfluencer(core_t::TTime time,
         return;
     }
 
+    CScopedBatchAllocator scopedAllocator(m_Writer, m_BatchAllocator);
+
     TDocumentWeakPtr doc = m_Writer.makeStorableDoc();
     TDocumentPtr newDoc = doc.lock();
     if (!newDoc) {
@@ -326,18 +368,40 @@ void CJsonOutputWriter::acceptBucketTimeInfluencer(core_t::TTime time,
 }
 
 bool CJsonOutputWriter::endOutputBatch(bool isInterim, uint64_t bucketProcessingTime) {
-    for (TTimeBucketDataMapItr iter = m_BucketDataByTime.begin();
-         iter != m_BucketDataByTime.end(); ++iter) {
-        this->writeBucket(isInterim, iter->first, iter->second, bucketProcessingTime);
-        if (!isInterim) {
-            m_LastNonInterimBucketTime = iter->first;
+    if (m_BucketDataByTime.empty() == false) {
+        {
+            CScopedBatchAllocator scopedAllocator(m_Writer, m_BatchAllocator);
+            for (TTimeBucketDataMapItr iter = m_BucketDataByTime.begin();
+                 iter != m_BucketDataByTime.end(); ++iter) {
+                this->addBucketFields(isInterim, iter->first, iter->second);
+                if (!isInterim) {
+                    m_LastNonInterimBucketTime = iter->first;
+                }
+            }
         }
+
+        // Hand the documents, and the memory pool which owns them, over
+        // to the output stream's thread to be serialised.
+        auto batch = std::make_shared<SOutputBatch>();
+        batch->s_JobId = m_JobId;
+        batch->s_IsInterim = isInterim;
+        batch->s_BucketProcessingTime = bucketProcessingTime;
+        batch->s_Allocator = m_BatchAllocator;
+        batch->s_BucketDataByTime.swap(m_BucketDataByTime);
+        m_OutputStream.writeAsync(
+            [batch](core::CJsonOutputStreamWrapper::CAsyncLineWriter& writer) {
+                for (const auto& bucketData : batch->s_BucketDataByTime) {
+                    writeBucket(batch->s_JobId, batch->s_IsInterim, bucketData.first,
+                                bucketData.second, batch->s_BucketProcessingTime, writer);
+                }
+            });
     }
 
     // After writing the buckets clear all the bucket data so that we don't
     // accumulate memory.
     m_BucketDataByTime.clear();
     m_NestedDocs.clear();
+    m_BatchAllocator.reset();
 
     return true;
 }
@@ -386,138 +450,150 @@ bool CJsonOutputWriter::writeRow(const TStrStrUMap& dataRowFields,
     return true;
 }
 
-void CJsonOutputWriter::writeBucket(bool isInterim,
+void CJsonOutputWriter::addBucketFields(bool isInterim,
+                                        core_t::TTime bucketTime,
+                                        SBucketData& bucketData) {
+    // Sort the results so they are grouped by detector and
+    // ordered by probability
+    std::sort(bucketData.s_DocumentsToWrite.begin(),
+              bucketData.s_DocumentsToWrite.end(), DETECTOR_PROBABILITY_LESS);
+
+    for (const auto& document : bucketData.s_DocumentsToWrite) {
+        TDocumentPtr docPtr = document.first.lock();
+        if (!docPtr) {
+            LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
+            continue;
+        }
+
+        m_Writer.addIntFieldToObj(DETECTOR_INDEX, document.second, *docPtr);
+        m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
+        m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
+        m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
+
+        if (isInterim) {
+            m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
+        }
+    }
+
+    for (const auto& document : bucketData.s_InfluencerDocuments) {
+        TDocumentPtr docPtr = document.lock();
+        if (!docPtr) {
+            LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
+            continue;
+        }
+
+        m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
+        m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
+        if (isInterim) {
+            m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
+        }
+        m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
+    }
+
+    for (const auto& document : bucketData.s_BucketInfluencerDocuments) {
+        TDocumentPtr docPtr = document.lock();
+        if (!docPtr) {
+            LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
+            continue;
+        }
+
+        m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
+        m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
+        m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
+        if (isInterim) {
+            m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
+        }
+    }
+}
+
+void CJsonOutputWriter::writeBucket(const std::string& jobId,
+                                    bool isInterim,
                                     core_t::TTime bucketTime,
-                                    SBucketData& bucketData,
-                                    uint64_t bucketProcessingTime) {
+                                    const SBucketData& bucketData,
+                                    uint64_t bucketProcessingTime,
+                                    core::CJsonOutputStreamWrapper::CAsyncLineWriter& writer) {
     // Write records
     if (!bucketData.s_DocumentsToWrite.empty()) {
-        // Sort the results so they are grouped by detector and
-        // ordered by probability
-        std::sort(bucketData.s_DocumentsToWrite.begin(),
-                  bucketData.s_DocumentsToWrite.end(), DETECTOR_PROBABILITY_LESS);
-
-        m_Writer.StartObject();
-        m_Writer.String(RECORDS);
-        m_Writer.StartArray();
+        writer.StartObject();
+        writer.String(RECORDS);
+        writer.StartArray();
 
         // Iterate over the different detectors that we have results for
-        for (TDocumentWeakPtrIntPrVecItr detectorIter =
-                 bucketData.s_DocumentsToWrite.begin();
-             detectorIter != bucketData.s_DocumentsToWrite.end(); ++detectorIter) {
-            // Write the document, adding some extra fields as we go
-            int detectorIndex = detectorIter->second;
-            TDocumentWeakPtr weakDoc = detectorIter->first;
-            TDocumentPtr docPtr = weakDoc.lock();
-            if (!docPtr) {
-                LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
-                continue;
+        for (const auto& document : bucketData.s_DocumentsToWrite) {
+            TDocumentPtr docPtr = document.first.lock();
+            if (docPtr) {
+                writer.write(*docPtr);
             }
-
-            m_Writer.addIntFieldToObj(DETECTOR_INDEX, detectorIndex, *docPtr);
-            m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
-            m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
-            m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
-
-            if (isInterim) {
-                m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
-            }
-            m_Writer.write(*docPtr);
         }
-        m_Writer.EndArray();
-        m_Writer.EndObject();
+        writer.EndArray();
+        writer.EndObject();
     }
 
     // Write influencers
     if (!bucketData.s_InfluencerDocuments.empty()) {
-        m_Writer.StartObject();
-        m_Writer.String(INFLUENCERS);
-        m_Writer.StartArray();
-        for (TDocumentWeakPtrVecItr influencerIter =
-                 bucketData.s_InfluencerDocuments.begin();
-             influencerIter != bucketData.s_InfluencerDocuments.end(); ++influencerIter) {
-            TDocumentWeakPtr weakDoc = *influencerIter;
-            TDocumentPtr docPtr = weakDoc.lock();
-            if (!docPtr) {
-                LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
-                continue;
+        writer.StartObject();
+        writer.String(INFLUENCERS);
+        writer.StartArray();
+        for (const auto& document : bucketData.s_InfluencerDocuments) {
+            TDocumentPtr docPtr = document.lock();
+            if (docPtr) {
+                writer.write(*docPtr);
             }
-
-            m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
-            m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
-            if (isInterim) {
-                m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
-            }
-            m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
-            m_Writer.write(*docPtr);
         }
-        m_Writer.EndArray();
-        m_Writer.EndObject();
+        writer.EndArray();
+        writer.EndObject();
     }
 
     // Write bucket at the end, as some of its values need to iterate over records, etc.
-    m_Writer.StartObject();
-    m_Writer.String(BUCKET);
-
-    m_Writer.StartObject();
-    m_Writer.String(JOB_ID);
-    m_Writer.String(m_JobId);
-    m_Writer.String(TIMESTAMP);
-    m_Writer.Time(bucketTime);
-
-    m_Writer.String(ANOMALY_SCORE);
-    m_Writer.Double(bucketData.s_MaxBucketInfluencerNormalizedAnomalyScore);
-    m_Writer.String(INITIAL_SCORE);
-    m_Writer.Double(bucketData.s_MaxBucketInfluencerNormalizedAnomalyScore);
-    m_Writer.String(EVENT_COUNT);
-    m_Writer.Uint64(bucketData.s_InputEventCount);
+    writer.StartObject();
+    writer.String(BUCKET);
+
+    writer.StartObject();
+    writer.String(JOB_ID);
+    writer.String(jobId);
+    writer.String(TIMESTAMP);
+    writer.Time(bucketTime);
+
+    writer.String(ANOMALY_SCORE);
+    writer.Double(bucketData.s_MaxBucketInfluencerNormalizedAnomalyScore);
+    writer.String(INITIAL_SCORE);
+    writer.Double(bucketData.s_MaxBucketInfluencerNormalizedAnomalyScore);
+    writer.String(EVENT_COUNT);
+    writer.Uint64(bucketData.s_InputEventCount);
     if (isInterim) {
-        m_Writer.String(IS_INTERIM);
-        m_Writer.Bool(isInterim);
+        writer.String(IS_INTERIM);
+        writer.Bool(isInterim);
     }
-    m_Writer.String(BUCKET_SPAN);
-    m_Writer.Int64(bucketData.s_BucketSpan);
+    writer.String(BUCKET_SPAN);
+    writer.Int64(bucketData.s_BucketSpan);
 
     if (!bucketData.s_BucketInfluencerDocuments.empty()) {
         // Write the array of influencers
-        m_Writer.String(BUCKET_INFLUENCERS);
-        m_Writer.StartArray();
-        for (TDocumentWeakPtrVecItr influencerIter =
-                 bucketData.s_BucketInfluencerDocuments.begin();
-             influencerIter != bucketData.s_BucketInfluencerDocuments.end();
-             ++influencerIter) {
-            TDocumentWeakPtr weakDoc = *influencerIter;
-            TDocumentPtr docPtr = weakDoc.lock();
-            if (!docPtr) {
-                LOG_ERROR(<< "Inconsistent program state. JSON document unavailable.");
-                continue;
-            }
-
-            m_Writer.addStringFieldCopyToObj(JOB_ID, m_JobId, *docPtr);
-            m_Writer.addTimeFieldToObj(TIMESTAMP, bucketTime, *docPtr);
-            m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketData.s_BucketSpan, *docPtr);
-            if (isInterim) {
-                m_Writer.addBoolFieldToObj(IS_INTERIM, isInterim, *docPtr);
+        writer.String(BUCKET_INFLUENCERS);
+        writer.StartArray();
+        for (const auto& document : bucketData.s_BucketInfluencerDocuments) {
+            TDocumentPtr docPtr = document.lock();
+            if (docPtr) {
+                writer.write(*docPtr);
             }
-            m_Writer.write(*docPtr);
         }
-        m_Writer.EndArray();
+        writer.EndArray();
     }
 
-    m_Writer.String(PROCESSING_TIME);
-    m_Writer.Uint64(bucketProcessingTime);
+    writer.String(PROCESSING_TIME);
+    writer.Uint64(bucketProcessingTime);
 
     if (bucketData.s_ScheduledEventDescriptions.empty() == false) {
-        m_Writer.String(SCHEDULED_EVENTS);
-        m_Writer.StartArray();
+        writer.String(SCHEDULED_EVENTS);
+        writer.StartArray();
         for (const auto& it : bucketData.s_ScheduledEventDescriptions) {
-            m_Writer.String(it);
+            writer.String(it);
         }
-        m_Writer.EndArray();
+        writer.EndArray();
     }
 
-    m_Writer.EndObject();
-    m_Writer.EndObject();
+    writer.EndObject();
+    writer.EndObject();
 }
 
 void CJsonOutputWriter::addMetricFields(const CHierarchicalResultsWriter::TResults& results,
@@ -671,8 +747,9 @@ void CJsonOutputWriter::addInfluences(const CHierarchicalResultsWriter::TStoredS
     }
 
     //! This function takes the raw c_str pointers of the string objects in
-    //! influenceResults. These strings must exist up to the time the results
-    //! are written
+    //! influenceResults. The document is written on the output stream's
+    //! thread, by which time the strings may have been pruned from the string
+    //! store, so they are copied into the document's allocator.
 
     using TCharPtrDoublePr = std::pair<const char*, double>;
     using TCharPtrDoublePrVec = std::vector<TCharPtrDoublePr>;
@@ -709,7 +786,8 @@ void CJsonOutputWriter::addInfluences(const CHierarchicalResultsWriter::TStoredS
         rapidjson::Value values = m_Writer.makeArray(influences.size());
         for (TCharPtrDoublePrVecIter arrayIter = iter->second.second.begin();
              arrayIter != iter->second.second.end(); ++arrayIter) {
-            m_Writer.pushBack(arrayIter->first, values);
+            rapidjson::Value value(arrayIter->first, m_Writer.getRawAllocator());
+            m_Writer.pushBack(value, values);
         }
 
         m_Writer.addMember(INFLUENCER_FIELD_NAME, iter->second.first, influenceDoc);
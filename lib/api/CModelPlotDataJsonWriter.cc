@@ -5,6 +5,7 @@
  */
 #include <api/CModelPlotDataJsonWriter.h>
 #include <core/CLogger.h>
+#include <core/CScopedRapidJsonPoolAllocator.h>
 #include <core/CTimeUtils.h>
 
 namespace ml {
@@ -35,85 +36,54 @@ CModelPlotDataJsonWriter::CModelPlotDataJsonWriter(core::CJsonOutputStreamWrappe
 
 void CModelPlotDataJsonWriter::writeFlat(const std::string& jobId,
                                          const model::CModelPlotData& data) {
-    const std::string& partitionFieldName = data.partitionFieldName();
-    const std::string& partitionFieldValue = data.partitionFieldValue();
-    const std::string& overFieldName = data.overFieldName();
-    const std::string& byFieldName = data.byFieldName();
-    core_t::TTime time = data.time();
-    int detectorIndex = data.detectorIndex();
-
-    for (TFeatureStrByFieldDataUMapUMapCItr featureItr = data.begin();
-         featureItr != data.end(); ++featureItr) {
-        std::string feature = model_t::print(featureItr->first);
-        const TStrByFieldDataUMap& byDataMap = featureItr->second;
-        for (TStrByFieldDataUMapCItr byItr = byDataMap.begin();
-             byItr != byDataMap.end(); ++byItr) {
-            const std::string& byFieldValue = byItr->first;
-            const TByFieldData& byData = byItr->second;
-            const TStrDoublePrVec& values = byData.s_ValuesPerOverField;
-            if (values.empty()) {
-                rapidjson::Value doc = m_Writer.makeObject();
-                this->writeFlatRow(time, jobId, detectorIndex, partitionFieldName,
-                                   partitionFieldValue, feature, byFieldName,
-                                   byFieldValue, byData, data.bucketSpan(), doc);
-
-                rapidjson::Value wrapper = m_Writer.makeObject();
-                m_Writer.addMember(MODEL_PLOT, doc, wrapper);
-                m_Writer.write(wrapper);
-            } else {
-                for (std::size_t valueIndex = 0; valueIndex < values.size(); ++valueIndex) {
-                    const TStrDoublePr& keyValue = values[valueIndex];
-                    rapidjson::Value doc = m_Writer.makeObject();
-                    this->writeFlatRow(time, jobId, detectorIndex, partitionFieldName,
-                                       partitionFieldValue, feature, byFieldName,
-                                       byFieldValue, byData, data.bucketSpan(), doc);
-                    if (!overFieldName.empty()) {
-                        m_Writer.addStringFieldCopyToObj(OVER_FIELD_NAME, overFieldName, doc);
-                        m_Writer.addStringFieldCopyToObj(OVER_FIELD_VALUE,
-                                                         keyValue.first, doc, true);
-                    }
-                    m_Writer.addDoubleFieldToObj(ACTUAL, keyValue.second, doc);
-
-                    rapidjson::Value wrapper = m_Writer.makeObject();
-                    m_Writer.addMember(MODEL_PLOT, doc, wrapper);
-                    m_Writer.write(wrapper);
-                }
-            }
-        }
-    }
+    data.forEachRow([&](const TRow& row) { this->writeRow(jobId, data, row); });
 
     m_Writer.Flush();
 }
 
-void CModelPlotDataJsonWriter::writeFlatRow(core_t::TTime time,
-                                            const std::string& jobId,
-                                            int detectorIndex,
-                                            const std::string& partitionFieldName,
-                                            const std::string& partitionFieldValue,
-                                            const std::string& feature,
-                                            const std::string& byFieldName,
-                                            const std::string& byFieldValue,
-                                            const TByFieldData& byData,
-                                            core_t::TTime bucketSpan,
-                                            rapidjson::Value& doc) {
-    m_Writer.addStringFieldCopyToObj(JOB_ID, jobId, doc, true);
-    m_Writer.addIntFieldToObj(DETECTOR_INDEX, detectorIndex, doc);
-    m_Writer.addStringFieldCopyToObj(FEATURE, feature, doc, true);
+void CModelPlotDataJsonWriter::writeRow(const std::string& jobId,
+                                        const model::CModelPlotData& series,
+                                        const TRow& row) {
+    using TScopedAllocator =
+        core::CScopedRapidJsonPoolAllocator<core::CRapidJsonConcurrentLineWriter>;
+    TScopedAllocator scopedAllocator("CModelPlotDataJsonWriter::writeRow", m_Writer);
+
+    // No need to copy the strings as the doc is written straight away
+    std::string feature{model_t::print(row.s_Feature)};
+    rapidjson::Value doc = m_Writer.makeObject();
+    m_Writer.addStringFieldReferenceToObj(JOB_ID, jobId, doc, true);
+    m_Writer.addIntFieldToObj(DETECTOR_INDEX, series.detectorIndex(), doc);
+    m_Writer.addStringFieldReferenceToObj(FEATURE, feature, doc, true);
     // time is in Java format - milliseconds since the epoch
-    m_Writer.addTimeFieldToObj(TIME, time, doc);
-    m_Writer.addIntFieldToObj(BUCKET_SPAN, bucketSpan, doc);
-    if (!partitionFieldName.empty()) {
-        m_Writer.addStringFieldCopyToObj(PARTITION_FIELD_NAME, partitionFieldName, doc);
-        m_Writer.addStringFieldCopyToObj(PARTITION_FIELD_VALUE,
-                                         partitionFieldValue, doc, true);
+    m_Writer.addTimeFieldToObj(TIME, series.time(), doc);
+    m_Writer.addIntFieldToObj(BUCKET_SPAN, series.bucketSpan(), doc);
+    if (!series.partitionFieldName().empty()) {
+        m_Writer.addStringFieldReferenceToObj(PARTITION_FIELD_NAME,
+                                              series.partitionFieldName(), doc);
+        m_Writer.addStringFieldReferenceToObj(PARTITION_FIELD_VALUE,
+                                              series.partitionFieldValue(), doc, true);
+    }
+    if (!series.byFieldName().empty()) {
+        m_Writer.addStringFieldReferenceToObj(BY_FIELD_NAME, series.byFieldName(), doc);
+        m_Writer.addStringFieldReferenceToObj(BY_FIELD_VALUE,
+                                              *row.s_ByFieldValue, doc, true);
     }
-    if (!byFieldName.empty()) {
-        m_Writer.addStringFieldCopyToObj(BY_FIELD_NAME, byFieldName, doc);
-        m_Writer.addStringFieldCopyToObj(BY_FIELD_VALUE, byFieldValue, doc, true);
+    m_Writer.addDoubleFieldToObj(LOWER, row.s_LowerBound, doc);
+    m_Writer.addDoubleFieldToObj(UPPER, row.s_UpperBound, doc);
+    m_Writer.addDoubleFieldToObj(MEDIAN, row.s_Median, doc);
+    if (row.s_OverFieldValue != nullptr) {
+        if (!series.overFieldName().empty()) {
+            m_Writer.addStringFieldReferenceToObj(OVER_FIELD_NAME,
+                                                  series.overFieldName(), doc);
+            m_Writer.addStringFieldReferenceToObj(OVER_FIELD_VALUE,
+                                                  *row.s_OverFieldValue, doc, true);
+        }
+        m_Writer.addDoubleFieldToObj(ACTUAL, row.s_Actual, doc);
     }
-    m_Writer.addDoubleFieldToObj(LOWER, byData.s_LowerBound, doc);
-    m_Writer.addDoubleFieldToObj(UPPER, byData.s_UpperBound, doc);
-    m_Writer.addDoubleFieldToObj(MEDIAN, byData.s_Median, doc);
+
+    rapidjson::Value wrapper = m_Writer.makeObject();
+    m_Writer.addMember(MODEL_PLOT, doc, wrapper);
+    m_Writer.write(wrapper);
 }
 }
 }
@@ -9,7 +9,9 @@
 
 #include <maths/CTools.h>
 
+#include <algorithm>
 #include <fstream>
+#include <tuple>
 
 namespace ml {
 namespace api {
@@ -32,11 +34,15 @@ const std::string CResultNormalizer::INFLUENCER_LEVEL("infl");
 const std::string CResultNormalizer::ZERO("0");
 
 CResultNormalizer::CResultNormalizer(const model::CAnomalyDetectorModelConfig& modelConfig,
-                                     COutputHandler& outputHandler)
+                                     COutputHandler& outputHandler,
+                                     std::size_t blockSize,
+                                     std::size_t numberThreads)
     : m_ModelConfig(modelConfig), m_OutputHandler(outputHandler),
       m_WriteFieldNames(true),
       m_OutputFieldNormalizedScore(m_OutputFields[NORMALIZED_SCORE_NAME]),
-      m_Normalizer(m_ModelConfig) {
+      m_Normalizer(m_ModelConfig), m_BlockSize(blockSize),
+      m_ThreadPool(numberThreads) {
+    m_Block.reserve(m_BlockSize);
 }
 
 bool CResultNormalizer::initNormalizer(const std::string& stateFileName) {
@@ -68,67 +74,88 @@ bool CResultNormalizer::handleRecord(const TStrStrUMap& dataRowFields) {
         m_WriteFieldNames = false;
     }
 
-    std::string level;
-    std::string partition;
-    std::string partitionValue;
-    std::string person;
-    std::string personValue;
-    std::string function;
-    std::string valueFieldName;
-    double probability(0.0);
+    if (m_BlockSize > 0) {
+        m_Block.push_back(dataRowFields);
+        return m_Block.size() < m_BlockSize || this->normalizeBlock();
+    }
+
+    SRecord record;
+    this->initRecord(dataRowFields, record);
+    this->normalize(record);
+    return this->writeRecord(dataRowFields, record);
+}
+
+bool CResultNormalizer::finalise() {
+    return m_Block.empty() || this->normalizeBlock();
+}
 
+void CResultNormalizer::initRecord(const TStrStrUMap& dataRowFields, SRecord& record) const {
     // As of version 6.5 the 'personValue' field is required for (re)normalization to succeed.
     // In the case of renormalization the 'personValue' field must be included in the set of
     // parameters sent from the Java side ML plugin to Elasticsearch.
     // In production the version of the native code application and the java application it is communicating directly
     // with will always match so supporting BWC with versions prior to 6.5 is not necessary.
-    bool isNormalizable = this->parseDataFields(dataRowFields, level, partition,
-                                                partitionValue, person, personValue,
-                                                function, valueFieldName, probability);
-
-    LOG_TRACE(<< "level='" << level << "', partition='" << partition << "', partitionValue='"
-              << partitionValue << "', person='" << person << "', personValue='"
-              << personValue << "', function='" << function << "', value='"
-              << valueFieldName << "', probability='" << probability << "'");
-
-    if (isNormalizable) {
-        const model::CAnomalyScore::CNormalizer* levelNormalizer = nullptr;
-        double score = probability > m_ModelConfig.maximumAnomalousProbability()
-                           ? 0.0
-                           : maths::CTools::anomalyScore(probability);
-        if (level == ROOT_LEVEL) {
-            levelNormalizer = &m_Normalizer.bucketNormalizer();
-        } else if (level == LEAF_LEVEL) {
-            levelNormalizer = m_Normalizer.leafNormalizer(partition, person,
-                                                          function, valueFieldName);
-        } else if (level == PARTITION_LEVEL) {
-            levelNormalizer = m_Normalizer.partitionNormalizer(partition);
-        } else if (level == BUCKET_INFLUENCER_LEVEL) {
-            levelNormalizer = m_Normalizer.influencerBucketNormalizer(person);
-        } else if (level == INFLUENCER_LEVEL) {
-            levelNormalizer = m_Normalizer.influencerNormalizer(person);
-        } else {
-            LOG_ERROR(<< "Unexpected   : " << level);
-        }
-        if (levelNormalizer != nullptr) {
-            if (levelNormalizer->canNormalize()) {
-                if (levelNormalizer->normalize(score, partition, partitionValue,
-                                               person, personValue) == false) {
-                    LOG_ERROR(<< "Failed to normalize score " << score
-                              << " at level \"" << level << "\" using partitionId \""
-                              << (partition + "_" + partitionValue + "_" + person + "_" + personValue)
-                              << "\"");
-                }
-            }
-        } else {
-            LOG_ERROR(<< "No normalizer available"
-                         " at level '"
-                      << level << "' with partition field name '" << partition
-                      << "' and person field name '" << person << "'");
+    record.s_IsNormalizable = this->parseDataFields(dataRowFields, record);
+
+    LOG_TRACE(<< "level='" << record.s_Level << "', partition='" << record.s_Partition
+              << "', partitionValue='" << record.s_PartitionValue << "', person='"
+              << record.s_Person << "', personValue='" << record.s_PersonValue
+              << "', function='" << record.s_Function << "', value='" << record.s_ValueFieldName
+              << "', probability='" << record.s_Probability << "'");
+
+    if (record.s_IsNormalizable == false) {
+        return;
+    }
+
+    const model::CAnomalyScore::CNormalizer* levelNormalizer = nullptr;
+    record.s_Score = record.s_Probability > m_ModelConfig.maximumAnomalousProbability()
+                         ? 0.0
+                         : maths::CTools::anomalyScore(record.s_Probability);
+    if (record.s_Level == ROOT_LEVEL) {
+        levelNormalizer = &m_Normalizer.bucketNormalizer();
+    } else if (record.s_Level == LEAF_LEVEL) {
+        levelNormalizer = m_Normalizer.leafNormalizer(record.s_Partition, record.s_Person,
+                                                      record.s_Function,
+                                                      record.s_ValueFieldName);
+    } else if (record.s_Level == PARTITION_LEVEL) {
+        levelNormalizer = m_Normalizer.partitionNormalizer(record.s_Partition);
+    } else if (record.s_Level == BUCKET_INFLUENCER_LEVEL) {
+        levelNormalizer = m_Normalizer.influencerBucketNormalizer(record.s_Person);
+    } else if (record.s_Level == INFLUENCER_LEVEL) {
+        levelNormalizer = m_Normalizer.influencerNormalizer(record.s_Person);
+    } else {
+        LOG_ERROR(<< "Unexpected   : " << record.s_Level);
+    }
+    if (levelNormalizer != nullptr) {
+        if (levelNormalizer->canNormalize()) {
+            record.s_Normalizer = levelNormalizer;
         }
+    } else {
+        LOG_ERROR(<< "No normalizer available"
+                     " at level '"
+                  << record.s_Level << "' with partition field name '" << record.s_Partition
+                  << "' and person field name '" << record.s_Person << "'");
+    }
+}
+
+void CResultNormalizer::normalize(SRecord& record) const {
+    if (record.s_Normalizer != nullptr &&
+        record.s_Normalizer->normalize(record.s_Score, record.s_Partition,
+                                       record.s_PartitionValue, record.s_Person,
+                                       record.s_PersonValue) == false) {
+        LOG_ERROR(<< "Failed to normalize score " << record.s_Score << " at level \""
+                  << record.s_Level << "\" using partitionId \""
+                  << (record.s_Partition + "_" + record.s_PartitionValue + "_" +
+                      record.s_Person + "_" + record.s_PersonValue)
+                  << "\"");
+    }
+}
 
+bool CResultNormalizer::writeRecord(const TStrStrUMap& dataRowFields, const SRecord& record) {
+    if (record.s_IsNormalizable) {
         m_OutputFieldNormalizedScore =
-            (score > 0.0) ? core::CStringUtils::typeToStringPretty(score) : ZERO;
+            (record.s_Score > 0.0) ? core::CStringUtils::typeToStringPretty(record.s_Score)
+                                   : ZERO;
     } else {
         m_OutputFieldNormalizedScore.clear();
     }
@@ -141,23 +168,92 @@ bool CResultNormalizer::handleRecord(const TStrStrUMap& dataRowFields) {
     return true;
 }
 
-bool CResultNormalizer::parseDataFields(const TStrStrUMap& dataRowFields,
-                                        std::string& level,
-                                        std::string& partition,
-                                        std::string& partitionValue,
-                                        std::string& person,
-                                        std::string& personValue,
-                                        std::string& function,
-                                        std::string& valueFieldName,
-                                        double& probability) {
-    return this->parseDataField(dataRowFields, LEVEL, level) &&
-           this->parseDataField(dataRowFields, PARTITION_FIELD_NAME, partition) &&
-           this->parseDataField(dataRowFields, PARTITION_FIELD_VALUE, partitionValue) &&
-           this->parseDataField(dataRowFields, PERSON_FIELD_NAME, person) &&
-           this->parseDataField(dataRowFields, PERSON_FIELD_VALUE, personValue) &&
-           this->parseDataField(dataRowFields, FUNCTION_NAME, function) &&
-           this->parseDataField(dataRowFields, VALUE_FIELD_NAME, valueFieldName) &&
-           this->parseDataField(dataRowFields, PROBABILITY_NAME, probability);
+bool CResultNormalizer::normalizeBlock() {
+    using TSizeVec = std::vector<std::size_t>;
+    using TSizeSizePr = std::pair<std::size_t, std::size_t>;
+    using TSizeSizePrVec = std::vector<TSizeSizePr>;
+
+    std::size_t n{m_Block.size()};
+    LOG_TRACE(<< "Normalizing block of " << n << " records");
+
+    // Parsing the records and looking up their normalizers only reads
+    // the normalizer state so is done in parallel.
+    TRecordVec records(n);
+    m_ThreadPool.parallelForEach(n, [this, &records](std::size_t i) {
+        this->initRecord(m_Block[i], records[i]);
+    });
+
+    // Group the records which share a normalizer. Each group must also
+    // share partition and person field names.
+    auto key = [&records](std::size_t i) {
+        return std::tie(records[i].s_Normalizer, records[i].s_Partition, records[i].s_Person);
+    };
+    TSizeVec ordering;
+    ordering.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (records[i].s_Normalizer != nullptr) {
+            ordering.push_back(i);
+        }
+    }
+    std::stable_sort(ordering.begin(), ordering.end(),
+                     [&key](std::size_t lhs, std::size_t rhs) {
+                         return key(lhs) < key(rhs);
+                     });
+    TSizeSizePrVec groups;
+    for (std::size_t i = 0; i < ordering.size(); ++i) {
+        if (i == 0 || key(ordering[i - 1]) != key(ordering[i])) {
+            groups.emplace_back(i, i);
+        }
+        ++groups.back().second;
+    }
+    LOG_TRACE(<< "# groups = " << groups.size());
+
+    // Normalize each group with a single pass over its normalizer.
+    m_ThreadPool.parallelForEach(groups.size(), [&](std::size_t i) {
+        const SRecord& first{records[ordering[groups[i].first]]};
+        std::size_t size{groups[i].second - groups[i].first};
+        TDoubleVec scores;
+        model::CAnomalyScore::TStrCRefVec partitionValues;
+        model::CAnomalyScore::TStrCRefVec personValues;
+        scores.reserve(size);
+        partitionValues.reserve(size);
+        personValues.reserve(size);
+        for (std::size_t j = groups[i].first; j < groups[i].second; ++j) {
+            const SRecord& record{records[ordering[j]]};
+            scores.push_back(record.s_Score);
+            partitionValues.emplace_back(record.s_PartitionValue);
+            personValues.emplace_back(record.s_PersonValue);
+        }
+        if (first.s_Normalizer->normalizeEach(scores, first.s_Partition, partitionValues,
+                                              first.s_Person, personValues) == false) {
+            LOG_ERROR(<< "Failed to normalize " << size << " scores at level \""
+                      << first.s_Level << "\" for partition \"" << first.s_Partition
+                      << "\" and person \"" << first.s_Person << "\"");
+            return;
+        }
+        for (std::size_t j = groups[i].first; j < groups[i].second; ++j) {
+            records[ordering[j]].s_Score = scores[j - groups[i].first];
+        }
+    });
+
+    bool result{true};
+    for (std::size_t i = 0; i < n; ++i) {
+        result = this->writeRecord(m_Block[i], records[i]) && result;
+    }
+    m_Block.clear();
+
+    return result;
+}
+
+bool CResultNormalizer::parseDataFields(const TStrStrUMap& dataRowFields, SRecord& record) const {
+    return this->parseDataField(dataRowFields, LEVEL, record.s_Level) &&
+           this->parseDataField(dataRowFields, PARTITION_FIELD_NAME, record.s_Partition) &&
+           this->parseDataField(dataRowFields, PARTITION_FIELD_VALUE, record.s_PartitionValue) &&
+           this->parseDataField(dataRowFields, PERSON_FIELD_NAME, record.s_Person) &&
+           this->parseDataField(dataRowFields, PERSON_FIELD_VALUE, record.s_PersonValue) &&
+           this->parseDataField(dataRowFields, FUNCTION_NAME, record.s_Function) &&
+           this->parseDataField(dataRowFields, VALUE_FIELD_NAME, record.s_ValueFieldName) &&
+           this->parseDataField(dataRowFields, PROBABILITY_NAME, record.s_Probability);
 }
 }
 }
@@ -0,0 +1,425 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CJobHostTest.h"
+
+#include <core/CContainerPrinter.h>
+#include <core/CLogger.h>
+#include <core/CStatistics.h>
+#include <core/CStringUtils.h>
+
+#include <maths/CSampling.h>
+
+#include <api/CDataProcessor.h>
+#include <api/CInputParser.h>
+#include <api/CJobHost.h>
+#include <api/CNullOutput.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using TDoubleVec = std::vector<double>;
+using TSizeVec = std::vector<std::size_t>;
+using TStrVec = std::vector<std::string>;
+using TStrStrUMap = ml::api::CDataProcessor::TStrStrUMap;
+
+const std::string VALUE("value");
+
+//! \brief Supplies records as the test adds them.
+class CTestInputParser : public ml::api::CInputParser {
+public:
+    CTestInputParser() : m_Closed(false) {}
+
+    void add(std::size_t value) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Values.push_back(value);
+        }
+        m_Condition.notify_one();
+    }
+
+    void close() {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Closed = true;
+        }
+        m_Condition.notify_one();
+    }
+
+    virtual bool readStream(const TReaderFunc& readerFunc) {
+        TStrStrUMap record;
+        for (;;) {
+            std::size_t value(0);
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Condition.wait(lock, [this] { return m_Closed || m_Values.size() > 0; });
+                if (m_Values.empty()) {
+                    return true;
+                }
+                value = m_Values.front();
+                m_Values.pop_front();
+            }
+            record[VALUE] = ml::core::CStringUtils::typeToString(value);
+            if (readerFunc(record) == false) {
+                return false;
+            }
+        }
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<std::size_t> m_Values;
+    bool m_Closed;
+};
+
+//! \brief Records the values it's passed.
+class CTestDataProcessor : public ml::api::CDataProcessor {
+public:
+    using TTrace = std::pair<std::mutex, TStrVec>;
+
+public:
+    CTestDataProcessor(const std::string& id, TTrace* trace)
+        : m_Id(id), m_Trace(trace), m_ThrowAt(-1), m_RejectAt(-1), m_Finalised(0) {}
+
+    void throwAt(int record) { m_ThrowAt = record; }
+    void rejectAt(int record) { m_RejectAt = record; }
+
+    const TSizeVec& values() const { return m_Values; }
+    const TDoubleVec& samples() const { return m_Samples; }
+    std::size_t finalised() const { return m_Finalised; }
+
+    virtual void newOutputStream() {}
+
+    virtual bool handleRecord(const TStrStrUMap& dataRowFields) {
+        int record(static_cast<int>(m_Values.size()));
+        if (record == m_ThrowAt) {
+            throw std::runtime_error("test failure");
+        }
+        if (record == m_RejectAt) {
+            return false;
+        }
+        std::size_t value(0);
+        ml::core::CStringUtils::stringToType(dataRowFields.find(VALUE)->second, value);
+        m_Values.push_back(value);
+        ml::core::CStatistics::stat(ml::stat_t::E_NumberApiRecordsHandled).increment();
+        m_Samples.push_back(ml::maths::CSampling::uniformSample(0.0, 1.0));
+        if (m_Trace != nullptr) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            std::unique_lock<std::mutex> lock(m_Trace->first);
+            m_Trace->second.push_back(m_Id);
+        }
+        return true;
+    }
+
+    virtual void finalise() { ++m_Finalised; }
+
+    virtual bool restoreState(ml::core::CDataSearcher&, ml::core_t::TTime&) {
+        return true;
+    }
+
+    virtual bool persistState(ml::core::CDataAdder&) { return true; }
+
+    virtual uint64_t numRecordsHandled() const { return m_Values.size(); }
+
+    virtual ml::api::COutputHandler& outputHandler() { return m_Output; }
+
+private:
+    std::string m_Id;
+    TTrace* m_Trace;
+    int m_ThrowAt;
+    int m_RejectAt;
+    TSizeVec m_Values;
+    TDoubleVec m_Samples;
+    std::size_t m_Finalised;
+    ml::api::CNullOutput m_Output;
+};
+
+//! \brief The outcome of a test job, which outlives the job.
+struct SOutcome {
+    SOutcome()
+        : s_Finished(0), s_Succeeded(false), s_Finalised(0), s_RecordsHandled(0) {}
+
+    std::size_t s_Finished;
+    bool s_Succeeded;
+    TSizeVec s_Values;
+    std::size_t s_Finalised;
+    TDoubleVec s_Samples;
+    uint64_t s_RecordsHandled;
+};
+
+class CTestJob : public ml::api::CJobHost::CJob {
+public:
+    CTestJob(const std::string& id, SOutcome& outcome, CTestDataProcessor::TTrace* trace = nullptr)
+        : m_Outcome(outcome), m_Processor(id, trace) {}
+
+    CTestInputParser& testInputParser() { return m_InputParser; }
+    CTestDataProcessor& testProcessor() { return m_Processor; }
+
+    virtual ml::core::CDataSearcher* restoreSearcher() { return nullptr; }
+    virtual ml::core::CDataAdder* persister() { return nullptr; }
+    virtual ml::api::CInputParser& inputParser() { return m_InputParser; }
+    virtual ml::api::CDataProcessor& processor() { return m_Processor; }
+
+    virtual void finished(bool succeeded) {
+        ++m_Outcome.s_Finished;
+        m_Outcome.s_Succeeded = succeeded;
+        m_Outcome.s_Values = m_Processor.values();
+        m_Outcome.s_Finalised = m_Processor.finalised();
+        m_Outcome.s_Samples = m_Processor.samples();
+        m_Outcome.s_RecordsHandled =
+            ml::core::CStatistics::stat(ml::stat_t::E_NumberApiRecordsHandled).value();
+    }
+
+private:
+    SOutcome& m_Outcome;
+    CTestInputParser m_InputParser;
+    CTestDataProcessor m_Processor;
+};
+
+using TTestJobUPtr = std::unique_ptr<CTestJob>;
+}
+
+CppUnit::Test* CJobHostTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CJobHostTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJobHostTest>(
+        "CJobHostTest::testManyJobs", &CJobHostTest::testManyJobs));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJobHostTest>(
+        "CJobHostTest::testFairness", &CJobHostTest::testFairness));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJobHostTest>(
+        "CJobHostTest::testFailureIsolation", &CJobHostTest::testFailureIsolation));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJobHostTest>(
+        "CJobHostTest::testDuplicateIds", &CJobHostTest::testDuplicateIds));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJobHostTest>(
+        "CJobHostTest::testStaticsIsolation", &CJobHostTest::testStaticsIsolation));
+
+    return suiteOfTests;
+}
+
+void CJobHostTest::testManyJobs() {
+    // Check that every job sees all its records in order and is finalised
+    // and finished exactly once.
+
+    std::size_t numberJobs(20);
+    std::size_t numberRecords(500);
+
+    std::vector<SOutcome> outcomes(numberJobs);
+    {
+        ml::api::CJobHost host(2, 10);
+
+        for (std::size_t i = 0; i < numberJobs; ++i) {
+            std::string id("job" + ml::core::CStringUtils::typeToString(i));
+            TTestJobUPtr job(new CTestJob(id, outcomes[i]));
+            CTestInputParser& input(job->testInputParser());
+            CPPUNIT_ASSERT(host.start(id, std::move(job)));
+            for (std::size_t j = 0; j < numberRecords; ++j) {
+                input.add(j);
+            }
+            input.close();
+        }
+
+        host.waitForAll();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), host.numberJobs());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), host.numberFailed());
+    }
+
+    for (const auto& outcome : outcomes) {
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), outcome.s_Finished);
+        CPPUNIT_ASSERT(outcome.s_Succeeded);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), outcome.s_Finalised);
+        CPPUNIT_ASSERT_EQUAL(numberRecords, outcome.s_Values.size());
+        for (std::size_t j = 0; j < numberRecords; ++j) {
+            CPPUNIT_ASSERT_EQUAL(j, outcome.s_Values[j]);
+        }
+    }
+}
+
+void CJobHostTest::testFairness() {
+    // Check that with one thread busy jobs take turns of at most the
+    // quantum whilst they all have records waiting.
+
+    std::size_t quantum(5);
+    std::size_t numberRecords(100);
+
+    CTestDataProcessor::TTrace trace;
+    std::vector<SOutcome> outcomes(3);
+    {
+        ml::api::CJobHost host(1, quantum);
+        for (std::size_t i = 0; i < outcomes.size(); ++i) {
+            std::string id(1, static_cast<char>('a' + i));
+            TTestJobUPtr job(new CTestJob(id, outcomes[i], &trace));
+            CTestInputParser& input(job->testInputParser());
+            for (std::size_t j = 0; j < numberRecords; ++j) {
+                input.add(j);
+            }
+            input.close();
+            CPPUNIT_ASSERT(host.start(id, std::move(job)));
+        }
+        host.waitForAll();
+    }
+
+    const TStrVec& ids(trace.second);
+    CPPUNIT_ASSERT_EQUAL(outcomes.size() * numberRecords, ids.size());
+
+    // Check from when all the jobs have started until the first job runs
+    // out of records.
+    std::size_t begin(ids.size());
+    std::size_t end(ids.size());
+    TSizeVec counts(outcomes.size(), 0);
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        std::size_t& count(counts[ids[i][0] - 'a']);
+        if (++count == 1 && std::count(counts.begin(), counts.end(), 0) == 0) {
+            begin = i;
+        }
+        if (count == numberRecords) {
+            end = i;
+            break;
+        }
+    }
+    LOG_DEBUG(<< "checking records " << begin << " to " << end);
+    CPPUNIT_ASSERT(end > begin + numberRecords);
+
+    std::size_t longest(0);
+    for (std::size_t i = begin, run = 0; i < end; ++i) {
+        run = (i > begin && ids[i] == ids[i - 1]) ? run + 1 : 1;
+        longest = std::max(longest, run);
+    }
+    LOG_DEBUG(<< "longest turn = " << longest);
+    CPPUNIT_ASSERT(longest <= quantum);
+}
+
+void CJobHostTest::testFailureIsolation() {
+    // Check that a job which throws or rejects a record fails without
+    // affecting the other jobs.
+
+    std::size_t numberRecords(200);
+
+    std::vector<SOutcome> outcomes(4);
+    {
+        ml::api::CJobHost host(2, 10);
+        for (std::size_t i = 0; i < outcomes.size(); ++i) {
+            std::string id("job" + ml::core::CStringUtils::typeToString(i));
+            TTestJobUPtr job(new CTestJob(id, outcomes[i]));
+            if (i == 1) {
+                job->testProcessor().throwAt(50);
+            } else if (i == 2) {
+                job->testProcessor().rejectAt(100);
+            }
+            CTestInputParser& input(job->testInputParser());
+            CPPUNIT_ASSERT(host.start(id, std::move(job)));
+            for (std::size_t j = 0; j < numberRecords; ++j) {
+                input.add(j);
+            }
+            input.close();
+        }
+        host.waitForAll();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), host.numberFailed());
+    }
+
+    for (std::size_t i = 0; i < outcomes.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), outcomes[i].s_Finished);
+    }
+    CPPUNIT_ASSERT(outcomes[0].s_Succeeded);
+    CPPUNIT_ASSERT(outcomes[1].s_Succeeded == false);
+    CPPUNIT_ASSERT(outcomes[2].s_Succeeded == false);
+    CPPUNIT_ASSERT(outcomes[3].s_Succeeded);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(50), outcomes[1].s_Values.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), outcomes[2].s_Values.size());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), outcomes[1].s_Finalised);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), outcomes[2].s_Finalised);
+    CPPUNIT_ASSERT_EQUAL(numberRecords, outcomes[0].s_Values.size());
+    CPPUNIT_ASSERT_EQUAL(numberRecords, outcomes[3].s_Values.size());
+}
+
+void CJobHostTest::testDuplicateIds() {
+    // Check that a job ID can't be reused until the job is removed.
+
+    SOutcome outcome1;
+    SOutcome outcome2;
+    SOutcome outcome3;
+    {
+        ml::api::CJobHost host(1);
+
+        TTestJobUPtr job1(new CTestJob("job", outcome1));
+        CTestInputParser& input1(job1->testInputParser());
+        CPPUNIT_ASSERT(host.start("job", std::move(job1)));
+        input1.add(1);
+
+        CPPUNIT_ASSERT(host.start("job", TTestJobUPtr(new CTestJob("job", outcome2))) == false);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), host.numberJobs());
+
+        input1.close();
+        host.waitForAll();
+
+        TTestJobUPtr job3(new CTestJob("job", outcome3));
+        CTestInputParser& input3(job3->testInputParser());
+        CPPUNIT_ASSERT(host.start("job", std::move(job3)));
+        input3.add(2);
+        input3.close();
+        host.waitForAll();
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), outcome1.s_Finished);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), outcome2.s_Finished);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), outcome3.s_Finished);
+    CPPUNIT_ASSERT_EQUAL(std::string("[1]"), ml::core::CContainerPrinter::print(outcome1.s_Values));
+    CPPUNIT_ASSERT_EQUAL(std::string("[2]"), ml::core::CContainerPrinter::print(outcome3.s_Values));
+}
+
+void CJobHostTest::testStaticsIsolation() {
+    // Check that each job's statistics and random numbers, which are
+    // persisted with its state, only depend on its own records.
+
+    uint64_t processRecordsHandled(
+        ml::core::CStatistics::stat(ml::stat_t::E_NumberApiRecordsHandled).value());
+
+    TSizeVec numberRecords{50, 120, 200, 75};
+
+    std::vector<SOutcome> outcomes(numberRecords.size());
+    {
+        ml::api::CJobHost host(2, 10);
+        for (std::size_t i = 0; i < outcomes.size(); ++i) {
+            std::string id("job" + ml::core::CStringUtils::typeToString(i));
+            TTestJobUPtr job(new CTestJob(id, outcomes[i]));
+            CTestInputParser& input(job->testInputParser());
+            CPPUNIT_ASSERT(host.start(id, std::move(job)));
+            for (std::size_t j = 0; j < numberRecords[i]; ++j) {
+                input.add(j);
+            }
+            input.close();
+        }
+        host.waitForAll();
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), host.numberFailed());
+    }
+
+    for (std::size_t i = 0; i < outcomes.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(uint64_t(numberRecords[i]), outcomes[i].s_RecordsHandled);
+
+        // This is what the job would sample if it ran in its own process.
+        ml::maths::CSampling::CContext context;
+        ml::maths::CSampling::CScopedContext scope(context);
+        TDoubleVec expected;
+        for (std::size_t j = 0; j < numberRecords[i]; ++j) {
+            expected.push_back(ml::maths::CSampling::uniformSample(0.0, 1.0));
+        }
+        CPPUNIT_ASSERT_EQUAL(ml::core::CContainerPrinter::print(expected),
+                             ml::core::CContainerPrinter::print(outcomes[i].s_Samples));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(
+        processRecordsHandled,
+        ml::core::CStatistics::stat(ml::stat_t::E_NumberApiRecordsHandled).value());
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_CJobHostTest_h
+#define INCLUDED_CJobHostTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CJobHostTest : public CppUnit::TestFixture {
+public:
+    void testManyJobs();
+    void testFairness();
+    void testFailureIsolation();
+    void testDuplicateIds();
+    void testStaticsIsolation();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CJobHostTest_h
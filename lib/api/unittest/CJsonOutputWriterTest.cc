@@ -28,12 +28,14 @@
 
 #include <boost/ref.hpp>
 
+#include <future>
 #include <set>
 #include <sstream>
 #include <string>
 
 using TDouble1Vec = ml::core::CSmallVector<double, 1>;
 using TStr1Vec = ml::core::CSmallVector<std::string, 1>;
+using TStrVec = std::vector<std::string>;
 const TStr1Vec EMPTY_STRING_LIST;
 
 CppUnit::Test* CJsonOutputWriterTest::suite() {
@@ -77,6 +79,11 @@ CppUnit::Test* CJsonOutputWriterTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CJsonOutputWriterTest>(
         "CJsonOutputWriterTest::testWriteScheduledEvent",
         &CJsonOutputWriterTest::testWriteScheduledEvent));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJsonOutputWriterTest>(
+        "CJsonOutputWriterTest::testOutputOrdering", &CJsonOutputWriterTest::testOutputOrdering));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CJsonOutputWriterTest>(
+        "CJsonOutputWriterTest::testInfluencesOutliveStringStore",
+        &CJsonOutputWriterTest::testInfluencesOutliveStringStore));
     suiteOfTests->addTest(new CppUnit::TestCaller<CJsonOutputWriterTest>(
         "CJsonOutputWriterTest::testThroughputWithScopedAllocator",
         &CJsonOutputWriterTest::testThroughputWithScopedAllocator));
@@ -1666,6 +1673,161 @@ void CJsonOutputWriterTest::testWriteScheduledEvent() {
                          std::string(events[rapidjson::SizeType(1)].GetString()));
 }
 
+void CJsonOutputWriterTest::testOutputOrdering() {
+    // Results are serialised on the output stream's thread. Check that
+    // they are interleaved with everything else written to the stream in
+    // the order the calls were made and that they have been written when
+    // a flush is acknowledged.
+
+    std::ostringstream sstream;
+
+    std::string function("mean");
+    std::string functionDescription("mean(responsetime)");
+    std::string emptyString;
+    ml::api::CHierarchicalResultsWriter::TStoredStringPtrStoredStringPtrPrDoublePrVec influences;
+
+    TStrVec expectedKeys;
+    {
+        ml::core::CJsonOutputStreamWrapper outputStream(sstream);
+        ml::api::CJsonOutputWriter writer("job", outputStream);
+        ml::core::CRapidJsonConcurrentLineWriter otherWriter(outputStream);
+
+        for (ml::core_t::TTime time = 1; time <= 50; ++time) {
+            ml::api::CHierarchicalResultsWriter::SResults result(
+                false, true, emptyString, emptyString, emptyString, emptyString,
+                emptyString, emptyString, emptyString, time, function,
+                functionDescription, TDouble1Vec(1, 10.0), TDouble1Vec(1, 20.0),
+                2.24, 0.5, 0.001, 30, emptyString, influences, false, false, 1, 100);
+
+            CPPUNIT_ASSERT(writer.acceptResult(result));
+            writer.acceptBucketTimeInfluencer(time, 0.001, 2.24, 0.5);
+            CPPUNIT_ASSERT(writer.endOutputBatch(time % 2 == 0, 10U));
+            expectedKeys.push_back("records");
+            expectedKeys.push_back("bucket");
+
+            otherWriter.StartObject();
+            otherWriter.String("other");
+            otherWriter.Int64(time);
+            otherWriter.EndObject();
+            expectedKeys.push_back("other");
+
+            if (time % 10 == 0) {
+                writer.acknowledgeFlush(std::to_string(time), time);
+                expectedKeys.push_back("flush");
+                outputStream.syncFlush();
+
+                // The flushed results must be in the stream.
+                std::string output{sstream.str()};
+                CPPUNIT_ASSERT(output.find("\"id\":\"" + std::to_string(time) + "\"") !=
+                               std::string::npos);
+                CPPUNIT_ASSERT(output.find("\"timestamp\":" + std::to_string(time * 1000)) !=
+                               std::string::npos);
+            }
+        }
+        writer.finalise();
+    }
+
+    rapidjson::Document arrayDoc;
+    arrayDoc.Parse<rapidjson::kParseDefaultFlags>(sstream.str().c_str());
+    CPPUNIT_ASSERT(arrayDoc.IsArray());
+    CPPUNIT_ASSERT_EQUAL(static_cast<rapidjson::SizeType>(expectedKeys.size()),
+                         arrayDoc.Size());
+
+    ml::core_t::TTime time{1};
+    for (rapidjson::SizeType i = 0; i < arrayDoc.Size(); ++i) {
+        const rapidjson::Value& document = arrayDoc[i];
+        CPPUNIT_ASSERT(document.IsObject());
+        CPPUNIT_ASSERT_EQUAL(rapidjson::SizeType(1), document.MemberCount());
+        std::string key{document.MemberBegin()->name.GetString()};
+        CPPUNIT_ASSERT_EQUAL(expectedKeys[i], key);
+        if (key == "bucket") {
+            const rapidjson::Value& bucket = document["bucket"];
+            CPPUNIT_ASSERT_EQUAL(time * 1000, bucket["timestamp"].GetInt64());
+            CPPUNIT_ASSERT_EQUAL(time % 2 == 0, bucket.HasMember("is_interim"));
+        } else if (key == "other") {
+            CPPUNIT_ASSERT_EQUAL(time, document["other"].GetInt64());
+            ++time;
+        }
+    }
+}
+
+void CJsonOutputWriterTest::testInfluencesOutliveStringStore() {
+    // Results are serialised on the output stream's thread after the
+    // string store may have been pruned. Check that the influencer values
+    // are still written correctly.
+
+    using TStoredStringPtrStoredStringPtrPrDoublePrVec =
+        ml::api::CHierarchicalResultsWriter::TStoredStringPtrStoredStringPtrPrDoublePrVec;
+
+    std::ostringstream sstream;
+
+    std::string fieldName("responsetime");
+    std::string function("mean");
+    std::string functionDescription("mean(responsetime)");
+    std::string emptyString;
+    std::string influencerName("pruned_influencer_name");
+    std::string influencerValue("pruned_influencer_value_which_is_long");
+
+    {
+        ml::core::CJsonOutputStreamWrapper outputStream(sstream);
+        ml::api::CJsonOutputWriter writer("job", outputStream);
+
+        // Stop the stream's thread writing until the strings have gone.
+        std::promise<void> pruned;
+        std::shared_future<void> waitForPrune(pruned.get_future().share());
+        outputStream.writeAsync(
+            [waitForPrune](ml::core::CJsonOutputStreamWrapper::CAsyncLineWriter&) {
+                waitForPrune.wait();
+            });
+
+        {
+            TStoredStringPtrStoredStringPtrPrDoublePrVec influences;
+            influences.emplace_back(
+                ml::api::CHierarchicalResultsWriter::TStoredStringPtrStoredStringPtrPr(
+                    ml::model::CStringStore::influencers().get(influencerName),
+                    ml::model::CStringStore::influencers().get(influencerValue)),
+                0.9);
+
+            ml::api::CHierarchicalResultsWriter::SResults result(
+                ml::api::CHierarchicalResultsWriter::E_Result, emptyString,
+                emptyString, emptyString, emptyString, emptyString, 1, function,
+                functionDescription, 42.0, 79, TDouble1Vec(1, 6953.0),
+                TDouble1Vec(1, 10090.0), 0.0, 0.1, 0.1, fieldName, influences,
+                false, true, 1, 100, EMPTY_STRING_LIST);
+
+            CPPUNIT_ASSERT(writer.acceptResult(result));
+            CPPUNIT_ASSERT(writer.endOutputBatch(false, 1U));
+        }
+
+        ml::model::CStringStore::tidyUp();
+        // Reuse the memory the pruned strings occupied.
+        ml::model::CStringStore::influencers().get(std::string(influencerName.size(), 'x'));
+        ml::model::CStringStore::influencers().get(std::string(influencerValue.size(), 'x'));
+
+        pruned.set_value();
+        writer.finalise();
+    }
+    ml::model::CStringStore::tidyUp();
+
+    rapidjson::Document doc;
+    std::string out = sstream.str();
+    LOG_DEBUG(<< "Results:\n" << out);
+    doc.Parse<rapidjson::kParseDefaultFlags>(out);
+    CPPUNIT_ASSERT(doc.IsArray());
+
+    CPPUNIT_ASSERT(doc[rapidjson::SizeType(0)].HasMember("records"));
+    const rapidjson::Value& records = doc[rapidjson::SizeType(0)]["records"];
+    CPPUNIT_ASSERT_EQUAL(rapidjson::SizeType(1), records.Size());
+    const rapidjson::Value& influencers = records[rapidjson::SizeType(0)]["influencers"];
+    CPPUNIT_ASSERT_EQUAL(rapidjson::SizeType(1), influencers.Size());
+    const rapidjson::Value& influencer = influencers[rapidjson::SizeType(0)];
+    CPPUNIT_ASSERT_EQUAL(influencerName,
+                         std::string(influencer["influencer_field_name"].GetString()));
+    const rapidjson::Value& values = influencer["influencer_field_values"];
+    CPPUNIT_ASSERT_EQUAL(rapidjson::SizeType(1), values.Size());
+    CPPUNIT_ASSERT_EQUAL(influencerValue, std::string(values[rapidjson::SizeType(0)].GetString()));
+}
+
 void CJsonOutputWriterTest::testThroughputWithScopedAllocator() {
     this->testThroughputHelper(true);
 }
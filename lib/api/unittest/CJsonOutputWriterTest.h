@@ -24,6 +24,8 @@ public:
     void testPersistNormalizer();
     void testReportMemoryUsage();
     void testWriteScheduledEvent();
+    void testOutputOrdering();
+    void testInfluencesOutliveStringStore();
     void testThroughputWithScopedAllocator();
     void testThroughputWithoutScopedAllocator();
 
@@ -21,6 +21,9 @@ CppUnit::Test* CModelPlotDataJsonWriterTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CModelPlotDataJsonWriterTest>(
         "CModelPlotDataJsonWriterTest::testWriteFlat",
         &CModelPlotDataJsonWriterTest::testWriteFlat));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CModelPlotDataJsonWriterTest>(
+        "CModelPlotDataJsonWriterTest::testWriteRows",
+        &CModelPlotDataJsonWriterTest::testWriteRows));
 
     return suiteOfTests;
 }
@@ -74,3 +77,62 @@ void CModelPlotDataJsonWriterTest::testWriteFlat() {
     CPPUNIT_ASSERT(modelPlot.HasMember("bucket_span"));
     CPPUNIT_ASSERT_EQUAL(int64_t(300), modelPlot["bucket_span"].GetInt64());
 }
+
+void CModelPlotDataJsonWriterTest::testWriteRows() {
+    // Check that streamed rows are written identically to the same rows
+    // collected in a CModelPlotData object.
+
+    ml::model::CModelPlotData series(1, "", "", "oName", "bName", 300, 2);
+
+    std::string byFieldValue{"bValue"};
+    std::string overFieldValue1{"oValue1"};
+    std::string overFieldValue2{"oValue2"};
+    ml::model::CModelPlotData::SRow rows[]{
+        {ml::model_t::E_PopulationMeanByPersonAndAttribute, &byFieldValue, 1.0,
+         2.0, 1.5, &overFieldValue1, 1.2},
+        {ml::model_t::E_PopulationMeanByPersonAndAttribute, &byFieldValue, 1.0,
+         2.0, 1.5, &overFieldValue2, 3.5}};
+
+    std::ostringstream streamed;
+    {
+        ml::core::CJsonOutputStreamWrapper outputStream(streamed);
+        ml::api::CModelPlotDataJsonWriter writer(outputStream);
+        for (const auto& row : rows) {
+            writer.writeRow("job-id", series, row);
+        }
+    }
+
+    std::ostringstream flat;
+    {
+        ml::core::CJsonOutputStreamWrapper outputStream(flat);
+        ml::api::CModelPlotDataJsonWriter writer(outputStream);
+        ml::model::CModelPlotData plotData{series};
+        for (const auto& row : rows) {
+            plotData.addRow(row);
+        }
+        writer.writeFlat("job-id", plotData);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(flat.str(), streamed.str());
+
+    rapidjson::Document doc;
+    doc.Parse<rapidjson::kParseDefaultFlags>(streamed.str());
+    CPPUNIT_ASSERT(!doc.HasParseError());
+    CPPUNIT_ASSERT_EQUAL(rapidjson::SizeType(2), doc.Size());
+    for (rapidjson::SizeType i = 0; i < doc.Size(); ++i) {
+        const rapidjson::Value& modelPlot = doc[i]["model_plot"];
+        CPPUNIT_ASSERT_EQUAL(std::string("job-id"),
+                             std::string(modelPlot["job_id"].GetString()));
+        CPPUNIT_ASSERT_EQUAL(2, modelPlot["detector_index"].GetInt());
+        CPPUNIT_ASSERT(modelPlot.HasMember("partition_field_name") == false);
+        CPPUNIT_ASSERT_EQUAL(std::string("bValue"),
+                             std::string(modelPlot["by_field_value"].GetString()));
+        CPPUNIT_ASSERT_EQUAL(std::string("oName"),
+                             std::string(modelPlot["over_field_name"].GetString()));
+        CPPUNIT_ASSERT_EQUAL(*rows[i].s_OverFieldValue,
+                             std::string(modelPlot["over_field_value"].GetString()));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, modelPlot["model_median"].GetDouble(), 1e-10);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(rows[i].s_Actual,
+                                     modelPlot["actual"].GetDouble(), 1e-10);
+    }
+}
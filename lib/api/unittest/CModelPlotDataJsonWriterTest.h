@@ -11,6 +11,7 @@
 class CModelPlotDataJsonWriterTest : public CppUnit::TestFixture {
 public:
     void testWriteFlat();
+    void testWriteRows();
 
     static CppUnit::Test* suite();
 };
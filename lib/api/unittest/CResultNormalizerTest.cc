@@ -31,6 +31,10 @@ CppUnit::Test* CResultNormalizerTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CResultNormalizerTest>(
         "CResultNormalizerTest::testInitNormalizer", &CResultNormalizerTest::testInitNormalizer));
 
+    suiteOfTests->addTest(new CppUnit::TestCaller<CResultNormalizerTest>(
+        "CResultNormalizerTest::testBlockNormalization",
+        &CResultNormalizerTest::testBlockNormalization));
+
     return suiteOfTests;
 }
 
@@ -552,3 +556,51 @@ void CResultNormalizerTest::testInitNormalizer() {
                              std::string(doc["normalized_score"].GetString()));
     }
 }
+
+void CResultNormalizerTest::testBlockNormalization() {
+    // Check that normalizing in blocks, on one or more threads, gives
+    // identical results, in the same order, to normalizing one record
+    // at a time.
+
+    using TDocumentVec = std::vector<rapidjson::Document>;
+
+    ml::model::CAnomalyDetectorModelConfig modelConfig =
+        ml::model::CAnomalyDetectorModelConfig::defaultConfig(900);
+
+    auto normalize = [&modelConfig](std::size_t blockSize, std::size_t numberThreads) {
+        ml::api::CLineifiedJsonOutputWriter outputWriter;
+        ml::api::CResultNormalizer normalizer(modelConfig, outputWriter,
+                                              blockSize, numberThreads);
+        CPPUNIT_ASSERT(normalizer.initNormalizer("testfiles/new_quantilesState.json"));
+
+        std::ifstream inputStrm("testfiles/new_normalizerInput.csv");
+        ml::api::CCsvInputParser inputParser(inputStrm, ml::api::CCsvInputParser::COMMA);
+        CPPUNIT_ASSERT(inputParser.readStream(
+            boost::bind(&ml::api::CResultNormalizer::handleRecord, &normalizer, _1)));
+        CPPUNIT_ASSERT(normalizer.finalise());
+
+        // The field order can differ so compare the parsed documents.
+        TDocumentVec resultDocs;
+        std::stringstream ss(outputWriter.internalString());
+        std::string docString;
+        while (std::getline(ss, docString)) {
+            resultDocs.emplace_back();
+            resultDocs.back().Parse<rapidjson::kParseDefaultFlags>(docString.c_str());
+        }
+        return resultDocs;
+    };
+
+    TDocumentVec expected{normalize(0, 1)};
+    CPPUNIT_ASSERT_EQUAL(TDocumentVec::size_type{327}, expected.size());
+
+    for (std::size_t blockSize : {1, 50, 10000}) {
+        for (std::size_t numberThreads : {1, 4}) {
+            LOG_DEBUG(<< "block size = " << blockSize << ", # threads = " << numberThreads);
+            TDocumentVec actual{normalize(blockSize, numberThreads)};
+            CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                CPPUNIT_ASSERT(expected[i] == actual[i]);
+            }
+        }
+    }
+}
@@ -12,6 +12,7 @@ class CResultNormalizerTest : public CppUnit::TestFixture {
 public:
     void testInitNormalizerPartitioned();
     void testInitNormalizer();
+    void testBlockNormalization();
 
     static CppUnit::Test* suite();
 };
@@ -18,6 +18,7 @@
 #include "CFieldDataTyperTest.h"
 #include "CForecastRunnerTest.h"
 #include "CIoManagerTest.h"
+#include "CJobHostTest.h"
 #include "CJsonOutputWriterTest.h"
 #include "CLengthEncodedInputParserTest.h"
 #include "CLineifiedJsonInputParserTest.h"
@@ -51,6 +52,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CFieldDataTyperTest::suite());
     runner.addTest(CForecastRunnerTest::suite());
     runner.addTest(CIoManagerTest::suite());
+    runner.addTest(CJobHostTest::suite());
     runner.addTest(CJsonOutputWriterTest::suite());
     runner.addTest(CLengthEncodedInputParserTest::suite());
     runner.addTest(CLineifiedJsonInputParserTest::suite());
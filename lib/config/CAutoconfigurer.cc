@@ -7,6 +7,7 @@
 #include <config/CAutoconfigurer.h>
 
 #include <core/CStringUtils.h>
+#include <core/CThreadPool.h>
 #include <core/CTimeUtils.h>
 #include <core/Constants.h>
 
@@ -15,6 +16,7 @@
 #include <config/CAutoconfigurerDetectorPenalties.h>
 #include <config/CAutoconfigurerFieldRolePenalties.h>
 #include <config/CAutoconfigurerParams.h>
+#include <config/CColumnarRecordBuffer.h>
 #include <config/CDataCountStatistics.h>
 #include <config/CDetectorEnumerator.h>
 #include <config/CDetectorRecord.h>
@@ -22,6 +24,7 @@
 #include <config/CFieldRolePenalty.h>
 #include <config/CFieldStatistics.h>
 #include <config/CReportWriter.h>
+#include <config/CTimeStratifiedSample.h>
 #include <config/ConfigTypes.h>
 #include <config/Constants.h>
 
@@ -30,7 +33,9 @@
 #include <boost/range.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -48,6 +53,10 @@ bool reportProgress(uint64_t records) {
 
 const std::size_t UPDATE_SCORE_RECORD_COUNT_INTERVAL = 50000;
 const core_t::TTime UPDATE_SCORE_TIME_INTERVAL = 172800;
+//! The maximum number of detector records to create in one batch.
+const std::size_t MAXIMUM_BATCH_DETECTOR_RECORDS = 262144;
+//! The maximum number of records to update the statistics with in one batch.
+const std::size_t MAXIMUM_BATCH_SIZE = 256;
 }
 
 //! \brief The implementation of automatic configuration.
@@ -73,8 +82,10 @@ public:
     uint64_t numRecordsHandled() const;
 
 private:
-    using TTimeStrStrUMapPr = std::pair<core_t::TTime, TStrStrUMap>;
-    using TTimeStrStrUMapPrVec = std::vector<TTimeStrStrUMapPr>;
+    using TStrStrUMapVec = std::vector<TStrStrUMap>;
+    using TTimeStratifiedSampleUPtr = std::unique_ptr<CTimeStratifiedSample>;
+    using TSizeVec = std::vector<std::size_t>;
+    using TSizeVecVec = std::vector<TSizeVec>;
     using TOptionalUserDataType = boost::optional<config_t::EUserDataType>;
     using TDetectorSpecificationVec = std::vector<CDetectorSpecification>;
     using TFieldStatisticsVec = std::vector<CFieldStatistics>;
@@ -94,15 +105,34 @@ private:
     void updateStatisticsAndMaybeComputeScores(core_t::TTime time,
                                                const TStrStrUMap& fieldValues);
 
+    //! Update the statistics with the records [\p begin, \p end) of
+    //! \p records, where \p numberRecords is the count of all records
+    //! so far including these, and maybe recompute detector scores and
+    //! prune.
+    void updateStatisticsAndMaybeComputeScores(const CColumnarRecordBuffer& records,
+                                               std::size_t begin,
+                                               std::size_t end,
+                                               uint64_t numberRecords);
+
+    //! Recompute detector scores and prune if we've seen enough records
+    //! and time since they were last computed.
+    void maybeComputeScores(core_t::TTime time, uint64_t numberRecords);
+
     //! Compute the detector scores.
     void computeScores(bool final);
 
+    //! Refresh all the candidate detectors' scores.
+    void refreshScores();
+
     //! Generate the candidate detectors to evaluate.
     void generateCandidateDetectorsOnce();
 
     //! Run the records in the buffer through the detector scorers.
     void replayBuffer();
 
+    //! Run the sampled records through the detector scorers.
+    void replaySample();
+
 private:
     //! The parameters.
     CAutoconfigurerParams m_Params;
@@ -119,8 +149,28 @@ private:
     //! The last time the detector scores were refreshed.
     core_t::TTime m_LastTimeScoresWereRefreshed;
 
-    //! A buffer of the records before the configuration has begun.
-    TTimeStrStrUMapPrVec m_Buffer;
+    //! The record count when we last checked if the detector scores
+    //! should be refreshed.
+    uint64_t m_NumberRecordsAtLastScoresCheck;
+
+    //! The threads used to update the statistics and compute scores.
+    core::CThreadPool m_ThreadPool;
+
+    //! The number of records to update the statistics with in one go.
+    std::size_t m_BatchSize;
+
+    //! A buffer of the records before the configuration has begun and,
+    //! if we're using more than one thread, of the current batch.
+    CColumnarRecordBuffer m_Buffer;
+
+    //! The sample of the records if we're not using all of them.
+    TTimeStratifiedSampleUPtr m_Sample;
+
+    //! Placeholders for the field values of a batch of records.
+    TStrStrUMapVec m_BatchFieldValues;
+
+    //! Placeholders for the detector records of a batch of records.
+    CDataCountStatisticsDirectAddressTable::TDetectorRecordVecVec m_BatchDetectorRecords;
 
     //! The field semantics and summary statistics.
     TFieldStatisticsVec m_FieldStatistics;
@@ -189,9 +239,19 @@ CAutoconfigurerImpl::CAutoconfigurerImpl(const CAutoconfigurerParams& params,
     : m_Params(params), m_Initialized(false), m_NumberRecords(0),
       m_NumberRecordsWithNoOrInvalidTime(0),
       m_LastTimeScoresWereRefreshed(boost::numeric::bounds<core_t::TTime>::lowest()),
-      m_DetectorCountStatistics(m_Params), m_FieldRolePenalties(m_Params),
-      m_DetectorPenalties(m_Params, m_FieldRolePenalties),
+      m_NumberRecordsAtLastScoresCheck(0), m_ThreadPool(params.numberThreads()),
+      m_BatchSize(1), m_DetectorCountStatistics(m_Params),
+      m_FieldRolePenalties(m_Params), m_DetectorPenalties(m_Params, m_FieldRolePenalties),
       m_GeneratedCandidateFieldNames(false), m_ReportWriter(reportWriter) {
+    if (m_Params.sampleSize() > 0) {
+        // Sample whole intervals of the longest candidate bucket length
+        // so every candidate bucket is either sampled or not.
+        const CAutoconfigurerParams::TTimeVec& candidates = m_Params.candidateBucketLengths();
+        core_t::TTime length = candidates.empty()
+                                   ? 1
+                                   : *std::max_element(candidates.begin(), candidates.end());
+        m_Sample = std::make_unique<CTimeStratifiedSample>(length, m_Params.sampleSize());
+    }
 }
 
 bool CAutoconfigurerImpl::handleRecord(const TStrStrUMap& fieldValues) {
@@ -215,6 +275,10 @@ bool CAutoconfigurerImpl::handleRecord(const TStrStrUMap& fieldValues) {
 void CAutoconfigurerImpl::finalise() {
     LOG_TRACE(<< "CAutoconfigurerImpl::finalise...");
 
+    if (m_GeneratedCandidateFieldNames) {
+        this->replayBuffer();
+        this->replaySample();
+    }
     this->computeScores(true);
 
     m_ReportWriter.addTotalRecords(m_NumberRecords);
@@ -306,8 +370,23 @@ void CAutoconfigurerImpl::processRecord(core_t::TTime time, const TStrStrUMap& f
         }
     }
 
-    if (m_NumberRecords < m_Params.minimumRecordsToAttemptConfig()) {
-        m_Buffer.push_back(std::make_pair(time, fieldValues));
+    if (m_Sample != nullptr) {
+        m_Sample->add(time, fieldValues);
+        if (m_NumberRecords >= m_Params.minimumRecordsToAttemptConfig()) {
+            this->generateCandidateDetectorsOnce();
+        }
+    } else if (m_NumberRecords < m_Params.minimumRecordsToAttemptConfig()) {
+        m_Buffer.add(time, fieldValues);
+    } else if (m_ThreadPool.numberThreads() > 1) {
+        // Batch up records so there is enough work to share between threads.
+        // Batches end where the scores are due to be refreshed so this gives
+        // the same results as updating with one record at a time.
+        this->generateCandidateDetectorsOnce();
+        m_Buffer.add(time, fieldValues);
+        if (m_Buffer.size() >= m_BatchSize ||
+            m_NumberRecords % UPDATE_SCORE_RECORD_COUNT_INTERVAL == 0) {
+            this->replayBuffer();
+        }
     } else {
         this->generateCandidateDetectorsOnce();
         this->replayBuffer();
@@ -320,8 +399,37 @@ void CAutoconfigurerImpl::updateStatisticsAndMaybeComputeScores(core_t::TTime ti
     CDetectorRecordDirectAddressTable::TDetectorRecordVec records;
     m_DetectorRecordFactory.detectorRecords(time, fieldValues, m_CandidateDetectors, records);
     m_DetectorCountStatistics.add(records);
-    if (m_NumberRecords % UPDATE_SCORE_RECORD_COUNT_INTERVAL == 0 &&
-        time >= m_LastTimeScoresWereRefreshed + UPDATE_SCORE_TIME_INTERVAL) {
+    this->maybeComputeScores(time, m_NumberRecords);
+}
+
+void CAutoconfigurerImpl::updateStatisticsAndMaybeComputeScores(
+    const CColumnarRecordBuffer& records,
+    std::size_t begin,
+    std::size_t end,
+    uint64_t numberRecords) {
+    std::size_t n = end - begin;
+    if (m_BatchFieldValues.size() < n) {
+        m_BatchFieldValues.resize(n);
+    }
+    m_BatchDetectorRecords.resize(n);
+    for (std::size_t i = 0u; i < n; ++i) {
+        records.fieldValues(begin + i, m_BatchFieldValues[i]);
+        m_DetectorRecordFactory.detectorRecords(records.time(begin + i),
+                                                m_BatchFieldValues[i], m_CandidateDetectors,
+                                                m_BatchDetectorRecords[i]);
+    }
+    m_DetectorCountStatistics.add(m_BatchDetectorRecords, m_ThreadPool);
+    this->maybeComputeScores(records.time(end - 1), numberRecords);
+}
+
+void CAutoconfigurerImpl::maybeComputeScores(core_t::TTime time, uint64_t numberRecords) {
+    // A batch of records can span a multiple of the interval.
+    bool due = numberRecords / UPDATE_SCORE_RECORD_COUNT_INTERVAL >
+               m_NumberRecordsAtLastScoresCheck / UPDATE_SCORE_RECORD_COUNT_INTERVAL;
+    if (due) {
+        m_NumberRecordsAtLastScoresCheck = numberRecords;
+    }
+    if (due && time >= m_LastTimeScoresWereRefreshed + UPDATE_SCORE_TIME_INTERVAL) {
         this->computeScores(false);
         m_LastTimeScoresWereRefreshed = time;
     }
@@ -330,12 +438,13 @@ void CAutoconfigurerImpl::updateStatisticsAndMaybeComputeScores(core_t::TTime ti
 void CAutoconfigurerImpl::computeScores(bool final) {
     LOG_TRACE(<< "CAutoconfigurerImpl::computeScores...");
 
+    this->refreshScores();
+
     std::size_t last = 0u;
 
     for (std::size_t i = 0u; i < m_CandidateDetectors.size(); ++i) {
-        LOG_TRACE(<< "Refreshing scores for " << m_CandidateDetectors[i].description());
-        m_CandidateDetectors[i].refreshScores();
-        LOG_TRACE(<< "score = " << m_CandidateDetectors[i].score());
+        LOG_TRACE(<< m_CandidateDetectors[i].description()
+                  << " score = " << m_CandidateDetectors[i].score());
         if (m_CandidateDetectors[i].score() >
             (final ? m_Params.minimumDetectorScore() : 0.0)) {
             if (i > last) {
@@ -356,6 +465,36 @@ void CAutoconfigurerImpl::computeScores(bool final) {
     LOG_TRACE(<< "CAutoconfigurerImpl::computeScores done");
 }
 
+void CAutoconfigurerImpl::refreshScores() {
+    if (m_ThreadPool.numberThreads() == 1) {
+        for (auto& spec : m_CandidateDetectors) {
+            spec.refreshScores();
+        }
+        return;
+    }
+
+    // Reading some count statistics, such as quantiles, updates them so
+    // detectors which share statistics must be scored by the same thread.
+    using TStatisticsCPtrSizeUMap = boost::unordered_map<const CDataCountStatistics*, std::size_t>;
+
+    TStatisticsCPtrSizeUMap groupIndices;
+    TSizeVecVec groups;
+    for (std::size_t i = 0u; i < m_CandidateDetectors.size(); ++i) {
+        auto group = groupIndices.emplace(m_CandidateDetectors[i].countStatistics(),
+                                          groups.size());
+        if (group.second) {
+            groups.emplace_back();
+        }
+        groups[group.first->second].push_back(i);
+    }
+
+    m_ThreadPool.parallelForEach(groups.size(), [&groups, this](std::size_t i) {
+        for (auto j : groups[i]) {
+            m_CandidateDetectors[j].refreshScores();
+        }
+    });
+}
+
 void CAutoconfigurerImpl::generateCandidateDetectorsOnce() {
     if (m_GeneratedCandidateFieldNames) {
         return;
@@ -414,6 +553,12 @@ void CAutoconfigurerImpl::generateCandidateDetectorsOnce() {
     m_DetectorCountStatistics.build(m_CandidateDetectors);
     m_DetectorRecordFactory.build(m_CandidateDetectors);
 
+    if (m_ThreadPool.numberThreads() > 1) {
+        m_BatchSize = maths::CTools::truncate(
+            MAXIMUM_BATCH_DETECTOR_RECORDS / (m_CandidateDetectors.size() + 1),
+            std::size_t(1), MAXIMUM_BATCH_SIZE);
+    }
+
     for (std::size_t i = 0u; i < m_CandidateDetectors.size(); ++i) {
         CDetectorSpecification& spec = m_CandidateDetectors[i];
         spec.addFieldStatistics(m_FieldStatistics);
@@ -425,15 +570,51 @@ void CAutoconfigurerImpl::generateCandidateDetectorsOnce() {
 }
 
 void CAutoconfigurerImpl::replayBuffer() {
-    for (std::size_t i = 0u; i < m_Buffer.size(); ++i) {
+    for (std::size_t i = 0u; i < m_Buffer.size(); i += m_BatchSize) {
         if (reportProgress(i)) {
             LOG_DEBUG(<< "Replayed " << i << " records");
         }
-        this->updateStatisticsAndMaybeComputeScores(m_Buffer[i].first,
-                                                    m_Buffer[i].second);
+        this->updateStatisticsAndMaybeComputeScores(
+            m_Buffer, i, std::min(i + m_BatchSize, m_Buffer.size()), m_NumberRecords);
+    }
+    m_Buffer.clear();
+}
+
+void CAutoconfigurerImpl::replaySample() {
+    if (m_Sample == nullptr || m_Sample->empty()) {
+        return;
+    }
+
+    LOG_DEBUG(<< "Replaying " << m_Sample->size() << " sampled records with weight "
+              << m_Sample->weight());
+
+    // The statistics are updated with the records of the sampled intervals
+    // in time order. The intervals between them are skipped and the bucket
+    // statistics of the sampled intervals scaled up to compensate.
+
+    core_t::TTime length = m_Sample->stratumLength();
+    m_DetectorCountStatistics.setBucketWeight(m_Sample->weight());
+
+    uint64_t numberRecords = 0;
+    core_t::TTime last = m_Sample->earliest();
+    for (const auto& stratum : m_Sample->strata()) {
+        if (last < stratum.first) {
+            m_DetectorCountStatistics.skip(last, stratum.first);
+        }
+        const CColumnarRecordBuffer& records = stratum.second;
+        for (std::size_t i = 0u, end = 0u; i < records.size(); i = end) {
+            std::size_t due = UPDATE_SCORE_RECORD_COUNT_INTERVAL -
+                              static_cast<std::size_t>(
+                                  numberRecords % UPDATE_SCORE_RECORD_COUNT_INTERVAL);
+            end = std::min({i + m_BatchSize, i + due, records.size()});
+            numberRecords += end - i;
+            this->updateStatisticsAndMaybeComputeScores(records, i, end, numberRecords);
+        }
+        last = stratum.first + length;
+    }
+    if (last <= m_Sample->latest()) {
+        m_DetectorCountStatistics.skip(last, m_Sample->latest() + 1);
     }
-    TTimeStrStrUMapPrVec empty;
-    m_Buffer.swap(empty);
 }
 }
 }
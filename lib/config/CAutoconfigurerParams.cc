@@ -465,6 +465,8 @@ bool canUse(const CAutoconfigurerParams::TOptionalStrVec& primary,
 const std::size_t MINIMUM_EXAMPLES_TO_CLASSIFY(1000);
 const std::size_t MINIMUM_RECORDS_TO_ATTEMPT_CONFIG(10000);
 const double MINIMUM_DETECTOR_SCORE(0.1);
+const std::size_t SAMPLE_SIZE(0);
+const std::size_t NUMBER_THREADS(1);
 const std::size_t NUMBER_OF_MOST_FREQUENT_FIELDS_COUNTS(10);
 std::string DEFAULT_DETECTOR_CONFIG_LINE_ENDING("\n");
 const config_t::EFunctionCategory FUNCTION_CATEGORIES[] = {
@@ -518,7 +520,8 @@ CAutoconfigurerParams::CAutoconfigurerParams(const std::string& timeFieldName,
       m_MinimumExamplesToClassify(MINIMUM_EXAMPLES_TO_CLASSIFY),
       m_NumberOfMostFrequentFieldsCounts(NUMBER_OF_MOST_FREQUENT_FIELDS_COUNTS),
       m_MinimumRecordsToAttemptConfig(MINIMUM_RECORDS_TO_ATTEMPT_CONFIG),
-      m_MinimumDetectorScore(MINIMUM_DETECTOR_SCORE),
+      m_MinimumDetectorScore(MINIMUM_DETECTOR_SCORE), m_SampleSize(SAMPLE_SIZE),
+      m_NumberThreads(NUMBER_THREADS),
       m_HighNumberByFieldValues(HIGH_NUMBER_BY_FIELD_VALUES),
       m_MaximumNumberByFieldValues(MAXIMUM_NUMBER_BY_FIELD_VALUES),
       m_HighNumberRareByFieldValues(HIGH_NUMBER_RARE_BY_FIELD_VALUES),
@@ -582,6 +585,7 @@ bool CAutoconfigurerParams::init(const std::string& file) {
     static const core_t::TTime ZERO_TIME = 0;
     static const double ZERO_DOUBLE = 0.0;
     static const double ONE_DOUBLE = 1.0;
+    static const std::size_t ZERO_SIZE = 0;
     static const std::string LABELS[] = {
         std::string("scope.fields_of_interest"),
         std::string("scope.permitted_argument_fields"),
@@ -593,6 +597,8 @@ bool CAutoconfigurerParams::init(const std::string& file) {
         std::string("statistics.minimum_examples_to_classify"),
         std::string("statistics.number_of_most_frequent_to_count"),
         std::string("configuration.minimum_records_to_attempt_config"),
+        std::string("configuration.sample_size"),
+        std::string("configuration.number_threads"),
         std::string("configuration.high_number_of_by_fields"),
         std::string("configuration.maximum_number_of_by_fields"),
         std::string("configuration.high_number_of_rare_by_fields"),
@@ -644,6 +650,9 @@ bool CAutoconfigurerParams::init(const std::string& file) {
         TParameterPtr(new CBuiltinParameter<uint64_t>(
             m_MinimumRecordsToAttemptConfig,
             new CValueIs<uint64_t, CGreater>(m_MinimumExamplesToClassify))),
+        TParameterPtr(new CBuiltinParameter<std::size_t>(m_SampleSize)),
+        TParameterPtr(new CBuiltinParameter<std::size_t>(
+            m_NumberThreads, new CValueIs<std::size_t, CGreater>(ZERO_SIZE))),
         TParameterPtr(new CBuiltinParameter<std::size_t>(m_HighNumberByFieldValues)),
         TParameterPtr(new CBuiltinParameter<std::size_t>(
             m_MaximumNumberByFieldValues,
@@ -856,6 +865,14 @@ double CAutoconfigurerParams::minimumDetectorScore() const {
     return m_MinimumDetectorScore;
 }
 
+std::size_t CAutoconfigurerParams::sampleSize() const {
+    return m_SampleSize;
+}
+
+std::size_t CAutoconfigurerParams::numberThreads() const {
+    return m_NumberThreads;
+}
+
 std::size_t CAutoconfigurerParams::highNumberByFieldValues() const {
     return m_HighNumberByFieldValues;
 }
@@ -1039,6 +1056,8 @@ std::string CAutoconfigurerParams::print() const {
     PRINT_VALUE(MinimumExamplesToClassify);
     PRINT_VALUE(NumberOfMostFrequentFieldsCounts);
     PRINT_VALUE(MinimumRecordsToAttemptConfig);
+    PRINT_VALUE(SampleSize);
+    PRINT_VALUE(NumberThreads);
     PRINT_VALUE(HighNumberByFieldValues);
     PRINT_VALUE(MaximumNumberByFieldValues);
     PRINT_VALUE(HighNumberRareByFieldValues);
@@ -0,0 +1,89 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <config/CColumnarRecordBuffer.h>
+
+#include <limits>
+
+namespace ml {
+namespace config {
+namespace {
+const uint32_t MISSING = std::numeric_limits<uint32_t>::max();
+}
+
+void CColumnarRecordBuffer::add(core_t::TTime time, const TStrStrUMap& fieldValues) {
+    std::size_t n{m_Times.size()};
+
+    for (const auto& fieldValue : fieldValues) {
+        SColumn& column{this->column(fieldValue.first)};
+        auto value = column.s_Index.emplace(
+            fieldValue.second, static_cast<uint32_t>(column.s_Values.size()));
+        if (value.second) {
+            column.s_Values.push_back(&value.first->first);
+        }
+        column.s_Records.push_back(value.first->second);
+    }
+    for (auto& column : m_Columns) {
+        if (column.s_Records.size() == n) {
+            column.s_Records.push_back(MISSING);
+        }
+    }
+
+    m_Times.push_back(time);
+}
+
+std::size_t CColumnarRecordBuffer::size() const {
+    return m_Times.size();
+}
+
+bool CColumnarRecordBuffer::empty() const {
+    return m_Times.empty();
+}
+
+core_t::TTime CColumnarRecordBuffer::time(std::size_t i) const {
+    return m_Times[i];
+}
+
+void CColumnarRecordBuffer::fieldValues(std::size_t i, TStrStrUMap& result) const {
+    std::size_t present{0};
+    for (const auto& column : m_Columns) {
+        uint32_t value{column.s_Records[i]};
+        if (value == MISSING) {
+            result.erase(column.s_Name);
+        } else {
+            result[column.s_Name] = *column.s_Values[value];
+            ++present;
+        }
+    }
+
+    // Remove any fields left over from a record which isn't in this buffer.
+    if (result.size() > present) {
+        for (auto j = result.begin(); j != result.end(); /**/) {
+            if (m_ColumnIndex.count(j->first) == 0) {
+                j = result.erase(j);
+            } else {
+                ++j;
+            }
+        }
+    }
+}
+
+void CColumnarRecordBuffer::clear() {
+    m_Times.clear();
+    m_Columns.clear();
+    m_ColumnIndex.clear();
+}
+
+CColumnarRecordBuffer::SColumn& CColumnarRecordBuffer::column(const std::string& name) {
+    auto index = m_ColumnIndex.emplace(name, m_Columns.size());
+    if (index.second) {
+        m_Columns.emplace_back(name);
+        m_Columns.back().s_Records.resize(m_Times.size(), MISSING);
+    }
+    return m_Columns[index.first->second];
+}
+}
+}
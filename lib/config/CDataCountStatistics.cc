@@ -10,6 +10,7 @@
 #include <core/CHashing.h>
 #include <core/CLogger.h>
 #include <core/CMaskIterator.h>
+#include <core/CThreadPool.h>
 #include <core/CompressUtils.h>
 
 #include <maths/CIntegerTools.h>
@@ -140,17 +141,19 @@ void CBucketCountStatistics::add(const TSizeSizeSizeTr& partition,
     }
 }
 
-void CBucketCountStatistics::capture() {
+void CBucketCountStatistics::capture(uint64_t weight) {
     using TSizeSizeSizeTrUInt64UMapCItr = TSizeSizeSizeTrUInt64UMap::const_iterator;
     using TSizeSizeSizeTrArgumentDataUMapItr = TSizeSizeSizeTrArgumentDataUMap::iterator;
 
-    m_BucketPartitionCount += m_CurrentBucketPartitionCounts.size();
+    double n = static_cast<double>(weight);
+
+    m_BucketPartitionCount += weight * m_CurrentBucketPartitionCounts.size();
     for (TSizeSizeSizeTrUInt64UMapCItr i = m_CurrentBucketPartitionCounts.begin();
          i != m_CurrentBucketPartitionCounts.end(); ++i) {
         TSizeSizePr id(i->first.first, i->first.third);
         double count = static_cast<double>(i->second);
-        m_CountMomentsPerPartition[id].add(count);
-        m_CountQuantiles.emplace(id, QUANTILES).first->second.add(count);
+        m_CountMomentsPerPartition[id].add(count, n);
+        m_CountQuantiles.emplace(id, QUANTILES).first->second.add(count, n);
     }
     m_CurrentBucketPartitionCounts.clear();
 
@@ -165,8 +168,8 @@ void CBucketCountStatistics::capture() {
             SArgumentMoments& moments = m_ArgumentMomentsPerPartition[j].second[id];
             double dc = static_cast<double>(k->second.s_DistinctValues.number());
             double info = dc * maths::CBasicStatistics::mean(k->second.s_MeanStringLength);
-            moments.s_DistinctCount.add(dc);
-            moments.s_InfoContent.add(info);
+            moments.s_DistinctCount.add(dc, n);
+            moments.s_InfoContent.add(info, n);
         }
         m_CurrentBucketArgumentDataPerPartition[i].second.clear();
     }
@@ -204,7 +207,7 @@ CBucketCountStatistics::argumentMomentsPerPartition(const std::string& name) con
 CDataCountStatistics::CDataCountStatistics(const CAutoconfigurerParams& params)
     : m_Params(params), m_RecordCount(0),
       m_ArrivalTimeDistribution(maths::CQuantileSketch::E_PiecewiseConstant, SKETCH_SIZE),
-      m_BucketIndices(params.candidateBucketLengths().size(), 0),
+      m_BucketIndices(params.candidateBucketLengths().size(), 0), m_BucketWeight(1),
       m_BucketCounts(params.candidateBucketLengths().size(), 0),
       m_BucketStatistics(params.candidateBucketLengths().size()) {
     const TTimeVec& candidates = params.candidateBucketLengths();
@@ -233,25 +236,7 @@ void CDataCountStatistics::add(TDetectorRecordCItr beginRecords, TDetectorRecord
     m_LastRecordTime = time;
 
     this->fillLastBucketEndTimes(time);
-
-    const TTimeVec& candidates = this->params().candidateBucketLengths();
-    for (std::size_t bid = 0u; bid < m_LastBucketEndTimes.size(); ++bid) {
-        if (time - m_LastBucketEndTimes[bid] >= candidates[bid]) {
-            for (core_t::TTime i = 0;
-                 i < (time - m_LastBucketEndTimes[bid]) / candidates[bid]; ++i) {
-                if (m_BucketMasks[bid][m_BucketIndices[bid]++]) {
-                    ++m_BucketCounts[bid];
-                    m_BucketStatistics[bid].capture();
-                }
-                if ((m_BucketIndices[bid] % m_BucketMasks.size()) == 0) {
-                    m_BucketIndices[bid] = 0;
-                    maths::CSampling::random_shuffle(m_Rng, m_BucketMasks[bid].begin(),
-                                                     m_BucketMasks[bid].end());
-                }
-            }
-            m_LastBucketEndTimes[bid] = maths::CIntegerTools::floor(time, candidates[bid]);
-        }
-    }
+    this->completeBuckets(time);
 
     std::size_t partition = beginRecords->partitionFieldValueHash();
     m_Partitions.insert(partition);
@@ -269,6 +254,28 @@ void CDataCountStatistics::add(TDetectorRecordCItr beginRecords, TDetectorRecord
     }
 }
 
+void CDataCountStatistics::setBucketWeight(uint64_t weight) {
+    m_BucketWeight = weight;
+}
+
+void CDataCountStatistics::skip(core_t::TTime begin, core_t::TTime end) {
+    m_Earliest.add(begin);
+    m_Latest.add(end - 1);
+    m_LastRecordTime.reset();
+
+    if (m_LastBucketEndTimes.empty()) {
+        return;
+    }
+
+    this->completeBuckets(begin);
+
+    const TTimeVec& candidates = this->params().candidateBucketLengths();
+    for (std::size_t bid = 0u; bid < m_LastBucketEndTimes.size(); ++bid) {
+        m_LastBucketEndTimes[bid] = std::max(
+            m_LastBucketEndTimes[bid], maths::CIntegerTools::floor(end, candidates[bid]));
+    }
+}
+
 uint64_t CDataCountStatistics::recordCount() const {
     return m_RecordCount;
 }
@@ -317,6 +324,27 @@ void CDataCountStatistics::fillLastBucketEndTimes(core_t::TTime time) {
     }
 }
 
+void CDataCountStatistics::completeBuckets(core_t::TTime time) {
+    const TTimeVec& candidates = this->params().candidateBucketLengths();
+    for (std::size_t bid = 0u; bid < m_LastBucketEndTimes.size(); ++bid) {
+        if (time - m_LastBucketEndTimes[bid] >= candidates[bid]) {
+            for (core_t::TTime i = 0;
+                 i < (time - m_LastBucketEndTimes[bid]) / candidates[bid]; ++i) {
+                if (m_BucketMasks[bid][m_BucketIndices[bid]++]) {
+                    m_BucketCounts[bid] += m_BucketWeight;
+                    m_BucketStatistics[bid].capture(m_BucketWeight);
+                }
+                if ((m_BucketIndices[bid] % m_BucketMasks.size()) == 0) {
+                    m_BucketIndices[bid] = 0;
+                    maths::CSampling::random_shuffle(m_Rng, m_BucketMasks[bid].begin(),
+                                                     m_BucketMasks[bid].end());
+                }
+            }
+            m_LastBucketEndTimes[bid] = maths::CIntegerTools::floor(time, candidates[bid]);
+        }
+    }
+}
+
 //////// CPartitionDataCountStatistics ////////
 
 CPartitionDataCountStatistics::CPartitionDataCountStatistics(const CAutoconfigurerParams& params)
@@ -441,6 +469,28 @@ void CDataCountStatisticsDirectAddressTable::add(const TDetectorRecordVec& recor
     }
 }
 
+void CDataCountStatisticsDirectAddressTable::add(const TDetectorRecordVecVec& records,
+                                                 core::CThreadPool& pool) {
+    pool.parallelForEach(m_RecordSchema.size(), [&records, this](std::size_t i) {
+        for (const auto& records_ : records) {
+            m_DataCountStatistics[i]->add(core::begin_masked(records_, m_RecordSchema[i]),
+                                          core::end_masked(records_, m_RecordSchema[i]));
+        }
+    });
+}
+
+void CDataCountStatisticsDirectAddressTable::setBucketWeight(uint64_t weight) {
+    for (const auto& statistics : m_DataCountStatistics) {
+        statistics->setBucketWeight(weight);
+    }
+}
+
+void CDataCountStatisticsDirectAddressTable::skip(core_t::TTime begin, core_t::TTime end) {
+    for (const auto& statistics : m_DataCountStatistics) {
+        statistics->skip(begin, end);
+    }
+}
+
 const CDataCountStatistics&
 CDataCountStatisticsDirectAddressTable::statistics(const CDetectorSpecification& spec) const {
     return *m_DataCountStatistics[m_DetectorSchema[spec.id()]];
@@ -0,0 +1,97 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <config/CTimeStratifiedSample.h>
+
+#include <core/CHashing.h>
+#include <core/CLogger.h>
+
+#include <maths/CIntegerTools.h>
+
+#include <boost/numeric/conversion/bounds.hpp>
+
+#include <algorithm>
+
+namespace ml {
+namespace config {
+namespace {
+const uint64_t SEED{0x5bd1e995};
+const std::size_t MAXIMUM_LEVEL{63};
+}
+
+CTimeStratifiedSample::CTimeStratifiedSample(core_t::TTime stratumLength, std::size_t maximumSize)
+    : m_StratumLength(std::max(stratumLength, core_t::TTime(1))),
+      m_MaximumSize(maximumSize), m_Level(0), m_Size(0),
+      m_Earliest(boost::numeric::bounds<core_t::TTime>::highest()),
+      m_Latest(boost::numeric::bounds<core_t::TTime>::lowest()) {
+}
+
+void CTimeStratifiedSample::add(core_t::TTime time, const TStrStrUMap& fieldValues) {
+    m_Earliest = std::min(m_Earliest, time);
+    m_Latest = std::max(m_Latest, time);
+
+    core_t::TTime start{maths::CIntegerTools::floor(time, m_StratumLength)};
+    if (this->sampled(start) == false) {
+        return;
+    }
+
+    m_Strata[start].add(time, fieldValues);
+    if (++m_Size > m_MaximumSize) {
+        this->reduce();
+    }
+}
+
+core_t::TTime CTimeStratifiedSample::stratumLength() const {
+    return m_StratumLength;
+}
+
+std::size_t CTimeStratifiedSample::size() const {
+    return m_Size;
+}
+
+uint64_t CTimeStratifiedSample::weight() const {
+    return uint64_t(1) << m_Level;
+}
+
+const CTimeStratifiedSample::TTimeRecordBufferMap& CTimeStratifiedSample::strata() const {
+    return m_Strata;
+}
+
+bool CTimeStratifiedSample::empty() const {
+    return m_Earliest > m_Latest;
+}
+
+core_t::TTime CTimeStratifiedSample::earliest() const {
+    return m_Earliest;
+}
+
+core_t::TTime CTimeStratifiedSample::latest() const {
+    return m_Latest;
+}
+
+bool CTimeStratifiedSample::sampled(core_t::TTime start) const {
+    uint64_t mask{(uint64_t(1) << m_Level) - 1};
+    uint64_t hash{core::CHashing::murmurHash64(&start, static_cast<int>(sizeof(start)), SEED)};
+    return (hash & mask) == 0;
+}
+
+void CTimeStratifiedSample::reduce() {
+    while (m_Size > m_MaximumSize && m_Strata.size() > 1 && m_Level < MAXIMUM_LEVEL) {
+        ++m_Level;
+        for (auto i = m_Strata.begin(); i != m_Strata.end(); /**/) {
+            if (this->sampled(i->first)) {
+                ++i;
+            } else {
+                m_Size -= i->second.size();
+                i = m_Strata.erase(i);
+            }
+        }
+    }
+    LOG_TRACE(<< "level = " << m_Level << ", size = " << m_Size
+              << ", strata = " << m_Strata.size());
+}
+}
+}
@@ -28,6 +28,8 @@ void CAutoconfigurerParamsTest::testDefaults() {
         "  MinimumExamplesToClassify = 1000\n"
         "  NumberOfMostFrequentFieldsCounts = 10\n"
         "  MinimumRecordsToAttemptConfig = 10000\n"
+        "  SampleSize = 0\n"
+        "  NumberThreads = 1\n"
         "  HighNumberByFieldValues = 500\n"
         "  MaximumNumberByFieldValues = 1000\n"
         "  HighNumberRareByFieldValues = 50000\n"
@@ -81,6 +83,8 @@ void CAutoconfigurerParamsTest::testInit() {
         "  MinimumExamplesToClassify = 50\n"
         "  NumberOfMostFrequentFieldsCounts = 20\n"
         "  MinimumRecordsToAttemptConfig = 200\n"
+        "  SampleSize = 100000\n"
+        "  NumberThreads = 4\n"
         "  HighNumberByFieldValues = 50\n"
         "  MaximumNumberByFieldValues = 5000\n"
         "  HighNumberRareByFieldValues = 10000\n"
@@ -0,0 +1,148 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CAutoconfigurerTest.h"
+
+#include <core/CContainerPrinter.h>
+#include <core/CLogger.h>
+#include <core/CStringUtils.h>
+#include <core/Constants.h>
+
+#include <config/CAutoconfigurer.h>
+#include <config/CAutoconfigurerParams.h>
+#include <config/CReportWriter.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <boost/range.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ml;
+
+namespace {
+
+using TDoubleVec = std::vector<double>;
+using TSizeVec = std::vector<std::size_t>;
+using TStrVec = std::vector<std::string>;
+using TStrStrUMap = boost::unordered_map<std::string, std::string>;
+using TStrStrUMapVec = std::vector<TStrStrUMap>;
+
+//! Generate a few days of records with a time, two categorical fields
+//! and a numeric field whose distribution depends on one of them.
+void generateRecords(TStrStrUMapVec& records) {
+    test::CRandomNumbers rng;
+
+    core_t::TTime startTime = 1459468800;
+    core_t::TTime endTime = startTime + 4 * core::constants::DAY;
+
+    std::string machines[] = {std::string("alpha"), std::string("beta"),
+                              std::string("gamma"), std::string("delta"),
+                              std::string("epsilon")};
+    double means[] = {120.0, 800.0, 35.0, 2000.0, 410.0};
+
+    TStrVec users;
+    rng.generateWords(8, 40, users);
+
+    TDoubleVec dt;
+    TDoubleVec bytes;
+    TSizeVec index;
+    for (core_t::TTime time = startTime; time < endTime;
+         time += static_cast<core_t::TTime>(dt[0])) {
+        TStrStrUMap record;
+        record["time"] = core::CStringUtils::typeToString(time);
+        rng.generateUniformSamples(0, boost::size(machines), 1, index);
+        record["machine"] = machines[index[0]];
+        rng.generateNormalSamples(means[index[0]], means[index[0]], 1, bytes);
+        record["bytes"] = core::CStringUtils::typeToString(std::fabs(bytes[0]));
+        rng.generateUniformSamples(0, users.size(), 1, index);
+        record["user"] = users[index[0]];
+        records.push_back(record);
+
+        rng.generateUniformSamples(1.0, 20.0, 1, dt);
+    }
+}
+
+//! Run autoconfiguration on \p records using the parameters in
+//! \p file, if any, and get the report.
+std::string report(const TStrStrUMapVec& records, const std::string& file) {
+    config::CAutoconfigurerParams params("time", "", false, false);
+    if (!file.empty()) {
+        CPPUNIT_ASSERT(params.init(file));
+    }
+
+    std::ostringstream result;
+    config::CReportWriter writer(result);
+    config::CAutoconfigurer configurer(params, writer);
+    for (const auto& record : records) {
+        CPPUNIT_ASSERT(configurer.handleRecord(record));
+    }
+    configurer.finalise();
+
+    return result.str();
+}
+
+//! Extract the sorted descriptions of the candidate detectors from
+//! \p report. Each one is a line underlined with '='.
+TStrVec candidateDetectors(const std::string& report) {
+    TStrVec lines;
+    std::istringstream input(report.substr(report.find("CANDIDATE DETECTORS")));
+    for (std::string line; std::getline(input, line); /**/) {
+        lines.push_back(line);
+    }
+
+    TStrVec result;
+    for (std::size_t i = 1u; i + 1 < lines.size(); ++i) {
+        if (lines[i].size() > 0 && lines[i + 1] == std::string(lines[i].size(), '=')) {
+            result.push_back(lines[i]);
+        }
+    }
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+}
+
+void CAutoconfigurerTest::testThreadsAndSampling() {
+    // Check that updating the statistics in batches on several threads
+    // gives exactly the same report as using a single thread and that
+    // evaluating the candidate detectors on a sample of the records
+    // finds the same detectors.
+
+    TStrStrUMapVec records;
+    generateRecords(records);
+    LOG_DEBUG(<< "# records = " << records.size());
+
+    std::string expected = report(records, "");
+    LOG_DEBUG(<< expected);
+    TStrVec expectedDetectors = candidateDetectors(expected);
+    LOG_DEBUG(<< "detectors = " << core::CContainerPrinter::print(expectedDetectors));
+    CPPUNIT_ASSERT(expectedDetectors.size() > 0);
+
+    std::string threaded = report(records, "testfiles/threads.conf");
+    CPPUNIT_ASSERT_EQUAL(expected, threaded);
+
+    std::string sampled = report(records, "testfiles/sample.conf");
+    TStrVec sampledDetectors = candidateDetectors(sampled);
+    LOG_DEBUG(<< "sampled detectors = " << core::CContainerPrinter::print(sampledDetectors));
+    CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(expectedDetectors),
+                         core::CContainerPrinter::print(sampledDetectors));
+}
+
+CppUnit::Test* CAutoconfigurerTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CAutoconfigurerTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAutoconfigurerTest>(
+        "CAutoconfigurerTest::testThreadsAndSampling",
+        &CAutoconfigurerTest::testThreadsAndSampling));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CAutoconfigurerTest_h
+#define INCLUDED_CAutoconfigurerTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CAutoconfigurerTest : public CppUnit::TestFixture {
+public:
+    void testThreadsAndSampling();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CAutoconfigurerTest_h
@@ -0,0 +1,100 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CColumnarRecordBufferTest.h"
+
+#include <core/CLogger.h>
+#include <core/CStringUtils.h>
+
+#include <config/CColumnarRecordBuffer.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <vector>
+
+using namespace ml;
+
+using TSizeVec = std::vector<std::size_t>;
+using TStrStrUMap = config::CColumnarRecordBuffer::TStrStrUMap;
+using TStrStrUMapVec = std::vector<TStrStrUMap>;
+
+void CColumnarRecordBufferTest::testAddAndRetrieve() {
+    // Test we get back exactly the records we added.
+
+    test::CRandomNumbers rng;
+
+    config::CColumnarRecordBuffer buffer;
+    CPPUNIT_ASSERT(buffer.empty());
+
+    TStrStrUMapVec expected;
+    TSizeVec values;
+    for (std::size_t i = 0u; i < 1000; ++i) {
+        rng.generateUniformSamples(0, 20, 3, values);
+        TStrStrUMap record;
+        record["time"] = core::CStringUtils::typeToString(100 * i);
+        record["user"] = "user" + core::CStringUtils::typeToString(values[0]);
+        record["host"] = "host" + core::CStringUtils::typeToString(values[1]);
+        record["bytes"] = core::CStringUtils::typeToString(values[2]);
+        buffer.add(static_cast<core_t::TTime>(100 * i), record);
+        expected.push_back(record);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1000), buffer.size());
+
+    TStrStrUMap record;
+    for (std::size_t i = 0u; i < expected.size(); ++i) {
+        buffer.fieldValues(i, record);
+        CPPUNIT_ASSERT_EQUAL(static_cast<core_t::TTime>(100 * i), buffer.time(i));
+        CPPUNIT_ASSERT(expected[i] == record);
+    }
+
+    buffer.clear();
+    CPPUNIT_ASSERT(buffer.empty());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), buffer.size());
+}
+
+void CColumnarRecordBufferTest::testMissingFields() {
+    // Test records with different fields, including fields which first
+    // appear part way through the buffer.
+
+    TStrStrUMapVec expected(4);
+    expected[0]["a"] = "1";
+    expected[1]["a"] = "2";
+    expected[1]["b"] = "x";
+    expected[2]["b"] = "y";
+    expected[3]["c"] = "";
+    expected[3]["a"] = "1";
+
+    config::CColumnarRecordBuffer buffer;
+    for (std::size_t i = 0u; i < expected.size(); ++i) {
+        buffer.add(static_cast<core_t::TTime>(i), expected[i]);
+    }
+
+    TStrStrUMap record;
+    for (std::size_t i = 0u; i < expected.size(); ++i) {
+        buffer.fieldValues(i, record);
+        LOG_DEBUG(<< "record " << i << " has " << record.size() << " fields");
+        CPPUNIT_ASSERT(expected[i] == record);
+    }
+
+    // Fields from a different buffer are removed.
+    record["d"] = "z";
+    buffer.fieldValues(0, record);
+    CPPUNIT_ASSERT(expected[0] == record);
+}
+
+CppUnit::Test* CColumnarRecordBufferTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CColumnarRecordBufferTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CColumnarRecordBufferTest>(
+        "CColumnarRecordBufferTest::testAddAndRetrieve",
+        &CColumnarRecordBufferTest::testAddAndRetrieve));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CColumnarRecordBufferTest>(
+        "CColumnarRecordBufferTest::testMissingFields",
+        &CColumnarRecordBufferTest::testMissingFields));
+
+    return suiteOfTests;
+}
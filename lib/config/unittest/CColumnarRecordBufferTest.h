@@ -0,0 +1,20 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CColumnarRecordBufferTest_h
+#define INCLUDED_CColumnarRecordBufferTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CColumnarRecordBufferTest : public CppUnit::TestFixture {
+public:
+    void testAddAndRetrieve();
+    void testMissingFields();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CColumnarRecordBufferTest_h
@@ -0,0 +1,153 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CTimeStratifiedSampleTest.h"
+
+#include <core/CLogger.h>
+#include <core/CStringUtils.h>
+
+#include <maths/CBasicStatistics.h>
+
+#include <config/CTimeStratifiedSample.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ml;
+
+using TSizeVec = std::vector<std::size_t>;
+using TStrStrUMap = config::CTimeStratifiedSample::TStrStrUMap;
+using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumulator;
+
+void CTimeStratifiedSampleTest::testWholeStrata() {
+    // Test that the sampled strata contain all their records.
+
+    const core_t::TTime length = 3600;
+
+    config::CTimeStratifiedSample sample(length, 2000);
+
+    TStrStrUMap record;
+    for (core_t::TTime time = 1800; time < 100 * 86400; time += 10) {
+        record["time"] = core::CStringUtils::typeToString(time);
+        sample.add(time, record);
+    }
+
+    LOG_DEBUG(<< "size = " << sample.size() << ", weight = " << sample.weight());
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(1800), sample.earliest());
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(100 * 86400 - 10), sample.latest());
+    CPPUNIT_ASSERT(sample.weight() > 1);
+
+    std::size_t size = 0u;
+    for (const auto& stratum : sample.strata()) {
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(0), stratum.first % length);
+        const config::CColumnarRecordBuffer& records = stratum.second;
+        std::size_t expected = stratum.first == 0 ? 180 : 360;
+        CPPUNIT_ASSERT_EQUAL(expected, records.size());
+        for (std::size_t i = 0u; i < records.size(); ++i) {
+            CPPUNIT_ASSERT(records.time(i) >= stratum.first);
+            CPPUNIT_ASSERT(records.time(i) < stratum.first + length);
+            records.fieldValues(i, record);
+            CPPUNIT_ASSERT_EQUAL(core::CStringUtils::typeToString(records.time(i)),
+                                 record["time"]);
+        }
+        size += records.size();
+    }
+    CPPUNIT_ASSERT_EQUAL(size, sample.size());
+}
+
+void CTimeStratifiedSampleTest::testSize() {
+    // Test that everything is kept if the data are small enough, otherwise
+    // that the sample size is bounded.
+
+    const core_t::TTime length = 600;
+
+    TStrStrUMap record;
+    record["field"] = "value";
+
+    {
+        config::CTimeStratifiedSample sample(length, 1000);
+        CPPUNIT_ASSERT(sample.empty());
+        for (core_t::TTime time = 0; time < 1000 * 60; time += 60) {
+            sample.add(time, record);
+        }
+        CPPUNIT_ASSERT(!sample.empty());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1000), sample.size());
+        CPPUNIT_ASSERT_EQUAL(uint64_t(1), sample.weight());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(100), sample.strata().size());
+    }
+    {
+        config::CTimeStratifiedSample sample(length, 1000);
+        uint64_t previousWeight = 1;
+        for (core_t::TTime time = 0; time < 1000000 * 6; time += 6) {
+            sample.add(time, record);
+            CPPUNIT_ASSERT(sample.size() <= 1000);
+            CPPUNIT_ASSERT(sample.weight() >= previousWeight);
+            previousWeight = sample.weight();
+        }
+        LOG_DEBUG(<< "size = " << sample.size() << ", weight = " << sample.weight());
+        CPPUNIT_ASSERT(sample.size() > 250);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(0), sample.weight() & (sample.weight() - 1));
+    }
+    {
+        // A single stratum can't be reduced.
+        config::CTimeStratifiedSample sample(length, 10);
+        for (core_t::TTime time = 0; time < 100; ++time) {
+            sample.add(time, record);
+        }
+        CPPUNIT_ASSERT_EQUAL(std::size_t(100), sample.size());
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), sample.strata().size());
+    }
+}
+
+void CTimeStratifiedSampleTest::testUnbiased() {
+    // Test that the weighted count of the sampled records is an unbiased
+    // estimate of the total count.
+
+    const core_t::TTime length = 3600;
+
+    test::CRandomNumbers rng;
+
+    TStrStrUMap record;
+    record["field"] = "value";
+
+    TMeanAccumulator error;
+    TSizeVec counts;
+    for (std::size_t t = 0u; t < 200; ++t) {
+        config::CTimeStratifiedSample sample(length, 1000);
+
+        rng.generateUniformSamples(0, 21, 500, counts);
+        core_t::TTime start = static_cast<core_t::TTime>(t) * 1000 * length;
+        double total = 0.0;
+        for (std::size_t i = 0u; i < counts.size(); ++i) {
+            core_t::TTime time = start + static_cast<core_t::TTime>(i) * length;
+            for (std::size_t j = 0u; j < counts[i]; ++j) {
+                sample.add(time + static_cast<core_t::TTime>(j), record);
+            }
+            total += static_cast<double>(counts[i]);
+        }
+
+        double estimate = static_cast<double>(sample.weight() * sample.size());
+        error.add((estimate - total) / total);
+    }
+
+    LOG_DEBUG(<< "mean relative error = " << maths::CBasicStatistics::mean(error));
+    CPPUNIT_ASSERT(std::fabs(maths::CBasicStatistics::mean(error)) < 0.03);
+}
+
+CppUnit::Test* CTimeStratifiedSampleTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CTimeStratifiedSampleTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeStratifiedSampleTest>(
+        "CTimeStratifiedSampleTest::testWholeStrata", &CTimeStratifiedSampleTest::testWholeStrata));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeStratifiedSampleTest>(
+        "CTimeStratifiedSampleTest::testSize", &CTimeStratifiedSampleTest::testSize));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeStratifiedSampleTest>(
+        "CTimeStratifiedSampleTest::testUnbiased", &CTimeStratifiedSampleTest::testUnbiased));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CTimeStratifiedSampleTest_h
+#define INCLUDED_CTimeStratifiedSampleTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CTimeStratifiedSampleTest : public CppUnit::TestFixture {
+public:
+    void testWholeStrata();
+    void testSize();
+    void testUnbiased();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CTimeStratifiedSampleTest_h
@@ -7,19 +7,25 @@
 #include <test/CTestRunner.h>
 
 #include "CAutoconfigurerParamsTest.h"
+#include "CAutoconfigurerTest.h"
+#include "CColumnarRecordBufferTest.h"
 #include "CDataSemanticsTest.h"
 #include "CDataSummaryStatisticsTest.h"
 #include "CDetectorEnumeratorTest.h"
 #include "CReportWriterTest.h"
+#include "CTimeStratifiedSampleTest.h"
 
 int main(int argc, const char** argv) {
     ml::test::CTestRunner runner(argc, argv);
 
     runner.addTest(CAutoconfigurerParamsTest::suite());
+    runner.addTest(CAutoconfigurerTest::suite());
+    runner.addTest(CColumnarRecordBufferTest::suite());
     runner.addTest(CDataSemanticsTest::suite());
     runner.addTest(CDataSummaryStatisticsTest::suite());
     runner.addTest(CDetectorEnumeratorTest::suite());
     runner.addTest(CReportWriterTest::suite());
+    runner.addTest(CTimeStratifiedSampleTest::suite());
 
     return !runner.runTests();
 }
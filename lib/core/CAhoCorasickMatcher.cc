@@ -0,0 +1,153 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <core/CAhoCorasickMatcher.h>
+
+#include <core/CLogger.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace ml {
+namespace core {
+
+namespace {
+const uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+const uint32_t ROOT = 0;
+}
+
+bool CAhoCorasickMatcher::build(const TStrVec& patterns) {
+    this->clear();
+
+    using TCharUInt32Map = std::map<char, uint32_t>;
+    using TUInt32Vec = std::vector<uint32_t>;
+
+    struct STrieNode {
+        TCharUInt32Map s_Children;
+        bool s_Terminal = false;
+    };
+    using TTrieNodeVec = std::vector<STrieNode>;
+
+    // Build the trie of the patterns.
+    TTrieNodeVec trie(1);
+    for (const auto& pattern : patterns) {
+        uint32_t node{ROOT};
+        for (char c : pattern) {
+            auto child = trie[node].s_Children.find(c);
+            if (child != trie[node].s_Children.end()) {
+                node = child->second;
+                continue;
+            }
+            if (trie.size() >= NO_NODE) {
+                LOG_ERROR(<< "Too many patterns to build matcher");
+                return false;
+            }
+            uint32_t next{static_cast<uint32_t>(trie.size())};
+            trie[node].s_Children.emplace(c, next);
+            trie.emplace_back();
+            node = next;
+        }
+        if (node != ROOT) {
+            trie[node].s_Terminal = true;
+        }
+    }
+    if (trie.size() == 1) {
+        return true;
+    }
+
+    // Lay out the nodes in breadth first order.
+    TUInt32Vec order{ROOT};
+    TUInt32Vec index(trie.size());
+    order.reserve(trie.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        index[order[i]] = static_cast<uint32_t>(i);
+        for (const auto& child : trie[order[i]].s_Children) {
+            order.push_back(child.second);
+        }
+    }
+    m_Nodes.resize(trie.size());
+    m_Edges.reserve(trie.size() - 1);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        const STrieNode& node{trie[order[i]]};
+        m_Nodes[i].s_FirstEdge = static_cast<uint32_t>(m_Edges.size());
+        for (const auto& child : node.s_Children) {
+            m_Edges.push_back({child.first, index[child.second]});
+        }
+        m_Nodes[i].s_EndEdge = static_cast<uint32_t>(m_Edges.size());
+        m_Nodes[i].s_Failure = ROOT;
+        m_Nodes[i].s_Terminal = node.s_Terminal;
+    }
+
+    // Compute the failure links. Visiting the nodes in breadth first
+    // order means the failure link of a node's parent and the terminal
+    // flag of its failure node, which are both shallower, are final.
+    for (uint32_t i = 0; i < m_Nodes.size(); ++i) {
+        for (uint32_t j = m_Nodes[i].s_FirstEdge; j < m_Nodes[i].s_EndEdge; ++j) {
+            uint32_t target{m_Edges[j].s_Target};
+            uint32_t failure{ROOT};
+            if (i != ROOT) {
+                for (uint32_t node = m_Nodes[i].s_Failure; /**/; node = m_Nodes[node].s_Failure) {
+                    uint32_t next{this->child(node, m_Edges[j].s_Char)};
+                    if (next != NO_NODE) {
+                        failure = next;
+                        break;
+                    }
+                    if (node == ROOT) {
+                        break;
+                    }
+                }
+            }
+            m_Nodes[target].s_Failure = failure;
+            m_Nodes[target].s_Terminal = m_Nodes[target].s_Terminal ||
+                                         m_Nodes[failure].s_Terminal;
+        }
+    }
+
+    return true;
+}
+
+bool CAhoCorasickMatcher::matches(const std::string& key) const {
+    if (m_Nodes.empty()) {
+        return false;
+    }
+    uint32_t node{ROOT};
+    for (char c : key) {
+        for (;;) {
+            uint32_t next{this->child(node, c)};
+            if (next != NO_NODE) {
+                node = next;
+                break;
+            }
+            if (node == ROOT) {
+                break;
+            }
+            node = m_Nodes[node].s_Failure;
+        }
+        if (m_Nodes[node].s_Terminal) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CAhoCorasickMatcher::empty() const {
+    return m_Nodes.empty();
+}
+
+void CAhoCorasickMatcher::clear() {
+    m_Nodes.clear();
+    m_Edges.clear();
+}
+
+uint32_t CAhoCorasickMatcher::child(uint32_t node, char c) const {
+    auto begin = m_Edges.begin() + m_Nodes[node].s_FirstEdge;
+    auto end = m_Edges.begin() + m_Nodes[node].s_EndEdge;
+    auto edge = std::lower_bound(begin, end, c);
+    return edge != end && edge->s_Char == c ? edge->s_Target : NO_NODE;
+}
+}
+}
@@ -75,6 +75,23 @@ void CJsonOutputStreamWrapper::flushBuffer(TGenericLineWriter& writer,
     acquireBuffer(writer, buffer);
 }
 
+void CJsonOutputStreamWrapper::writeAsync(const TAsyncWriteFunc& write) {
+    m_ConcurrentOutputStream([this, write](std::ostream& o) {
+        CAsyncLineWriter writer(*this, o);
+        write(writer);
+    });
+}
+
+void CJsonOutputStreamWrapper::writeElement(std::ostream& stream,
+                                            const rapidjson::StringBuffer& buffer) {
+    if (m_FirstObject) {
+        m_FirstObject = false;
+    } else {
+        stream.put(JSON_ARRAY_DELIMITER);
+    }
+    stream.write(buffer.GetString(), buffer.GetLength());
+}
+
 void CJsonOutputStreamWrapper::returnAndCheckBuffer(rapidjson::StringBuffer* buffer) {
     buffer->Clear();
 
@@ -137,5 +154,25 @@ std::size_t CJsonOutputStreamWrapper::memoryUsage() const {
     memoryUsage += m_ConcurrentOutputStream.memoryUsage();
     return memoryUsage;
 }
+
+CJsonOutputStreamWrapper::CAsyncLineWriter::CAsyncLineWriter(CJsonOutputStreamWrapper& outStream,
+                                                             std::ostream& stream)
+    : m_OutputStreamWrapper(outStream), m_Stream(stream) {
+    m_StringBuffer.Reserve(BUFFER_START_SIZE);
+    this->Reset(m_StringBuffer);
+}
+
+bool CJsonOutputStreamWrapper::CAsyncLineWriter::EndObject(rapidjson::SizeType memberCount) {
+    bool baseReturnCode = TGenericLineWriter::EndObject(memberCount);
+
+    if (TGenericLineWriter::IsComplete()) {
+        this->Flush();
+        m_OutputStreamWrapper.writeElement(m_Stream, m_StringBuffer);
+        m_StringBuffer.Clear();
+        this->Reset(m_StringBuffer);
+    }
+
+    return baseReturnCode;
+}
 }
 }
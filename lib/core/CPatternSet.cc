@@ -13,20 +13,25 @@
 #include <rapidjson/error/en.h>
 
 #include <algorithm>
+#include <atomic>
 
 namespace ml {
 namespace core {
 
 namespace {
 const char WILDCARD = '*';
+std::atomic<uint64_t> nextUniqueId{0};
 }
 
 CPatternSet::CPatternSet()
     : m_FullMatchPatterns(), m_PrefixPatterns(), m_SuffixPatterns(),
       m_ContainsPatterns() {
+    this->newUniqueId();
 }
 
 bool CPatternSet::initFromJson(const std::string& json) {
+    this->newUniqueId();
+
     TStrVec fullPatterns;
     TStrVec prefixPatterns;
     TStrVec suffixPatterns;
@@ -96,12 +101,7 @@ bool CPatternSet::contains(const std::string& key) const {
     if (m_FullMatchPatterns.matchesFully(key)) {
         return true;
     }
-    for (TStrCItr keyItr = key.begin(); keyItr != key.end(); ++keyItr) {
-        if (m_ContainsPatterns.matchesStart(keyItr, key.end())) {
-            return true;
-        }
-    }
-    return false;
+    return m_ContainsPatterns.matches(key);
 }
 
 void CPatternSet::clear() {
@@ -109,6 +109,15 @@ void CPatternSet::clear() {
     m_PrefixPatterns.clear();
     m_SuffixPatterns.clear();
     m_ContainsPatterns.clear();
+    this->newUniqueId();
+}
+
+uint64_t CPatternSet::uniqueId() const {
+    return m_UniqueId;
+}
+
+void CPatternSet::newUniqueId() {
+    m_UniqueId = nextUniqueId++;
 }
 }
 }
@@ -0,0 +1,22 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CProcessMemory.h>
+
+namespace ml {
+namespace core {
+
+std::size_t CProcessMemory::residentSetSize() {
+    // Default is that we don't know - see platform-specific implementation
+    // files for platforms where we do
+    return 0;
+}
+
+void CProcessMemory::releaseFreeMemory() {
+    // Default is to do nothing - see platform-specific implementation files for
+    // platforms where we do more
+}
+}
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CProcessMemory.h>
+
+#include <core/CLogger.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace ml {
+namespace core {
+
+std::size_t CProcessMemory::residentSetSize() {
+    // The second field of statm is the number of resident pages. Use low
+    // level functions to read rather than C++ wrappers, as this is a system
+    // file.
+    int fd = ::open("/proc/self/statm", O_RDONLY);
+    if (fd == -1) {
+        LOG_ERROR(<< "Could not open /proc/self/statm: " << ::strerror(errno));
+        return 0;
+    }
+
+    char buffer[128] = {'\0'};
+    ssize_t bytesRead = ::read(fd, buffer, sizeof(buffer) - 1);
+    ::close(fd);
+
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    if (bytesRead <= 0 || ::sscanf(buffer, "%lu %lu", &size, &resident) != 2) {
+        LOG_ERROR(<< "Could not read resident set size from /proc/self/statm");
+        return 0;
+    }
+
+    long pageSize = ::sysconf(_SC_PAGESIZE);
+    return static_cast<std::size_t>(resident) *
+           static_cast<std::size_t>(pageSize > 0 ? pageSize : 4096);
+}
+
+void CProcessMemory::releaseFreeMemory() {
+#ifdef __GLIBC__
+    // This returns every whole free page in every arena to the kernel, not
+    // just the free memory at the top of the main heap. The pages remain
+    // mapped, so there's no problem if they're subsequently reused.
+    ::malloc_trim(0);
+#endif
+    // Other C libraries, e.g. musl, give memory back to the kernel themselves
+    // and have no equivalent of malloc_trim.
+}
+}
+}
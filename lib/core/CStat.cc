@@ -23,6 +23,10 @@ void CStat::decrement() {
     m_Value.fetch_sub(1);
 }
 
+void CStat::decrement(uint64_t value) {
+    m_Value.fetch_sub(value);
+}
+
 void CStat::set(uint64_t value) {
     m_Value.store(value);
 }
@@ -33,6 +33,9 @@ const std::string STAT_TYPE("value");
 const std::string KEY_TAG("a");
 const std::string VALUE_TAG("b");
 
+//! The collection of the calling thread if it has set one.
+thread_local CStatistics* currentStatistics{nullptr};
+
 //! Helper function to add a string/int pair to JSON writer
 void addStringInt(TGenericLineWriter& writer,
                   const std::string& name,
@@ -53,18 +56,28 @@ void addStringInt(TGenericLineWriter& writer,
 }
 }
 
+CStatistics::CScopedContext::CScopedContext(CStatistics& statistics)
+    : m_Previous(currentStatistics) {
+    currentStatistics = &statistics;
+}
+
+CStatistics::CScopedContext::~CScopedContext() {
+    currentStatistics = m_Previous;
+}
+
 CStatistics::CStatistics() {
 }
 
 CStatistics& CStatistics::instance() {
-    return ms_Instance;
+    return currentStatistics != nullptr ? *currentStatistics : ms_Instance;
 }
 
 CStat& CStatistics::stat(int index) {
-    if (static_cast<std::size_t>(index) >= ms_Instance.m_Stats.size()) {
+    CStatistics& statistics = instance();
+    if (static_cast<std::size_t>(index) >= statistics.m_Stats.size()) {
         LOG_ABORT(<< "Bad index " << index);
     }
-    return ms_Instance.m_Stats[index];
+    return statistics.m_Stats[index];
 }
 
 void CStatistics::staticsAcceptPersistInserter(CStatePersistInserter& inserter) {
@@ -114,81 +127,93 @@ bool CStatistics::staticsAcceptRestoreTraverser(CStateRestoreTraverser& traverse
 
 CStatistics CStatistics::ms_Instance;
 
-std::ostream& operator<<(std::ostream& o, const CStatistics& /*stats*/) {
+std::ostream& operator<<(std::ostream& o, const CStatistics& stats) {
     rapidjson::OStreamWrapper writeStream(o);
     TGenericLineWriter writer(writeStream);
 
     writer.StartArray();
 
     addStringInt(writer, "E_NumberNewPeopleNotAllowed", "Number of new people not allowed",
-                 CStatistics::stat(stat_t::E_NumberNewPeopleNotAllowed).value());
+                 stats.m_Stats[stat_t::E_NumberNewPeopleNotAllowed].value());
 
     addStringInt(writer, "E_NumberNewPeople", "Number of new people created",
-                 CStatistics::stat(stat_t::E_NumberNewPeople).value());
+                 stats.m_Stats[stat_t::E_NumberNewPeople].value());
 
     addStringInt(writer, "E_NumberNewPeopleRecycled",
                  "Number of new people recycled into existing space",
-                 CStatistics::stat(stat_t::E_NumberNewPeopleRecycled).value());
+                 stats.m_Stats[stat_t::E_NumberNewPeopleRecycled].value());
 
     addStringInt(writer, "E_NumberApiRecordsHandled",
                  "Number of records successfully ingested into the engine API",
-                 CStatistics::stat(stat_t::E_NumberApiRecordsHandled).value());
+                 stats.m_Stats[stat_t::E_NumberApiRecordsHandled].value());
 
     addStringInt(writer, "E_MemoryUsage",
                  "The estimated memory currently used by the engine and models",
-                 CStatistics::stat(stat_t::E_MemoryUsage).value());
+                 stats.m_Stats[stat_t::E_MemoryUsage].value());
 
     addStringInt(writer, "E_NumberMemoryUsageChecks",
                  "Number of times a model memory usage check has been carried out",
-                 CStatistics::stat(stat_t::E_NumberMemoryUsageChecks).value());
+                 stats.m_Stats[stat_t::E_NumberMemoryUsageChecks].value());
 
     addStringInt(writer, "E_NumberMemoryUsageEstimates",
                  "Number of times a partial memory usage estimate has been carried out",
-                 CStatistics::stat(stat_t::E_NumberMemoryUsageEstimates).value());
+                 stats.m_Stats[stat_t::E_NumberMemoryUsageEstimates].value());
 
     addStringInt(writer, "E_NumberRecordsNoTimeField",
                  "Number of records that didn't contain a Time field",
-                 CStatistics::stat(stat_t::E_NumberRecordsNoTimeField).value());
+                 stats.m_Stats[stat_t::E_NumberRecordsNoTimeField].value());
 
     addStringInt(writer, "E_NumberTimeFieldConversionErrors",
                  "Number of records where the format of the time field could not be converted",
-                 CStatistics::stat(stat_t::E_NumberTimeFieldConversionErrors).value());
+                 stats.m_Stats[stat_t::E_NumberTimeFieldConversionErrors].value());
 
     addStringInt(writer, "E_NumberTimeOrderErrors", "Number of records not in ascending time order",
-                 CStatistics::stat(stat_t::E_NumberTimeOrderErrors).value());
+                 stats.m_Stats[stat_t::E_NumberTimeOrderErrors].value());
 
     addStringInt(writer, "E_NumberNewAttributesNotAllowed", "Number of new attributes not allowed",
-                 CStatistics::stat(stat_t::E_NumberNewAttributesNotAllowed).value());
+                 stats.m_Stats[stat_t::E_NumberNewAttributesNotAllowed].value());
 
     addStringInt(writer, "E_NumberNewAttributes", "Number of new attributes created",
-                 CStatistics::stat(stat_t::E_NumberNewAttributes).value());
+                 stats.m_Stats[stat_t::E_NumberNewAttributes].value());
 
     addStringInt(writer, "E_NumberNewAttributesRecycled",
                  "Number of new attributes recycled into existing space",
-                 CStatistics::stat(stat_t::E_NumberNewAttributesRecycled).value());
+                 stats.m_Stats[stat_t::E_NumberNewAttributesRecycled].value());
 
     addStringInt(writer, "E_NumberByFields", "Number of 'by' fields within the model",
-                 CStatistics::stat(stat_t::E_NumberByFields).value());
+                 stats.m_Stats[stat_t::E_NumberByFields].value());
 
     addStringInt(writer, "E_NumberOverFields", "Number of 'over' fields within the model",
-                 CStatistics::stat(stat_t::E_NumberOverFields).value());
+                 stats.m_Stats[stat_t::E_NumberOverFields].value());
 
     addStringInt(writer, "E_NumberExcludedFrequentInvocations",
                  "The number of times 'ExcludeFrequent' has been invoked by the model",
-                 CStatistics::stat(stat_t::E_NumberExcludedFrequentInvocations).value());
+                 stats.m_Stats[stat_t::E_NumberExcludedFrequentInvocations].value());
 
     addStringInt(writer, "E_NumberSamplesOutsideLatencyWindow",
                  "The number of samples received outside the latency window",
-                 CStatistics::stat(stat_t::E_NumberSamplesOutsideLatencyWindow).value());
+                 stats.m_Stats[stat_t::E_NumberSamplesOutsideLatencyWindow].value());
 
     addStringInt(
         writer, "E_NumberMemoryLimitModelCreationFailures",
         "The number of model creation failures from being over memory limit",
-        CStatistics::stat(stat_t::E_NumberMemoryLimitModelCreationFailures).value());
+        stats.m_Stats[stat_t::E_NumberMemoryLimitModelCreationFailures].value());
 
     addStringInt(writer, "E_NumberPrunedItems",
                  "The number of old people or attributes pruned from the models",
-                 CStatistics::stat(stat_t::E_NumberPrunedItems).value());
+                 stats.m_Stats[stat_t::E_NumberPrunedItems].value());
+
+    addStringInt(writer, "E_MaintenanceQueueDepth",
+                 "The number of model maintenance tasks deferred in the last bucket",
+                 stats.m_Stats[stat_t::E_MaintenanceQueueDepth].value());
+
+    addStringInt(writer, "E_NumberProbabilityCacheLookups",
+                 "The number of lookups in the individual model probability caches",
+                 stats.m_Stats[stat_t::E_NumberProbabilityCacheLookups].value());
+
+    addStringInt(writer, "E_NumberProbabilityCacheHits",
+                 "The number of probabilities found in the individual model probability caches",
+                 stats.m_Stats[stat_t::E_NumberProbabilityCacheHits].value());
 
     writer.EndArray();
     writeStream.Flush();
@@ -11,8 +11,11 @@
 #include <boost/multi_array.hpp>
 
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <cstdint>
 #include <limits>
+#include <type_traits>
 
 #include <ctype.h>
 #include <errno.h>
@@ -31,6 +34,192 @@ double clampToReadable(double x) {
     return (x < SMALLEST ? SMALLEST : x > LARGEST ? LARGEST : x);
 }
 
+//! The maximum number of significant digits we parse directly. Larger
+//! mantissas could overflow a 64 bit integer.
+const int MAXIMUM_FAST_DIGITS{19};
+
+//! Powers of ten which are exactly representable as doubles.
+const double EXACT_POWERS_OF_TEN[]{1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+//! Load eight characters into an integer with the first in the low byte.
+std::uint64_t loadEightChars(const char* chars) {
+    std::uint64_t result{0};
+    for (int i = 7; i >= 0; --i) {
+        result = (result << 8) | static_cast<unsigned char>(chars[i]);
+    }
+    return result;
+}
+
+//! Check if all the characters loaded by loadEightChars are digits.
+bool isEightDigits(std::uint64_t chars) {
+    return ((chars & 0xF0F0F0F0F0F0F0F0) |
+            (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+           0x3333333333333333;
+}
+
+//! Convert eight digits loaded by loadEightChars to their value.
+//!
+//! This combines pairs of digits, then pairs of pairs, and so on, using
+//! a handful of multiplications rather than one per digit.
+std::uint64_t parseEightDigits(std::uint64_t chars) {
+    chars -= 0x3030303030303030;
+    chars = (chars * 10) + (chars >> 8);
+    return (((chars & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+            (((chars >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+           32;
+}
+
+//! Read the digits starting at \p begin into \p value.
+//!
+//! \return The end of the digits or null if there are more than
+//! \p maximumDigits digits in total.
+const char* parseDigits(const char* begin,
+                        const char* end,
+                        int maximumDigits,
+                        std::uint64_t& value,
+                        int& digits) {
+    while (end - begin >= 8 && digits + 8 <= maximumDigits) {
+        std::uint64_t chars{loadEightChars(begin)};
+        if (isEightDigits(chars) == false) {
+            break;
+        }
+        value = 100000000 * value + parseEightDigits(chars);
+        digits += 8;
+        begin += 8;
+    }
+    for (/**/; begin != end && *begin >= '0' && *begin <= '9'; ++begin) {
+        if (++digits > maximumDigits) {
+            return nullptr;
+        }
+        value = 10 * value + static_cast<std::uint64_t>(*begin - '0');
+    }
+    return begin;
+}
+
+//! Convert plain decimal strings such as "-12.5e3" to a double.
+//!
+//! If the mantissa is at most 2^53 and the power of ten at most 22 both
+//! are exact doubles and a single multiplication or division is correctly
+//! rounded, so this gives the same result as strtod. Anything else, i.e.
+//! leading white space, hexadecimal, infinities, NaNs or long mantissas,
+//! is left to strtod.
+//!
+//! \return False if the string must be converted by strtod.
+bool fastStringToDouble(const std::string& str, double& result) {
+    if (FLT_EVAL_METHOD != 0) {
+        // Intermediate results are held with extra precision so double
+        // rounding could give a different result to strtod.
+        return false;
+    }
+
+    const char* begin{str.data()};
+    const char* end{begin + str.size()};
+
+    bool negative{false};
+    if (begin != end && (*begin == '-' || *begin == '+')) {
+        negative = (*begin == '-');
+        ++begin;
+    }
+
+    std::uint64_t mantissa{0};
+    int digits{0};
+    std::int64_t exponent{0};
+
+    const char* integer{begin};
+    begin = parseDigits(begin, end, MAXIMUM_FAST_DIGITS, mantissa, digits);
+    if (begin == nullptr) {
+        return false;
+    }
+    bool haveDigits{begin != integer};
+    if (begin != end && *begin == '.') {
+        const char* fraction{++begin};
+        begin = parseDigits(begin, end, MAXIMUM_FAST_DIGITS, mantissa, digits);
+        if (begin == nullptr) {
+            return false;
+        }
+        exponent = -(begin - fraction);
+        haveDigits = haveDigits || begin != fraction;
+    }
+    if (haveDigits == false) {
+        return false;
+    }
+
+    if (begin != end && (*begin == 'e' || *begin == 'E')) {
+        ++begin;
+        bool negativeExponent{false};
+        if (begin != end && (*begin == '-' || *begin == '+')) {
+            negativeExponent = (*begin == '-');
+            ++begin;
+        }
+        std::uint64_t explicitExponent{0};
+        int exponentDigits{0};
+        const char* exponentBegin{begin};
+        begin = parseDigits(begin, end, 4, explicitExponent, exponentDigits);
+        if (begin == nullptr || begin == exponentBegin) {
+            return false;
+        }
+        exponent += negativeExponent ? -static_cast<std::int64_t>(explicitExponent)
+                                     : static_cast<std::int64_t>(explicitExponent);
+    }
+
+    if (begin != end || mantissa > (std::uint64_t{1} << 53) || exponent < -22 || exponent > 22) {
+        return false;
+    }
+
+    double value{static_cast<double>(mantissa)};
+    value = exponent < 0 ? value / EXACT_POWERS_OF_TEN[-exponent]
+                         : value * EXACT_POWERS_OF_TEN[exponent];
+    result = negative ? -value : value;
+    return true;
+}
+
+//! Convert plain decimal integer strings such as "-1234" to \p T.
+//!
+//! This handles an optional sign followed by at most 18 digits without
+//! a leading zero, which is the same as strtol with base 0 provided the
+//! value is in range. Octal, hexadecimal, leading white space, negative
+//! unsigned values and large values are left to the strtol family.
+//!
+//! \return False if the string must be converted by the strtol family.
+template<typename T>
+bool fastStringToInteger(const std::string& str, T& result) {
+    const char* begin{str.data()};
+    const char* end{begin + str.size()};
+
+    bool negative{false};
+    if (begin != end && (*begin == '-' || *begin == '+')) {
+        negative = (*begin == '-');
+        ++begin;
+    }
+    if (begin == end || (*begin == '0' && end - begin > 1) ||
+        (negative && std::is_unsigned<T>::value)) {
+        return false;
+    }
+
+    std::uint64_t magnitude{0};
+    int digits{0};
+    const char* digitsEnd{parseDigits(begin, end, 18, magnitude, digits)};
+    if (digitsEnd != end || digits == 0) {
+        return false;
+    }
+
+    if (negative) {
+        std::int64_t value{-static_cast<std::int64_t>(magnitude)};
+        if (value < static_cast<std::int64_t>(std::numeric_limits<T>::min())) {
+            return false;
+        }
+        result = static_cast<T>(value);
+    } else {
+        if (magnitude > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+            return false;
+        }
+        result = static_cast<T>(magnitude);
+    }
+    return true;
+}
+
 // To ensure the singleton locale is constructed before multiple threads may
 // require it, call locale() during the static initialisation phase of the
 // program.  Of course, the locale may already be constructed before this if
@@ -438,6 +627,10 @@ std::string CStringUtils::typeToStringPrecise(double d, CIEEE754::EPrecision pre
 }
 
 bool CStringUtils::_stringToType(bool silent, const std::string& str, unsigned long long& i) {
+    if (fastStringToInteger(str, i)) {
+        return true;
+    }
+
     if (str.empty()) {
         if (!silent) {
             LOG_ERROR(<< "Unable to convert empty string to unsigned long long");
@@ -486,6 +679,10 @@ bool CStringUtils::_stringToType(bool silent, const std::string& str, unsigned l
 }
 
 bool CStringUtils::_stringToType(bool silent, const std::string& str, unsigned long& i) {
+    if (fastStringToInteger(str, i)) {
+        return true;
+    }
+
     if (str.empty()) {
         if (!silent) {
             LOG_ERROR(<< "Unable to convert empty string to unsigned long");
@@ -580,6 +777,10 @@ bool CStringUtils::_stringToType(bool silent, const std::string& str, unsigned s
 }
 
 bool CStringUtils::_stringToType(bool silent, const std::string& str, long long& i) {
+    if (fastStringToInteger(str, i)) {
+        return true;
+    }
+
     if (str.empty()) {
         if (!silent) {
             LOG_ERROR(<< "Unable to convert empty string to long long");
@@ -628,6 +829,10 @@ bool CStringUtils::_stringToType(bool silent, const std::string& str, long long&
 }
 
 bool CStringUtils::_stringToType(bool silent, const std::string& str, long& i) {
+    if (fastStringToInteger(str, i)) {
+        return true;
+    }
+
     if (str.empty()) {
         if (!silent) {
             LOG_ERROR(<< "Unable to convert empty string to long");
@@ -791,6 +996,10 @@ bool CStringUtils::_stringToType(bool silent, const std::string& str, bool& ret)
 }
 
 bool CStringUtils::_stringToType(bool silent, const std::string& str, double& d) {
+    if (fastStringToDouble(str, d)) {
+        return true;
+    }
+
     if (str.empty()) {
         if (!silent) {
             LOG_ERROR(<< "Unable to convert empty string to double");
@@ -0,0 +1,72 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <core/CThreadPool.h>
+
+#include <boost/threadpool.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+namespace ml {
+namespace core {
+
+//! \brief Wraps up the boost thread pool.
+class CThreadPool::CWorkers {
+public:
+    explicit CWorkers(std::size_t numberThreads) : m_Pool(numberThreads) {}
+
+    boost::threadpool::pool& pool() { return m_Pool; }
+
+private:
+    boost::threadpool::pool m_Pool;
+};
+
+CThreadPool::CThreadPool(std::size_t numberThreads)
+    : m_NumberThreads(std::max(numberThreads, std::size_t(1))) {
+    if (m_NumberThreads > 1) {
+        m_Workers = std::make_unique<CWorkers>(m_NumberThreads - 1);
+    }
+}
+
+CThreadPool::~CThreadPool() {
+}
+
+std::size_t CThreadPool::numberThreads() const {
+    return m_NumberThreads;
+}
+
+void CThreadPool::parallelForEach(std::size_t n, const TSizeFunc& f) {
+    std::size_t numberThreads{std::min(m_NumberThreads, n)};
+    if (numberThreads <= 1) {
+        for (std::size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&next, n, &f]() {
+        for (std::size_t i = next++; i < n; i = next++) {
+            f(i);
+        }
+    };
+
+    boost::threadpool::pool& pool{m_Workers->pool()};
+    for (std::size_t i = 1; i < numberThreads; ++i) {
+        pool.schedule(worker);
+    }
+    try {
+        worker();
+    } catch (...) {
+        // The scheduled tasks reference this stack frame.
+        pool.wait();
+        throw;
+    }
+    pool.wait();
+}
+}
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include <core/CTimeFormatParser.h>
+
+#include <core/CTimeUtils.h>
+#include <core/CTimezone.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#include <ctype.h>
+#include <time.h>
+
+namespace ml {
+namespace core {
+namespace {
+
+bool isSpace(char c) {
+    return ::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+//! Read a number in the range [\p from, \p to] with at most \p n digits.
+//!
+//! This matches the way strptime reads numbers, i.e. leading white space
+//! is skipped and digits are only consumed while the value can remain
+//! in range.
+bool readNumber(const char*& dateTime,
+                std::int64_t from,
+                std::int64_t to,
+                int n,
+                std::int64_t& result) {
+    while (isSpace(*dateTime)) {
+        ++dateTime;
+    }
+    if (isDigit(*dateTime) == false) {
+        return false;
+    }
+    std::int64_t value{0};
+    do {
+        value = 10 * value + (*dateTime++ - '0');
+    } while (--n > 0 && value * 10 <= to && isDigit(*dateTime));
+    if (value < from || value > to) {
+        return false;
+    }
+    result = value;
+    return true;
+}
+
+//! Append \p value to \p result zero padded to \p width digits.
+void appendPadded(std::int64_t value, int width, std::string& result) {
+    char buffer[32];
+    int length{std::snprintf(buffer, sizeof(buffer), "%0*lld", width,
+                             static_cast<long long>(value))};
+    result.append(buffer, static_cast<std::size_t>(std::max(length, 0)));
+}
+
+//! The largest number of digits in an epoch time we parse directly.
+const int MAXIMUM_EPOCH_DIGITS{15};
+}
+
+CTimeFormatParser::CTimeFormatParser(const std::string& format)
+    : m_Format(format), m_Compiled(false), m_MaximumSecondOfHour(0),
+      m_Timezone(&CTimezone::instance()), m_CachedTimezoneGeneration(0),
+      m_CachedHourIsRegular(false), m_CachedHourStart(0) {
+    m_Compiled = this->compile();
+    if (m_Compiled == false) {
+        m_Tokens.clear();
+    }
+    // Make sure the first lookup misses.
+    m_CachedHour.s_Values[E_YearField] = -1;
+}
+
+const std::string& CTimeFormatParser::format() const {
+    return m_Format;
+}
+
+bool CTimeFormatParser::isCompiled() const {
+    return m_Compiled;
+}
+
+bool CTimeFormatParser::parse(const std::string& dateTime, core_t::TTime& result) {
+    SFields fields;
+    if (m_Compiled == false || this->parseFields(dateTime.c_str(), fields) == false) {
+        return CTimeUtils::strptimeSilent(m_Format, dateTime, result);
+    }
+
+    std::uint64_t generation{m_Timezone->generation()};
+    if (fields.sameHour(m_CachedHour) == false || generation != m_CachedTimezoneGeneration) {
+        m_CachedTimezoneGeneration = generation;
+        this->updateCache(fields);
+    }
+    if (m_CachedHourIsRegular == false) {
+        return CTimeUtils::strptimeSilent(m_Format, dateTime, result);
+    }
+
+    result = m_CachedHourStart + 60 * fields.s_Values[E_MinuteField] +
+             fields.s_Values[E_SecondField];
+    return true;
+}
+
+bool CTimeFormatParser::compile() {
+    for (std::size_t i = 0; i < m_Format.size(); ++i) {
+        char c{m_Format[i]};
+        if (isSpace(c)) {
+            // Any amount of white space in the format matches any amount
+            // of white space in the input.
+            if (m_Tokens.empty() || m_Tokens.back().s_Type != E_Space) {
+                m_Tokens.push_back({E_Space, ' '});
+            }
+            continue;
+        }
+        if (c != '%') {
+            m_Tokens.push_back({E_Literal, c});
+            continue;
+        }
+        if (++i == m_Format.size()) {
+            return false;
+        }
+        switch (m_Format[i]) {
+        case 'Y':
+            m_Tokens.push_back({E_Year, ' '});
+            break;
+        case 'm':
+            m_Tokens.push_back({E_Month, ' '});
+            break;
+        case 'd':
+            m_Tokens.push_back({E_Day, ' '});
+            break;
+        case 'H':
+            m_Tokens.push_back({E_Hour, ' '});
+            break;
+        case 'M':
+            m_Tokens.push_back({E_Minute, ' '});
+            break;
+        case 'S':
+            m_Tokens.push_back({E_Second, ' '});
+            break;
+        case 'T':
+            m_Tokens.insert(m_Tokens.end(), {{E_Hour, ' '},
+                                             {E_Literal, ':'},
+                                             {E_Minute, ' '},
+                                             {E_Literal, ':'},
+                                             {E_Second, ' '}});
+            break;
+        case 'F':
+            m_Tokens.insert(m_Tokens.end(), {{E_Year, ' '},
+                                             {E_Literal, '-'},
+                                             {E_Month, ' '},
+                                             {E_Literal, '-'},
+                                             {E_Day, ' '}});
+            break;
+        case 'z':
+            m_Tokens.push_back({E_Offset, ' '});
+            break;
+        case 's':
+            m_Tokens.push_back({E_Epoch, ' '});
+            break;
+        case '%':
+            m_Tokens.push_back({E_Literal, '%'});
+            break;
+        default:
+            return false;
+        }
+    }
+
+    auto count = [this](EToken type) {
+        return std::count_if(m_Tokens.begin(), m_Tokens.end(),
+                             [type](const SToken& token) {
+                                 return token.s_Type == type;
+                             });
+    };
+
+    if (count(E_Epoch) > 0) {
+        // This must be the only directive.
+        if (count(E_Epoch) + count(E_Space) != static_cast<std::ptrdiff_t>(m_Tokens.size())) {
+            return false;
+        }
+        m_MaximumSecondOfHour = 3599;
+        return true;
+    }
+
+    for (auto type : {E_Year, E_Month, E_Day, E_Hour, E_Minute, E_Second, E_Offset}) {
+        if (count(type) > 1) {
+            return false;
+        }
+    }
+    // Without a year strptimeSilent has to guess it and without a month
+    // or day the date is normalised in ways we don't replicate.
+    if (count(E_Year) == 0 || count(E_Month) == 0 || count(E_Day) == 0) {
+        return false;
+    }
+    // The offset must be the last directive.
+    auto offset = std::find_if(m_Tokens.begin(), m_Tokens.end(), [](const SToken& token) {
+        return token.s_Type == E_Offset;
+    });
+    if (offset != m_Tokens.end() &&
+        std::any_of(offset + 1, m_Tokens.end(), [](const SToken& token) {
+            return token.s_Type != E_Space;
+        })) {
+        return false;
+    }
+
+    m_MaximumSecondOfHour = (count(E_Minute) > 0 ? 3540 : 0) + (count(E_Second) > 0 ? 59 : 0);
+    return true;
+}
+
+bool CTimeFormatParser::parseFields(const char* dateTime, SFields& fields) const {
+    auto& values = fields.s_Values;
+
+    for (const auto& token : m_Tokens) {
+        switch (token.s_Type) {
+        case E_Literal:
+            if (*dateTime++ != token.s_Literal) {
+                return false;
+            }
+            break;
+        case E_Space:
+            while (isSpace(*dateTime)) {
+                ++dateTime;
+            }
+            break;
+        case E_Year:
+            // strptimeSilent guesses the year if it is 1900.
+            if (readNumber(dateTime, 0, 9999, 4, values[E_YearField]) == false ||
+                values[E_YearField] == 1900) {
+                return false;
+            }
+            break;
+        case E_Month:
+            if (readNumber(dateTime, 1, 12, 2, values[E_MonthField]) == false) {
+                return false;
+            }
+            break;
+        case E_Day:
+            if (readNumber(dateTime, 1, 31, 2, values[E_DayField]) == false) {
+                return false;
+            }
+            break;
+        case E_Hour:
+            if (readNumber(dateTime, 0, 23, 2, values[E_HourField]) == false) {
+                return false;
+            }
+            break;
+        case E_Minute:
+            if (readNumber(dateTime, 0, 59, 2, values[E_MinuteField]) == false) {
+                return false;
+            }
+            break;
+        case E_Second:
+            // Leap seconds are normalised so leave them to strptimeSilent.
+            if (readNumber(dateTime, 0, 61, 2, values[E_SecondField]) == false ||
+                values[E_SecondField] > 59) {
+                return false;
+            }
+            break;
+        case E_Offset: {
+            // We expect a sign followed by hhmm, as per CStrPTime.
+            while (isSpace(*dateTime)) {
+                ++dateTime;
+            }
+            std::int64_t sign{*dateTime == '+' ? 1 : (*dateTime == '-' ? -1 : 0)};
+            if (sign == 0 || dateTime[1] < '0' || dateTime[1] > '2' ||
+                isDigit(dateTime[2]) == false || dateTime[3] < '0' ||
+                dateTime[3] > '5' || isDigit(dateTime[4]) == false) {
+                return false;
+            }
+            values[E_OffsetField] =
+                sign * (600 * (dateTime[1] - '0') + 60 * (dateTime[2] - '0') +
+                        10 * (dateTime[3] - '0') + (dateTime[4] - '0'));
+            dateTime += 5;
+            break;
+        }
+        case E_Epoch: {
+            std::int64_t epoch{0};
+            int digits{0};
+            for (/**/; isDigit(*dateTime); ++dateTime) {
+                if (++digits > MAXIMUM_EPOCH_DIGITS) {
+                    return false;
+                }
+                epoch = 10 * epoch + (*dateTime - '0');
+            }
+            if (digits == 0) {
+                return false;
+            }
+            values[E_HourField] = epoch / 3600;
+            values[E_MinuteField] = (epoch % 3600) / 60;
+            values[E_SecondField] = epoch % 60;
+            break;
+        }
+        }
+    }
+
+    // Anything after the end of the format is ignored by strptimeSilent.
+    return true;
+}
+
+std::string CTimeFormatParser::print(const SFields& fields) const {
+    const auto& values = fields.s_Values;
+
+    std::string result;
+    for (const auto& token : m_Tokens) {
+        switch (token.s_Type) {
+        case E_Literal:
+            result += token.s_Literal;
+            break;
+        case E_Space:
+            result += ' ';
+            break;
+        case E_Year:
+            appendPadded(values[E_YearField], 4, result);
+            break;
+        case E_Month:
+            appendPadded(values[E_MonthField], 2, result);
+            break;
+        case E_Day:
+            appendPadded(values[E_DayField], 2, result);
+            break;
+        case E_Hour:
+            appendPadded(values[E_HourField], 2, result);
+            break;
+        case E_Minute:
+            appendPadded(values[E_MinuteField], 2, result);
+            break;
+        case E_Second:
+            appendPadded(values[E_SecondField], 2, result);
+            break;
+        case E_Offset: {
+            std::int64_t offset{values[E_OffsetField]};
+            result += offset < 0 ? '-' : '+';
+            offset = std::abs(offset);
+            appendPadded(100 * (offset / 60) + offset % 60, 4, result);
+            break;
+        }
+        case E_Epoch:
+            appendPadded(3600 * values[E_HourField] + 60 * values[E_MinuteField] +
+                             values[E_SecondField],
+                         1, result);
+            break;
+        }
+    }
+    return result;
+}
+
+void CTimeFormatParser::updateCache(const SFields& fields) {
+    m_CachedHour = fields;
+    m_CachedHourIsRegular = false;
+
+    SFields first{fields};
+    first.s_Values[E_MinuteField] = 0;
+    first.s_Values[E_SecondField] = 0;
+    SFields last{fields};
+    last.s_Values[E_MinuteField] = m_MaximumSecondOfHour / 60;
+    last.s_Values[E_SecondField] = m_MaximumSecondOfHour % 60;
+
+    core_t::TTime firstTime;
+    core_t::TTime lastTime;
+    if (CTimeUtils::strptimeSilent(m_Format, this->print(first), firstTime) == false ||
+        CTimeUtils::strptimeSilent(m_Format, this->print(last), lastTime) == false ||
+        lastTime - firstTime != m_MaximumSecondOfHour) {
+        return;
+    }
+
+    // Check there is no daylight saving transition at the boundaries of
+    // the hour, in which case local times in the hour can be ambiguous.
+    struct tm before;
+    struct tm after;
+    if (m_Timezone->utcToLocal(firstTime - 1, before) == false ||
+        m_Timezone->utcToLocal(lastTime + 1, after) == false ||
+        before.tm_isdst != after.tm_isdst) {
+        return;
+    }
+
+    m_CachedHourIsRegular = true;
+    m_CachedHourStart = firstTime;
+}
+
+CTimeFormatParser::SFields::SFields() {
+    s_Values.fill(0);
+}
+
+bool CTimeFormatParser::SFields::sameHour(const SFields& other) const {
+    return std::equal(s_Values.begin(), s_Values.begin() + HOUR_KEY_SIZE,
+                      other.s_Values.begin());
+}
+}
+}
@@ -53,10 +53,15 @@ bool CTimezone::timezoneName(const std::string& name) {
     ::tzset();
 
     m_Name = name;
+    ++m_Generation;
 
     return true;
 }
 
+std::uint64_t CTimezone::generation() const {
+    return m_Generation.load(std::memory_order_acquire);
+}
+
 bool CTimezone::setTimezone(const std::string& timezone) {
     return CTimezone::instance().timezoneName(timezone);
 }
@@ -76,6 +76,7 @@ bool CTimezone::timezoneName(const std::string& name) {
     if (name.empty()) {
         m_Timezone.reset();
         m_Name.clear();
+        ++m_Generation;
         return true;
     }
 
@@ -84,15 +85,21 @@ bool CTimezone::timezoneName(const std::string& name) {
         LOG_ERROR(<< "Unable to set timezone to " << name
                   << " - operating system timezone settings will be used instead");
         m_Name.clear();
+        ++m_Generation;
 
         return false;
     }
 
     m_Name = name;
+    ++m_Generation;
 
     return true;
 }
 
+std::uint64_t CTimezone::generation() const {
+    return m_Generation.load(std::memory_order_acquire);
+}
+
 bool CTimezone::setTimezone(const std::string& timezone) {
     return CTimezone::instance().timezoneName(timezone);
 }
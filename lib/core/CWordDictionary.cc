@@ -6,14 +6,20 @@
 #include <core/CWordDictionary.h>
 
 #include <core/CLogger.h>
+#include <core/COsFileFuncs.h>
 #include <core/CResourceLocator.h>
 #include <core/CScopedFastLock.h>
-#include <core/CStrCaseCmp.h>
 #include <core/CStringUtils.h>
 
-#include <fstream>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/unordered_map.hpp>
 
-#include <ctype.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 namespace ml {
 namespace core {
@@ -63,9 +69,149 @@ CWordDictionary::EPartOfSpeech partOfSpeechFromCode(char partOfSpeechCode) {
     // This should be treated as an error when returned by this function
     return CWordDictionary::E_NotInDictionary;
 }
+
+//! The image starts with these characters.
+const char IMAGE_MAGIC[] = {'M', 'L', 'W', 'D'};
+//! The image format version.
+const std::uint32_t IMAGE_VERSION(1);
+//! Written in the host byte order to detect images with the wrong one.
+const std::uint32_t IMAGE_BYTE_ORDER(0x01020304);
+//! The average number of words per bucket.
+const std::uint32_t WORDS_PER_BUCKET(4);
+//! The maximum displacement to try for a bucket.
+const std::uint32_t MAXIMUM_DISPLACEMENT(1 << 24);
+
+//! \brief The image header.
+struct SHeader {
+    char s_Magic[sizeof(IMAGE_MAGIC)];
+    std::uint32_t s_Version;
+    std::uint32_t s_ByteOrder;
+    std::uint32_t s_NumberWords;
+    std::uint32_t s_NumberBuckets;
+    std::uint32_t s_PoolSize;
+};
+
+char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+//! FNV-1a hash of the lower case characters of a word.
+std::uint64_t hashIgnoreCase(const char* word, std::size_t length) {
+    std::uint64_t hash(0xcbf29ce484222325ull);
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(toLower(word[i]));
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+//! The MurmurHash3 finaliser.
+std::uint64_t mix(std::uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
 }
 
+std::uint32_t bucket(std::uint64_t hash, std::uint32_t numberBuckets) {
+    return static_cast<std::uint32_t>(mix(hash ^ 0x5bd1e9955bd1e995ull) % numberBuckets);
+}
+
+std::uint32_t slot(std::uint64_t hash, std::uint32_t displacement, std::uint32_t numberSlots) {
+    return static_cast<std::uint32_t>(
+        mix(hash + (displacement + 1) * 0x9e3779b97f4a7c15ull) % numberSlots);
+}
+
+bool equalIgnoreCase(const char* lhs, const char* rhs, std::size_t length) {
+    for (std::size_t i = 0; i < length; ++i) {
+        if (toLower(lhs[i]) != toLower(rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+class CStrHashIgnoreCase {
+public:
+    std::size_t operator()(const std::string& str) const {
+        return static_cast<std::size_t>(hashIgnoreCase(str.data(), str.length()));
+    }
+};
+
+class CStrEqualIgnoreCase {
+public:
+    bool operator()(const std::string& lhs, const std::string& rhs) const {
+        return lhs.length() == rhs.length() &&
+               equalIgnoreCase(lhs.data(), rhs.data(), lhs.length());
+    }
+};
+
+using TStrPartOfSpeechPr = std::pair<std::string, CWordDictionary::EPartOfSpeech>;
+using TStrPartOfSpeechPrVec = std::vector<TStrPartOfSpeechPr>;
+
+//! Read the words and their parts of speech from \p text.  If a word
+//! appears more than once, ignoring case, the last part of speech wins.
+void readWords(std::istream& text, TStrPartOfSpeechPrVec& words) {
+    using TStrSizeUMap =
+        boost::unordered_map<std::string, std::size_t, CStrHashIgnoreCase, CStrEqualIgnoreCase>;
+
+    TStrSizeUMap indices;
+    std::string word;
+    while (std::getline(text, word)) {
+        CStringUtils::trimWhitespace(word);
+        if (word.empty()) {
+            continue;
+        }
+        size_t sepPos(word.find(PART_OF_SPEECH_SEPARATOR));
+        if (sepPos == std::string::npos) {
+            LOG_ERROR(<< "Found word with no part-of-speech separator: " << word);
+            continue;
+        }
+        if (sepPos == 0) {
+            LOG_ERROR(<< "Found part-of-speech separator with no preceding word: " << word);
+            continue;
+        }
+        if (sepPos + 1 >= word.length()) {
+            LOG_ERROR(<< "Found word with no part-of-speech code: " << word);
+            continue;
+        }
+        char partOfSpeechCode(word[sepPos + 1]);
+        CWordDictionary::EPartOfSpeech partOfSpeech(partOfSpeechFromCode(partOfSpeechCode));
+        if (partOfSpeech == CWordDictionary::E_NotInDictionary) {
+            LOG_ERROR(<< "Unknown part-of-speech code (" << partOfSpeechCode
+                      << ") for word: " << word);
+            continue;
+        }
+        word.erase(sepPos);
+        auto index = indices.emplace(word, words.size());
+        if (index.second) {
+            words.emplace_back(word, partOfSpeech);
+        } else {
+            words[index.first->second].second = partOfSpeech;
+        }
+    }
+}
+
+template<typename T>
+void write(std::ostream& image, const T& value) {
+    image.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}
+
+//! \brief A slot of the hash table.
+struct CWordDictionary::SSlot {
+    //! The offset of the word in the pool.
+    std::uint32_t s_Offset;
+    //! The length of the word.
+    std::uint16_t s_Length;
+    //! The word's part of speech.
+    std::uint16_t s_PartOfSpeech;
+};
+
 const char* const CWordDictionary::DICTIONARY_FILE("ml-en.dict");
+const char* const CWordDictionary::DICTIONARY_IMAGE_FILE("ml-en.dict.bin");
 
 CFastMutex CWordDictionary::ms_LoadMutex;
 volatile CWordDictionary* CWordDictionary::ms_Instance(nullptr);
@@ -88,59 +234,124 @@ const CWordDictionary& CWordDictionary::instance() {
 }
 
 bool CWordDictionary::isInDictionary(const std::string& str) const {
-    return m_DictionaryWords.find(str) != m_DictionaryWords.end();
+    return this->lookup(str.data(), str.length()) != E_NotInDictionary;
 }
 
 CWordDictionary::EPartOfSpeech CWordDictionary::partOfSpeech(const std::string& str) const {
-    TStrUMapCItr iter = m_DictionaryWords.find(str);
-    if (iter == m_DictionaryWords.end()) {
-        return E_NotInDictionary;
-    }
-    return iter->second;
+    return this->lookup(str.data(), str.length());
 }
 
-CWordDictionary::CWordDictionary() {
-    std::string fileToLoad(CResourceLocator::resourceDir() + '/' + DICTIONARY_FILE);
+bool CWordDictionary::compile(std::istream& text, std::ostream& image) {
+    TStrPartOfSpeechPrVec words;
+    readWords(text, words);
 
-    // If the file can't be read for some reason, we just end up with an empty
-    // dictionary
-    std::ifstream ifs(fileToLoad.c_str());
-    if (ifs.is_open()) {
-        LOG_DEBUG(<< "Populating word dictionary from file " << fileToLoad);
+    std::uint32_t numberWords(static_cast<std::uint32_t>(words.size()));
+    std::uint32_t numberBuckets(std::max((numberWords + WORDS_PER_BUCKET - 1) / WORDS_PER_BUCKET,
+                                         std::uint32_t(1)));
 
-        std::string word;
-        while (std::getline(ifs, word)) {
-            CStringUtils::trimWhitespace(word);
-            if (word.empty()) {
-                continue;
-            }
-            size_t sepPos(word.find(PART_OF_SPEECH_SEPARATOR));
-            if (sepPos == std::string::npos) {
-                LOG_ERROR(<< "Found word with no part-of-speech separator: " << word);
-                continue;
-            }
-            if (sepPos == 0) {
-                LOG_ERROR(<< "Found part-of-speech separator with no preceding word: " << word);
-                continue;
-            }
-            if (sepPos + 1 >= word.length()) {
-                LOG_ERROR(<< "Found word with no part-of-speech code: " << word);
-                continue;
+    using TUInt32Vec = std::vector<std::uint32_t>;
+    using TUInt32VecVec = std::vector<TUInt32Vec>;
+    using TUInt64Vec = std::vector<std::uint64_t>;
+
+    TUInt64Vec hashes;
+    hashes.reserve(words.size());
+    TUInt32VecVec buckets(numberBuckets);
+    for (std::uint32_t i = 0; i < numberWords; ++i) {
+        const std::string& word(words[i].first);
+        if (word.length() > std::numeric_limits<std::uint16_t>::max()) {
+            LOG_ERROR(<< "Word too long: " << word);
+            return false;
+        }
+        hashes.push_back(hashIgnoreCase(word.data(), word.length()));
+        buckets[bucket(hashes.back(), numberBuckets)].push_back(i);
+    }
+
+    // Place the largest buckets first while there's most freedom.
+    TUInt32Vec order(numberBuckets);
+    for (std::uint32_t i = 0; i < numberBuckets; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](std::uint32_t lhs, std::uint32_t rhs) {
+        return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    static const std::uint32_t EMPTY(std::numeric_limits<std::uint32_t>::max());
+    TUInt32Vec displacements(numberBuckets, 0);
+    TUInt32Vec slots(numberWords, EMPTY);
+    TUInt32Vec candidates;
+    for (auto b : order) {
+        const TUInt32Vec& bucket_(buckets[b]);
+        if (bucket_.empty()) {
+            break;
+        }
+        std::uint32_t displacement(0);
+        for (/**/; displacement < MAXIMUM_DISPLACEMENT; ++displacement) {
+            candidates.clear();
+            for (auto i : bucket_) {
+                std::uint32_t candidate(slot(hashes[i], displacement, numberWords));
+                if (slots[candidate] != EMPTY ||
+                    std::find(candidates.begin(), candidates.end(), candidate) !=
+                        candidates.end()) {
+                    break;
+                }
+                candidates.push_back(candidate);
             }
-            char partOfSpeechCode(word[sepPos + 1]);
-            EPartOfSpeech partOfSpeech(partOfSpeechFromCode(partOfSpeechCode));
-            if (partOfSpeech == E_NotInDictionary) {
-                LOG_ERROR(<< "Unknown part-of-speech code (" << partOfSpeechCode
-                          << ") for word: " << word);
-                continue;
+            if (candidates.size() == bucket_.size()) {
+                break;
             }
-            word.erase(sepPos);
-            m_DictionaryWords[word] = partOfSpeech;
         }
+        if (displacement == MAXIMUM_DISPLACEMENT) {
+            LOG_ERROR(<< "Failed to find a displacement for " << bucket_.size() << " words");
+            return false;
+        }
+        displacements[b] = displacement;
+        for (std::size_t i = 0; i < bucket_.size(); ++i) {
+            slots[candidates[i]] = bucket_[i];
+        }
+    }
+
+    // Store the words in slot order so lookups of nearby slots are local.
+    std::string pool;
+    std::vector<SSlot> slots_(numberWords);
+    for (std::uint32_t i = 0; i < numberWords; ++i) {
+        const TStrPartOfSpeechPr& word(words[slots[i]]);
+        slots_[i].s_Offset = static_cast<std::uint32_t>(pool.length());
+        slots_[i].s_Length = static_cast<std::uint16_t>(word.first.length());
+        slots_[i].s_PartOfSpeech = static_cast<std::uint16_t>(word.second);
+        pool += word.first;
+    }
+    if (pool.length() > std::numeric_limits<std::uint32_t>::max()) {
+        LOG_ERROR(<< "Dictionary too large");
+        return false;
+    }
+
+    SHeader header;
+    std::memcpy(header.s_Magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+    header.s_Version = IMAGE_VERSION;
+    header.s_ByteOrder = IMAGE_BYTE_ORDER;
+    header.s_NumberWords = numberWords;
+    header.s_NumberBuckets = numberBuckets;
+    header.s_PoolSize = static_cast<std::uint32_t>(pool.length());
+    write(image, header);
+    for (auto displacement : displacements) {
+        write(image, displacement);
+    }
+    for (const auto& slot_ : slots_) {
+        write(image, slot_);
+    }
+    image.write(pool.data(), pool.length());
+
+    return image.good();
+}
 
-        LOG_DEBUG(<< "Populated word dictionary with " << m_DictionaryWords.size() << " words");
-    } else {
-        LOG_ERROR(<< "Failed to open dictionary file " << fileToLoad);
+CWordDictionary::CWordDictionary()
+    : m_NumberWords(0), m_NumberBuckets(0), m_PoolSize(0),
+      m_Displacements(nullptr), m_Slots(nullptr), m_Pool(nullptr) {
+    std::string resourceDir(CResourceLocator::resourceDir() + '/');
+    if (this->mapImage(resourceDir + DICTIONARY_IMAGE_FILE) == false) {
+        // If the text can't be read for some reason, we just end up with an
+        // empty dictionary
+        this->compileText(resourceDir + DICTIONARY_FILE);
     }
 }
 
@@ -148,21 +359,108 @@ CWordDictionary::~CWordDictionary() {
     ms_Instance = nullptr;
 }
 
-size_t CWordDictionary::CStrHashIgnoreCase::operator()(const std::string& str) const {
-    size_t hash(0);
+bool CWordDictionary::mapImage(const std::string& fileName) {
+    COsFileFuncs::TStat buf;
+    if (COsFileFuncs::stat(fileName.c_str(), &buf) != 0) {
+        LOG_DEBUG(<< "No precompiled word dictionary " << fileName);
+        return false;
+    }
 
-    for (std::string::const_iterator iter = str.begin(); iter != str.end(); ++iter) {
-        hash *= 17;
-        hash += ::tolower(*iter);
+    try {
+        m_MappedImage = std::make_unique<boost::iostreams::mapped_file_source>(fileName);
+    } catch (const std::exception& e) {
+        LOG_ERROR(<< "Failed to map word dictionary " << fileName << ": " << e.what());
+        m_MappedImage.reset();
+        return false;
     }
 
-    return hash;
+    if (this->attach(m_MappedImage->data(), m_MappedImage->size()) == false) {
+        LOG_ERROR(<< "Invalid word dictionary " << fileName);
+        m_MappedImage.reset();
+        return false;
+    }
+
+    LOG_DEBUG(<< "Mapped word dictionary " << fileName << " with "
+              << m_NumberWords << " words");
+    return true;
+}
+
+bool CWordDictionary::compileText(const std::string& fileName) {
+    std::ifstream ifs(fileName.c_str());
+    if (ifs.is_open() == false) {
+        LOG_ERROR(<< "Failed to open dictionary file " << fileName);
+        return false;
+    }
+
+    LOG_DEBUG(<< "Populating word dictionary from file " << fileName);
+
+    std::ostringstream image;
+    if (compile(ifs, image) == false) {
+        LOG_ERROR(<< "Failed to compile dictionary file " << fileName);
+        return false;
+    }
+    m_CompiledImage = image.str();
+    if (this->attach(m_CompiledImage.data(), m_CompiledImage.size()) == false) {
+        LOG_ERROR(<< "Invalid compiled dictionary file " << fileName);
+        m_CompiledImage.clear();
+        return false;
+    }
+
+    LOG_DEBUG(<< "Populated word dictionary with " << m_NumberWords << " words");
+    return true;
+}
+
+bool CWordDictionary::attach(const char* image, std::size_t size) {
+    static_assert(sizeof(SSlot) == 8, "Image slots must not be padded");
+
+    SHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, image, sizeof(header));
+    if (std::memcmp(header.s_Magic, IMAGE_MAGIC, sizeof(IMAGE_MAGIC)) != 0 ||
+        header.s_Version != IMAGE_VERSION || header.s_ByteOrder != IMAGE_BYTE_ORDER ||
+        header.s_NumberBuckets == 0) {
+        return false;
+    }
+
+    std::size_t expectedSize(sizeof(header) +
+                             sizeof(std::uint32_t) * header.s_NumberBuckets +
+                             sizeof(SSlot) * header.s_NumberWords + header.s_PoolSize);
+    if (size != expectedSize) {
+        return false;
+    }
+
+    m_NumberWords = header.s_NumberWords;
+    m_NumberBuckets = header.s_NumberBuckets;
+    m_PoolSize = header.s_PoolSize;
+    image += sizeof(header);
+    m_Displacements = reinterpret_cast<const std::uint32_t*>(image);
+    image += sizeof(std::uint32_t) * m_NumberBuckets;
+    m_Slots = reinterpret_cast<const SSlot*>(image);
+    image += sizeof(SSlot) * m_NumberWords;
+    m_Pool = image;
+
+    return true;
 }
 
-bool CWordDictionary::CStrEqualIgnoreCase::operator()(const std::string& lhs,
-                                                      const std::string& rhs) const {
-    return lhs.length() == rhs.length() &&
-           CStrCaseCmp::strCaseCmp(lhs.c_str(), rhs.c_str()) == 0;
+CWordDictionary::EPartOfSpeech CWordDictionary::lookup(const char* word,
+                                                       std::size_t length) const {
+    if (m_NumberWords == 0) {
+        return E_NotInDictionary;
+    }
+
+    std::uint64_t hash(hashIgnoreCase(word, length));
+    std::uint32_t displacement(m_Displacements[bucket(hash, m_NumberBuckets)]);
+    const SSlot& candidate(m_Slots[slot(hash, displacement, m_NumberWords)]);
+
+    // Every string hashes to some slot so we must check it holds this word.
+    if (candidate.s_Length != length ||
+        static_cast<std::size_t>(candidate.s_Offset) + length > m_PoolSize ||
+        equalIgnoreCase(word, m_Pool + candidate.s_Offset, length) == false) {
+        return E_NotInDictionary;
+    }
+    return static_cast<EPartOfSpeech>(candidate.s_PartOfSpeech);
 }
 }
 }
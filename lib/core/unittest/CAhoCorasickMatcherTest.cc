@@ -0,0 +1,131 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CAhoCorasickMatcherTest.h"
+
+#include <core/CAhoCorasickMatcher.h>
+#include <core/CLogger.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ml;
+using namespace core;
+
+CppUnit::Test* CAhoCorasickMatcherTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CAhoCorasickMatcherTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickMatcherTest>(
+        "CAhoCorasickMatcherTest::testEmpty", &CAhoCorasickMatcherTest::testEmpty));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickMatcherTest>(
+        "CAhoCorasickMatcherTest::testSimple", &CAhoCorasickMatcherTest::testSimple));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickMatcherTest>(
+        "CAhoCorasickMatcherTest::testOverlappingPatterns",
+        &CAhoCorasickMatcherTest::testOverlappingPatterns));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAhoCorasickMatcherTest>(
+        "CAhoCorasickMatcherTest::testRandom", &CAhoCorasickMatcherTest::testRandom));
+
+    return suiteOfTests;
+}
+
+void CAhoCorasickMatcherTest::testEmpty() {
+    CAhoCorasickMatcher matcher;
+    CPPUNIT_ASSERT(matcher.empty());
+    CPPUNIT_ASSERT(matcher.matches("") == false);
+    CPPUNIT_ASSERT(matcher.matches("foo") == false);
+
+    // Empty patterns are ignored.
+    CPPUNIT_ASSERT(matcher.build({"", ""}));
+    CPPUNIT_ASSERT(matcher.empty());
+    CPPUNIT_ASSERT(matcher.matches("foo") == false);
+
+    CPPUNIT_ASSERT(matcher.build({"", "oo"}));
+    CPPUNIT_ASSERT(matcher.empty() == false);
+    CPPUNIT_ASSERT(matcher.matches("") == false);
+    CPPUNIT_ASSERT(matcher.matches("foo"));
+
+    matcher.clear();
+    CPPUNIT_ASSERT(matcher.empty());
+    CPPUNIT_ASSERT(matcher.matches("foo") == false);
+}
+
+void CAhoCorasickMatcherTest::testSimple() {
+    CAhoCorasickMatcher matcher;
+    CPPUNIT_ASSERT(matcher.build({"abc", "xyz", "ab", "10.0."}));
+
+    CPPUNIT_ASSERT(matcher.matches("ab"));
+    CPPUNIT_ASSERT(matcher.matches("abc"));
+    CPPUNIT_ASSERT(matcher.matches("__ab__"));
+    CPPUNIT_ASSERT(matcher.matches("__xyz"));
+    CPPUNIT_ASSERT(matcher.matches("host-10.0.1.1"));
+    CPPUNIT_ASSERT(matcher.matches("a") == false);
+    CPPUNIT_ASSERT(matcher.matches("ba") == false);
+    CPPUNIT_ASSERT(matcher.matches("xy_z") == false);
+    CPPUNIT_ASSERT(matcher.matches("10.1.0.1") == false);
+}
+
+void CAhoCorasickMatcherTest::testOverlappingPatterns() {
+    // Test the failure links, including where a match ends inside
+    // a longer pattern.
+
+    CAhoCorasickMatcher matcher;
+    CPPUNIT_ASSERT(matcher.build({"she", "hers", "abcd", "bce"}));
+
+    CPPUNIT_ASSERT(matcher.matches("ushers"));
+    CPPUNIT_ASSERT(matcher.matches("hishe"));
+    CPPUNIT_ASSERT(matcher.matches("abce"));
+    CPPUNIT_ASSERT(matcher.matches("abcbce"));
+    CPPUNIT_ASSERT(matcher.matches("sh") == false);
+    CPPUNIT_ASSERT(matcher.matches("her") == false);
+    CPPUNIT_ASSERT(matcher.matches("abcbc") == false);
+
+    CPPUNIT_ASSERT(matcher.build({"aaab", "ab"}));
+    CPPUNIT_ASSERT(matcher.matches("aaaab"));
+    CPPUNIT_ASSERT(matcher.matches("aaaa") == false);
+}
+
+void CAhoCorasickMatcherTest::testRandom() {
+    // Compare with brute force search for random patterns and keys
+    // from a small alphabet so that there are plenty of partial matches.
+
+    using TStrVec = std::vector<std::string>;
+
+    test::CRandomNumbers rng;
+    test::CRandomNumbers::CUniform0nGenerator uniformGen = rng.uniformGenerator();
+
+    std::string alphabet{"abc."};
+    auto randomString = [&](std::size_t length) {
+        std::string result;
+        for (std::size_t i = 0; i < length; ++i) {
+            result += alphabet[uniformGen(alphabet.size())];
+        }
+        return result;
+    };
+
+    for (std::size_t t = 0; t < 100; ++t) {
+        TStrVec patterns;
+        for (std::size_t i = 0, n = 1 + uniformGen(20); i < n; ++i) {
+            patterns.push_back(randomString(3 + uniformGen(6)));
+        }
+
+        CAhoCorasickMatcher matcher;
+        CPPUNIT_ASSERT(matcher.build(patterns));
+
+        std::size_t matches{0};
+        for (std::size_t i = 0; i < 200; ++i) {
+            std::string key{randomString(uniformGen(30))};
+            bool expected{std::any_of(patterns.begin(), patterns.end(),
+                                      [&key](const std::string& pattern) {
+                                          return key.find(pattern) != std::string::npos;
+                                      })};
+            CPPUNIT_ASSERT_EQUAL(expected, matcher.matches(key));
+            matches += expected ? 1 : 0;
+        }
+        LOG_TRACE(<< "# matches = " << matches);
+    }
+}
@@ -0,0 +1,21 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_CAhoCorasickMatcherTest_h
+#define INCLUDED_CAhoCorasickMatcherTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CAhoCorasickMatcherTest : public CppUnit::TestFixture {
+public:
+    void testEmpty();
+    void testSimple();
+    void testOverlappingPatterns();
+    void testRandom();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CAhoCorasickMatcherTest_h
@@ -43,6 +43,8 @@ CppUnit::Test* CPatternSetTest::suite() {
         &CPatternSetTest::testContains_GivenMixedKeys));
     suiteOfTests->addTest(new CppUnit::TestCaller<CPatternSetTest>(
         "CPatternSetTest::testClear", &CPatternSetTest::testClear));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CPatternSetTest>(
+        "CPatternSetTest::testUniqueId", &CPatternSetTest::testUniqueId));
 
     return suiteOfTests;
 }
@@ -156,3 +158,21 @@ void CPatternSetTest::testClear() {
 
     CPPUNIT_ASSERT(set.contains("foo") == false);
 }
+
+void CPatternSetTest::testUniqueId() {
+    CPatternSet set1;
+    CPatternSet set2;
+    CPPUNIT_ASSERT(set1.uniqueId() != set2.uniqueId());
+
+    CPatternSet copy{set1};
+    CPPUNIT_ASSERT_EQUAL(set1.uniqueId(), copy.uniqueId());
+
+    uint64_t id{set1.uniqueId()};
+    CPPUNIT_ASSERT(set1.initFromJson("[\"foo\"]"));
+    CPPUNIT_ASSERT(set1.uniqueId() != id);
+    CPPUNIT_ASSERT(set1.uniqueId() != copy.uniqueId());
+
+    id = set1.uniqueId();
+    set1.clear();
+    CPPUNIT_ASSERT(set1.uniqueId() != id);
+}
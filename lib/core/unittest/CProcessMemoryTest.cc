@@ -0,0 +1,27 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CProcessMemoryTest.h"
+
+#include <core/CProcessMemory.h>
+
+CppUnit::Test* CProcessMemoryTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CProcessMemoryTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CProcessMemoryTest>(
+        "CProcessMemoryTest::testResidentSetSize", &CProcessMemoryTest::testResidentSetSize));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CProcessMemoryTest>(
+        "CProcessMemoryTest::testReleaseFreeMemory", &CProcessMemoryTest::testReleaseFreeMemory));
+
+    return suiteOfTests;
+}
+
+void CProcessMemoryTest::testResidentSetSize() {
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), ml::core::CProcessMemory::residentSetSize());
+}
+
+void CProcessMemoryTest::testReleaseFreeMemory() {
+    ml::core::CProcessMemory::releaseFreeMemory();
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CProcessMemoryTest.h"
+
+#include <core/CLogger.h>
+#include <core/CProcessMemory.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+const std::size_t MB{1024 * 1024};
+}
+
+CppUnit::Test* CProcessMemoryTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CProcessMemoryTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CProcessMemoryTest>(
+        "CProcessMemoryTest::testResidentSetSize", &CProcessMemoryTest::testResidentSetSize));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CProcessMemoryTest>(
+        "CProcessMemoryTest::testReleaseFreeMemory", &CProcessMemoryTest::testReleaseFreeMemory));
+
+    return suiteOfTests;
+}
+
+void CProcessMemoryTest::testResidentSetSize() {
+    std::size_t before{ml::core::CProcessMemory::residentSetSize()};
+    LOG_DEBUG(<< "before = " << before);
+    CPPUNIT_ASSERT(before > 0);
+
+    // Touching every page should make it all resident.
+    std::vector<char> block(64 * MB, 'a');
+    std::size_t after{ml::core::CProcessMemory::residentSetSize()};
+    LOG_DEBUG(<< "after = " << after);
+    CPPUNIT_ASSERT(after >= before + 60 * MB);
+}
+
+void CProcessMemoryTest::testReleaseFreeMemory() {
+    // Allocate lots of small objects, as the models do, then free most of
+    // them, as pruning does. The survivors are scattered throughout the heap
+    // so it can't simply shrink. Each run of freed objects is long enough to
+    // contain whole pages wherever the heap starts.
+
+    using TCharArrayUPtr = std::unique_ptr<char[]>;
+
+    std::vector<TCharArrayUPtr> objects;
+    objects.reserve(200000);
+    for (std::size_t i = 0; i < 200000; ++i) {
+        objects.emplace_back(new char[500]);
+        std::memset(objects.back().get(), 'a', 500);
+    }
+    std::size_t peak{ml::core::CProcessMemory::residentSetSize()};
+
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        if (i % 32 != 31) {
+            objects[i].reset();
+        }
+    }
+
+    std::size_t before{ml::core::CProcessMemory::residentSetSize()};
+    ml::core::CProcessMemory::releaseFreeMemory();
+    std::size_t after{ml::core::CProcessMemory::residentSetSize()};
+    LOG_DEBUG(<< "peak = " << peak << ", before = " << before << ", after = " << after);
+
+#ifdef __GLIBC__
+    CPPUNIT_ASSERT(after + 32 * MB < before);
+#else
+    CPPUNIT_ASSERT(after <= before);
+#endif
+}
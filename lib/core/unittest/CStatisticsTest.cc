@@ -53,6 +53,8 @@ CppUnit::Test* CStatisticsTest::suite() {
         "CStatisticsTest::testStatistics", &CStatisticsTest::testStatistics));
     suiteOfTests->addTest(new CppUnit::TestCaller<CStatisticsTest>(
         "CStatisticsTest::testPersist", &CStatisticsTest::testPersist));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStatisticsTest>(
+        "CStatisticsTest::testScopedContext", &CStatisticsTest::testScopedContext));
 
     return suiteOfTests;
 }
@@ -197,3 +199,51 @@ void CStatisticsTest::testPersist() {
 
     LOG_DEBUG(<< output);
 }
+
+void CStatisticsTest::testScopedContext() {
+    // Check that statistics are counted in, persisted from and restored to
+    // the current collection and that the previous collection is current
+    // again when the scope ends.
+
+    ml::core::CStatistics& process = ml::core::CStatistics::instance();
+    uint64_t processValue = process.stat(TEST_STAT).value();
+
+    ml::core::CStatistics job1;
+    ml::core::CStatistics job2;
+
+    std::string job1Xml;
+    {
+        ml::core::CStatistics::CScopedContext scope1(job1);
+        CPPUNIT_ASSERT_EQUAL(&job1, &ml::core::CStatistics::instance());
+        ml::core::CStatistics::stat(TEST_STAT).set(10);
+        {
+            ml::core::CStatistics::CScopedContext scope2(job2);
+            CPPUNIT_ASSERT_EQUAL(&job2, &ml::core::CStatistics::instance());
+            ml::core::CStatistics::stat(TEST_STAT).increment();
+        }
+        CPPUNIT_ASSERT_EQUAL(&job1, &ml::core::CStatistics::instance());
+        ml::core::CStatistics::stat(TEST_STAT).increment();
+
+        ml::core::CRapidXmlStatePersistInserter inserter("root");
+        ml::core::CStatistics::staticsAcceptPersistInserter(inserter);
+        inserter.toXml(job1Xml);
+    }
+    CPPUNIT_ASSERT_EQUAL(&process, &ml::core::CStatistics::instance());
+
+    {
+        ml::core::CStatistics::CScopedContext scope1(job1);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(11), ml::core::CStatistics::stat(TEST_STAT).value());
+    }
+    {
+        ml::core::CStatistics::CScopedContext scope2(job2);
+        CPPUNIT_ASSERT_EQUAL(uint64_t(1), ml::core::CStatistics::stat(TEST_STAT).value());
+
+        ml::core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(job1Xml));
+        ml::core::CRapidXmlStateRestoreTraverser traverser(parser);
+        CPPUNIT_ASSERT(traverser.traverseSubLevel(
+            &ml::core::CStatistics::staticsAcceptRestoreTraverser));
+        CPPUNIT_ASSERT_EQUAL(uint64_t(11), ml::core::CStatistics::stat(TEST_STAT).value());
+    }
+    CPPUNIT_ASSERT_EQUAL(processValue, process.stat(TEST_STAT).value());
+}
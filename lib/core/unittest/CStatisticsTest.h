@@ -12,6 +12,7 @@ class CStatisticsTest : public CppUnit::TestFixture {
 public:
     void testStatistics();
     void testPersist();
+    void testScopedContext();
 
     void threadRunner(int i);
 
@@ -10,12 +10,18 @@
 #include <core/CStrTokR.h>
 #include <core/CStringUtils.h>
 
+#include <test/CRandomNumbers.h>
+
 #include <boost/lexical_cast.hpp>
 
+#include <cmath>
 #include <set>
 #include <vector>
 
+#include <errno.h>
+#include <limits.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -64,6 +70,9 @@ CppUnit::Test* CStringUtilsTest::suite() {
         "CStringUtilsTest::testUtf8ByteType", &CStringUtilsTest::testUtf8ByteType));
     suiteOfTests->addTest(new CppUnit::TestCaller<CStringUtilsTest>(
         "CStringUtilsTest::testRoundtripMaxDouble", &CStringUtilsTest::testRoundtripMaxDouble));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CStringUtilsTest>(
+        "CStringUtilsTest::testStringToTypeMatchesStrtod",
+        &CStringUtilsTest::testStringToTypeMatchesStrtod));
 
     return suiteOfTests;
 }
@@ -978,3 +987,189 @@ void CStringUtilsTest::testRoundtripMaxDouble() {
         CPPUNIT_ASSERT_DOUBLES_EQUAL(min, d, -tolerances[i] * min);
     }
 }
+
+void CStringUtilsTest::testStringToTypeMatchesStrtod() {
+    // Check the conversions agree exactly with the C library for a wide
+    // variety of strings, including those which aren't handled directly.
+
+    using TDoubleVec = std::vector<double>;
+    using TStrVec = std::vector<std::string>;
+
+    ml::test::CRandomNumbers rng;
+
+    TStrVec doubles{"0",
+                    "-0",
+                    "+0.0",
+                    "1",
+                    "-1",
+                    "1.",
+                    ".5",
+                    "-.5",
+                    "0.1",
+                    "0.3",
+                    "123.456",
+                    "1e22",
+                    "1e23",
+                    "1e-22",
+                    "1e-23",
+                    "9007199254740992",
+                    "9007199254740993",
+                    "18446744073709551615",
+                    "123456789012345678901234567890",
+                    "0.000000000000000000000000000001",
+                    "1.7976931348623157e308",
+                    "4.9e-324",
+                    "2.2250738585072014e-308",
+                    "1E5",
+                    "1e+5",
+                    "1e-5",
+                    "1e0005",
+                    " 1",
+                    "0x1p3",
+                    "inf",
+                    "-INF",
+                    "nan",
+                    "1e",
+                    "1e+",
+                    "--1",
+                    "+-1",
+                    "1..2",
+                    "1.2.3",
+                    "1,5",
+                    "1 ",
+                    ".",
+                    "-",
+                    "e5",
+                    "12345678.12345678"};
+
+    TDoubleVec samples;
+    rng.generateUniformSamples(-1000.0, 1000.0, 2000, samples);
+    TDoubleVec scales;
+    rng.generateUniformSamples(-30.0, 30.0, 2000, scales);
+    char buffer[64];
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        double x{samples[i] * std::pow(10.0, std::floor(scales[i]))};
+        for (const char* format : {"%.17g", "%.15g", "%.6g", "%.3f", "%.10e", "%.0f"}) {
+            ::snprintf(buffer, sizeof(buffer), format, x);
+            doubles.push_back(buffer);
+        }
+    }
+
+    for (const auto& str : doubles) {
+        char* endPtr{nullptr};
+        errno = 0;
+        double expected{::strtod(str.c_str(), &endPtr)};
+        bool expectedOk{str.empty() == false && *endPtr == '\0' &&
+                        ((expected != HUGE_VAL && expected != -HUGE_VAL) || errno != ERANGE)};
+        double actual{0.0};
+        bool actualOk{ml::core::CStringUtils::stringToTypeSilent(str, actual)};
+        if (actualOk != expectedOk ||
+            (expectedOk && ::memcmp(&expected, &actual, sizeof(double)) != 0)) {
+            LOG_ERROR(<< "Mismatch for '" << str << "'");
+        }
+        CPPUNIT_ASSERT_EQUAL(expectedOk, actualOk);
+        if (expectedOk) {
+            CPPUNIT_ASSERT(::memcmp(&expected, &actual, sizeof(double)) == 0);
+        }
+    }
+
+    TStrVec integers{"0",
+                     "-0",
+                     "+0",
+                     "1",
+                     "-1",
+                     "+1",
+                     "010",
+                     "0x10",
+                     "-0x10",
+                     "08",
+                     " 1",
+                     "1 ",
+                     "--1",
+                     "-",
+                     "2147483647",
+                     "2147483648",
+                     "-2147483648",
+                     "-2147483649",
+                     "4294967295",
+                     "4294967296",
+                     "999999999999999999",
+                     "1000000000000000000",
+                     "9223372036854775807",
+                     "9223372036854775808",
+                     "-9223372036854775808",
+                     "-9223372036854775809",
+                     "18446744073709551615",
+                     "18446744073709551616",
+                     "12345678",
+                     "123456789",
+                     "1234567a"};
+    rng.generateUniformSamples(0.0, 19.0, 2000, scales);
+    for (std::size_t i = 0; i < scales.size(); ++i) {
+        long long x{static_cast<long long>(std::pow(10.0, scales[i]))};
+        integers.push_back(ml::core::CStringUtils::typeToString(i % 2 == 0 ? x : -x));
+    }
+
+    for (const auto& str : integers) {
+        char* endPtr{nullptr};
+        errno = 0;
+        long long expected{::strtoll(str.c_str(), &endPtr, 0)};
+        bool expectedOk{*endPtr == '\0' && errno == 0};
+        long long actual{0};
+        bool actualOk{ml::core::CStringUtils::stringToTypeSilent(str, actual)};
+        if (actualOk != expectedOk || (expectedOk && actual != expected)) {
+            LOG_ERROR(<< "Mismatch for '" << str << "'");
+        }
+        CPPUNIT_ASSERT_EQUAL(expectedOk, actualOk);
+        if (expectedOk) {
+            CPPUNIT_ASSERT_EQUAL(expected, actual);
+        }
+
+        errno = 0;
+        unsigned long long expectedUnsigned{::strtoull(str.c_str(), &endPtr, 0)};
+        expectedOk = (*endPtr == '\0' && errno == 0);
+        unsigned long long actualUnsigned{0};
+        actualOk = ml::core::CStringUtils::stringToTypeSilent(str, actualUnsigned);
+        CPPUNIT_ASSERT_EQUAL(expectedOk, actualOk);
+        if (expectedOk) {
+            CPPUNIT_ASSERT_EQUAL(expectedUnsigned, actualUnsigned);
+        }
+
+        int expectedInt{static_cast<int>(expected)};
+        expectedOk = (expectedOk && expected >= INT_MIN && expected <= INT_MAX);
+        int actualInt{0};
+        actualOk = ml::core::CStringUtils::stringToTypeSilent(str, actualInt);
+        CPPUNIT_ASSERT_EQUAL(expectedOk, actualOk);
+        if (expectedOk) {
+            CPPUNIT_ASSERT_EQUAL(expectedInt, actualInt);
+        }
+    }
+
+    // Throughput for typical metric values.
+    TStrVec values;
+    rng.generateUniformSamples(0.0, 10000.0, 1000000, samples);
+    for (auto sample : samples) {
+        ::snprintf(buffer, sizeof(buffer), "%.3f", sample);
+        values.push_back(buffer);
+    }
+
+    ml::core::CStopWatch stopWatch;
+    double expectedTotal{0.0};
+    stopWatch.start();
+    for (const auto& value : values) {
+        expectedTotal += ::strtod(value.c_str(), nullptr);
+    }
+    std::uint64_t strtodTime{stopWatch.stop()};
+    stopWatch.reset();
+    double total{0.0};
+    stopWatch.start();
+    for (const auto& value : values) {
+        double x;
+        ml::core::CStringUtils::stringToType(value, x);
+        total += x;
+    }
+    std::uint64_t stringToTypeTime{stopWatch.stop()};
+    LOG_DEBUG(<< "strtod took " << strtodTime << "ms, stringToType took "
+              << stringToTypeTime << "ms");
+    CPPUNIT_ASSERT_EQUAL(expectedTotal, total);
+}
@@ -31,6 +31,7 @@ public:
     void testPerformance();
     void testUtf8ByteType();
     void testRoundtripMaxDouble();
+    void testStringToTypeMatchesStrtod();
 
     static CppUnit::Test* suite();
 
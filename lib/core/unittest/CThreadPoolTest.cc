@@ -6,14 +6,20 @@
 #include "CThreadPoolTest.h"
 
 #include <core/CLogger.h>
+#include <core/CThreadPool.h>
 
 #include <boost/threadpool.hpp>
 
+#include <atomic>
+#include <vector>
+
 CppUnit::Test* CThreadPoolTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CThreadPoolTest");
 
     suiteOfTests->addTest(new CppUnit::TestCaller<CThreadPoolTest>(
         "CThreadPoolTest::testPool", &CThreadPoolTest::testPool));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CThreadPoolTest>(
+        "CThreadPoolTest::testParallelForEach", &CThreadPoolTest::testParallelForEach));
 
     return suiteOfTests;
 }
@@ -40,3 +46,42 @@ void CThreadPoolTest::testPool() {
     // Wait until all tasks are finished.
     tp.wait();
 }
+
+void CThreadPoolTest::testParallelForEach() {
+    // Check that every index is visited exactly once for various numbers
+    // of threads and loop lengths and that the pool can be reused.
+
+    using TSizeVec = std::vector<std::size_t>;
+
+    for (std::size_t numberThreads : {0, 1, 2, 4}) {
+        ml::core::CThreadPool pool(numberThreads);
+        CPPUNIT_ASSERT_EQUAL(std::max(numberThreads, std::size_t(1)),
+                             pool.numberThreads());
+
+        for (std::size_t n : {0, 1, 3, 1000}) {
+            std::vector<std::atomic<std::size_t>> visits(n);
+            for (auto& count : visits) {
+                count.store(0);
+            }
+            TSizeVec squares(n, 0);
+
+            pool.parallelForEach(n, [&visits, &squares](std::size_t i) {
+                ++visits[i];
+                squares[i] = i * i;
+            });
+
+            for (std::size_t i = 0; i < n; ++i) {
+                CPPUNIT_ASSERT_EQUAL(std::size_t(1), visits[i].load());
+                CPPUNIT_ASSERT_EQUAL(i * i, squares[i]);
+            }
+        }
+    }
+
+    // Check the loop waits for every call to finish.
+    ml::core::CThreadPool pool(4);
+    std::atomic<std::size_t> total{0};
+    for (std::size_t i = 0; i < 20; ++i) {
+        pool.parallelForEach(100, [&total](std::size_t j) { total += j; });
+        CPPUNIT_ASSERT_EQUAL((i + 1) * 4950, total.load());
+    }
+}
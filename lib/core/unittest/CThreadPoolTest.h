@@ -11,6 +11,7 @@
 class CThreadPoolTest : public CppUnit::TestFixture {
 public:
     void testPool();
+    void testParallelForEach();
 
     static CppUnit::Test* suite();
 };
@@ -0,0 +1,235 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#include "CTimeFormatParserTest.h"
+
+#include <core/CLogger.h>
+#include <core/CTimeFormatParser.h>
+#include <core/CTimeUtils.h>
+#include <core/CTimezone.h>
+#include <core/CoreTypes.h>
+
+#include <string>
+#include <vector>
+
+#include <time.h>
+
+CppUnit::Test* CTimeFormatParserTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CTimeFormatParserTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeFormatParserTest>(
+        "CTimeFormatParserTest::testCompile", &CTimeFormatParserTest::testCompile));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeFormatParserTest>(
+        "CTimeFormatParserTest::testParse", &CTimeFormatParserTest::testParse));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeFormatParserTest>(
+        "CTimeFormatParserTest::testDaylightSaving", &CTimeFormatParserTest::testDaylightSaving));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeFormatParserTest>(
+        "CTimeFormatParserTest::testOffset", &CTimeFormatParserTest::testOffset));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeFormatParserTest>(
+        "CTimeFormatParserTest::testInvalid", &CTimeFormatParserTest::testInvalid));
+
+    return suiteOfTests;
+}
+
+using namespace ml;
+
+namespace {
+using TStrVec = std::vector<std::string>;
+
+//! Format \p time as a local time using \p format.
+std::string print(const std::string& format, core_t::TTime time) {
+    struct tm local;
+    core::CTimezone::instance().utcToLocal(time, local);
+    char buffer[128];
+    std::size_t length{::strftime(buffer, sizeof(buffer), format.c_str(), &local)};
+    return std::string(buffer, length);
+}
+
+//! Check \p parser gives the same results as strptimeSilent for \p dateTime.
+void checkSame(core::CTimeFormatParser& parser, const std::string& dateTime) {
+    core_t::TTime expected{0};
+    bool expectedOk{core::CTimeUtils::strptimeSilent(parser.format(), dateTime, expected)};
+    core_t::TTime actual{0};
+    bool actualOk{parser.parse(dateTime, actual)};
+    if (actualOk != expectedOk || (expectedOk && actual != expected)) {
+        LOG_ERROR(<< "format = '" << parser.format() << "', date time = '"
+                  << dateTime << "'");
+    }
+    CPPUNIT_ASSERT_EQUAL(expectedOk, actualOk);
+    if (expectedOk) {
+        CPPUNIT_ASSERT_EQUAL(expected, actual);
+    }
+}
+}
+
+void CTimeFormatParserTest::tearDown() {
+    // Other tests assume UK time.
+    core::CTimezone::setTimezone("Europe/London");
+}
+
+void CTimeFormatParserTest::testCompile() {
+    TStrVec compiled{"%Y-%m-%dT%H:%M:%S",
+                     "%Y-%m-%d %H:%M:%S",
+                     "%Y-%m-%dT%H:%M:%S%z",
+                     "%Y-%m-%d %H:%M:%S %z",
+                     "%FT%T",
+                     "%d/%m/%Y %H:%M",
+                     "%Y%m%d%H%M%S",
+                     "%Y-%m-%d",
+                     "%Y-%m-%d %H:%M:%S %%",
+                     "%s",
+                     " %s "};
+    for (const auto& format : compiled) {
+        LOG_DEBUG(<< "format = '" << format << "'");
+        CPPUNIT_ASSERT(core::CTimeFormatParser(format).isCompiled());
+    }
+
+    TStrVec fallback{"%d/%b/%Y:%H:%M:%S %z",
+                     "%b %d %H:%M:%S",
+                     "%m/%d %H:%M:%S",
+                     "%Y-%m-%d %H:%M:%S %Z",
+                     "%Y-%m-%dT%H:%M:%S%z %H",
+                     "%Y-%m-%d %Y",
+                     "%s %H",
+                     "%Y-%m-%d %",
+                     ""};
+    for (const auto& format : fallback) {
+        LOG_DEBUG(<< "format = '" << format << "'");
+        CPPUNIT_ASSERT(core::CTimeFormatParser(format).isCompiled() == false);
+    }
+}
+
+void CTimeFormatParserTest::testParse() {
+    CPPUNIT_ASSERT(core::CTimezone::setTimezone("Europe/London"));
+
+    // Known values.
+    {
+        core::CTimeFormatParser parser{"%Y-%m-%d %H:%M:%S"};
+        core_t::TTime time{0};
+        CPPUNIT_ASSERT(parser.parse("2008-11-26 14:40:37", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1227710437}, time);
+        CPPUNIT_ASSERT(parser.parse("2008-11-26 14:41:00", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1227710460}, time);
+        CPPUNIT_ASSERT(parser.parse("2008-04-11 15:53:44", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1207925624}, time);
+    }
+    {
+        core::CTimeFormatParser parser{"%s"};
+        core_t::TTime time{0};
+        CPPUNIT_ASSERT(parser.parse("1227710437", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1227710437}, time);
+    }
+
+    // Compare with strptimeSilent for a range of formats.
+    TStrVec formats{"%Y-%m-%dT%H:%M:%S", "%Y-%m-%d %H:%M:%S", "%FT%T",
+                    "%d/%m/%Y %H:%M",    "%Y%m%d%H%M%S",      "%Y-%m-%d",
+                    "%s",                "%d/%b/%Y:%H:%M:%S"};
+    for (const auto& format : formats) {
+        LOG_DEBUG(<< "format = '" << format << "'");
+        core::CTimeFormatParser parser{format};
+        for (core_t::TTime time = 1199145600; time < 1262304000; time += 7919) {
+            checkSame(parser, print(format, time));
+        }
+        // Times going backwards.
+        for (core_t::TTime time = 1262304000; time > 1199145600; time -= 104729) {
+            checkSame(parser, print(format, time));
+        }
+    }
+}
+
+void CTimeFormatParserTest::testDaylightSaving() {
+    // Check times either side of and during daylight saving transitions
+    // for zones with different offsets, including a half hour offset.
+
+    TStrVec timezones{"Europe/London", "America/New_York", "Australia/Adelaide",
+                      "Asia/Kolkata", ""};
+    TStrVec formats{"%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M", "%s"};
+
+    for (const auto& timezone : timezones) {
+        LOG_DEBUG(<< "timezone = '" << timezone << "'");
+        CPPUNIT_ASSERT(core::CTimezone::setTimezone(timezone));
+        for (const auto& format : formats) {
+            core::CTimeFormatParser parser{format};
+            for (core_t::TTime time = 1199145600; time < 1262304000; time += 3607) {
+                checkSame(parser, print(format, time));
+            }
+            for (core_t::TTime time = 1206838800 - 7200; time < 1206838800 + 7200; time += 59) {
+                checkSame(parser, print(format, time));
+            }
+            for (core_t::TTime time = 1225587600 - 7200; time < 1225587600 + 7200; time += 59) {
+                checkSame(parser, print(format, time));
+            }
+        }
+        // Local times which don't exist or are ambiguous.
+        core::CTimeFormatParser parser{"%Y-%m-%d %H:%M:%S"};
+        for (const auto& dateTime :
+             {"2008-03-30 00:59:59", "2008-03-30 01:30:00", "2008-03-30 02:30:00",
+              "2008-10-26 01:30:00", "2008-10-26 00:30:00", "2008-04-06 02:30:00",
+              "2008-10-05 02:30:00", "2008-03-09 02:30:00", "2008-11-02 01:30:00"}) {
+            checkSame(parser, dateTime);
+        }
+    }
+
+    // Check changing the timezone invalidates the cache.
+    core::CTimeFormatParser parser{"%Y-%m-%d %H:%M:%S"};
+    core_t::TTime london{0};
+    CPPUNIT_ASSERT(core::CTimezone::setTimezone("Europe/London"));
+    CPPUNIT_ASSERT(parser.parse("2008-11-26 14:40:37", london));
+    core_t::TTime newYork{0};
+    CPPUNIT_ASSERT(core::CTimezone::setTimezone("America/New_York"));
+    CPPUNIT_ASSERT(parser.parse("2008-11-26 14:40:37", newYork));
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime{5 * 3600}, newYork - london);
+}
+
+void CTimeFormatParserTest::testOffset() {
+    TStrVec timezones{"Europe/London", "America/New_York"};
+
+    for (const auto& timezone : timezones) {
+        CPPUNIT_ASSERT(core::CTimezone::setTimezone(timezone));
+
+        core::CTimeFormatParser parser{"%Y-%m-%dT%H:%M:%S%z"};
+        core_t::TTime time{0};
+        CPPUNIT_ASSERT(parser.parse("2008-11-26T14:40:37+0000", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1227710437}, time);
+        CPPUNIT_ASSERT(parser.parse("2008-11-26T14:40:37-0500", time));
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime{1227710437 + 5 * 3600}, time);
+
+        for (const auto& dateTime :
+             {"2008-11-26T14:40:37+0100", "2008-11-26T14:40:37+0130",
+              "2008-11-26T14:40:37-0930", "2008-11-26T14:40:37 +0000",
+              "2008-03-30T01:30:00+0000", "2008-03-30T01:30:00+0100",
+              "2008-10-26T01:30:00+0000", "2008-10-26T01:30:00+0100",
+              "2008-11-26T14:40:37+2460", "2008-11-26T14:40:37+3000",
+              "2008-11-26T14:40:37Z", "2008-11-26T14:40:37+01"}) {
+            checkSame(parser, dateTime);
+        }
+
+        core::CTimeFormatParser spaced{"%Y-%m-%d %H:%M:%S %z"};
+        for (core_t::TTime t = 1199145600; t < 1262304000; t += 7919) {
+            checkSame(spaced, print("%Y-%m-%d %H:%M:%S %z", t));
+        }
+    }
+}
+
+void CTimeFormatParserTest::testInvalid() {
+    CPPUNIT_ASSERT(core::CTimezone::setTimezone("Europe/London"));
+
+    core::CTimeFormatParser parser{"%Y-%m-%d %H:%M:%S"};
+    for (const auto& dateTime :
+         {"", "2008", "2008-11-26", "2008-11-26 14:40", "2008/11/26 14:40:37",
+          "2008-13-26 14:40:37", "2008-11-32 14:40:37", "2008-11-26 24:40:37",
+          "2008-11-26 14:60:37", "2008-11-26 14:40:60", "2008-11-26 14:40:61",
+          "2008-11-26 14:40:62", "1900-11-26 14:40:37", "08-11-26 14:40:37",
+          "2008-2-3 4:5:6", "2008-11-26  14:40:37", " 2008-11-26 14:40:37",
+          "2008-11-26 14:40:37 trailing", "2008-11-26T14:40:37", "x2008-11-26 14:40:37",
+          "20081-11-26 14:40:37", "2008-02-30 14:40:37"}) {
+        checkSame(parser, dateTime);
+    }
+
+    core::CTimeFormatParser epoch{"%s"};
+    for (const auto& dateTime : {"", "x", "-1", "12x", " 12", "1234567890123456789"}) {
+        checkSame(epoch, dateTime);
+    }
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+#ifndef INCLUDED_CTimeFormatParserTest_h
+#define INCLUDED_CTimeFormatParserTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CTimeFormatParserTest : public CppUnit::TestFixture {
+public:
+    void testCompile();
+    void testParse();
+    void testDaylightSaving();
+    void testOffset();
+    void testInvalid();
+
+    void tearDown();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CTimeFormatParserTest_h
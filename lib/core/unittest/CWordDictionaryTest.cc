@@ -9,6 +9,11 @@
 #include <core/CTimeUtils.h>
 #include <core/CWordDictionary.h>
 
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
 CppUnit::Test* CWordDictionaryTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CWordDictionaryTest");
 
@@ -18,6 +23,10 @@ CppUnit::Test* CWordDictionaryTest::suite() {
         "CWordDictionaryTest::testPartOfSpeech", &CWordDictionaryTest::testPartOfSpeech));
     suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
         "CWordDictionaryTest::testWeightingFunctors", &CWordDictionaryTest::testWeightingFunctors));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
+        "CWordDictionaryTest::testAllWords", &CWordDictionaryTest::testAllWords));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
+        "CWordDictionaryTest::testPrecompiledImage", &CWordDictionaryTest::testPrecompiledImage));
     suiteOfTests->addTest(new CppUnit::TestCaller<CWordDictionaryTest>(
         "CWordDictionaryTest::testPerformance", &CWordDictionaryTest::testPerformance));
 
@@ -102,6 +111,48 @@ void CWordDictionaryTest::testWeightingFunctors() {
     }
 }
 
+void CWordDictionaryTest::testAllWords() {
+    // Every word in the text file should be found in the dictionary and
+    // have a part of speech.
+
+    const ml::core::CWordDictionary& dict = ml::core::CWordDictionary::instance();
+
+    std::ifstream ifs("../ml-en.dict");
+    CPPUNIT_ASSERT(ifs.is_open());
+
+    std::size_t count(0);
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::size_t sepPos(line.find('@'));
+        CPPUNIT_ASSERT(sepPos != std::string::npos);
+        std::string word(line.substr(0, sepPos));
+        CPPUNIT_ASSERT(dict.isInDictionary(word));
+        CPPUNIT_ASSERT(dict.partOfSpeech(word) != ml::core::CWordDictionary::E_NotInDictionary);
+        ++count;
+    }
+    LOG_DEBUG(<< "Checked " << count << " words");
+    CPPUNIT_ASSERT(count > 70000);
+}
+
+void CWordDictionaryTest::testPrecompiledImage() {
+    // The image generated by the build must be what compiling the text
+    // file produces. The top level build generates it with the program
+    // in devbin/compile_dictionary once the libraries are installed.
+
+    std::ifstream text("../ml-en.dict");
+    CPPUNIT_ASSERT(text.is_open());
+    std::ostringstream image;
+    CPPUNIT_ASSERT(ml::core::CWordDictionary::compile(text, image));
+
+    std::ifstream ifs("../ml-en.dict.bin", std::ios::binary);
+    CPPUNIT_ASSERT(ifs.is_open());
+    std::string expected{std::istreambuf_iterator<char>(ifs),
+                         std::istreambuf_iterator<char>()};
+
+    CPPUNIT_ASSERT_EQUAL(expected.size(), image.str().size());
+    CPPUNIT_ASSERT(expected == image.str());
+}
+
 void CWordDictionaryTest::testPerformance() {
     const ml::core::CWordDictionary& dict = ml::core::CWordDictionary::instance();
 
@@ -13,6 +13,8 @@ public:
     void testLookups();
     void testPartOfSpeech();
     void testWeightingFunctors();
+    void testAllWords();
+    void testPrecompiledImage();
     void testPerformance();
 
     static CppUnit::Test* suite();
@@ -5,6 +5,7 @@
  */
 #include <test/CTestRunner.h>
 
+#include "CAhoCorasickMatcherTest.h"
 #include "CAllocationStrategyTest.h"
 #include "CBase64FilterTest.h"
 #include "CBlockingMessageQueueTest.h"
@@ -40,6 +41,7 @@
 #include "CPatternSetTest.h"
 #include "CPersistUtilsTest.h"
 #include "CPolymorphicStackObjectCPtrTest.h"
+#include "CProcessMemoryTest.h"
 #include "CProcessPriorityTest.h"
 #include "CProcessTest.h"
 #include "CProgNameTest.h"
@@ -66,6 +68,7 @@
 #include "CThreadMutexConditionTest.h"
 #include "CThreadPoolTest.h"
 #include "CTickerTest.h"
+#include "CTimeFormatParserTest.h"
 #include "CTimeUtilsTest.h"
 #include "CTripleTest.h"
 #include "CUnameTest.h"
@@ -79,6 +82,7 @@
 int main(int argc, const char** argv) {
     ml::test::CTestRunner runner(argc, argv);
 
+    runner.addTest(CAhoCorasickMatcherTest::suite());
     runner.addTest(CAllocationStrategyTest::suite());
     runner.addTest(CBase64FilterTest::suite());
     runner.addTest(CBlockingMessageQueueTest::suite());
@@ -115,6 +119,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CPersistUtilsTest::suite());
     runner.addTest(CPolymorphicStackObjectCPtrTest::suite());
     runner.addTest(CProcessTest::suite());
+    runner.addTest(CProcessMemoryTest::suite());
     runner.addTest(CProcessPriorityTest::suite());
     runner.addTest(CProgNameTest::suite());
     runner.addTest(CRapidJsonLineWriterTest::suite());
@@ -140,6 +145,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CThreadMutexConditionTest::suite());
     runner.addTest(CThreadPoolTest::suite());
     runner.addTest(CTickerTest::suite());
+    runner.addTest(CTimeFormatParserTest::suite());
     runner.addTest(CTimeUtilsTest::suite());
     runner.addTest(CTripleTest::suite());
     runner.addTest(CUnameTest::suite());
@@ -95,6 +95,110 @@ private:
     TPoint m_X;
 };
 
+//! \brief Sign random projection hashes of the projected residuals.
+//!
+//! DESCRIPTION:\n
+//! Each band hashes a point to the signs of its inner products with a
+//! fixed collection of random vectors. All the signs are flipped if the
+//! first is negative so that a point and its negation, i.e. strongly
+//! correlated and anti-correlated variables, hash to the same value.
+class CSignHashes {
+public:
+    using TVectorCPtrVec = std::vector<const CKMostCorrelated::TVector*>;
+
+public:
+    CSignHashes(std::size_t bands, std::size_t bitsPerBand, const TVectorCPtrVec& points)
+        : m_Bands(bands), m_Points(points.size()) {
+        std::size_t d = CKMostCorrelated::NUMBER_PROJECTIONS;
+
+        // The generator is default seeded so the hashes are reproducible.
+        CPRNG::CXorOShiro128Plus rng;
+        CKMostCorrelated::TDoubleVec normals;
+        CSampling::normalSample(rng, 0.0, 1.0, bands * bitsPerBand * d, normals);
+
+        m_Hashes.reserve(m_Points * bands);
+        for (std::size_t i = 0u; i < m_Points; ++i) {
+            const CKMostCorrelated::TVector& point = *points[i];
+            for (std::size_t b = 0u, j = 0u; b < bands; ++b) {
+                uint32_t hash = 0;
+                for (std::size_t k = 0u; k < bitsPerBand; ++k) {
+                    double projection = 0.0;
+                    for (std::size_t l = 0u; l < d; ++l, ++j) {
+                        projection += normals[j] * point(l);
+                    }
+                    hash = (hash << 1) | (projection < 0.0 ? 1 : 0);
+                }
+                if (hash >> (bitsPerBand - 1)) {
+                    hash = ~hash & (0xffffffff >> (32 - bitsPerBand));
+                }
+                m_Hashes.push_back(hash);
+            }
+        }
+    }
+
+    //! Call \p f with each pair of point indices which collide in some
+    //! band exactly once.
+    //!
+    //! Each point is paired with at most \p maximumNeighbours following
+    //! points in a bucket.
+    template<typename F>
+    void forEachCollision(std::size_t maximumNeighbours, const F& f) const {
+        using TUInt32SizePr = std::pair<uint32_t, std::size_t>;
+        using TUInt32SizePrVec = std::vector<TUInt32SizePr>;
+
+        TUInt32SizePrVec bucketed;
+        bucketed.reserve(m_Points);
+        for (std::size_t b = 0u; b < m_Bands; ++b) {
+            bucketed.clear();
+            for (std::size_t i = 0u; i < m_Points; ++i) {
+                bucketed.emplace_back(this->hash(i, b), i);
+            }
+            std::sort(bucketed.begin(), bucketed.end());
+
+            for (std::size_t start = 0u, end = 0u; start < bucketed.size(); start = end) {
+                for (end = start + 1; end < bucketed.size() &&
+                                      bucketed[end].first == bucketed[start].first;
+                     ++end) {
+                }
+                for (std::size_t i = start; i < end; ++i) {
+                    std::size_t last = std::min(end, i + 1 + maximumNeighbours);
+                    for (std::size_t j = i + 1; j < last; ++j) {
+                        if (this->firstCollision(bucketed[i].second,
+                                                 bucketed[j].second) == b) {
+                            f(bucketed[i].second, bucketed[j].second);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    using TUInt32Vec = std::vector<uint32_t>;
+
+private:
+    //! Get the hash of point \p i in band \p b.
+    uint32_t hash(std::size_t i, std::size_t b) const {
+        return m_Hashes[i * m_Bands + b];
+    }
+
+    //! Get the first band in which \p i and \p j collide.
+    std::size_t firstCollision(std::size_t i, std::size_t j) const {
+        std::size_t b = 0u;
+        for (/**/; b < m_Bands && this->hash(i, b) != this->hash(j, b); ++b) {
+        }
+        return b;
+    }
+
+private:
+    //! The number of bands.
+    std::size_t m_Bands;
+    //! The number of points.
+    std::size_t m_Points;
+    //! The points' hashes for each band.
+    TUInt32Vec m_Hashes;
+};
+
 const std::string PROJECTIONS_TAG("a");
 const std::string CURRENT_PROJECTED_TAG("b");
 const std::string PROJECTED_TAG("c");
@@ -102,6 +206,8 @@ const std::string MAXIMUM_COUNT_TAG("d");
 const std::string MOMENTS_TAG("e");
 const std::string MOST_CORRELATED_TAG("f");
 const std::string RNG_TAG("g");
+const std::string HASH_BANDS_TAG("h");
+const std::string HASH_BITS_PER_BAND_TAG("i");
 // Nested tags.
 const std::string CORRELATION_TAG("a");
 const std::string X_TAG("b");
@@ -112,12 +218,23 @@ const double MINIMUM_FREQUENCY = 0.25;
 } // unnamed::
 
 CKMostCorrelated::CKMostCorrelated(std::size_t k, double decayRate, bool initialize)
-    : m_K(k), m_DecayRate(decayRate), m_MaximumCount(0.0) {
+    : m_K(k), m_HashBands(DEFAULT_HASH_BANDS),
+      m_HashBitsPerBand(DEFAULT_HASH_BITS_PER_BAND), m_DecayRate(decayRate),
+      m_MaximumCount(0.0) {
     if (initialize) {
         this->nextProjection();
     }
 }
 
+void CKMostCorrelated::setHashingParameters(std::size_t bands, std::size_t bitsPerBand) {
+    if (bitsPerBand < 1 || bitsPerBand > 32) {
+        LOG_ERROR(<< "Invalid bits per band " << bitsPerBand);
+        return;
+    }
+    m_HashBands = bands;
+    m_HashBitsPerBand = bitsPerBand;
+}
+
 bool CKMostCorrelated::acceptRestoreTraverser(core::CStateRestoreTraverser& traverser) {
     m_Projections.clear();
     m_CurrentProjected.clear();
@@ -138,8 +255,15 @@ bool CKMostCorrelated::acceptRestoreTraverser(core::CStateRestoreTraverser& trav
         RESTORE(MOMENTS_TAG, core::CPersistUtils::restore(MOMENTS_TAG, m_Moments, traverser))
         RESTORE(MOST_CORRELATED_TAG,
                 core::CPersistUtils::restore(MOST_CORRELATED_TAG, m_MostCorrelated, traverser))
+        RESTORE_BUILT_IN(HASH_BANDS_TAG, m_HashBands)
+        RESTORE_BUILT_IN(HASH_BITS_PER_BAND_TAG, m_HashBitsPerBand)
     } while (traverser.next());
 
+    if (m_HashBitsPerBand < 1 || m_HashBitsPerBand > 32) {
+        LOG_ERROR(<< "Invalid bits per band " << m_HashBitsPerBand);
+        return false;
+    }
+
     return true;
 }
 
@@ -151,6 +275,8 @@ void CKMostCorrelated::acceptPersistInserter(core::CStatePersistInserter& insert
     inserter.insertValue(MAXIMUM_COUNT_TAG, m_MaximumCount);
     core::CPersistUtils::persist(MOMENTS_TAG, m_Moments, inserter);
     core::CPersistUtils::persist(MOST_CORRELATED_TAG, m_MostCorrelated, inserter);
+    inserter.insertValue(HASH_BANDS_TAG, m_HashBands);
+    inserter.insertValue(HASH_BITS_PER_BAND_TAG, m_HashBitsPerBand);
 }
 
 void CKMostCorrelated::mostCorrelated(TSizeSizePrVec& result) const {
@@ -351,6 +477,8 @@ void CKMostCorrelated::capture() {
 
 uint64_t CKMostCorrelated::checksum(uint64_t seed) const {
     seed = CChecksum::calculate(seed, m_K);
+    seed = CChecksum::calculate(seed, m_HashBands);
+    seed = CChecksum::calculate(seed, m_HashBitsPerBand);
     seed = CChecksum::calculate(seed, m_DecayRate);
     seed = CChecksum::calculate(seed, m_Projections);
     seed = CChecksum::calculate(seed, m_CurrentProjected);
@@ -424,6 +552,37 @@ void CKMostCorrelated::mostCorrelated(TCorrelationVec& result) const {
                 }
             }
         }
+    } else if (m_HashBands > 0 && V >= MINIMUM_VARIABLES_TO_HASH) {
+        LOG_TRACE(<< "Hashed neighbour search");
+
+        // Only evaluate the correlation for pairs of variables whose
+        // projections collide in some band. Note that this is linear
+        // in V provided the buckets are small.
+
+        TSizeVec variables;
+        CSignHashes::TVectorCPtrVec points;
+        variables.reserve(V);
+        points.reserve(V);
+        for (TSizeVectorPackedBitVectorPrUMapCItr i = m_Projected.begin();
+             i != m_Projected.end(); ++i) {
+            variables.push_back(i->first);
+            points.push_back(&i->second.first);
+        }
+
+        CSignHashes hashes(m_HashBands, m_HashBitsPerBand, points);
+        std::size_t candidates = 0u;
+        hashes.forEachCollision(MAXIMUM_BUCKET_NEIGHBOURS, [&](std::size_t i, std::size_t j) {
+            std::size_t X = variables[i];
+            std::size_t Y = variables[j];
+            if (lookup.count(std::make_pair(std::min(X, Y), std::max(X, Y))) == 0) {
+                const TVectorPackedBitVectorPr& px = m_Projected.at(X);
+                const TVectorPackedBitVectorPr& py = m_Projected.at(Y);
+                mostCorrelated.add(SCorrelation(X, px.first, px.second, Y,
+                                                py.first, py.second));
+                ++candidates;
+            }
+        });
+        LOG_TRACE(<< "# candidates = " << candidates);
     } else {
         LOG_TRACE(<< "Nearest neighbour search");
 
@@ -621,6 +780,10 @@ const CKMostCorrelated::TMeanVarAccumulatorVec& CKMostCorrelated::moments() cons
 const std::size_t CKMostCorrelated::PROJECTION_DIMENSION = 20u;
 const double CKMostCorrelated::MINIMUM_SPARSENESS = 0.5;
 const double CKMostCorrelated::REPLACE_FRACTION = 0.1;
+const std::size_t CKMostCorrelated::MINIMUM_VARIABLES_TO_HASH = 10000u;
+const std::size_t CKMostCorrelated::DEFAULT_HASH_BANDS = 32u;
+const std::size_t CKMostCorrelated::DEFAULT_HASH_BITS_PER_BAND = 14u;
+const std::size_t CKMostCorrelated::MAXIMUM_BUCKET_NEIGHBOURS = 100u;
 
 CKMostCorrelated::SCorrelation::SCorrelation()
     : s_X(std::numeric_limits<std::size_t>::max()),
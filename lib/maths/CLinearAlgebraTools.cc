@@ -16,6 +16,61 @@ namespace linear_algebra_tools_detail {
 
 namespace {
 
+//! Compute the inverse quadratic product using the Cholesky factorization
+//! if \p covariance is well conditioned.
+template<typename T, std::size_t N>
+bool inverseQuadraticProductCholesky(std::size_t d,
+                                     const CSymmetricMatrixNxN<T, N>& covariance,
+                                     const CVectorNx1<T, N>& residual,
+                                     double& result) {
+    if (d != N) {
+        return false;
+    }
+    CCholeskyNxN<N> cholesky(covariance);
+    if (cholesky.wellConditioned() == false) {
+        return false;
+    }
+    result = cholesky.inverseQuadraticForm(residual);
+    return true;
+}
+
+//! Compute the log-likelihood using the Cholesky factorization if
+//! \p covariance is well conditioned.
+template<typename T, std::size_t N>
+bool gaussianLogLikelihoodCholesky(std::size_t d,
+                                   const CSymmetricMatrixNxN<T, N>& covariance,
+                                   const CVectorNx1<T, N>& residual,
+                                   double& result) {
+    if (d != N) {
+        return false;
+    }
+    CCholeskyNxN<N> cholesky(covariance);
+    if (cholesky.wellConditioned() == false) {
+        return false;
+    }
+    result = -0.5 * (cholesky.inverseQuadraticForm(residual) +
+                     static_cast<double>(N) * core::constants::LOG_TWO_PI +
+                     cholesky.logDeterminant());
+    return true;
+}
+
+//! Compute the log-determinant using the Cholesky factorization if
+//! \p matrix is well conditioned.
+template<typename T, std::size_t N>
+bool logDeterminantCholesky(std::size_t d,
+                            const CSymmetricMatrixNxN<T, N>& matrix,
+                            double& result) {
+    if (d != N) {
+        return false;
+    }
+    CCholeskyNxN<N> cholesky(matrix);
+    if (cholesky.wellConditioned() == false) {
+        return false;
+    }
+    result = cholesky.logDeterminant();
+    return true;
+}
+
 //! \brief Shared implementation of the inverse quadratic product.
 template<typename EIGENMATRIX, typename EIGENVECTOR>
 class CInverseQuadraticProduct {
@@ -230,13 +285,17 @@ public:
 };
 }
 
-#define INVERSE_QUADRATIC_PRODUCT(T, N)                                                                                 \
-    maths_t::EFloatingPointErrorStatus inverseQuadraticProduct(                                                         \
-        std::size_t d, const CSymmetricMatrixNxN<T, N>& covariance,                                                     \
-        const CVectorNx1<T, N>& residual, double& result, bool ignoreSingularSubspace) {                                \
-        return CInverseQuadraticProduct<SDenseMatrix<CSymmetricMatrixNxN<T, N>>::Type,                                  \
-                                        SDenseVector<CVectorNx1<T, N>>::Type>::compute(d, covariance, residual,         \
-                                                                                       result, ignoreSingularSubspace); \
+#define INVERSE_QUADRATIC_PRODUCT(T, N)                                                  \
+    maths_t::EFloatingPointErrorStatus inverseQuadraticProduct(                          \
+        std::size_t d, const CSymmetricMatrixNxN<T, N>& covariance,                      \
+        const CVectorNx1<T, N>& residual, double& result, bool ignoreSingularSubspace) { \
+        if (inverseQuadraticProductCholesky(d, covariance, residual, result)) {          \
+            return maths_t::E_FpNoErrors;                                                \
+        }                                                                                \
+        using TDenseMatrix = SDenseMatrix<CSymmetricMatrixNxN<T, N>>::Type;              \
+        using TDenseVector = SDenseVector<CVectorNx1<T, N>>::Type;                       \
+        return CInverseQuadraticProduct<TDenseMatrix, TDenseVector>::compute(            \
+            d, covariance, residual, result, ignoreSingularSubspace);                    \
     }
 INVERSE_QUADRATIC_PRODUCT(CFloatStorage, 2)
 INVERSE_QUADRATIC_PRODUCT(CFloatStorage, 3)
@@ -266,12 +325,17 @@ inverseQuadraticProduct(std::size_t d,
         d, covariance, residual, result, ignoreSingularSubspace);
 }
 
-#define GAUSSIAN_LOG_LIKELIHOOD(T, N)                                                                                                      \
-    maths_t::EFloatingPointErrorStatus gaussianLogLikelihood(                                                                              \
-        std::size_t d, const CSymmetricMatrixNxN<T, N>& covariance,                                                                        \
-        const CVectorNx1<T, N>& residual, double& result, bool ignoreSingularSubspace) {                                                   \
-        return CGaussianLogLikelihood<SDenseMatrix<CSymmetricMatrixNxN<T, N>>::Type, SDenseVector<CVector<CFloatStorage>>::Type>::compute( \
-            d, covariance, residual, result, ignoreSingularSubspace);                                                                      \
+#define GAUSSIAN_LOG_LIKELIHOOD(T, N)                                                    \
+    maths_t::EFloatingPointErrorStatus gaussianLogLikelihood(                            \
+        std::size_t d, const CSymmetricMatrixNxN<T, N>& covariance,                      \
+        const CVectorNx1<T, N>& residual, double& result, bool ignoreSingularSubspace) { \
+        if (gaussianLogLikelihoodCholesky(d, covariance, residual, result)) {            \
+            return maths_t::E_FpNoErrors;                                                \
+        }                                                                                \
+        using TDenseMatrix = SDenseMatrix<CSymmetricMatrixNxN<T, N>>::Type;              \
+        using TDenseVector = SDenseVector<CVector<CFloatStorage>>::Type;                 \
+        return CGaussianLogLikelihood<TDenseMatrix, TDenseVector>::compute(              \
+            d, covariance, residual, result, ignoreSingularSubspace);                    \
     }
 GAUSSIAN_LOG_LIKELIHOOD(CFloatStorage, 2)
 GAUSSIAN_LOG_LIKELIHOOD(CFloatStorage, 3)
@@ -337,6 +401,9 @@ void sampleGaussian(std::size_t d,
     maths_t::EFloatingPointErrorStatus logDeterminant(                                  \
         std::size_t d, const CSymmetricMatrixNxN<T, N>& matrix,                         \
         double& result, bool ignoreSingularSubspace) {                                  \
+        if (logDeterminantCholesky(d, matrix, result)) {                                \
+            return maths_t::E_FpNoErrors;                                               \
+        }                                                                               \
         return CLogDeterminant<SDenseMatrix<CSymmetricMatrixNxN<T, N>>::Type>::compute( \
             d, matrix, result, ignoreSingularSubspace);                                 \
     }
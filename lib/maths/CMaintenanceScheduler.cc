@@ -0,0 +1,198 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include <maths/CMaintenanceScheduler.h>
+
+#include <core/CScopedFastLock.h>
+#include <core/CStatePersistInserter.h>
+#include <core/CStateRestoreTraverser.h>
+#include <core/CStatistics.h>
+#include <core/Constants.h>
+#include <core/RestoreMacros.h>
+
+#include <maths/CIntegerTools.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace ml {
+namespace maths {
+
+namespace {
+//! The context of the calling thread if it has set one.
+thread_local CMaintenanceScheduler::CContext* currentContext{nullptr};
+
+const std::string BUCKET_TAG{"a"};
+const std::string SCHEDULED_TAG{"b"};
+const std::string RUN_TAG{"c"};
+const std::string DEFERRED_TAG{"d"};
+const std::string QUEUE_DEPTH_TAG{"e"};
+}
+
+CMaintenanceScheduler::CContext::CContext()
+    : m_Budget{DEFAULT_BUDGET}, m_Bucket{std::numeric_limits<core_t::TTime>::min()},
+      m_Scheduled{0}, m_Run{0}, m_Deferred{0}, m_QueueDepth{0} {
+}
+
+CMaintenanceScheduler::CContext::CContext(const CContext& other) {
+    core::CScopedFastLock lock{other.m_Lock};
+    m_Budget = other.m_Budget;
+    m_Bucket = other.m_Bucket;
+    m_Scheduled = other.m_Scheduled;
+    m_Run = other.m_Run;
+    m_Deferred = other.m_Deferred;
+    m_QueueDepth = other.m_QueueDepth;
+}
+
+bool CMaintenanceScheduler::CContext::acceptRestoreTraverser(
+    core::CStateRestoreTraverser& traverser) {
+    core::CScopedFastLock lock{m_Lock};
+    do {
+        const std::string& name{traverser.name()};
+        RESTORE_BUILT_IN(BUCKET_TAG, m_Bucket)
+        RESTORE_BUILT_IN(SCHEDULED_TAG, m_Scheduled)
+        RESTORE_BUILT_IN(RUN_TAG, m_Run)
+        RESTORE_BUILT_IN(DEFERRED_TAG, m_Deferred)
+        RESTORE_BUILT_IN(QUEUE_DEPTH_TAG, m_QueueDepth)
+    } while (traverser.next());
+    return true;
+}
+
+void CMaintenanceScheduler::CContext::acceptPersistInserter(
+    core::CStatePersistInserter& inserter) const {
+    core::CScopedFastLock lock{m_Lock};
+    inserter.insertValue(BUCKET_TAG, m_Bucket);
+    inserter.insertValue(SCHEDULED_TAG, m_Scheduled);
+    inserter.insertValue(RUN_TAG, m_Run);
+    inserter.insertValue(DEFERRED_TAG, m_Deferred);
+    inserter.insertValue(QUEUE_DEPTH_TAG, m_QueueDepth);
+}
+
+CMaintenanceScheduler::CScopedContext::CScopedContext(CContext& context)
+    : m_Previous{currentContext} {
+    currentContext = &context;
+}
+
+CMaintenanceScheduler::CScopedContext::~CScopedContext() {
+    currentContext = m_Previous;
+}
+
+core_t::TTime CMaintenanceScheduler::schedule(core_t::TTime time,
+                                              core_t::TTime bucketLength,
+                                              std::uint64_t key) {
+    if (bucketLength <= 0) {
+        return time;
+    }
+
+    {
+        CContext& context_{context()};
+        core::CScopedFastLock lock{context_.m_Lock};
+        core_t::TTime bucket{CIntegerTools::floor(time, bucketLength)};
+        startBucket(context_, bucket);
+        // We only stagger tasks if there are more due in this bucket than
+        // we can run. This means series which aren't competing for time
+        // with many others are unaffected.
+        if (bucket < context_.m_Bucket || ++context_.m_Scheduled <= context_.m_Budget) {
+            return time;
+        }
+    }
+
+    core_t::TTime buckets{std::min(MAXIMUM_JITTER, MAXIMUM_JITTER_INTERVAL / bucketLength)};
+    return time + static_cast<core_t::TTime>(key % static_cast<std::uint64_t>(buckets + 1)) *
+                      bucketLength;
+}
+
+bool CMaintenanceScheduler::run(core_t::TTime& scheduled,
+                                core_t::TTime time,
+                                core_t::TTime bucketLength) {
+    if (scheduled == NOT_SCHEDULED || time < scheduled) {
+        return false;
+    }
+
+    core_t::TTime deferral{std::max(
+        std::min(MAXIMUM_DEFERRAL * bucketLength, MAXIMUM_DEFERRAL_INTERVAL), bucketLength)};
+    bool overdue{time >= scheduled + deferral};
+    core_t::TTime bucket{CIntegerTools::floor(time, std::max(bucketLength, core_t::TTime{1}))};
+
+    CContext& context_{context()};
+    core::CScopedFastLock lock{context_.m_Lock};
+    startBucket(context_, bucket);
+    // Tasks for earlier buckets, which can happen if the job has a
+    // latency, and overdue tasks aren't subject to the budget.
+    if (bucket < context_.m_Bucket || overdue || context_.m_Run < context_.m_Budget) {
+        ++context_.m_Run;
+        scheduled = NOT_SCHEDULED;
+        return true;
+    }
+    ++context_.m_Deferred;
+    return false;
+}
+
+void CMaintenanceScheduler::budget(std::size_t budget) {
+    CContext& context_{context()};
+    core::CScopedFastLock lock{context_.m_Lock};
+    context_.m_Budget = budget;
+}
+
+std::size_t CMaintenanceScheduler::budget() {
+    CContext& context_{context()};
+    core::CScopedFastLock lock{context_.m_Lock};
+    return context_.m_Budget;
+}
+
+std::size_t CMaintenanceScheduler::queueDepth() {
+    CContext& context_{context()};
+    core::CScopedFastLock lock{context_.m_Lock};
+    return context_.m_QueueDepth;
+}
+
+void CMaintenanceScheduler::reset() {
+    CContext& context_{context()};
+    core::CScopedFastLock lock{context_.m_Lock};
+    context_.m_Budget = DEFAULT_BUDGET;
+    context_.m_Bucket = std::numeric_limits<core_t::TTime>::min();
+    context_.m_Scheduled = 0;
+    context_.m_Run = 0;
+    context_.m_Deferred = 0;
+    publishQueueDepth(context_, 0);
+}
+
+CMaintenanceScheduler::CContext& CMaintenanceScheduler::context() {
+    return currentContext != nullptr ? *currentContext : ms_DefaultContext;
+}
+
+void CMaintenanceScheduler::startBucket(CContext& context, core_t::TTime bucket) {
+    if (bucket > context.m_Bucket) {
+        publishQueueDepth(context, context.m_Deferred);
+        context.m_Bucket = bucket;
+        context.m_Scheduled = 0;
+        context.m_Run = 0;
+        context.m_Deferred = 0;
+    }
+}
+
+void CMaintenanceScheduler::publishQueueDepth(CContext& context, std::size_t depth) {
+    core::CStat& stat{core::CStatistics::stat(stat_t::E_MaintenanceQueueDepth)};
+    if (depth > context.m_QueueDepth) {
+        stat.increment(depth - context.m_QueueDepth);
+    } else {
+        stat.decrement(context.m_QueueDepth - depth);
+    }
+    context.m_QueueDepth = depth;
+}
+
+const core_t::TTime CMaintenanceScheduler::NOT_SCHEDULED{
+    std::numeric_limits<core_t::TTime>::min()};
+const std::size_t CMaintenanceScheduler::DEFAULT_BUDGET{500};
+const core_t::TTime CMaintenanceScheduler::MAXIMUM_JITTER{12};
+const core_t::TTime CMaintenanceScheduler::MAXIMUM_JITTER_INTERVAL{6 * core::constants::HOUR};
+const core_t::TTime CMaintenanceScheduler::MAXIMUM_DEFERRAL{24};
+const core_t::TTime CMaintenanceScheduler::MAXIMUM_DEFERRAL_INTERVAL{core::constants::DAY};
+
+CMaintenanceScheduler::CContext CMaintenanceScheduler::ms_DefaultContext;
+}
+}
@@ -313,6 +313,29 @@ CModelParams& CModel::params() {
     return m_Params;
 }
 
+void CModel::probabilities(const CModelProbabilityParams& params,
+                           const TTime2Vec1Vec& time,
+                           const TDouble2Vec1Vec& values,
+                           const TDouble2VecWeightsAry1Vec& weights,
+                           const TBool2Vec1Vec& bucketEmpty,
+                           TModelProbabilityResultVec& results,
+                           TBoolVec& successes) const {
+    results.assign(values.size(), SModelProbabilityResult{});
+    successes.assign(values.size(), false);
+
+    CModelProbabilityParams params_{params};
+    TDouble2Vec1Vec value(1);
+    for (std::size_t i = 0u; i < values.size(); ++i) {
+        params_.weights({weights[i]}).bucketEmpty({bucketEmpty[i]});
+        value[0] = values[i];
+        successes[i] = this->probability(params_, time, value, results[i]);
+    }
+}
+
+CModel* CModel::promote() {
+    return nullptr;
+}
+
 double CModel::correctForEmptyBucket(maths_t::EProbabilityCalculation calculation,
                                      const TDouble2Vec& value,
                                      bool bucketEmpty,
@@ -410,7 +433,7 @@ void CModelStub::addBucketValue(const TTimeDouble2VecSizeTrVec& /*value*/) {
 }
 
 CModelStub::EUpdateResult CModelStub::addSamples(const CModelAddSamplesParams& /*params*/,
-                                                 TTimeDouble2VecSizeTrVec /*samples*/) {
+                                                 const TTimeDouble2VecSizeTrVec& /*samples*/) {
     return E_Success;
 }
 
@@ -52,7 +52,9 @@ bool CModelStateSerialiser::operator()(const SModelRestoreParams& params,
 
 void CModelStateSerialiser::operator()(const CModel& model,
                                        core::CStatePersistInserter& inserter) const {
-    if (dynamic_cast<const CUnivariateTimeSeriesModel*>(&model) != nullptr) {
+    // Newborn models persist the full model they stand in for.
+    if (dynamic_cast<const CUnivariateTimeSeriesModel*>(&model) != nullptr ||
+        dynamic_cast<const CNewbornTimeSeriesModel*>(&model) != nullptr) {
         inserter.insertLevel(UNIVARIATE_TIME_SERIES_TAG,
                              boost::bind(&CModel::acceptPersistInserter, &model, _1));
     } else if (dynamic_cast<const CMultivariateTimeSeriesModel*>(&model) != nullptr) {
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <limits>
 #include <numeric>
+#include <tuple>
 
 namespace ml {
 namespace maths {
@@ -561,57 +562,128 @@ bool CNaturalBreaksClassifier::naturalBreaksImpl(const std::vector<TUPLE>& categ
     // size we simply need to set any matrix entries that
     // violate the constraint to some large value (which will
     // mean it is never chosen).
+    //
+    // We only fill in the entries of D which can be part of
+    // a solution. The m'th break of a partition of N tuples
+    // into n classes is in the range [m, N - n + m], so each
+    // column of D only needs N - n + 1 rows and the last only
+    // needs row N - 1. In particular, the 2-split, which is
+    // what the clusterers ask for, is a single O(N) scan.
+    //
+    // The variation of a class satisfies the quadrangle
+    // inequality, so for that objective the optimal break for
+    // row i is nondecreasing in i and we can fill each column
+    // by divide and conquer in O(N log(N)) rather than O(N^2).
+    // The deviation objective doesn't satisfy the inequality,
+    // and its optimal breaks aren't monotonic, so for it every
+    // row is a full scan.
 
     // A proxy for infinity since operations on infinity are
     // slow and this will be well out of range of any real
     // values.
 
-    result.clear();
-
     static const double INF = boost::numeric::bounds<double>::highest();
 
     double pp = static_cast<double>(p);
 
-    using TDoubleVecVec = std::vector<TDoubleVec>;
-    using TSizeVecVec = std::vector<TSizeVec>;
-
     std::size_t N = categories.size();
+    std::size_t R = N - n + 1;
+
+    // Column m of D and B holds rows [m, N - n + m].
+    TSizeVec B(n * R, 0);
+    TDoubleVec D(n * R, INF);
+    auto index = [R](std::size_t i, std::size_t m) { return m * R + i - m; };
 
-    TSizeVecVec B(N, TSizeVec(n, 0));
-    TDoubleVecVec D(N, TDoubleVec(n, 0.0));
     {
         TTuple t;
-        for (std::size_t i = 0u; i < N; ++i) {
+        for (std::size_t i = 0u; i < R; ++i) {
             t += categories[i];
-            D[i][0] = CBasicStatistics::count(t) < pp ? INF : objective(target, t);
+            D[index(i, 0)] = CBasicStatistics::count(t) < pp ? INF : objective(target, t);
         }
     }
 
     LOG_TRACE(<< "categories = " << core::CContainerPrinter::print(categories));
 
-    for (std::size_t i = 1u; i < N; ++i) {
-        for (std::size_t m = 1u; m <= std::min(i, n - 1); ++m) {
-            std::size_t b = m + 1;
-            double d = INF;
-
-            TTuple t;
-            for (std::size_t j = i; j >= m; --j) {
-                t += categories[j];
-                double c = (D[j - 1][m - 1] == INF || CBasicStatistics::count(t) < pp)
-                               ? INF
-                               : D[j - 1][m - 1] + objective(target, t);
-                if (c <= d) {
-                    b = j;
-                    d = c;
-                }
+    // Find the best break for row i of column m by trying
+    // every possible break. Ties go to the smallest break.
+    auto scan = [&](std::size_t i, std::size_t m) {
+        std::size_t b = m;
+        double d = INF;
+
+        TTuple t;
+        for (std::size_t j = i; j >= m; --j) {
+            t += categories[j];
+            double Dj = D[index(j - 1, m - 1)];
+            double c = (Dj == INF || CBasicStatistics::count(t) < pp)
+                           ? INF
+                           : Dj + objective(target, t);
+            if (c <= d) {
+                b = j;
+                d = c;
             }
+        }
+
+        B[index(i, m)] = b;
+        D[index(i, m)] = d;
+    };
 
-            B[i][m] = b;
-            D[i][m] = d;
+    if (target == E_TargetVariation && n > 2) {
+        // The classes' statistics are the differences of prefix
+        // sums, which are accumulated in double precision since
+        // the differences lose accuracy.
+        TDoubleTupleVec prefixes(N + 1);
+        for (std::size_t i = 0u; i < N; ++i) {
+            prefixes[i + 1] = prefixes[i] + categories[i];
+        }
+
+        using TSizeSizeSizeSizeTuple =
+            std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>;
+        using TSizeSizeSizeSizeTupleVec = std::vector<TSizeSizeSizeSizeTuple>;
+
+        TSizeSizeSizeSizeTupleVec stack;
+        for (std::size_t m = 1u; m + 1 < n; ++m) {
+            stack.emplace_back(m, m + R, m, m + R);
+            while (stack.size() > 0) {
+                std::size_t iBegin, iEnd, jBegin, jEnd;
+                std::tie(iBegin, iEnd, jBegin, jEnd) = stack.back();
+                stack.pop_back();
+
+                std::size_t i = (iBegin + iEnd) / 2;
+                std::size_t b = jBegin;
+                double d = INF;
+                for (std::size_t j = jBegin; j < std::min(i + 1, jEnd); ++j) {
+                    TDoubleTuple t = prefixes[i + 1] - prefixes[j];
+                    double Dj = D[index(j - 1, m - 1)];
+                    double c = (Dj == INF || CBasicStatistics::count(t) < pp)
+                                   ? INF
+                                   : Dj + CBasicStatistics::count(t) *
+                                              CBasicStatistics::maximumLikelihoodVariance(t);
+                    if (c < d) {
+                        b = j;
+                        d = c;
+                    }
+                }
+                B[index(i, m)] = b;
+                D[index(i, m)] = d;
+
+                if (iBegin < i) {
+                    stack.emplace_back(iBegin, i, jBegin, b + 1);
+                }
+                if (i + 1 < iEnd) {
+                    stack.emplace_back(i + 1, iEnd, b, jEnd);
+                }
+            }
+        }
+    } else {
+        for (std::size_t m = 1u; m + 1 < n; ++m) {
+            for (std::size_t i = m; i < m + R; ++i) {
+                scan(i, m);
+            }
         }
     }
+    scan(N - 1, n - 1);
 
-    if (D[N - 1][n - 1] == INF) {
+    if (D[index(N - 1, n - 1)] == INF) {
         return false;
     }
 
@@ -626,9 +698,9 @@ bool CNaturalBreaksClassifier::naturalBreaksImpl(const std::vector<TUPLE>& categ
 
     result.resize(n, 0);
     result[n - 1] = N;
-    result[n - 2] = B[N - 1][n - 1];
+    result[n - 2] = B[index(N - 1, n - 1)];
     for (std::size_t i = 3u; i <= n; ++i) {
-        result[n - i] = B[result[n - i + 1] - 1][n - i + 1];
+        result[n - i] = B[index(result[n - i + 1] - 1, n - i + 1)];
     }
 
     LOG_TRACE(<< "result = " << core::CContainerPrinter::print(result));
@@ -13,19 +13,91 @@
 
 #include <maths/CChecksum.h>
 
+#include <functional>
+#include <new>
+#include <utility>
+
+#ifdef Windows
+#include <intrin.h>
+#endif
+
 namespace ml {
 namespace maths {
+namespace {
+
+const std::size_t WORD_BITS{64};
+
+//! Count the bits set in \p x.
+//!
+//! \note We compile for SSE4.2 so this is a single POPCNT instruction.
+inline std::size_t bitCount(uint64_t x) {
+#ifdef Windows
+    return static_cast<std::size_t>(__popcnt64(x));
+#else
+    return static_cast<std::size_t>(__builtin_popcountll(x));
+#endif
+}
+
+//! Get a mask for the bits [\p a, \p b) of a word.
+inline uint64_t mask(std::size_t a, std::size_t b) {
+    uint64_t upper{b == WORD_BITS ? ~uint64_t{0} : (uint64_t{1} << b) - 1};
+    return upper & ~((uint64_t{1} << a) - 1);
+}
+
+//! Get the length of the intersection of [\p a, \p b) and [\p c, \p d).
+//!
+//! \note Either run can be empty because runs of the maximum length are
+//! terminated by a zero length run.
+inline std::size_t overlap(std::size_t a, std::size_t b, std::size_t c, std::size_t d) {
+    std::size_t start{std::max(a, c)};
+    std::size_t end{std::min(b, d)};
+    return end > start ? end - start : 0;
+}
+
+//! Set the bits [\p a, \p b) of \p words.
+void setBits(std::size_t a, std::size_t b, std::vector<uint64_t>& words) {
+    while (a < b) {
+        std::size_t i{a / WORD_BITS};
+        std::size_t end{std::min(b, (i + 1) * WORD_BITS)};
+        words[i] |= mask(a % WORD_BITS, end - i * WORD_BITS);
+        a = end;
+    }
+}
+
+//! Count the bits set in \p op applied to \p x and \p y.
+//!
+//! The loop is unrolled with independent accumulators so the population
+//! counts of consecutive words can be pipelined.
+template<typename OP>
+std::size_t bitCount(const uint64_t* x, const uint64_t* y, std::size_t n, OP op) {
+    std::size_t result[]{0, 0, 0, 0};
+    std::size_t i{0};
+    for (/**/; i + 4 <= n; i += 4) {
+        result[0] += bitCount(op(x[i], y[i]));
+        result[1] += bitCount(op(x[i + 1], y[i + 1]));
+        result[2] += bitCount(op(x[i + 2], y[i + 2]));
+        result[3] += bitCount(op(x[i + 3], y[i + 3]));
+    }
+    for (/**/; i < n; ++i) {
+        result[0] += bitCount(op(x[i], y[i]));
+    }
+    return result[0] + result[1] + result[2] + result[3];
+}
+}
 
 CPackedBitVector::CPackedBitVector()
-    : m_Dimension(0), m_First(false), m_Parity(true) {
+    : m_Dimension(0), m_First(false), m_Parity(true), m_Packed(false),
+      m_RunLengths() {
 }
 
 CPackedBitVector::CPackedBitVector(bool bit)
-    : m_Dimension(1), m_First(bit), m_Parity(true), m_RunLengths(1, 1) {
+    : m_Dimension(1), m_First(bit), m_Parity(true), m_Packed(false),
+      m_RunLengths(1, 1) {
 }
 
 CPackedBitVector::CPackedBitVector(std::size_t dimension, bool bit)
-    : m_Dimension(static_cast<uint32_t>(dimension)), m_First(bit), m_Parity(true) {
+    : m_Dimension(static_cast<uint32_t>(dimension)), m_First(bit),
+      m_Parity(true), m_Packed(false), m_RunLengths() {
     if (dimension > 0) {
         std::size_t remainder = static_cast<std::size_t>(MAX_RUN_LENGTH);
         for (/**/; remainder <= dimension;
@@ -39,7 +111,8 @@ CPackedBitVector::CPackedBitVector(std::size_t dimension, bool bit)
 
 CPackedBitVector::CPackedBitVector(const TBoolVec& bits)
     : m_Dimension(static_cast<uint32_t>(bits.size())),
-      m_First(bits.empty() ? false : bits[0]), m_Parity(true) {
+      m_First(bits.empty() ? false : bits[0]), m_Parity(true),
+      m_Packed(false), m_RunLengths() {
     std::size_t length = 1u;
     for (std::size_t i = 1u; i < bits.size(); ++i) {
         if (bits[i] == bits[i - 1]) {
@@ -54,6 +127,57 @@ CPackedBitVector::CPackedBitVector(const TBoolVec& bits)
         }
     }
     m_RunLengths.push_back(static_cast<uint8_t>(length));
+    this->adapt();
+}
+
+CPackedBitVector::CPackedBitVector(const CPackedBitVector& other)
+    : m_Dimension(other.m_Dimension), m_First(other.m_First),
+      m_Parity(other.m_Parity), m_Packed(other.m_Packed) {
+    if (m_Packed) {
+        new (&m_Words) TUInt64Vec(other.m_Words);
+    } else {
+        new (&m_RunLengths) TUInt8Vec(other.m_RunLengths);
+    }
+}
+
+CPackedBitVector::CPackedBitVector(CPackedBitVector&& other) noexcept
+    : m_Dimension(other.m_Dimension), m_First(other.m_First),
+      m_Parity(other.m_Parity), m_Packed(other.m_Packed) {
+    if (m_Packed) {
+        new (&m_Words) TUInt64Vec(std::move(other.m_Words));
+    } else {
+        new (&m_RunLengths) TUInt8Vec(std::move(other.m_RunLengths));
+    }
+}
+
+CPackedBitVector::~CPackedBitVector() {
+    if (m_Packed) {
+        m_Words.~TUInt64Vec();
+    } else {
+        m_RunLengths.~TUInt8Vec();
+    }
+}
+
+CPackedBitVector& CPackedBitVector::operator=(const CPackedBitVector& other) {
+    if (this != &other) {
+        CPackedBitVector copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+CPackedBitVector& CPackedBitVector::operator=(CPackedBitVector&& other) noexcept {
+    if (this != &other) {
+        if (other.m_Packed) {
+            this->packedStorage(std::move(other.m_Words));
+        } else {
+            this->runLengthStorage(std::move(other.m_RunLengths));
+        }
+        m_Dimension = other.m_Dimension;
+        m_First = other.m_First;
+        m_Parity = other.m_Parity;
+    }
+    return *this;
 }
 
 void CPackedBitVector::contract() {
@@ -61,6 +185,19 @@ void CPackedBitVector::contract() {
         return;
     }
 
+    if (m_Packed) {
+        std::size_t n{m_Words.size()};
+        for (std::size_t i = 0u; i + 1 < n; ++i) {
+            m_Words[i] = (m_Words[i] >> 1) | (m_Words[i + 1] << (WORD_BITS - 1));
+        }
+        m_Words[n - 1] >>= 1;
+        if (--m_Dimension % WORD_BITS == 0) {
+            m_Words.pop_back();
+            this->adapt();
+        }
+        return;
+    }
+
     if (--m_Dimension == 0) {
         m_First = false;
         m_Parity = true;
@@ -83,9 +220,27 @@ void CPackedBitVector::contract() {
         m_Parity = !m_Parity;
         m_RunLengths.erase(m_RunLengths.begin());
     }
+
+    if (m_Dimension % WORD_BITS == 0) {
+        this->adapt();
+    }
 }
 
 void CPackedBitVector::extend(bool bit) {
+    if (m_Packed) {
+        std::size_t i{m_Dimension % WORD_BITS};
+        if (i == 0) {
+            m_Words.push_back(0);
+        }
+        if (bit) {
+            m_Words.back() |= uint64_t{1} << i;
+        }
+        if (++m_Dimension % WORD_BITS == 0) {
+            this->adapt();
+        }
+        return;
+    }
+
     ++m_Dimension;
 
     if (m_Dimension == 1) {
@@ -101,9 +256,15 @@ void CPackedBitVector::extend(bool bit) {
     } else {
         ++m_RunLengths.back();
     }
+
+    if (m_Dimension % WORD_BITS == 0) {
+        this->adapt();
+    }
 }
 
 bool CPackedBitVector::fromDelimited(const std::string& str) {
+    this->runLengthStorage(TUInt8Vec());
+
     std::size_t last = 0u;
     std::size_t pos = str.find_first_of(core::CPersistUtils::DELIMITER, last);
     if (pos == std::string::npos ||
@@ -136,18 +297,28 @@ bool CPackedBitVector::fromDelimited(const std::string& str) {
         LOG_ERROR(<< "Invalid packed vector in " << str);
         return false;
     }
+    this->adapt();
 
     return true;
 }
 
 std::string CPackedBitVector::toDelimited() const {
+    // We always persist the run length encoding so that the state
+    // doesn't depend on the representation.
+    bool first{m_First};
+    bool parity{m_Parity};
+    TUInt8Vec runLengths;
+    if (m_Packed) {
+        this->runLengths(first, parity, runLengths);
+    }
+
     std::string result;
     result += core::CStringUtils::typeToString(m_Dimension) + core::CPersistUtils::DELIMITER;
-    result += core::CStringUtils::typeToString(static_cast<int>(m_First)) +
+    result += core::CStringUtils::typeToString(static_cast<int>(first)) +
               core::CPersistUtils::DELIMITER;
-    result += core::CStringUtils::typeToString(static_cast<int>(m_Parity)) +
+    result += core::CStringUtils::typeToString(static_cast<int>(parity)) +
               core::CPersistUtils::DELIMITER;
-    result += core::CPersistUtils::toString(m_RunLengths);
+    result += core::CPersistUtils::toString(m_Packed ? runLengths : m_RunLengths);
     return result;
 }
 
@@ -156,6 +327,10 @@ std::size_t CPackedBitVector::dimension() const {
 }
 
 bool CPackedBitVector::operator()(std::size_t i) const {
+    if (m_Packed) {
+        return ((m_Words[i / WORD_BITS] >> (i % WORD_BITS)) & 1) != 0;
+    }
+
     bool parity = true;
     for (std::size_t j = 0u, k = static_cast<std::size_t>(m_RunLengths[j]);
          k <= i; k += static_cast<std::size_t>(m_RunLengths[++j])) {
@@ -167,19 +342,57 @@ bool CPackedBitVector::operator()(std::size_t i) const {
 }
 
 bool CPackedBitVector::operator==(const CPackedBitVector& other) const {
-    return m_Dimension == other.m_Dimension && m_First == other.m_First &&
-           m_Parity == other.m_Parity && m_RunLengths == other.m_RunLengths;
+    if (m_Dimension != other.m_Dimension) {
+        return false;
+    }
+    if (m_Packed && other.m_Packed) {
+        return m_Words == other.m_Words;
+    }
+    if (!m_Packed && !other.m_Packed) {
+        return m_First == other.m_First && m_Parity == other.m_Parity &&
+               m_RunLengths == other.m_RunLengths;
+    }
+
+    bool first[2];
+    bool parity[2];
+    TUInt8Vec runLengths[2];
+    this->runLengths(first[0], parity[0], runLengths[0]);
+    other.runLengths(first[1], parity[1], runLengths[1]);
+    return first[0] == first[1] && parity[0] == parity[1] && runLengths[0] == runLengths[1];
 }
 
 bool CPackedBitVector::operator<(const CPackedBitVector& rhs) const {
-    return COrderings::lexicographical_compare(m_Dimension, m_First, m_Parity,
-                                               m_RunLengths, rhs.m_Dimension, rhs.m_First,
-                                               rhs.m_Parity, rhs.m_RunLengths);
+    if (!m_Packed && !rhs.m_Packed) {
+        return COrderings::lexicographical_compare(
+            m_Dimension, m_First, m_Parity, m_RunLengths, rhs.m_Dimension,
+            rhs.m_First, rhs.m_Parity, rhs.m_RunLengths);
+    }
+
+    // The order is defined on the run length encoding so it must be
+    // independent of the representations.
+    bool first[2];
+    bool parity[2];
+    TUInt8Vec runLengths[2];
+    this->runLengths(first[0], parity[0], runLengths[0]);
+    rhs.runLengths(first[1], parity[1], runLengths[1]);
+    return COrderings::lexicographical_compare(m_Dimension, first[0], parity[0],
+                                               runLengths[0], rhs.m_Dimension,
+                                               first[1], parity[1], runLengths[1]);
 }
 
 CPackedBitVector CPackedBitVector::complement() const {
     CPackedBitVector result(*this);
-    result.m_First = !result.m_First;
+    if (m_Packed) {
+        for (auto& word : result.m_Words) {
+            word = ~word;
+        }
+        std::size_t remainder{m_Dimension % WORD_BITS};
+        if (remainder > 0) {
+            result.m_Words.back() &= mask(0, remainder);
+        }
+    } else {
+        result.m_First = !result.m_First;
+    }
     return result;
 }
 
@@ -194,6 +407,26 @@ double CPackedBitVector::inner(const CPackedBitVector& covector, EOperation op)
         return result;
     }
 
+    if (m_Packed && covector.m_Packed) {
+        const uint64_t* x{m_Words.data()};
+        const uint64_t* y{covector.m_Words.data()};
+        std::size_t n{m_Words.size()};
+        switch (op) {
+        case E_AND:
+            return static_cast<double>(bitCount(x, y, n, std::bit_and<uint64_t>()));
+        case E_OR:
+            return static_cast<double>(bitCount(x, y, n, std::bit_or<uint64_t>()));
+        case E_XOR:
+            return static_cast<double>(bitCount(x, y, n, std::bit_xor<uint64_t>()));
+        }
+    }
+    if (m_Packed) {
+        return this->mixedInner(covector, op);
+    }
+    if (covector.m_Packed) {
+        return covector.mixedInner(*this, op);
+    }
+
     int value = static_cast<int>(m_First);
     int covalue = static_cast<int>(covector.m_First);
     std::size_t length = static_cast<std::size_t>(m_RunLengths[0]);
@@ -203,7 +436,7 @@ double CPackedBitVector::inner(const CPackedBitVector& covector, EOperation op)
 
     for (std::size_t i = 0u, j = 0u; pos < m_Dimension || copos < m_Dimension;
          /**/) {
-        std::size_t run = std::min(pos, copos) - std::max(pos - length, copos - colength);
+        std::size_t run = overlap(pos - length, pos, copos - colength, copos);
         switch (op) {
         case E_AND:
             result += static_cast<double>((value & covalue) * run);
@@ -231,6 +464,8 @@ double CPackedBitVector::inner(const CPackedBitVector& covector, EOperation op)
         } else {
             if (length != MAX_RUN_LENGTH) {
                 value = 1 - value;
+            }
+            if (colength != MAX_RUN_LENGTH) {
                 covalue = 1 - covalue;
             }
             length = static_cast<std::size_t>(m_RunLengths[++i]);
@@ -240,7 +475,7 @@ double CPackedBitVector::inner(const CPackedBitVector& covector, EOperation op)
         }
     }
 
-    std::size_t run = std::min(length, colength);
+    std::size_t run = overlap(pos - length, pos, copos - colength, copos);
     switch (op) {
     case E_AND:
         result += static_cast<double>((value & covalue) * run);
@@ -264,6 +499,13 @@ CPackedBitVector::TBoolVec CPackedBitVector::toBitVector() const {
     TBoolVec result;
     result.reserve(m_Dimension);
 
+    if (m_Packed) {
+        for (std::size_t i = 0u; i < m_Dimension; ++i) {
+            result.push_back((*this)(i));
+        }
+        return result;
+    }
+
     bool parity = true;
     for (std::size_t i = 0u; i < m_RunLengths.size(); ++i) {
         std::fill_n(std::back_inserter(result),
@@ -277,6 +519,17 @@ CPackedBitVector::TBoolVec CPackedBitVector::toBitVector() const {
 }
 
 uint64_t CPackedBitVector::checksum() const {
+    if (m_Packed) {
+        bool first;
+        bool parity;
+        TUInt8Vec runLengths;
+        this->runLengths(first, parity, runLengths);
+        uint64_t seed = m_Dimension;
+        seed = CChecksum::calculate(seed, first);
+        seed = CChecksum::calculate(seed, parity);
+        return CChecksum::calculate(seed, runLengths);
+    }
+
     uint64_t seed = m_Dimension;
     seed = CChecksum::calculate(seed, m_First);
     seed = CChecksum::calculate(seed, m_Parity);
@@ -285,14 +538,186 @@ uint64_t CPackedBitVector::checksum() const {
 
 void CPackedBitVector::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
     mem->setName("CPackedBitVector");
-    core::CMemoryDebug::dynamicSize("m_RunLengths", m_RunLengths, mem);
+    if (m_Packed) {
+        core::CMemoryDebug::dynamicSize("m_Words", m_Words, mem);
+    } else {
+        core::CMemoryDebug::dynamicSize("m_RunLengths", m_RunLengths, mem);
+    }
 }
 
 std::size_t CPackedBitVector::memoryUsage() const {
-    return core::CMemory::dynamicSize(m_RunLengths);
+    return m_Packed ? core::CMemory::dynamicSize(m_Words)
+                    : core::CMemory::dynamicSize(m_RunLengths);
+}
+
+bool CPackedBitVector::packed() const {
+    return m_Packed;
+}
+
+void CPackedBitVector::runLengths(bool& first, bool& parity, TUInt8Vec& runLengths) const {
+    if (!m_Packed) {
+        first = m_First;
+        parity = m_Parity;
+        runLengths = m_RunLengths;
+        return;
+    }
+
+    // This must match the encoding CPackedBitVector(const TBoolVec&)
+    // produces.
+
+    runLengths.clear();
+    first = (*this)(0);
+    parity = true;
+    bool last = first;
+    std::size_t length = 1u;
+    for (std::size_t i = 1u; i < m_Dimension; ++i) {
+        bool bit = (*this)(i);
+        if (bit == last) {
+            if (++length == static_cast<std::size_t>(MAX_RUN_LENGTH)) {
+                runLengths.push_back(MAX_RUN_LENGTH);
+                length -= static_cast<std::size_t>(MAX_RUN_LENGTH);
+            }
+        } else {
+            parity = !parity;
+            runLengths.push_back(static_cast<uint8_t>(length));
+            length = 1;
+            last = bit;
+        }
+    }
+    runLengths.push_back(static_cast<uint8_t>(length));
+}
+
+std::size_t CPackedBitVector::countOnes(std::size_t a, std::size_t b) const {
+    std::size_t result{0};
+    while (a < b) {
+        std::size_t i{a / WORD_BITS};
+        std::size_t end{std::min(b, (i + 1) * WORD_BITS)};
+        result += bitCount(m_Words[i] & mask(a % WORD_BITS, end - i * WORD_BITS));
+        a = end;
+    }
+    return result;
+}
+
+double CPackedBitVector::mixedInner(const CPackedBitVector& covector, EOperation op) const {
+    // We count the ones in the packed vector which overlap runs of
+    // ones in the run length encoded vector. The or and exclusive or
+    // follow from this and the total number of ones in each vector.
+
+    std::size_t ones{0};
+    for (auto word : m_Words) {
+        ones += bitCount(word);
+    }
+
+    std::size_t coones{0};
+    std::size_t both{0};
+    bool value{covector.m_First};
+    std::size_t pos{0};
+    for (auto length : covector.m_RunLengths) {
+        std::size_t end{std::min(pos + static_cast<std::size_t>(length),
+                                 static_cast<std::size_t>(m_Dimension))};
+        if (value) {
+            coones += end - pos;
+            both += this->countOnes(pos, end);
+        }
+        pos = end;
+        if (length != MAX_RUN_LENGTH) {
+            value = !value;
+        }
+    }
+
+    switch (op) {
+    case E_AND:
+        return static_cast<double>(both);
+    case E_OR:
+        return static_cast<double>(ones + coones - both);
+    case E_XOR:
+        return static_cast<double>(ones + coones - 2 * both);
+    }
+    return 0.0;
+}
+
+void CPackedBitVector::adapt() {
+    // The run length encoding uses roughly one byte per run and the
+    // packed representation one byte per eight components. We switch
+    // to whichever is smaller, with a factor of two hysteresis so that
+    // we don't flip flop between representations as the vector changes.
+
+    std::size_t bytes{8 * ((static_cast<std::size_t>(m_Dimension) + WORD_BITS - 1) / WORD_BITS)};
+
+    if (m_Packed) {
+        if (m_Dimension < MINIMUM_PACKED_DIMENSION) {
+            this->unpack();
+            return;
+        }
+        // Count the runs, i.e. one plus the number of bit flips.
+        std::size_t runs{1};
+        uint64_t carry{m_Words[0] & 1};
+        for (std::size_t i = 0u; i < m_Words.size(); ++i) {
+            uint64_t flips{m_Words[i] ^ ((m_Words[i] << 1) | carry)};
+            if (i + 1 == m_Words.size() && m_Dimension % WORD_BITS != 0) {
+                flips &= mask(0, m_Dimension % WORD_BITS);
+            }
+            runs += bitCount(flips);
+            carry = m_Words[i] >> (WORD_BITS - 1);
+        }
+        if (2 * runs < bytes) {
+            this->unpack();
+        }
+    } else if (m_Dimension >= MINIMUM_PACKED_DIMENSION && m_RunLengths.size() > bytes) {
+        this->pack();
+    }
+}
+
+void CPackedBitVector::pack() {
+    TUInt64Vec words((static_cast<std::size_t>(m_Dimension) + WORD_BITS - 1) / WORD_BITS, 0);
+    bool value{m_First};
+    std::size_t pos{0};
+    for (auto length : m_RunLengths) {
+        std::size_t end{std::min(pos + static_cast<std::size_t>(length),
+                                 static_cast<std::size_t>(m_Dimension))};
+        if (value) {
+            setBits(pos, end, words);
+        }
+        pos = end;
+        if (length != MAX_RUN_LENGTH) {
+            value = !value;
+        }
+    }
+    this->packedStorage(std::move(words));
+}
+
+void CPackedBitVector::unpack() {
+    bool first;
+    bool parity;
+    TUInt8Vec runLengths;
+    this->runLengths(first, parity, runLengths);
+    m_First = first;
+    m_Parity = parity;
+    this->runLengthStorage(std::move(runLengths));
+}
+
+void CPackedBitVector::packedStorage(TUInt64Vec&& words) {
+    if (m_Packed) {
+        m_Words = std::move(words);
+    } else {
+        m_RunLengths.~TUInt8Vec();
+        new (&m_Words) TUInt64Vec(std::move(words));
+        m_Packed = true;
+    }
+}
+
+void CPackedBitVector::runLengthStorage(TUInt8Vec&& runLengths) {
+    if (m_Packed) {
+        m_Words.~TUInt64Vec();
+        new (&m_RunLengths) TUInt8Vec(std::move(runLengths));
+        m_Packed = false;
+    } else {
+        m_RunLengths = std::move(runLengths);
+    }
 }
 
 const uint8_t CPackedBitVector::MAX_RUN_LENGTH = std::numeric_limits<uint8_t>::max();
+const std::size_t CPackedBitVector::MINIMUM_PACKED_DIMENSION = 256;
 
 std::ostream& operator<<(std::ostream& o, const CPackedBitVector& v) {
     if (v.dimension() == 0) {
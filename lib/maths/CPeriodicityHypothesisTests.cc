@@ -45,7 +45,6 @@ namespace {
 
 using TDoubleVec = std::vector<double>;
 using TSizeVec = std::vector<std::size_t>;
-using TTimeVec = std::vector<core_t::TTime>;
 using TSizeSizePr = std::pair<std::size_t, std::size_t>;
 using TSizeSizePr2Vec = core::CSmallVector<TSizeSizePr, 2>;
 using TMeanAccumulator = CBasicStatistics::SSampleMean<double>::TAccumulator;
@@ -174,10 +173,12 @@ void removeLinearTrend(TFloatMeanAccumulatorVec& values) {
         trend.add(time, CBasicStatistics::mean(value), CBasicStatistics::count(value));
         time += dt;
     }
+    TRegression::TArray params;
+    trend.parameters(params);
     time = dt / 2.0;
     for (auto& value : values) {
         if (CBasicStatistics::count(value) > 0.0) {
-            CBasicStatistics::moment<0>(value) -= trend.predict(time);
+            CBasicStatistics::moment<0>(value) -= CRegression::predict(params, time);
         }
         time += dt;
     }
@@ -305,12 +306,14 @@ TSizeVec calculateRepeats(const TSizeSizePr2Vec& windows,
     TSizeVec result(std::min(period, length(windows[0])), 0);
     std::size_t n{values.size()};
     for (const auto& window : windows) {
-        std::size_t a{window.first};
-        std::size_t b{window.second};
-        for (std::size_t i = a; i < b; ++i) {
-            if (CBasicStatistics::count(values[i % n]) > 0.0) {
-                ++result[(i - a) % period];
+        std::size_t i{window.first % n};
+        std::size_t k{0};
+        for (std::size_t j = window.first; j < window.second; ++j) {
+            if (CBasicStatistics::count(values[i]) > 0.0) {
+                ++result[k];
             }
+            i = i + 1 == n ? 0 : i + 1;
+            k = k + 1 == period ? 0 : k + 1;
         }
     }
     return result;
@@ -358,17 +361,18 @@ void reweightOutliers(const std::vector<T>& trend,
             TMaxAccumulator outliers{numberOutliers};
             TMeanAccumulator meanDifference;
             for (const auto& window : windows) {
-                std::size_t a{window.first};
-                std::size_t b{window.second};
-                for (std::size_t j = a; j < b; ++j) {
-                    const TFloatMeanAccumulator& value{values[j % n]};
+                std::size_t i{window.first % n};
+                std::size_t k{0};
+                for (std::size_t j = window.first; j < window.second; ++j) {
+                    const TFloatMeanAccumulator& value{values[i]};
                     if (CBasicStatistics::count(value) > 0.0) {
-                        std::size_t offset{(j - a) % period};
                         double difference{std::fabs(CBasicStatistics::mean(value) -
-                                                    CBasicStatistics::mean(trend[offset]))};
+                                                    CBasicStatistics::mean(trend[k]))};
                         outliers.add({difference, j});
                         meanDifference.add(difference);
                     }
+                    i = i + 1 == n ? 0 : i + 1;
+                    k = k + 1 == period ? 0 : k + 1;
                 }
             }
             TMeanAccumulator meanDifferenceOfOutliers;
@@ -402,12 +406,16 @@ void periodicTrend(const std::vector<T>& values,
         std::size_t period{trend.size()};
         std::size_t n{values.size()};
         for (const auto& window : windows) {
-            std::size_t a{window.first};
-            std::size_t b{window.second};
-            for (std::size_t j = a; j < b; ++j) {
-                const TFloatMeanAccumulator& value{values[j % n]};
-                trend[(j - a) % period].add(CBasicStatistics::mean(value),
-                                            CBasicStatistics::count(value));
+            // Step the value and trend indices rather than reducing modulo
+            // the window length and period for every bucket: this loop is
+            // run many times for each candidate hypothesis.
+            std::size_t i{window.first % n};
+            std::size_t k{0};
+            for (std::size_t j = window.first; j < window.second; ++j) {
+                const TFloatMeanAccumulator& value{values[i]};
+                trend[k].add(CBasicStatistics::mean(value), CBasicStatistics::count(value));
+                i = i + 1 == n ? 0 : i + 1;
+                k = k + 1 == period ? 0 : k + 1;
             }
         }
     }
@@ -425,13 +433,11 @@ void periodicTrendMinusOutliers(std::vector<T>& values,
     periodicTrend(values, windows, bucketLength, trend);
 }
 
-//! Compute the average of the values at \p times.
+//! Compute the average of the values at \p indices.
 void averageValue(const TFloatMeanAccumulatorVec& values,
-                  const TTimeVec& times,
-                  core_t::TTime bucketLength,
+                  const TSizeVec& indices,
                   TMeanVarAccumulator& value) {
-    for (const auto time : times) {
-        std::size_t index(time / bucketLength);
+    for (const auto index : indices) {
         value.add(CBasicStatistics::mean(values[index]),
                   CBasicStatistics::count(values[index]));
     }
@@ -1313,7 +1319,7 @@ void CPeriodicityHypothesisTests::nullHypothesis(const TTimeTimePr2Vec& window,
 void CPeriodicityHypothesisTests::hypothesis(const TTime2Vec& periods,
                                              const TFloatMeanAccumulatorCRng& buckets,
                                              STestStats& stats) const {
-    if (this->testStatisticsFor(buckets, stats)) {
+    if (stats.populated()) {
         stats.s_V0 = 0.0;
         stats.s_DF0 = 0.0;
         stats.s_T0 = TDoubleVec2Vec(stats.s_Partition.size());
@@ -1352,12 +1358,14 @@ void CPeriodicityHypothesisTests::conditionOnHypothesis(const STestStats& stats,
         std::size_t period{stats.s_T0[i].size()};
         LOG_TRACE(<< "Conditioning on period = " << period
                   << " in windows = " << core::CContainerPrinter::print(windows_));
+        const TDoubleVec& trend{stats.s_T0[i]};
         for (const auto& window : indexWindows) {
-            std::size_t a{window.first};
-            std::size_t b{window.second};
-            for (std::size_t j = a; j < b; ++j) {
-                CBasicStatistics::moment<0>(buckets[j % n]) -=
-                    stats.s_T0[i][(j - a) % period];
+            std::size_t j{window.first % n};
+            std::size_t k{0};
+            for (std::size_t l = window.first; l < window.second; ++l) {
+                CBasicStatistics::moment<0>(buckets[j]) -= trend[k];
+                j = j + 1 == n ? 0 : j + 1;
+                k = k + 1 == period ? 0 : k + 1;
             }
         }
     }
@@ -1376,7 +1384,7 @@ bool CPeriodicityHypothesisTests::testPeriod(const TTimeTimePr2Vec& windows,
 
     LOG_TRACE(<< "Testing period " << period_);
 
-    if (!this->testStatisticsFor(buckets, stats) || stats.nullHypothesisGoodEnough()) {
+    if (!stats.populated() || stats.nullHypothesisGoodEnough()) {
         return false;
     }
     if (stats.s_HasPeriod) {
@@ -1398,17 +1406,19 @@ bool CPeriodicityHypothesisTests::testPeriod(const TTimeTimePr2Vec& windows,
     TFloatMeanAccumulatorVec values(buckets.begin(), buckets.end());
     this->conditionOnHypothesis(stats, values);
 
+    // Conditioning only changes the bucket means so the number of
+    // populated buckets only changes if we project the values.
+    double B{stats.s_B};
     if (windowLength < length(buckets, m_BucketLength)) {
         LOG_TRACE(<< "Projecting onto " << core::CContainerPrinter::print(windows));
         TFloatMeanAccumulatorVec projection;
         project(values, windows, m_BucketLength, projection);
         values = std::move(projection);
+        B = static_cast<double>(std::count_if(
+            values.begin(), values.end(), [](const TFloatMeanAccumulator& value) {
+                return CBasicStatistics::count(value) > 0.0;
+            }));
     }
-
-    double B{static_cast<double>(std::count_if(
-        values.begin(), values.end(), [](const TFloatMeanAccumulator& value) {
-            return CBasicStatistics::count(value) > 0.0;
-        }))};
     double df0{B - stats.s_DF0};
 
     // We need fewer degrees of freedom in the null hypothesis trend model
@@ -1559,7 +1569,7 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
     LOG_TRACE(<< "Testing partition " << core::CContainerPrinter::print(partition)
               << " with period " << period_);
 
-    if (!this->testStatisticsFor(buckets, stats) || stats.nullHypothesisGoodEnough()) {
+    if (!stats.populated() || stats.nullHypothesisGoodEnough()) {
         return false;
     }
     if (stats.s_HasPartition) {
@@ -1611,7 +1621,11 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
         calculateWindows(startOfPartition, windowLength, repeat, partition[1])};
     LOG_TRACE(<< "windows = " << core::CContainerPrinter::print(windows));
 
-    TTimeVec deltas[2];
+    // We track the bucket indices, rather than times, of the values
+    // entering the trends as we shift the partition so that each step
+    // is an increment rather than a division.
+    std::size_t n{values.size()};
+    TSizeVec deltas[2];
     deltas[0].reserve((length(partition[0]) * windowLength) / (period_ * repeat));
     deltas[1].reserve((length(partition[1]) * windowLength) / (period_ * repeat));
     for (std::size_t j = 0u; j < 2; ++j) {
@@ -1619,7 +1633,8 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
             core_t::TTime a_{window.first};
             core_t::TTime b_{window.second};
             for (core_t::TTime t = a_ + period_; t <= b_; t += period_) {
-                deltas[j].push_back(t - m_BucketLength);
+                deltas[j].push_back(
+                    static_cast<std::size_t>((t - m_BucketLength) / m_BucketLength) % n);
             }
         }
     }
@@ -1643,11 +1658,11 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
     for (core_t::TTime time = m_BucketLength; time < repeat; time += m_BucketLength) {
         for (std::size_t j = 0u; j < 2; ++j) {
             for (auto& delta : deltas[j]) {
-                delta = (delta + m_BucketLength) % windowLength;
+                delta = delta + 1 == n ? 0 : delta + 1;
             }
             TMeanVarAccumulator oldBucket{trends[j].front()};
             TMeanVarAccumulator newBucket;
-            averageValue(values, deltas[j], m_BucketLength, newBucket);
+            averageValue(values, deltas[j], newBucket);
 
             trends[j].pop_front();
             trends[j].push_back(newBucket);
@@ -1662,7 +1677,6 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
         }
     }
 
-    double b{0.0};
     TMinAccumulator best;
 
     for (const auto& candidate : candidates) {
@@ -1677,19 +1691,23 @@ bool CPeriodicityHypothesisTests::testPartition(const TTimeTimePr2Vec& partition
                 double vb{CBasicStatistics::mean(values[b_ % values.size()])};
                 cost.add(std::fabs(va) + std::fabs(vb) + std::fabs(vb - va));
             }
-            if (best.add({CBasicStatistics::mean(cost), startOfPartition})) {
-                b = 0.0;
-                for (std::size_t i = 0u; i < partition.size(); ++i) {
-                    windows[i] = calculateWindows(startOfPartition, windowLength,
-                                                  repeat, partition[i]);
-                    TMeanVarAccumulatorVec trend(period);
-                    periodicTrend(values, windows[i], m_BucketLength, trend);
-                    b += static_cast<double>(std::count_if(
-                        trend.begin(), trend.end(), [](const TMeanVarAccumulator& value) {
-                            return CBasicStatistics::count(value) > 0.0;
-                        }));
-                }
-            }
+            best.add({CBasicStatistics::mean(cost), startOfPartition});
+        }
+    }
+
+    // Only the best candidate's trend is needed so we defer computing
+    // it until we've finished the search.
+    double b{0.0};
+    if (best.count() > 0) {
+        for (std::size_t i = 0u; i < partition.size(); ++i) {
+            windows[i] = calculateWindows(best[0].second, windowLength, repeat,
+                                          partition[i]);
+            TMeanVarAccumulatorVec trend(period);
+            periodicTrend(values, windows[i], m_BucketLength, trend);
+            b += static_cast<double>(std::count_if(
+                trend.begin(), trend.end(), [](const TMeanVarAccumulator& value) {
+                    return CBasicStatistics::count(value) > 0.0;
+                }));
         }
     }
 
@@ -1796,6 +1814,10 @@ void CPeriodicityHypothesisTests::STestStats::setThresholds(double vt, double at
     s_Rt = Rt;
 }
 
+bool CPeriodicityHypothesisTests::STestStats::populated() const {
+    return s_B > 0.0;
+}
+
 bool CPeriodicityHypothesisTests::STestStats::nullHypothesisGoodEnough() const {
     TMeanAccumulator mean;
     for (const auto& t : s_T0) {
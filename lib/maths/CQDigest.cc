@@ -8,6 +8,7 @@
 
 #include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
+#include <core/CMemory.h>
 #include <core/CStatePersistInserter.h>
 #include <core/CStateRestoreTraverser.h>
 #include <core/RestoreMacros.h>
@@ -37,6 +38,7 @@ std::string EMPTY_STRING;
 const std::string CQDigest::K_TAG("a");
 const std::string CQDigest::N_TAG("b");
 const std::string CQDigest::NODE_TAG("c");
+const std::size_t CQDigest::CNodeAllocator::MINIMUM_BLOCK_SIZE(16);
 
 CQDigest::CQDigest(uint64_t k, double decayRate)
     : m_K(k), m_N(0u), m_Root(nullptr),
@@ -66,6 +68,7 @@ bool CQDigest::acceptRestoreTraverser(core::CStateRestoreTraverser& traverser) {
                 LOG_ERROR(<< "Failed to restore NODE_TAG, got " << traverser.value());
             }
             if (nodeCount++ == 0) {
+                this->releaseNodes();
                 m_Root = &m_NodeAllocator.create(node);
             } else {
                 m_Root->insert(m_NodeAllocator, node);
@@ -116,9 +119,12 @@ void CQDigest::merge(const CQDigest& digest) {
         m_Root = expanded;
     }
 
+    // Note that we must only insert the nodes' own counts: the
+    // descendants of node in the other q-digest are also inserted.
     for (const auto& node : nodes) {
         m_N += node->count();
-        m_Root->insert(m_NodeAllocator, *node);
+        m_Root->insert(m_NodeAllocator,
+                       CNode(node->min(), node->max(), node->count(), node->count()));
     }
 
     // Compress the whole tree.
@@ -210,6 +216,7 @@ void CQDigest::clear() {
     m_Root->postOrder(nodes);
     for (const auto& node : nodes) {
         m_N -= node->count();
+        m_NodeAllocator.release(*node);
     }
 
     // Reset root to its initial state and sanity check total count.
@@ -406,6 +413,15 @@ uint64_t CQDigest::checksum(uint64_t seed) const {
     return CChecksum::calculate(seed, summary);
 }
 
+void CQDigest::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CQDigest");
+    mem->addItem("m_NodeAllocator", m_NodeAllocator.memoryUsage());
+}
+
+std::size_t CQDigest::memoryUsage() const {
+    return m_NodeAllocator.memoryUsage();
+}
+
 bool CQDigest::checkInvariants() const {
     // These are:
     //   1) |Q| <= 3 * k.
@@ -441,6 +457,15 @@ std::string CQDigest::print() const {
     return result.str();
 }
 
+void CQDigest::releaseNodes() {
+    TNodePtrVec nodes;
+    m_Root->postOrder(nodes);
+    for (const auto& node : nodes) {
+        m_NodeAllocator.release(*node);
+    }
+    m_Root = nullptr;
+}
+
 void CQDigest::compress() {
     for (std::size_t i = 0u; i < 3 * m_K + 2; ++i) {
         TNodePtrVec compress;
@@ -786,6 +811,10 @@ bool CQDigest::CNode::acceptRestoreTraverser(core::CStateRestoreTraverser& trave
     return true;
 }
 
+std::size_t CQDigest::CNode::memoryUsage() const {
+    return core::CMemory::dynamicSize(m_Descendants);
+}
+
 bool CQDigest::CNode::checkInvariants(uint64_t compressionFactor) const {
     // 1) span is a power of 2
     // 2) q-digest connectivity is consistent.
@@ -996,34 +1025,48 @@ bool CQDigest::CNode::takeDescendants(CNode& node) {
     return true;
 }
 
-CQDigest::CNodeAllocator::CNodeAllocator(std::size_t size) {
+CQDigest::CNodeAllocator::CNodeAllocator(std::size_t size)
+    : m_MaximumBlockSize(std::max(size, std::size_t(1))) {
     m_Nodes.push_back(TNodeVec());
-    m_Nodes.back().reserve(size);
+    m_Nodes.back().reserve(std::min(MINIMUM_BLOCK_SIZE, m_MaximumBlockSize));
     m_FreeNodes.push_back(TNodePtrVec());
 }
 
 CQDigest::CNode& CQDigest::CNodeAllocator::create(const CNode& node) {
-    if (m_FreeNodes.front().empty()) {
-        // Add a new collection if necessary. This should
-        // only happen when merging two q-digests.
-        std::size_t size = m_Nodes.back().size();
-        if (size == m_Nodes.back().capacity()) {
-            m_Nodes.push_back(TNodeVec());
-            m_Nodes.back().reserve(size);
-            m_FreeNodes.push_back(TNodePtrVec());
-            LOG_TRACE(<< "Added new block " << m_Nodes.size());
+    // Recycle a node if possible. There are only ever a handful of
+    // blocks so this search is cheap.
+    for (auto& freeNodes : m_FreeNodes) {
+        if (freeNodes.size() > 0) {
+            CNode* freeNode = freeNodes.back();
+            *freeNode = node;
+            freeNodes.pop_back();
+            return *freeNode;
         }
+    }
 
-        TNodeVec& nodes = m_Nodes.back();
-        nodes.resize(nodes.size() + 1u);
-        nodes.back() = node;
-        return nodes.back();
+    // Add a new block if necessary. We never resize a block
+    // since this would invalidate pointers to its nodes.
+    std::size_t capacity = m_Nodes.back().capacity();
+    if (m_Nodes.back().size() == capacity) {
+        // The q-digest has at most the maximum block size nodes except
+        // transiently during a merge so we stop growing when the total
+        // reaches this.
+        std::size_t total = 0;
+        for (const auto& block : m_Nodes) {
+            total += block.capacity();
+        }
+        std::size_t size = total < m_MaximumBlockSize
+                               ? std::min(2 * capacity, m_MaximumBlockSize - total)
+                               : capacity;
+        m_Nodes.push_back(TNodeVec());
+        m_Nodes.back().reserve(std::max(size, MINIMUM_BLOCK_SIZE));
+        m_FreeNodes.push_back(TNodePtrVec());
+        LOG_TRACE(<< "Added new block " << m_Nodes.size());
     }
 
-    CNode* freeNode = m_FreeNodes.front().back();
-    *freeNode = node;
-    m_FreeNodes.front().pop_back();
-    return *freeNode;
+    TNodeVec& nodes = m_Nodes.back();
+    nodes.push_back(node);
+    return nodes.back();
 }
 
 void CQDigest::CNodeAllocator::release(CNode& node) {
@@ -1048,6 +1091,17 @@ void CQDigest::CNodeAllocator::release(CNode& node) {
     }
 }
 
+std::size_t CQDigest::CNodeAllocator::memoryUsage() const {
+    std::size_t mem = core::CMemory::dynamicSize(m_FreeNodes);
+    for (const auto& block : m_Nodes) {
+        mem += block.capacity() * sizeof(CNode);
+        for (const auto& node : block) {
+            mem += node.memoryUsage();
+        }
+    }
+    return mem;
+}
+
 std::size_t CQDigest::CNodeAllocator::findBlock(const CNode& node) const {
     std::size_t result = 0u;
 
@@ -393,8 +393,14 @@ void CQuantileSketch::reduce() {
     this->orderAndDeduplicate();
 
     if (m_Knots.size() > target) {
-        TDoubleDoublePrVec costs;
-        TSizeVec indexing;
+        // This happens every time the sketch fills up so we reuse the
+        // calling thread's collections to avoid allocating.
+        thread_local TDoubleDoublePrVec costs;
+        thread_local TSizeVec indexing;
+        thread_local TSizeVec stale;
+        costs.clear();
+        indexing.clear();
+        stale.clear();
         costs.reserve(m_Knots.size());
         indexing.reserve(m_Knots.size());
         for (std::size_t i = 1u; i + 2 < m_Knots.size(); ++i) {
@@ -406,7 +412,7 @@ void CQuantileSketch::reduce() {
         std::size_t merged = 0u;
 
         std::make_heap(indexing.begin(), indexing.end(), CIndexingGreater(costs));
-        for (TSizeVec stale; m_Knots.size() > target + merged; /**/) {
+        while (m_Knots.size() > target + merged) {
             LOG_TRACE(<< "indexing = " << core::CContainerPrinter::print(indexing));
 
             std::size_t l = indexing[0] + 1;
@@ -473,7 +479,12 @@ void CQuantileSketch::reduce() {
 }
 
 void CQuantileSketch::orderAndDeduplicate() {
-    if (m_Unsorted > 0) {
+    if (m_Unsorted == 1) {
+        // This is the common case and rotating the new knot into place
+        // avoids the temporary buffer inplace_merge allocates.
+        auto last = m_Knots.end() - 1;
+        std::rotate(std::upper_bound(m_Knots.begin(), last, *last), last, m_Knots.end());
+    } else if (m_Unsorted > 0) {
         std::sort(m_Knots.end() - m_Unsorted, m_Knots.end());
         std::inplace_merge(m_Knots.begin(), m_Knots.end() - m_Unsorted, m_Knots.end());
     }
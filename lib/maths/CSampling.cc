@@ -394,10 +394,26 @@ void sampleQuantiles(const DISTRIBUTION& distribution, std::size_t n, TDoubleVec
 }
 
 const std::string RNG_TAG("a");
+
+//! The context of the calling thread if it has set one.
+thread_local CSampling::CContext* currentContext{nullptr};
+}
+
+CSampling::CScopedContext::CScopedContext(CContext& context)
+    : m_Previous(currentContext) {
+    currentContext = &context;
+}
+
+CSampling::CScopedContext::~CScopedContext() {
+    currentContext = m_Previous;
+}
+
+CSampling::CContext& CSampling::context() {
+    return currentContext != nullptr ? *currentContext : ms_DefaultContext;
 }
 
 bool CSampling::staticsAcceptRestoreTraverser(core::CStateRestoreTraverser& traverser) {
-    // Note we require that we only ever do one persistence per process.
+    // Note we require that we only ever do one persistence per context.
 
     do {
         const std::string& name = traverser.name();
@@ -407,8 +423,9 @@ bool CSampling::staticsAcceptRestoreTraverser(core::CStateRestoreTraverser& trav
             // See acceptPersistInserter
             std::replace(value.begin(), value.end(), '_', ' ');
             std::istringstream ss(value);
-            core::CScopedFastLock scopedLock(ms_Lock);
-            ss >> ms_Rng;
+            CContext& context_ = context();
+            core::CScopedFastLock scopedLock(context_.m_Lock);
+            ss >> context_.m_Rng;
         }
     } while (traverser.next());
 
@@ -416,12 +433,13 @@ bool CSampling::staticsAcceptRestoreTraverser(core::CStateRestoreTraverser& trav
 }
 
 void CSampling::staticsAcceptPersistInserter(core::CStatePersistInserter& inserter) {
-    // Note we require that we only ever do one persistence per process.
+    // Note we require that we only ever do one persistence per context.
 
     std::ostringstream ss;
     {
-        core::CScopedFastLock scopedLock(ms_Lock);
-        ss << ms_Rng;
+        CContext& context_ = context();
+        core::CScopedFastLock scopedLock(context_.m_Lock);
+        ss << context_.m_Rng;
     }
     std::string rng(ss.str());
     // These are space separated integers. We replace spaces or else
@@ -431,14 +449,16 @@ void CSampling::staticsAcceptPersistInserter(core::CStatePersistInserter& insert
 }
 
 void CSampling::seed() {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    ms_Rng.seed();
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    context_.m_Rng.seed();
 }
 
 #define UNIFORM_SAMPLE(TYPE)                                                                  \
     TYPE CSampling::uniformSample(TYPE a, TYPE b) {                                           \
-        core::CScopedFastLock scopedLock(ms_Lock);                                            \
-        return doUniformSample(ms_Rng, a, b);                                                 \
+        CContext& context_ = context();                                                       \
+        core::CScopedFastLock scopedLock(context_.m_Lock);                                    \
+        return doUniformSample(context_.m_Rng, a, b);                                         \
     }                                                                                         \
     TYPE CSampling::uniformSample(CPRNG::CXorOShiro128Plus& rng, TYPE a, TYPE b) {            \
         return doUniformSample(rng, a, b);                                                    \
@@ -447,8 +467,9 @@ void CSampling::seed() {
         return doUniformSample(rng, a, b);                                                    \
     }                                                                                         \
     void CSampling::uniformSample(TYPE a, TYPE b, std::size_t n, std::vector<TYPE>& result) { \
-        core::CScopedFastLock scopedLock(ms_Lock);                                            \
-        doUniformSample(ms_Rng, a, b, n, result);                                             \
+        CContext& context_ = context();                                                       \
+        core::CScopedFastLock scopedLock(context_.m_Lock);                                    \
+        doUniformSample(context_.m_Rng, a, b, n, result);                                     \
     }                                                                                         \
     void CSampling::uniformSample(CPRNG::CXorOShiro128Plus& rng, TYPE a, TYPE b,              \
                                   std::size_t n, std::vector<TYPE>& result) {                 \
@@ -464,8 +485,9 @@ UNIFORM_SAMPLE(double)
 #undef UNIFORM_SAMPLE
 
 double CSampling::normalSample(double mean, double variance) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    return doNormalSample(ms_Rng, mean, variance);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    return doNormalSample(context_.m_Rng, mean, variance);
 }
 
 double CSampling::normalSample(CPRNG::CXorOShiro128Plus& rng, double mean, double variance) {
@@ -477,8 +499,9 @@ double CSampling::normalSample(CPRNG::CXorShift1024Mult& rng, double mean, doubl
 }
 
 void CSampling::normalSample(double mean, double variance, std::size_t n, TDoubleVec& result) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    doNormalSample(ms_Rng, mean, variance, n, result);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    doNormalSample(context_.m_Rng, mean, variance, n, result);
 }
 
 void CSampling::normalSample(CPRNG::CXorOShiro128Plus& rng,
@@ -498,8 +521,9 @@ void CSampling::normalSample(CPRNG::CXorShift1024Mult& rng,
 }
 
 void CSampling::chiSquaredSample(double f, std::size_t n, TDoubleVec& result) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    doChiSquaredSample(ms_Rng, f, n, result);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    doChiSquaredSample(context_.m_Rng, f, n, result);
 }
 
 void CSampling::chiSquaredSample(CPRNG::CXorOShiro128Plus& rng,
@@ -520,8 +544,9 @@ bool CSampling::multivariateNormalSample(const TDoubleVec& mean,
                                          const TDoubleVecVec& covariance,
                                          std::size_t n,
                                          TDoubleVecVec& samples) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    return doMultivariateNormalSample(ms_Rng, mean, covariance, n, samples);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    return doMultivariateNormalSample(context_.m_Rng, mean, covariance, n, samples);
 }
 
 bool CSampling::multivariateNormalSample(CPRNG::CXorOShiro128Plus& rng,
@@ -544,8 +569,9 @@ bool CSampling::multivariateNormalSample(CPRNG::CXorShift1024Mult& rng,
     void CSampling::multivariateNormalSample(                                                \
         const CVectorNx1<double, N>& mean, const CSymmetricMatrixNxN<double, N>& covariance, \
         std::size_t n, std::vector<CVectorNx1<double, N>>& samples) {                        \
-        core::CScopedFastLock scopedLock(ms_Lock);                                           \
-        doMultivariateNormalSample(ms_Rng, mean, covariance, n, samples);                    \
+        CContext& context_ = context();                                                      \
+        core::CScopedFastLock scopedLock(context_.m_Lock);                                   \
+        doMultivariateNormalSample(context_.m_Rng, mean, covariance, n, samples);            \
     }                                                                                        \
     void CSampling::multivariateNormalSample(                                                \
         CPRNG::CXorOShiro128Plus& rng, const CVectorNx1<double, N>& mean,                    \
@@ -566,8 +592,9 @@ MULTIVARIATE_NORMAL_SAMPLE(5)
 #undef MULTIVARIATE_NORMAL_SAMPLE
 
 std::size_t CSampling::categoricalSample(TDoubleVec& probabilities) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    return doCategoricalSample(ms_Rng, probabilities);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    return doCategoricalSample(context_.m_Rng, probabilities);
 }
 
 std::size_t CSampling::categoricalSample(CPRNG::CXorOShiro128Plus& rng,
@@ -583,8 +610,9 @@ std::size_t CSampling::categoricalSample(CPRNG::CXorShift1024Mult& rng,
 void CSampling::categoricalSampleWithReplacement(TDoubleVec& probabilities,
                                                  std::size_t n,
                                                  TSizeVec& result) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    doCategoricalSampleWithReplacement(ms_Rng, probabilities, n, result);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    doCategoricalSampleWithReplacement(context_.m_Rng, probabilities, n, result);
 }
 
 void CSampling::categoricalSampleWithReplacement(CPRNG::CXorOShiro128Plus& rng,
@@ -604,8 +632,9 @@ void CSampling::categoricalSampleWithReplacement(CPRNG::CXorShift1024Mult& rng,
 void CSampling::categoricalSampleWithoutReplacement(TDoubleVec& probabilities,
                                                     std::size_t n,
                                                     TSizeVec& result) {
-    core::CScopedFastLock scopedLock(ms_Lock);
-    doCategoricalSampleWithoutReplacement(ms_Rng, probabilities, n, result);
+    CContext& context_ = context();
+    core::CScopedFastLock scopedLock(context_.m_Lock);
+    doCategoricalSampleWithoutReplacement(context_.m_Rng, probabilities, n, result);
 }
 
 void CSampling::categoricalSampleWithoutReplacement(CPRNG::CXorOShiro128Plus& rng,
@@ -666,11 +695,12 @@ void CSampling::multinomialSampleFast(TDoubleVec& probabilities,
         std::size_t r = n;
         double p = 1.0;
         std::size_t m = probabilities.size() - 1;
-        core::CScopedFastLock scopedLock(ms_Lock);
+        CContext& context_ = context();
+        core::CScopedFastLock scopedLock(context_.m_Lock);
         for (std::size_t i = 0u; r > 0 && i < m; ++i) {
             boost::random::binomial_distribution<> binomial(static_cast<int>(r),
                                                             probabilities[i] / p);
-            std::size_t ni = static_cast<std::size_t>(binomial(ms_Rng));
+            std::size_t ni = static_cast<std::size_t>(binomial(context_.m_Rng));
             sample.push_back(ni);
             r -= ni;
             p -= probabilities[i];
@@ -832,8 +862,7 @@ void CSampling::gammaSampleQuantiles(double shape, double rate, std::size_t n, T
     }
 }
 
-core::CFastMutex CSampling::ms_Lock;
-CSampling::CRandomNumberGenerator CSampling::ms_Rng;
+CSampling::CContext CSampling::ms_DefaultContext;
 
 void CSampling::CRandomNumberGenerator::mock() {
     m_Mock.reset((min() + max()) / 2);
@@ -848,11 +877,11 @@ void CSampling::CRandomNumberGenerator::seed() {
 }
 
 CSampling::CScopeMockRandomNumberGenerator::CScopeMockRandomNumberGenerator() {
-    CSampling::ms_Rng.mock();
+    CSampling::context().m_Rng.mock();
 }
 
 CSampling::CScopeMockRandomNumberGenerator::~CScopeMockRandomNumberGenerator() {
-    CSampling::ms_Rng.unmock();
+    CSampling::context().m_Rng.unmock();
 }
 }
 }
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -213,7 +214,10 @@ void CSeasonalComponentAdaptiveBucketing::add(core_t::TTime time,
         this->addLargeError(bucket, time);
     }
 
-    if (m_Time->regressionInterval(bucket_.s_FirstUpdate, bucket_.s_LastUpdate) <
+    core_t::TTime firstUpdate{bucket_.s_FirstUpdate};
+    core_t::TTime lastUpdate{bucket_.lastUpdate()};
+
+    if (m_Time->regressionInterval(firstUpdate, lastUpdate) <
         SUFFICIENT_INTERVAL_TO_ESTIMATE_SLOPE) {
         double delta{regression.predict(t)};
         regression.shiftGradient(-gradient(regression));
@@ -221,12 +225,8 @@ void CSeasonalComponentAdaptiveBucketing::add(core_t::TTime time,
         regression.shiftOrdinate(delta);
     }
 
-    bucket_.s_FirstUpdate = bucket_.s_FirstUpdate == UNSET_TIME
-                                ? time
-                                : std::min(bucket_.s_FirstUpdate, time);
-    bucket_.s_LastUpdate = bucket_.s_LastUpdate == UNSET_TIME
-                               ? time
-                               : std::max(bucket_.s_LastUpdate, time);
+    bucket_.updateTimes(firstUpdate == UNSET_TIME ? time : std::min(firstUpdate, time),
+                        lastUpdate == UNSET_TIME ? time : std::max(lastUpdate, time));
 }
 
 const CSeasonalTime& CSeasonalComponentAdaptiveBucketing::time() const {
@@ -419,7 +419,7 @@ void CSeasonalComponentAdaptiveBucketing::refresh(const TFloatVec& oldEndpoints)
             double w{CTools::truncate(interval / (xr - xl), 0.0, 1.0)};
             const SBucket& bucket{m_Buckets[l - 1]};
             buckets.emplace_back(bucket.s_Regression.scaled(w * w), bucket.s_Variance,
-                                 bucket.s_FirstUpdate, bucket.s_LastUpdate);
+                                 bucket.s_FirstUpdate, bucket.lastUpdate());
             newCentres.push_back(
                 CTools::truncate(static_cast<double>(oldCentres[l - 1]), yl, yr));
             newLargeErrorCounts.push_back(w * oldLargeErrorCounts[l - 1]);
@@ -434,7 +434,7 @@ void CSeasonalComponentAdaptiveBucketing::refresh(const TFloatVec& oldEndpoints)
                 w * bucket->s_Regression.count(), bucket->s_Regression.mean(),
                 static_cast<double>(bucket->s_Variance))};
             firstUpdate.add(bucket->s_FirstUpdate);
-            lastUpdate.add(bucket->s_LastUpdate);
+            lastUpdate.add(bucket->lastUpdate());
             TDoubleMeanAccumulator centre{CBasicStatistics::accumulator(
                 w * bucket->s_Regression.count(), static_cast<double>(oldCentres[l - 1]))};
             double largeErrorCount{w * oldLargeErrorCounts[l - 1]};
@@ -446,7 +446,7 @@ void CSeasonalComponentAdaptiveBucketing::refresh(const TFloatVec& oldEndpoints)
                     bucket->s_Regression.count(), bucket->s_Regression.mean(),
                     static_cast<double>(bucket->s_Variance));
                 firstUpdate.add(bucket->s_FirstUpdate);
-                lastUpdate.add(bucket->s_LastUpdate);
+                lastUpdate.add(bucket->lastUpdate());
                 centre += CBasicStatistics::accumulator(
                     bucket->s_Regression.count(), static_cast<double>(oldCentres[l - 1]));
                 largeErrorCount += oldLargeErrorCounts[l - 1];
@@ -462,7 +462,7 @@ void CSeasonalComponentAdaptiveBucketing::refresh(const TFloatVec& oldEndpoints)
                 w * bucket->s_Regression.count(), bucket->s_Regression.mean(),
                 static_cast<double>(bucket->s_Variance));
             firstUpdate.add(bucket->s_FirstUpdate);
-            lastUpdate.add(bucket->s_LastUpdate);
+            lastUpdate.add(bucket->lastUpdate());
             centre += CBasicStatistics::accumulator(
                 w * bucket->s_Regression.count(), static_cast<double>(oldCentres[l - 1]));
             largeErrorCount += w * oldLargeErrorCounts[l - 1];
@@ -533,7 +533,7 @@ double CSeasonalComponentAdaptiveBucketing::predict(std::size_t bucket,
                                                     double offset) const {
     const SBucket& bucket_{m_Buckets[bucket]};
     core_t::TTime firstUpdate{bucket_.s_FirstUpdate};
-    core_t::TTime lastUpdate{bucket_.s_LastUpdate};
+    core_t::TTime lastUpdate{bucket_.lastUpdate()};
     const TRegression& regression{bucket_.s_Regression};
 
     double interval{static_cast<double>(lastUpdate - firstUpdate)};
@@ -589,26 +589,30 @@ double CSeasonalComponentAdaptiveBucketing::observedInterval(core_t::TTime time)
 }
 
 CSeasonalComponentAdaptiveBucketing::SBucket::SBucket()
-    : s_Variance{0.0}, s_FirstUpdate{UNSET_TIME}, s_LastUpdate{UNSET_TIME} {
+    : s_Variance{0.0}, s_LastUpdateOffset{0}, s_FirstUpdate{UNSET_TIME} {
 }
 
 CSeasonalComponentAdaptiveBucketing::SBucket::SBucket(const TRegression& regression,
                                                       double variance,
                                                       core_t::TTime firstUpdate,
                                                       core_t::TTime lastUpdate)
-    : s_Regression{regression}, s_Variance{variance}, s_FirstUpdate{firstUpdate}, s_LastUpdate{lastUpdate} {
+    : s_Regression{regression}, s_Variance{variance} {
+    this->updateTimes(firstUpdate, lastUpdate);
 }
 
 bool CSeasonalComponentAdaptiveBucketing::SBucket::acceptRestoreTraverser(core::CStateRestoreTraverser& traverser) {
+    core_t::TTime firstUpdate{s_FirstUpdate};
+    core_t::TTime lastUpdate{this->lastUpdate()};
     do {
         const std::string& name{traverser.name()};
         RESTORE(REGRESSION_6_3_TAG,
                 traverser.traverseSubLevel(boost::bind(
                     &TRegression::acceptRestoreTraverser, &s_Regression, _1)))
         RESTORE(VARIANCE_6_3_TAG, s_Variance.fromString(traverser.value()))
-        RESTORE_BUILT_IN(FIRST_UPDATE_6_3_TAG, s_FirstUpdate)
-        RESTORE_BUILT_IN(LAST_UPDATE_6_3_TAG, s_LastUpdate)
+        RESTORE_BUILT_IN(FIRST_UPDATE_6_3_TAG, firstUpdate)
+        RESTORE_BUILT_IN(LAST_UPDATE_6_3_TAG, lastUpdate)
     } while (traverser.next());
+    this->updateTimes(firstUpdate, lastUpdate);
     return true;
 }
 
@@ -618,14 +622,27 @@ void CSeasonalComponentAdaptiveBucketing::SBucket::acceptPersistInserter(
                                                          &s_Regression, _1));
     inserter.insertValue(VARIANCE_6_3_TAG, s_Variance.toString());
     inserter.insertValue(FIRST_UPDATE_6_3_TAG, s_FirstUpdate);
-    inserter.insertValue(LAST_UPDATE_6_3_TAG, s_LastUpdate);
+    inserter.insertValue(LAST_UPDATE_6_3_TAG, this->lastUpdate());
+}
+
+core_t::TTime CSeasonalComponentAdaptiveBucketing::SBucket::lastUpdate() const {
+    return s_FirstUpdate + static_cast<core_t::TTime>(s_LastUpdateOffset);
+}
+
+void CSeasonalComponentAdaptiveBucketing::SBucket::updateTimes(core_t::TTime firstUpdate,
+                                                               core_t::TTime lastUpdate) {
+    s_FirstUpdate = firstUpdate;
+    s_LastUpdateOffset = static_cast<std::int32_t>(CTools::truncate(
+        lastUpdate - firstUpdate,
+        static_cast<core_t::TTime>(std::numeric_limits<std::int32_t>::min()),
+        static_cast<core_t::TTime>(std::numeric_limits<std::int32_t>::max())));
 }
 
 uint64_t CSeasonalComponentAdaptiveBucketing::SBucket::checksum(uint64_t seed) const {
     seed = CChecksum::calculate(seed, s_Regression);
     seed = CChecksum::calculate(seed, s_Variance);
     seed = CChecksum::calculate(seed, s_FirstUpdate);
-    return CChecksum::calculate(seed, s_LastUpdate);
+    return CChecksum::calculate(seed, this->lastUpdate());
 }
 }
 }
@@ -7,9 +7,11 @@
 #include <maths/CSignal.h>
 
 #include <core/CLogger.h>
+#include <core/CScopedFastLock.h>
 
 #include <maths/CIntegerTools.h>
 
+#include <boost/make_unique.hpp>
 #include <boost/math/constants/constants.hpp>
 
 #include <algorithm>
@@ -32,40 +34,319 @@ void scale(double scale, TComplexVec& f) {
     }
 }
 
-//! Compute the radix 2 FFT of \p f in-place.
-void radix2fft(TComplexVec& f) {
-    // Perform the appropriate permutation of f(x) by swapping
-    // each i in [0, N] with its bit reversal.
+//! Get the twiddle factor \f$e^{-2\pi i k / n}\f$.
+TComplex twiddle(std::size_t k, std::size_t n) {
+    double t{boost::math::double_constants::two_pi * static_cast<double>(k) /
+             static_cast<double>(n)};
+    return {std::cos(t), -std::sin(t)};
+}
+
+//! Apply the radix 2 butterflies for a block of \p f of length 2 * \p m.
+void butterfly2(const TComplexVec& twiddles, std::size_t stride, std::size_t m, TComplex* f) {
+    for (std::size_t k = 0u, t = 0u; k < m; ++k, t += stride) {
+        TComplex tw{f[k + m] * twiddles[t]};
+        f[k + m] = f[k] - tw;
+        f[k] += tw;
+    }
+}
+
+//! Apply the radix 4 butterflies for a block of \p f of length 4 * \p m.
+void butterfly4(const TComplexVec& twiddles, std::size_t stride, std::size_t m, TComplex* f) {
+    for (std::size_t k = 0u, t = 0u; k < m; ++k, t += stride) {
+        TComplex a0{f[k]};
+        TComplex a1{f[k + m] * twiddles[t]};
+        TComplex a2{f[k + 2 * m] * twiddles[2 * t]};
+        TComplex a3{f[k + 3 * m] * twiddles[3 * t]};
+        TComplex b0{a0 + a2};
+        TComplex b1{a0 - a2};
+        TComplex b2{a1 + a3};
+        TComplex b3{a1 - a3};
+        // Multiplication by -i.
+        b3 = TComplex{b3.imag(), -b3.real()};
+        f[k] = b0 + b2;
+        f[k + m] = b1 + b3;
+        f[k + 2 * m] = b0 - b2;
+        f[k + 3 * m] = b1 - b3;
+    }
+}
 
-    uint64_t bits = CIntegerTools::nextPow2(f.size()) - 1;
-    for (uint64_t i = 0; i < f.size(); ++i) {
-        uint64_t j = CIntegerTools::reverseBits(i) >> (64 - bits);
-        if (j > i) {
-            LOG_TRACE(<< j << " -> " << i);
-            std::swap(f[i], f[j]);
+//! Apply the radix \p p butterflies for a block of \p f of length \p p * \p m.
+void butterfly(const TComplexVec& twiddles,
+               std::size_t stride,
+               std::size_t p,
+               std::size_t m,
+               TComplex* f) {
+    std::size_t n{twiddles.size()};
+    TComplex scratch[CSignal::CFftPlan::MAXIMUM_RADIX];
+    for (std::size_t u = 0u; u < m; ++u) {
+        for (std::size_t q = 0u, k = u; q < p; ++q, k += m) {
+            scratch[q] = f[k];
+        }
+        for (std::size_t q = 0u, k = u; q < p; ++q, k += m) {
+            TComplex sum{scratch[0]};
+            for (std::size_t r = 1u, t = 0u; r < p; ++r) {
+                t += stride * k;
+                t %= n;
+                sum += scratch[r] * twiddles[t];
+            }
+            f[k] = sum;
         }
     }
+}
+}
 
-    // Apply the twiddle factors.
+const std::size_t CSignal::CFftPlan::MAXIMUM_RADIX{7};
+
+CSignal::CFftPlan::CFftPlan(std::size_t n) : m_Size{n} {
+    if (n <= 1) {
+        m_Permutation.assign(n, 0);
+    } else {
+        std::size_t remainder{n};
+        for (std::size_t p : {4, 2, 3, 5, 7}) {
+            for (/**/; remainder % p == 0; remainder /= p) {
+                m_Radixes.push_back(p);
+            }
+        }
 
-    for (std::size_t stride = 1; stride < f.size(); stride <<= 1) {
-        for (std::size_t k = 0u; k < stride; ++k) {
-            double t = boost::math::double_constants::pi *
-                       static_cast<double>(k) / static_cast<double>(stride);
-            TComplex w(std::cos(t), std::sin(t));
-            for (std::size_t start = k; start < f.size(); start += 2 * stride) {
-                TComplex fs = f[start];
-                TComplex tw = w * f[start + stride];
-                f[start] = fs + tw;
-                f[start + stride] = fs - tw;
+        if (remainder == 1) {
+            m_Twiddles.reserve(n);
+            for (std::size_t k = 0u; k < n; ++k) {
+                m_Twiddles.push_back(twiddle(k, n));
+            }
+            m_Permutation.resize(n);
+            this->permutation(0, 0, 1, 0);
+            std::vector<bool> visited(n, false);
+            for (std::size_t i = 0u; i < n; ++i) {
+                if (visited[i] == false && m_Permutation[i] != i) {
+                    m_Cycles.push_back(i);
+                    for (std::size_t j = i; visited[j] == false; j = m_Permutation[j]) {
+                        visited[j] = true;
+                    }
+                }
+            }
+        } else {
+            // We use Bluestein's trick to reformulate as a convolution
+            // which can be computed by padding to a power of 2.
+
+            m_Radixes.clear();
+            std::size_t m{std::size_t{1} << CIntegerTools::nextPow2(2 * n - 1)};
+            m_Convolution = boost::make_unique<CFftPlan>(m);
+
+            m_Chirp.reserve(n);
+            m_Kernel.assign(m, TComplex{0.0, 0.0});
+            for (std::size_t k = 0u; k < n; ++k) {
+                // Reduce k^2 modulo 2n to preserve precision.
+                m_Chirp.push_back(std::conj(twiddle((k * k) % (2 * n), 2 * n)));
             }
+            m_Kernel[0] = m_Chirp[0];
+            for (std::size_t k = 1u; k < n; ++k) {
+                m_Kernel[k] = m_Kernel[m - k] = m_Chirp[k];
+            }
+            m_Convolution->fft(m_Kernel);
         }
     }
 
-    std::reverse(f.begin() + 1, f.end());
+    m_RealTwiddles.reserve(n + 1);
+    for (std::size_t k = 0u; k <= n; ++k) {
+        m_RealTwiddles.push_back(twiddle(k, 2 * n));
+    }
 }
+
+std::size_t CSignal::CFftPlan::size() const {
+    return m_Size;
 }
 
+void CSignal::CFftPlan::fft(TComplexVec& f) const {
+    if (f.size() != m_Size) {
+        LOG_ERROR(<< "Bad length " << f.size() << " for plan of length " << m_Size);
+        return;
+    }
+    if (m_Size <= 1) {
+        return;
+    }
+
+    if (m_Convolution != nullptr) {
+        this->bluestein(f);
+    } else {
+        this->permute(f);
+        this->butterflies(f);
+    }
+}
+
+void CSignal::CFftPlan::ifft(TComplexVec& f) const {
+    conj(f);
+    this->fft(f);
+    conj(f);
+    scale(1.0 / static_cast<double>(f.size()), f);
+}
+
+void CSignal::CFftPlan::fft(const TDoubleVec& x, TComplexVec& f) const {
+    if (x.size() != 2 * m_Size) {
+        LOG_ERROR(<< "Bad length " << x.size() << " for real plan of length " << 2 * m_Size);
+        return;
+    }
+
+    // Transform z(j) = x(2j) + i x(2j+1) then separate the transforms
+    // of the even and odd terms E(k) and O(k) using the symmetries of
+    // the DFT of real sequences, i.e. F(x)(k) = E(k) + w^k O(k).
+
+    std::size_t n{m_Size};
+    f.resize(n + 1);
+    if (n == 0) {
+        f[0] = TComplex{0.0, 0.0};
+        return;
+    }
+    TComplexVec z;
+    z.reserve(n);
+    for (std::size_t j = 0u; j < n; ++j) {
+        z.emplace_back(x[2 * j], x[2 * j + 1]);
+    }
+    this->fft(z);
+
+    for (std::size_t k = 0u; k <= n; ++k) {
+        TComplex zk{z[k == n ? 0 : k]};
+        TComplex znk{std::conj(z[k == 0 ? 0 : n - k])};
+        TComplex even{0.5 * (zk + znk)};
+        TComplex odd{0.5 * (zk - znk)};
+        // Division by i.
+        odd = TComplex{odd.imag(), -odd.real()};
+        f[k] = even + m_RealTwiddles[k] * odd;
+    }
+}
+
+void CSignal::CFftPlan::ifft(const TComplexVec& f, TDoubleVec& x) const {
+    if (f.size() != m_Size + 1) {
+        LOG_ERROR(<< "Bad length " << f.size() << " for real plan of length " << 2 * m_Size);
+        return;
+    }
+
+    // Invert the separation of the even and odd terms in the real fft.
+
+    std::size_t n{m_Size};
+    x.resize(2 * n);
+    if (n == 0) {
+        return;
+    }
+    TComplexVec z;
+    z.reserve(n);
+    for (std::size_t k = 0u; k < n; ++k) {
+        TComplex fnk{std::conj(f[n - k])};
+        TComplex even{0.5 * (f[k] + fnk)};
+        TComplex odd{0.5 * (f[k] - fnk) * std::conj(m_RealTwiddles[k])};
+        // Multiplication by i.
+        z.push_back(even + TComplex{-odd.imag(), odd.real()});
+    }
+    this->ifft(z);
+
+    for (std::size_t j = 0u; j < n; ++j) {
+        x[2 * j] = z[j].real();
+        x[2 * j + 1] = z[j].imag();
+    }
+}
+
+void CSignal::CFftPlan::permutation(std::size_t in,
+                                    std::size_t out,
+                                    std::size_t stride,
+                                    std::size_t level) {
+    // This mirrors the recursion of the decimation in time. The leaves
+    // are the input values which each element of the digit reversed
+    // sequence takes.
+
+    std::size_t p{m_Radixes[level]};
+    if (level + 1 == m_Radixes.size()) {
+        for (std::size_t k = 0u; k < p; ++k, in += stride) {
+            m_Permutation[out + k] = in;
+        }
+    } else {
+        std::size_t m{m_Size / (stride * p)};
+        for (std::size_t k = 0u; k < p; ++k, in += stride, out += m) {
+            this->permutation(in, out, stride * p, level + 1);
+        }
+    }
+}
+
+void CSignal::CFftPlan::permute(TComplexVec& f) const {
+    // Element i of the result is element m_Permutation[i] of the input
+    // so we shift each cycle along by one position.
+
+    for (auto start : m_Cycles) {
+        TComplex first{f[start]};
+        std::size_t i{start};
+        for (std::size_t j = m_Permutation[i]; j != start; i = j, j = m_Permutation[j]) {
+            f[i] = f[j];
+        }
+        f[i] = first;
+    }
+}
+
+void CSignal::CFftPlan::butterflies(TComplexVec& f) const {
+    // The butterflies at each level act on contiguous blocks of length
+    // p * m, where p is the radix at that level, and combine the p DFTs
+    // of length m computed at the previous level.
+
+    std::size_t stride{m_Size};
+    std::size_t m{1};
+    for (std::size_t level = m_Radixes.size(); level > 0; --level) {
+        std::size_t p{m_Radixes[level - 1]};
+        stride /= p;
+        for (std::size_t block = 0u; block < m_Size; block += p * m) {
+            switch (p) {
+            case 2:
+                butterfly2(m_Twiddles, stride, m, &f[block]);
+                break;
+            case 4:
+                butterfly4(m_Twiddles, stride, m, &f[block]);
+                break;
+            default:
+                butterfly(m_Twiddles, stride, p, m, &f[block]);
+                break;
+            }
+        }
+        m *= p;
+    }
+}
+
+void CSignal::CFftPlan::bluestein(TComplexVec& f) const {
+    std::size_t n{m_Size};
+    std::size_t m{m_Convolution->size()};
+
+    TComplexVec a(m, TComplex{0.0, 0.0});
+    for (std::size_t i = 0u; i < n; ++i) {
+        a[i] = f[i] * std::conj(m_Chirp[i]);
+    }
+
+    m_Convolution->fft(a);
+    hadamard(m_Kernel, a);
+    m_Convolution->ifft(a);
+
+    for (std::size_t i = 0u; i < n; ++i) {
+        f[i] = std::conj(m_Chirp[i]) * a[i];
+    }
+}
+
+CSignal::TFftPlanCPtr CSignal::fftPlan(std::size_t n) {
+    core::CScopedFastLock lock(ms_PlansMutex);
+
+    auto i = std::find_if(ms_Plans.begin(), ms_Plans.end(),
+                          [n](const TSizeFftPlanCPtrPr& plan) {
+                              return plan.first == n;
+                          });
+    if (i == ms_Plans.end()) {
+        if (ms_Plans.size() == MAXIMUM_CACHED_PLANS) {
+            ms_Plans.pop_back();
+        }
+        ms_Plans.emplace_back(n, std::make_shared<const CFftPlan>(n));
+        i = ms_Plans.end() - 1;
+    }
+    std::rotate(ms_Plans.begin(), i, i + 1);
+
+    return ms_Plans.front().second;
+}
+
+const std::size_t CSignal::MAXIMUM_CACHED_PLANS{32};
+core::CFastMutex CSignal::ms_PlansMutex;
+CSignal::TSizeFftPlanCPtrPrVec CSignal::ms_Plans;
+
 void CSignal::conj(TComplexVec& f) {
     for (std::size_t i = 0u; i < f.size(); ++i) {
         f[i] = std::conj(f[i]);
@@ -79,56 +360,43 @@ void CSignal::hadamard(const TComplexVec& fx, TComplexVec& fy) {
 }
 
 void CSignal::fft(TComplexVec& f) {
-    std::size_t n = f.size();
-    std::size_t p = CIntegerTools::nextPow2(n);
-    std::size_t m = std::size_t{1} << p;
+    fftPlan(f.size())->fft(f);
+}
 
-    LOG_TRACE(<< "n = " << n << ", m = " << m);
+void CSignal::ifft(TComplexVec& f) {
+    fftPlan(f.size())->ifft(f);
+}
 
-    if ((m >> 1) == n) {
-        radix2fft(f);
+void CSignal::fft(const TDoubleVec& x, TComplexVec& f) {
+    std::size_t n{x.size()};
+    if (n % 2 == 0) {
+        fftPlan(n / 2)->fft(x, f);
     } else {
-        // We use Bluestein's trick to reformulate as a convolution
-        // which can be computed by padding to a power of 2.
-
-        LOG_TRACE(<< "Using Bluestein's trick");
-
-        m = 2 * n - 1;
-        p = CIntegerTools::nextPow2(m);
-        m = std::size_t{1} << p;
-
-        TComplexVec chirp;
-        chirp.reserve(n);
-        TComplexVec a(m, TComplex(0.0));
-        TComplexVec b(m, TComplex(0.0));
-
-        chirp.emplace_back(1.0, 0.0);
-        a[0] = f[0] * chirp[0];
-        b[0] = chirp[0];
-        for (std::size_t i = 1u; i < n; ++i) {
-            double t = boost::math::double_constants::pi *
-                       static_cast<double>(i * i) / static_cast<double>(n);
-            chirp.emplace_back(std::cos(t), std::sin(t));
-            a[i] = f[i] * std::conj(chirp[i]);
-            b[i] = b[m - i] = chirp[i];
-        }
-
-        fft(a);
-        fft(b);
-        hadamard(a, b);
-        ifft(b);
-
-        for (std::size_t i = 0u; i < n; ++i) {
-            f[i] = std::conj(chirp[i]) * b[i];
-        }
+        f.assign(x.begin(), x.end());
+        fft(f);
+        f.resize(n / 2 + 1);
     }
 }
 
-void CSignal::ifft(TComplexVec& f) {
-    conj(f);
-    fft(f);
-    conj(f);
-    scale(1.0 / static_cast<double>(f.size()), f);
+void CSignal::ifft(const TComplexVec& f, std::size_t n, TDoubleVec& x) {
+    if (f.size() != n / 2 + 1) {
+        LOG_ERROR(<< "Bad length " << f.size() << " for real sequence of length " << n);
+        return;
+    }
+    if (n % 2 == 0) {
+        fftPlan(n / 2)->ifft(f, x);
+    } else {
+        TComplexVec g(f);
+        g.resize(n);
+        for (std::size_t k = n / 2 + 1; k < n; ++k) {
+            g[k] = std::conj(f[n - k]);
+        }
+        ifft(g);
+        x.resize(n);
+        for (std::size_t j = 0u; j < n; ++j) {
+            x[j] = g[j].real();
+        }
+    }
 }
 
 double CSignal::autocorrelation(std::size_t offset, const TFloatMeanAccumulatorVec& values) {
@@ -182,7 +450,7 @@ void CSignal::autocorrelations(const TFloatMeanAccumulatorVec& values, TDoubleVe
     double mean = CBasicStatistics::mean(moments);
     double variance = CBasicStatistics::maximumLikelihoodVariance(moments);
 
-    TComplexVec f;
+    TDoubleVec f;
     f.reserve(n);
     for (std::size_t i = 0u; i < n; ++i) {
         std::size_t j = i;
@@ -191,32 +459,36 @@ void CSignal::autocorrelations(const TFloatMeanAccumulatorVec& values, TDoubleVe
         if (i != j) {
             // Infer missing values by linearly interpolating.
             if (j == n) {
-                f.resize(n, TComplex(0.0, 0.0));
+                f.resize(n, 0.0);
                 break;
             } else if (i == 0) {
-                f.resize(j - 1, TComplex(0.0, 0.0));
+                f.resize(j - 1, 0.0);
             } else {
                 for (std::size_t k = i; k < j; ++k) {
                     double alpha = static_cast<double>(k - i + 1) /
                                    static_cast<double>(j - i + 1);
                     double real = CBasicStatistics::mean(values[j]) - mean;
-                    f.push_back((1.0 - alpha) * f[i - 1] + alpha * TComplex(real, 0.0));
+                    f.push_back((1.0 - alpha) * f[i - 1] + alpha * real);
                 }
             }
             i = j;
         }
-        f.emplace_back(CBasicStatistics::mean(values[i]) - mean, 0.0);
+        f.push_back(CBasicStatistics::mean(values[i]) - mean);
     }
 
-    fft(f);
-    TComplexVec fConj(f);
-    conj(fConj);
-    hadamard(fConj, f);
-    ifft(f);
+    // The values are real so we can use the real transform. Also, the
+    // power spectrum is real and symmetric so we can invert it with the
+    // real transform.
+    TComplexVec F;
+    fft(f, F);
+    for (auto& Fk : F) {
+        Fk = std::norm(Fk);
+    }
+    ifft(F, f.size(), f);
 
     result.reserve(n);
     for (std::size_t i = 1u; i < n; ++i) {
-        result.push_back(f[i].real() / variance / static_cast<double>(n));
+        result.push_back(f[i] / variance / static_cast<double>(n));
     }
 }
 }
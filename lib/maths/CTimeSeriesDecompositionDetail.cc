@@ -24,6 +24,7 @@
 #include <maths/CIntegerTools.h>
 #include <maths/CLinearAlgebra.h>
 #include <maths/CLinearAlgebraPersist.h>
+#include <maths/CMaintenanceScheduler.h>
 #include <maths/CPeriodicityHypothesisTests.h>
 #include <maths/CRegressionDetail.h>
 #include <maths/CSampling.h>
@@ -101,9 +102,13 @@ double meanOf(MEAN_FUNCTION mean, const TSeasonalComponentVec& components) {
 
     using TMeanAccumulator = CBasicStatistics::SSampleMean<double>::TAccumulator;
 
-    double unwindowed{0.0};
-    TTimeTimePrDoubleFMap windows;
+    // This is called for every value so we reuse the calling thread's
+    // map to avoid allocating.
+    thread_local TTimeTimePrDoubleFMap windows;
+    windows.clear();
     windows.reserve(components.size());
+
+    double unwindowed{0.0};
     for (const auto& component : components) {
         if (component.initialized()) {
             TTimeTimePr window{component.time().window()};
@@ -153,8 +158,11 @@ void decompose(double trend,
     std::size_t m{seasonal.size()};
     std::size_t n{calendar.size()};
 
+    // The predictions are computed last so we can store the component
+    // values in them rather than allocating a collection.
+    TDoubleVec& x{predictions};
+
     double x0{trend};
-    TDoubleVec x(m + n);
     double xhat{x0};
     for (std::size_t i = 0u; i < m; ++i) {
         x[i] = CBasicStatistics::mean(seasonal[i]->value(time, 0.0));
@@ -182,12 +190,12 @@ void decompose(double trend,
     referenceError = decomposition[0] - x0;
     decomposition[0] = x0 + (decomposition[0] - xhat) / Z;
     for (std::size_t i = 0u; i < m; ++i) {
-        predictions[i] = x[i] - seasonal[i]->meanValue();
         decomposition[i + 1] = x[i] + (decomposition[i + 1] - xhat) / Z + deltas[i];
+        predictions[i] = x[i] - seasonal[i]->meanValue();
     }
     for (std::size_t i = m; i < m + n; ++i) {
-        predictions[i] = x[i] - calendar[i - m]->meanValue();
         decomposition[i + 1] = x[i] + (decomposition[i + 1] - xhat) / Z;
+        predictions[i] = x[i] - calendar[i - m]->meanValue();
     }
 
     // Because we add in more than the prediction error across the
@@ -276,6 +284,10 @@ const std::string VERSION_6_4_TAG("6.4");
 const std::string PERIODICITY_TEST_MACHINE_6_3_TAG{"a"};
 const std::string SHORT_WINDOW_6_3_TAG{"b"};
 const std::string LONG_WINDOW_6_3_TAG{"c"};
+const std::string SHORT_SCHEDULED_TEST_6_3_TAG{"d"};
+const std::string LONG_SCHEDULED_TEST_6_3_TAG{"e"};
+const std::string SHORT_LAST_DUE_BUCKET_6_3_TAG{"f"};
+const std::string LONG_LAST_DUE_BUCKET_6_3_TAG{"g"};
 // Old versions can't be restored.
 
 // Calendar Cyclic Test Tags
@@ -283,6 +295,7 @@ const std::string LONG_WINDOW_6_3_TAG{"c"};
 const std::string CALENDAR_TEST_MACHINE_6_3_TAG{"a"};
 const std::string LAST_MONTH_6_3_TAG{"b"};
 const std::string CALENDAR_TEST_6_3_TAG{"c"};
+const std::string SCHEDULED_TEST_6_3_TAG{"d"};
 // These work for all versions.
 
 // Components Tags
@@ -480,13 +493,18 @@ CTimeSeriesDecompositionDetail::CPeriodicityTest::CPeriodicityTest(double decayR
           PT_STATES,
           PT_TRANSITION_FUNCTION,
           bucketLength > LONG_BUCKET_LENGTHS.back() ? PT_NOT_TESTING : PT_INITIAL)},
-      m_DecayRate{decayRate}, m_BucketLength{bucketLength} {
+      m_DecayRate{decayRate}, m_BucketLength{bucketLength},
+      m_ScheduledTests{{CMaintenanceScheduler::NOT_SCHEDULED,
+                        CMaintenanceScheduler::NOT_SCHEDULED}},
+      m_LastDueBuckets{{CMaintenanceScheduler::NOT_SCHEDULED,
+                        CMaintenanceScheduler::NOT_SCHEDULED}} {
 }
 
 CTimeSeriesDecompositionDetail::CPeriodicityTest::CPeriodicityTest(const CPeriodicityTest& other,
                                                                    bool isForForecast)
     : CHandler(), m_Machine{other.m_Machine}, m_DecayRate{other.m_DecayRate},
-      m_BucketLength{other.m_BucketLength} {
+      m_BucketLength{other.m_BucketLength}, m_ScheduledTests(other.m_ScheduledTests),
+      m_LastDueBuckets(other.m_LastDueBuckets) {
     // Note that m_Windows is an array.
     for (std::size_t i = 0u; !isForForecast && i < other.m_Windows.size(); ++i) {
         if (other.m_Windows[i] != nullptr) {
@@ -515,6 +533,10 @@ bool CTimeSeriesDecompositionDetail::CPeriodicityTest::acceptRestoreTraverser(
                 traverser.traverseSubLevel(boost::bind(&CExpandingWindow::acceptRestoreTraverser,
                                                        m_Windows[E_Long].get(), _1)),
             /**/)
+        RESTORE_BUILT_IN(SHORT_SCHEDULED_TEST_6_3_TAG, m_ScheduledTests[E_Short])
+        RESTORE_BUILT_IN(LONG_SCHEDULED_TEST_6_3_TAG, m_ScheduledTests[E_Long])
+        RESTORE_BUILT_IN(SHORT_LAST_DUE_BUCKET_6_3_TAG, m_LastDueBuckets[E_Short])
+        RESTORE_BUILT_IN(LONG_LAST_DUE_BUCKET_6_3_TAG, m_LastDueBuckets[E_Long])
     } while (traverser.next());
     return true;
 }
@@ -534,6 +556,10 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::acceptPersistInserter(
                              boost::bind(&CExpandingWindow::acceptPersistInserter,
                                          m_Windows[E_Long].get(), _1));
     }
+    inserter.insertValue(SHORT_SCHEDULED_TEST_6_3_TAG, m_ScheduledTests[E_Short]);
+    inserter.insertValue(LONG_SCHEDULED_TEST_6_3_TAG, m_ScheduledTests[E_Long]);
+    inserter.insertValue(SHORT_LAST_DUE_BUCKET_6_3_TAG, m_LastDueBuckets[E_Short]);
+    inserter.insertValue(LONG_LAST_DUE_BUCKET_6_3_TAG, m_LastDueBuckets[E_Long]);
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::swap(CPeriodicityTest& other) {
@@ -542,6 +568,8 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::swap(CPeriodicityTest& ot
     std::swap(m_BucketLength, other.m_BucketLength);
     m_Windows[E_Short].swap(other.m_Windows[E_Short]);
     m_Windows[E_Long].swap(other.m_Windows[E_Long]);
+    std::swap(m_ScheduledTests, other.m_ScheduledTests);
+    std::swap(m_LastDueBuckets, other.m_LastDueBuckets);
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::handle(const SAddValue& message) {
@@ -618,6 +646,11 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::shiftTime(core_t::TTime d
             window->shiftTime(dt);
         }
     }
+    for (auto& time : m_ScheduledTests) {
+        if (time != CMaintenanceScheduler::NOT_SCHEDULED) {
+            time += dt;
+        }
+    }
 }
 
 void CTimeSeriesDecompositionDetail::CPeriodicityTest::propagateForwards(core_t::TTime start,
@@ -630,6 +663,8 @@ uint64_t CTimeSeriesDecompositionDetail::CPeriodicityTest::checksum(uint64_t see
     seed = CChecksum::calculate(seed, m_Machine);
     seed = CChecksum::calculate(seed, m_DecayRate);
     seed = CChecksum::calculate(seed, m_BucketLength);
+    seed = CChecksum::calculate(seed, m_ScheduledTests);
+    seed = CChecksum::calculate(seed, m_LastDueBuckets);
     return CChecksum::calculate(seed, m_Windows);
 }
 
@@ -674,6 +709,7 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::apply(std::size_t symbol,
                   << PT_STATES[state]);
 
         auto initialize = [this](core_t::TTime time_) {
+            m_ScheduledTests.fill(CMaintenanceScheduler::NOT_SCHEDULED);
             for (auto i : {E_Short, E_Long}) {
                 m_Windows[i].reset(this->newWindow(i));
                 if (m_Windows[i] != nullptr) {
@@ -708,6 +744,7 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::apply(std::size_t symbol,
         case PT_NOT_TESTING:
             m_Windows[0].reset();
             m_Windows[1].reset();
+            m_ScheduledTests.fill(CMaintenanceScheduler::NOT_SCHEDULED);
             break;
         default:
             LOG_ERROR(<< "Test in a bad state: " << state);
@@ -718,11 +755,17 @@ void CTimeSeriesDecompositionDetail::CPeriodicityTest::apply(std::size_t symbol,
 }
 
 bool CTimeSeriesDecompositionDetail::CPeriodicityTest::shouldTest(ETest test,
-                                                                  core_t::TTime time) const {
+                                                                  core_t::TTime time) {
     // We need to test more frequently than we compress because it
     // only happens each 336 buckets and would significantly delay
     // when we first detect short periodic components for longer
     // bucket lengths otherwise.
+    //
+    // These extra tests happen at the same time for every series
+    // with the same start time so we hand them to the maintenance
+    // scheduler which staggers them over a number of buckets. The
+    // test we are forced to run when the window compresses subsumes
+    // any test which is still outstanding.
     auto scheduledTest = [&]() {
         if (test != E_Long || m_Windows[E_Short] == nullptr) {
             core_t::TTime length{time - m_Windows[test]->startTime()};
@@ -734,8 +777,29 @@ bool CTimeSeriesDecompositionDetail::CPeriodicityTest::shouldTest(ETest test,
         }
         return false;
     };
-    return m_Windows[test] != nullptr &&
-           (m_Windows[test]->needToCompress(time) || scheduledTest());
+    if (m_Windows[test] == nullptr) {
+        return false;
+    }
+    if (m_Windows[test]->needToCompress(time)) {
+        m_ScheduledTests[test] = CMaintenanceScheduler::NOT_SCHEDULED;
+        return true;
+    }
+    if (scheduledTest()) {
+        // This holds for every value added in the bucket, of which there
+        // can be many for population models, but it is one task for the
+        // scheduler. If the test has already run in this bucket we repeat
+        // it for each new value as we always have.
+        core_t::TTime bucket{
+            CIntegerTools::floor(time, std::max(m_BucketLength, core_t::TTime{1}))};
+        if (bucket != m_LastDueBuckets[test]) {
+            m_LastDueBuckets[test] = bucket;
+            m_ScheduledTests[test] = CMaintenanceScheduler::schedule(
+                time, m_BucketLength, m_Windows[test]->checksum());
+        } else if (m_ScheduledTests[test] == CMaintenanceScheduler::NOT_SCHEDULED) {
+            return true;
+        }
+    }
+    return CMaintenanceScheduler::run(m_ScheduledTests[test], time, m_BucketLength);
 }
 
 CExpandingWindow*
@@ -778,13 +842,15 @@ CTimeSeriesDecompositionDetail::CCalendarTest::CCalendarTest(double decayRate,
                                             CC_STATES,
                                             CC_TRANSITION_FUNCTION,
                                             bucketLength > DAY ? CC_NOT_TESTING : CC_INITIAL)},
-      m_DecayRate{decayRate}, m_LastMonth{} {
+      m_DecayRate{decayRate}, m_BucketLength{bucketLength}, m_LastMonth{},
+      m_ScheduledTest{CMaintenanceScheduler::NOT_SCHEDULED} {
 }
 
 CTimeSeriesDecompositionDetail::CCalendarTest::CCalendarTest(const CCalendarTest& other,
                                                              bool isForForecast)
     : CHandler(), m_Machine{other.m_Machine}, m_DecayRate{other.m_DecayRate},
-      m_LastMonth{other.m_LastMonth}, m_Test{!isForForecast && other.m_Test
+      m_BucketLength{other.m_BucketLength}, m_LastMonth{other.m_LastMonth},
+      m_ScheduledTest{other.m_ScheduledTest}, m_Test{!isForForecast && other.m_Test
                                                  ? boost::make_unique<CCalendarCyclicTest>(
                                                        *other.m_Test)
                                                  : nullptr} {
@@ -804,6 +870,7 @@ bool CTimeSeriesDecompositionDetail::CCalendarTest::acceptRestoreTraverser(core:
             traverser.traverseSubLevel(boost::bind(
                 &CCalendarCyclicTest::acceptRestoreTraverser, m_Test.get(), _1)),
             /**/)
+        RESTORE_BUILT_IN(SCHEDULED_TEST_6_3_TAG, m_ScheduledTest)
     } while (traverser.next());
     return true;
 }
@@ -814,6 +881,7 @@ void CTimeSeriesDecompositionDetail::CCalendarTest::acceptPersistInserter(
         CALENDAR_TEST_MACHINE_6_3_TAG,
         boost::bind(&core::CStateMachine::acceptPersistInserter, &m_Machine, _1));
     inserter.insertValue(LAST_MONTH_6_3_TAG, m_LastMonth);
+    inserter.insertValue(SCHEDULED_TEST_6_3_TAG, m_ScheduledTest);
     if (m_Test) {
         inserter.insertLevel(CALENDAR_TEST_6_3_TAG,
                              boost::bind(&CCalendarCyclicTest::acceptPersistInserter,
@@ -824,7 +892,9 @@ void CTimeSeriesDecompositionDetail::CCalendarTest::acceptPersistInserter(
 void CTimeSeriesDecompositionDetail::CCalendarTest::swap(CCalendarTest& other) {
     std::swap(m_Machine, other.m_Machine);
     std::swap(m_DecayRate, other.m_DecayRate);
+    std::swap(m_BucketLength, other.m_BucketLength);
     std::swap(m_LastMonth, other.m_LastMonth);
+    std::swap(m_ScheduledTest, other.m_ScheduledTest);
     m_Test.swap(other.m_Test);
 }
 
@@ -898,6 +968,7 @@ uint64_t CTimeSeriesDecompositionDetail::CCalendarTest::checksum(uint64_t seed)
     seed = CChecksum::calculate(seed, m_Machine);
     seed = CChecksum::calculate(seed, m_DecayRate);
     seed = CChecksum::calculate(seed, m_LastMonth);
+    seed = CChecksum::calculate(seed, m_ScheduledTest);
     return CChecksum::calculate(seed, m_Test);
 }
 
@@ -947,6 +1018,7 @@ void CTimeSeriesDecompositionDetail::CCalendarTest::apply(std::size_t symbol,
         case CC_INITIAL:
             m_Test.reset();
             m_LastMonth = int{};
+            m_ScheduledTest = CMaintenanceScheduler::NOT_SCHEDULED;
             break;
         default:
             LOG_ERROR(<< "Test in a bad state: " << state);
@@ -957,12 +1029,17 @@ void CTimeSeriesDecompositionDetail::CCalendarTest::apply(std::size_t symbol,
 }
 
 bool CTimeSeriesDecompositionDetail::CCalendarTest::shouldTest(core_t::TTime time) {
+    // Every series tests at the start of the month so we stagger the
+    // tests using the maintenance scheduler.
     int month{this->month(time)};
     if (month == (m_LastMonth + 1) % 12) {
         m_LastMonth = month;
-        return true;
+        if (m_Test != nullptr) {
+            m_ScheduledTest = CMaintenanceScheduler::schedule(time, m_BucketLength,
+                                                              m_Test->checksum());
+        }
     }
-    return false;
+    return CMaintenanceScheduler::run(m_ScheduledTest, time, m_BucketLength);
 }
 
 int CTimeSeriesDecompositionDetail::CCalendarTest::month(core_t::TTime time) const {
@@ -1124,11 +1201,21 @@ void CTimeSeriesDecompositionDetail::CComponents::handle(const SAddValue& messag
         double trend{message.s_Trend};
         const maths_t::TDoubleWeightsAry& weights{message.s_Weights};
 
-        TSeasonalComponentPtrVec seasonalComponents;
-        TCalendarComponentPtrVec calendarComponents;
-        TComponentErrorsPtrVec seasonalErrors;
-        TComponentErrorsPtrVec calendarErrors;
-        TDoubleVec deltas;
+        // This is called for every value added to every time series so
+        // we reuse the calling thread's collections to avoid allocating.
+        thread_local TSeasonalComponentPtrVec seasonalComponents;
+        thread_local TCalendarComponentPtrVec calendarComponents;
+        thread_local TComponentErrorsPtrVec seasonalErrors;
+        thread_local TComponentErrorsPtrVec calendarErrors;
+        thread_local TDoubleVec deltas;
+        thread_local TDoubleVec values;
+        thread_local TDoubleVec predictions;
+        thread_local TDoubleVec variances;
+        seasonalComponents.clear();
+        calendarComponents.clear();
+        seasonalErrors.clear();
+        calendarErrors.clear();
+        deltas.clear();
 
         if (m_Seasonal) {
             m_Seasonal->componentsErrorsAndDeltas(time, seasonalComponents,
@@ -1142,8 +1229,8 @@ void CTimeSeriesDecompositionDetail::CComponents::handle(const SAddValue& messag
         std::size_t m{seasonalComponents.size()};
         std::size_t n{calendarComponents.size()};
 
-        TDoubleVec values(m + n + 1, value);
-        TDoubleVec predictions(m + n, 0.0);
+        values.assign(m + n + 1, value);
+        predictions.assign(m + n, 0.0);
         double referenceError;
         double error;
         double scale;
@@ -1151,7 +1238,7 @@ void CTimeSeriesDecompositionDetail::CComponents::handle(const SAddValue& messag
                   m_GainController.gain(), values, predictions, referenceError,
                   error, scale);
 
-        TDoubleVec variances(m + n + 1, 0.0);
+        variances.assign(m + n + 1, 0.0);
         if (m_UsingTrendForPrediction) {
             variances[0] = CBasicStatistics::mean(m_Trend.variance(0.0));
         }
@@ -1744,10 +1831,14 @@ void CTimeSeriesDecompositionDetail::CComponents::canonicalize(core_t::TTime tim
     if (m_Seasonal) {
         TSeasonalComponentVec& seasonal{m_Seasonal->components()};
 
-        double slope{0.0};
-        TTimeTimePrDoubleFMap windowSlopes;
+        // This is called for every value so we reuse the calling thread's
+        // map to avoid allocating.
+        thread_local TTimeTimePrDoubleFMap windowSlopes;
+        windowSlopes.clear();
         windowSlopes.reserve(seasonal.size());
 
+        double slope{0.0};
+
         for (auto& component : seasonal) {
             if (component.slopeAccurate(time)) {
                 double si{component.slope()};
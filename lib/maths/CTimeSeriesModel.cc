@@ -100,6 +100,52 @@ TOptionalSize randomlySample(CPRNG::CXorOShiro128Plus& rng,
     return {};
 }
 
+//! Fill in \p order with the indices of \p samples in increasing order
+//! of value.
+//!
+//! \note Ties are broken by index so this is equivalent to a stable sort,
+//! which we avoid because std::stable_sort allocates a buffer.
+void orderByValue(const CModel::TTimeDouble2VecSizeTrVec& samples, TSizeVec& order) {
+    order.resize(samples.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&samples](std::size_t lhs, std::size_t rhs) {
+        return COrderings::lexicographical_compare(samples[lhs].second, lhs,
+                                                   samples[rhs].second, rhs);
+    });
+}
+
+//! \brief Scratch space for updating univariate time series models.
+//!
+//! DESCRIPTION:\n
+//! A job can have millions of models and adding samples to each one
+//! needs a handful of small temporary collections. These are shared by
+//! all the models updated on a thread so, once their capacities have
+//! grown to fit the largest update, adding samples doesn't allocate.
+//!
+//! \warning Each collection must only be used by one function at a time.
+struct SUnivariateWorkspace {
+    using TDouble1VecVec = std::vector<TDouble1Vec>;
+
+    //! The samples' detrended values.
+    CModel::TTimeDouble2VecSizeTrVec s_Samples;
+    //! The samples' indices in increasing order of value.
+    TSizeVec s_ValueOrder;
+    //! The samples' indices in increasing order of time.
+    TSizeVec s_TimeOrder;
+    //! The residual model's samples.
+    TDouble1Vec s_Residuals;
+    //! The residual model's sample weights.
+    maths_t::TDoubleWeightsAry1Vec s_Weights;
+    //! The prediction errors for the decay rate controllers.
+    TDouble1VecVec s_Errors[2];
+};
+
+//! Get the calling thread's univariate model workspace.
+SUnivariateWorkspace& univariateWorkspace() {
+    thread_local SUnivariateWorkspace workspace;
+    return workspace;
+}
+
 //! Convert \p value to comma separated string.
 std::string toDelimited(const TTimeDoublePr& value) {
     return core::CStringUtils::typeToString(value.first) + ',' +
@@ -306,7 +352,13 @@ public:
     //! Extends the current anomaly if \p probability is small; otherwise,
     //! it closes it. If the time series is currently anomalous, update the
     //! model with the anomaly feature vector.
-    void sample(core_t::TTime time, double error, double bucketProbability, double overallProbability);
+    //!
+    //! \return True if an anomaly was started or extended. Sampling again
+    //! with the same values would then update the model again.
+    bool sample(core_t::TTime time,
+                double error,
+                double bucketProbability,
+                double overallProbability);
 
     //! Reset the mean error norm.
     void reset();
@@ -456,7 +508,7 @@ CTimeSeriesAnomalyModel::CTimeSeriesAnomalyModel(core_t::TTime bucketLength, dou
         maths_t::E_ContinuousData, LARGEST_SIGNIFICANT_PROBABILITY * decayRate));
 }
 
-void CTimeSeriesAnomalyModel::sample(core_t::TTime time,
+bool CTimeSeriesAnomalyModel::sample(core_t::TTime time,
                                      double predictionError,
                                      double bucketProbability,
                                      double overallProbability) {
@@ -469,10 +521,13 @@ void CTimeSeriesAnomalyModel::sample(core_t::TTime time,
             m_Anomaly->update(predictionError);
             this->sample(time, m_Anomaly->weight(this->scale(time)));
         }
-    } else if (m_Anomaly != boost::none) {
+        return true;
+    }
+    if (m_Anomaly != boost::none) {
         this->sample(time, 1.0 - m_Anomaly->weight(this->scale(time)));
         m_Anomaly.reset();
     }
+    return false;
 }
 
 void CTimeSeriesAnomalyModel::sample(core_t::TTime time, double weight) {
@@ -707,19 +762,18 @@ void CUnivariateTimeSeriesModel::addBucketValue(const TTimeDouble2VecSizeTrVec&
 
 CUnivariateTimeSeriesModel::EUpdateResult
 CUnivariateTimeSeriesModel::addSamples(const CModelAddSamplesParams& params,
-                                       TTimeDouble2VecSizeTrVec samples) {
-    if (samples.empty()) {
+                                       const TTimeDouble2VecSizeTrVec& values) {
+    if (values.empty()) {
         return E_Success;
     }
 
     using TOptionalTimeDoublePr = boost::optional<TTimeDoublePr>;
 
-    TSizeVec valueorder(samples.size());
-    std::iota(valueorder.begin(), valueorder.end(), 0);
-    std::stable_sort(valueorder.begin(), valueorder.end(),
-                     [&samples](std::size_t lhs, std::size_t rhs) {
-                         return samples[lhs].second < samples[rhs].second;
-                     });
+    SUnivariateWorkspace& workspace{univariateWorkspace()};
+    TTimeDouble2VecSizeTrVec& samples{workspace.s_Samples};
+    TSizeVec& valueorder{workspace.s_ValueOrder};
+    samples.assign(values.begin(), values.end());
+    orderByValue(samples, valueorder);
 
     // Maybe remember one of the samples to update the recent samples.
     TOptionalTimeDoublePr randomSample;
@@ -748,16 +802,13 @@ CUnivariateTimeSeriesModel::addSamples(const CModelAddSamplesParams& params,
 
     // Removing the trend can change the order of values due to the time
     // differences so we need to re-sort here.
-    std::stable_sort(valueorder.begin(), valueorder.end(),
-                     [&samples](std::size_t lhs, std::size_t rhs) {
-                         return samples[lhs].second < samples[rhs].second;
-                     });
+    orderByValue(samples, valueorder);
 
     // Compute the current bucket residual samples.
-    TDouble1Vec samples_;
-    maths_t::TDoubleWeightsAry1Vec weights_;
-    samples_.reserve(samples.size());
-    weights_.reserve(samples.size());
+    TDouble1Vec& samples_{workspace.s_Residuals};
+    maths_t::TDoubleWeightsAry1Vec& weights_{workspace.s_Weights};
+    samples_.clear();
+    weights_.clear();
     TMeanAccumulator averageTime_;
     for (auto i : valueorder) {
         core_t::TTime time{samples[i].first};
@@ -1010,6 +1061,68 @@ bool CUnivariateTimeSeriesModel::probability(const CModelProbabilityParams& para
                : this->correlatedProbability(params, time, value, result);
 }
 
+void CUnivariateTimeSeriesModel::probabilities(const CModelProbabilityParams& params,
+                                               const TTime2Vec1Vec& time_,
+                                               const TDouble2Vec1Vec& values,
+                                               const TDouble2VecWeightsAry1Vec& weights,
+                                               const TBool2Vec1Vec& bucketEmpty,
+                                               TModelProbabilityResultVec& results,
+                                               TBoolVec& successes) const {
+    // We only batch the residual model probabilities. The multi-bucket
+    // feature probability is corrected using each value and its bucket
+    // empty status, and sampling the anomaly model with each value's
+    // probability changes its state for the values which follow. So if
+    // either is used we compute the probability of each value in turn.
+    if ((m_MultibucketFeatureModel != nullptr && params.useMultibucketFeatures()) ||
+        (m_AnomalyModel != nullptr && params.useAnomalyModel()) ||
+        std::any_of(values.begin(), values.end(),
+                    [](const TDouble2Vec& value) { return value.size() != 1; })) {
+        this->CModel::probabilities(params, time_, values, weights, bucketEmpty,
+                                    results, successes);
+        return;
+    }
+
+    results.assign(values.size(), SModelProbabilityResult{});
+    successes.assign(values.size(), false);
+
+    maths_t::EProbabilityCalculation calculation{params.calculation(0)};
+    core_t::TTime time{time_[0][0]};
+
+    // This is equivalent to calling detrend for each value, but we only
+    // need to compute the trend prediction once.
+    TDoubleDoublePr interval{0.0, 0.0};
+    if (m_TrendModel->initialized()) {
+        interval = m_TrendModel->value(time, params.seasonalConfidenceInterval());
+    }
+
+    // Declared outside the loop to minimize the number of times they are created.
+    TDouble1Vec sample(1);
+    maths_t::TDoubleWeightsAry1Vec weight(1);
+    double pl, pu;
+    maths_t::ETail tail;
+
+    for (std::size_t i = 0u; i < values.size(); ++i) {
+        sample[0] = std::min(values[i][0] - interval.first, 0.0) +
+                    std::max(values[i][0] - interval.second, 0.0);
+        weight[0] = unpack(weights[i]);
+        if (m_ResidualModel->probabilityOfLessLikelySamples(calculation, sample,
+                                                            weight, pl, pu, tail) == false) {
+            LOG_ERROR(<< "Failed to compute P(" << sample << " | weight = " << weight
+                      << ", time = " << time << ")");
+            continue;
+        }
+        LOG_TRACE(<< "P(" << sample << " | weight = " << weight
+                  << ", time = " << time << ") = " << (pl + pu) / 2.0);
+        double probability{correctForEmptyBucket(
+            calculation, values[i], bucketEmpty[i][0],
+            this->params().probabilityBucketEmpty(), (pl + pu) / 2.0)};
+        results[i].s_Probability = probability;
+        results[i].s_FeatureProbabilities.emplace_back(BUCKET_FEATURE_LABEL, probability);
+        results[i].s_Tail = {tail};
+        successes[i] = true;
+    }
+}
+
 bool CUnivariateTimeSeriesModel::uncorrelatedProbability(const CModelProbabilityParams& params,
                                                          const TTime2Vec1Vec& time_,
                                                          const TDouble2Vec1Vec& value,
@@ -1069,11 +1182,13 @@ bool CUnivariateTimeSeriesModel::uncorrelatedProbability(const CModelProbability
 
     double probability{aggregateFeatureProbabilities(probabilities, correlation)};
 
+    bool anomalyModelUpdated{false};
     if (m_AnomalyModel != nullptr && params.useAnomalyModel()) {
         double residual{
             (sample[0] - m_ResidualModel->nearestMarginalLikelihoodMean(sample[0])) /
             std::max(std::sqrt(this->seasonalWeight(0.0, time)[0]), 1.0)};
-        m_AnomalyModel->sample(time, residual, probabilities[0], probability);
+        anomalyModelUpdated =
+            m_AnomalyModel->sample(time, residual, probabilities[0], probability);
         double anomalyProbability;
         std::tie(probability, anomalyProbability) =
             m_AnomalyModel->probability(time, probability);
@@ -1083,6 +1198,7 @@ bool CUnivariateTimeSeriesModel::uncorrelatedProbability(const CModelProbability
 
     result.s_Probability = probability;
     result.s_FeatureProbabilities = std::move(featureProbabilities);
+    result.s_AnomalyModelUpdated = anomalyModelUpdated;
     result.s_Tail = {tail};
 
     return true;
@@ -1199,12 +1315,14 @@ bool CUnivariateTimeSeriesModel::correlatedProbability(const CModelProbabilityPa
     SModelProbabilityResult::TFeatureProbability4Vec featureProbabilities;
     featureProbabilities.emplace_back(BUCKET_FEATURE_LABEL, probability);
 
+    bool anomalyModelUpdated{false};
     if (m_AnomalyModel != nullptr && params.useAnomalyModel()) {
         double residual{
             (mostAnomalousSample - mostAnomalousCorrelationModel->nearestMarginalLikelihoodMean(
                                        mostAnomalousSample)) /
             std::max(std::sqrt(this->seasonalWeight(0.0, mostAnomalousTime)[0]), 1.0)};
-        m_AnomalyModel->sample(mostAnomalousTime, residual, probabilities[0], probability);
+        anomalyModelUpdated = m_AnomalyModel->sample(mostAnomalousTime, residual,
+                                                     probabilities[0], probability);
         double anomalyProbability;
         std::tie(probability, anomalyProbability) =
             m_AnomalyModel->probability(mostAnomalousTime, probability);
@@ -1216,6 +1334,7 @@ bool CUnivariateTimeSeriesModel::correlatedProbability(const CModelProbabilityPa
     result.s_Probability = probability;
     result.s_Conditional = conditional;
     result.s_FeatureProbabilities = std::move(featureProbabilities);
+    result.s_AnomalyModelUpdated = anomalyModelUpdated;
     result.s_Tail = std::move(tail);
     result.s_MostAnomalousCorrelate = std::move(mostAnomalousCorrelate);
 
@@ -1550,14 +1669,16 @@ CUnivariateTimeSeriesModel::updateTrend(const TTimeDouble2VecSizeTrVec& samples,
 
     // Time order is not reliable, for example if the data are polled
     // or for count feature, the times of all samples will be the same.
-    TSizeVec timeorder(samples.size());
+    // Ties are broken by index rather than using a stable sort, which
+    // allocates.
+    TSizeVec& timeorder{univariateWorkspace().s_TimeOrder};
+    timeorder.resize(samples.size());
     std::iota(timeorder.begin(), timeorder.end(), 0);
-    std::stable_sort(timeorder.begin(), timeorder.end(),
-                     [&samples](std::size_t lhs, std::size_t rhs) {
-                         return COrderings::lexicographical_compare(
-                             samples[lhs].first, samples[lhs].second,
-                             samples[rhs].first, samples[rhs].second);
-                     });
+    std::sort(timeorder.begin(), timeorder.end(), [&samples](std::size_t lhs, std::size_t rhs) {
+        return COrderings::lexicographical_compare(samples[lhs].first, samples[lhs].second,
+                                                   lhs, samples[rhs].first,
+                                                   samples[rhs].second, rhs);
+    });
 
     for (auto i : timeorder) {
         core_t::TTime time{samples[i].first};
@@ -1584,9 +1705,9 @@ double CUnivariateTimeSeriesModel::updateDecayRates(const CModelAddSamplesParams
         return multiplier;
     }
 
-    TDouble1VecVec errors[2];
-    errors[0].reserve(samples.size());
-    errors[1].reserve(samples.size());
+    TDouble1VecVec(&errors)[2] = univariateWorkspace().s_Errors;
+    errors[0].clear();
+    errors[1].clear();
     for (auto sample : samples) {
         this->appendPredictionErrors(params.propagationInterval(), sample, errors);
     }
@@ -1681,6 +1802,379 @@ bool CUnivariateTimeSeriesModel::correlationModels(TSize1Vec& correlated,
     return correlated.size() > 0;
 }
 
+const std::size_t CNewbornTimeSeriesModel::MAXIMUM_NUMBER_UPDATES{3};
+const double CNewbornTimeSeriesModel::MAXIMUM_COUNT{3.0};
+const std::size_t CNewbornTimeSeriesModel::MAXIMUM_NUMBER_RECORDED_UPDATES{10};
+
+CNewbornTimeSeriesModel::CNewbornTimeSeriesModel(const TUnivariateTimeSeriesModelCPtr& model,
+                                                 std::size_t id)
+    : CModel(model->params()), m_Id(id), m_Template(model),
+      m_NumberUpdates(0), m_Count(0.0) {
+}
+
+std::size_t CNewbornTimeSeriesModel::identifier() const {
+    return m_Id;
+}
+
+CModel* CNewbornTimeSeriesModel::clone(std::size_t id) const {
+    if (m_Full != nullptr) {
+        return this->full().clone(id);
+    }
+    return new CNewbornTimeSeriesModel{*this, id};
+}
+
+CModel* CNewbornTimeSeriesModel::cloneForPersistence() const {
+    if (m_Full != nullptr) {
+        return this->full().cloneForPersistence();
+    }
+    return new CNewbornTimeSeriesModel{*this, m_Id};
+}
+
+CModel* CNewbornTimeSeriesModel::cloneForForecast() const {
+    if (m_Full != nullptr) {
+        return this->full().cloneForForecast();
+    }
+    TUnivariateTimeSeriesModelPtr full{this->replay()};
+    return full->cloneForForecast();
+}
+
+bool CNewbornTimeSeriesModel::isForecastPossible() const {
+    return m_Full != nullptr && this->full().isForecastPossible();
+}
+
+void CNewbornTimeSeriesModel::modelCorrelations(CTimeSeriesCorrelations& model) {
+    this->full().modelCorrelations(model);
+}
+
+CNewbornTimeSeriesModel::TSize2Vec1Vec CNewbornTimeSeriesModel::correlates() const {
+    return m_Full != nullptr ? this->full().correlates() : TSize2Vec1Vec{};
+}
+
+void CNewbornTimeSeriesModel::addBucketValue(const TTimeDouble2VecSizeTrVec& values) {
+    if (m_Full != nullptr || m_Updates.size() == MAXIMUM_NUMBER_RECORDED_UPDATES) {
+        this->full().addBucketValue(values);
+        return;
+    }
+    m_Updates.emplace_back(SUpdate::E_AddBucketValue);
+    m_Updates.back().s_Values.reserve(values.size());
+    for (const auto& value : values) {
+        m_Updates.back().s_Values.emplace_back(value.first, value.second[0], value.third,
+                                               maths_t::CUnitWeights::UNIT,
+                                               maths_t::CUnitWeights::UNIT);
+    }
+}
+
+CNewbornTimeSeriesModel::EUpdateResult
+CNewbornTimeSeriesModel::addSamples(const CModelAddSamplesParams& params,
+                                    const TTimeDouble2VecSizeTrVec& samples) {
+    if (m_Full != nullptr) {
+        return this->full().addSamples(params, samples);
+    }
+    if (samples.empty()) {
+        return E_Success;
+    }
+
+    // This mirrors the count the gamma residual model adds for the samples.
+    double count{0.0};
+    for (const auto& weight : params.priorWeights()) {
+        TDoubleWeightsAry weight_{CUnivariateTimeSeriesModel::unpack(weight)};
+        count += maths_t::countForUpdate(weight_) /
+                 (maths_t::seasonalVarianceScale(weight_) * maths_t::countVarianceScale(weight_));
+    }
+
+    if (m_NumberUpdates + 1 > MAXIMUM_NUMBER_UPDATES || m_Count + count > MAXIMUM_COUNT ||
+        m_Updates.size() == MAXIMUM_NUMBER_RECORDED_UPDATES) {
+        return this->full().addSamples(params, samples);
+    }
+
+    m_Updates.emplace_back(SUpdate::E_AddSamples);
+    SUpdate& update{m_Updates.back()};
+    update.s_DataType = params.type();
+    update.s_IsNonNegative = params.isNonNegative();
+    update.s_PropagationInterval = params.propagationInterval();
+    update.s_Values.reserve(samples.size());
+    for (std::size_t i = 0u; i < samples.size(); ++i) {
+        update.s_Values.emplace_back(
+            samples[i].first, samples[i].second[0], samples[i].third,
+            CUnivariateTimeSeriesModel::unpack(params.trendWeights()[i]),
+            CUnivariateTimeSeriesModel::unpack(params.priorWeights()[i]));
+    }
+    ++m_NumberUpdates;
+    m_Count += count;
+
+    return E_Success;
+}
+
+void CNewbornTimeSeriesModel::skipTime(core_t::TTime gap) {
+    if (m_Full != nullptr) {
+        this->full().skipTime(gap);
+        return;
+    }
+    // Skipping time is additive so we merge consecutive skips.
+    if (m_Updates.empty() || m_Updates.back().s_Type != SUpdate::E_SkipTime) {
+        if (m_Updates.size() == MAXIMUM_NUMBER_RECORDED_UPDATES) {
+            this->full().skipTime(gap);
+            return;
+        }
+        m_Updates.emplace_back(SUpdate::E_SkipTime);
+    }
+    m_Updates.back().s_Gap += gap;
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec
+CNewbornTimeSeriesModel::mode(core_t::TTime time, const TDouble2VecWeightsAry& weights) const {
+    return this->full().mode(time, weights);
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec1Vec
+CNewbornTimeSeriesModel::correlateModes(core_t::TTime time,
+                                        const TDouble2VecWeightsAry1Vec& weights) const {
+    return m_Full != nullptr ? this->full().correlateModes(time, weights) : TDouble2Vec1Vec{};
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec1Vec
+CNewbornTimeSeriesModel::residualModes(const TDouble2VecWeightsAry& weights) const {
+    return this->full().residualModes(weights);
+}
+
+void CNewbornTimeSeriesModel::detrend(const TTime2Vec1Vec& time,
+                                      double confidenceInterval,
+                                      TDouble2Vec1Vec& value) const {
+    // The trend of the full model is uninitialized so this is a no-op.
+    if (m_Full != nullptr) {
+        this->full().detrend(time, confidenceInterval, value);
+    }
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec
+CNewbornTimeSeriesModel::predict(core_t::TTime time,
+                                 const TSizeDoublePr1Vec& correlated,
+                                 TDouble2Vec hint) const {
+    return this->full().predict(time, correlated, std::move(hint));
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec3Vec
+CNewbornTimeSeriesModel::confidenceInterval(core_t::TTime time,
+                                            double confidenceInterval,
+                                            const TDouble2VecWeightsAry& weights) const {
+    return this->full().confidenceInterval(time, confidenceInterval, weights);
+}
+
+bool CNewbornTimeSeriesModel::forecast(core_t::TTime startTime,
+                                       core_t::TTime endTime,
+                                       double confidenceInterval,
+                                       const TDouble2Vec& minimum,
+                                       const TDouble2Vec& maximum,
+                                       const TForecastPushDatapointFunc& forecastPushDataPointFunc,
+                                       std::string& messageOut) {
+    return this->full().forecast(startTime, endTime, confidenceInterval, minimum,
+                                 maximum, forecastPushDataPointFunc, messageOut);
+}
+
+bool CNewbornTimeSeriesModel::probability(const CModelProbabilityParams& params,
+                                          const TTime2Vec1Vec& time,
+                                          const TDouble2Vec1Vec& value,
+                                          SModelProbabilityResult& result) const {
+    if (m_Full != nullptr || (value.size() > 0 && value[0].size() != 1)) {
+        return this->full().probability(params, time, value, result);
+    }
+
+    result = SModelProbabilityResult{};
+    if (value.empty()) {
+        return true;
+    }
+
+    // The residual and multi-bucket feature models are non-informative and
+    // the multi-bucket feature is empty so both feature probabilities are
+    // one before correcting for empty buckets.
+    maths_t::EProbabilityCalculation calculation{params.calculation(0)};
+    double probability{correctForEmptyBucket(calculation, value[0],
+                                             params.bucketEmpty()[0][0],
+                                             this->params().probabilityBucketEmpty(), 1.0)};
+    result.s_FeatureProbabilities.emplace_back(BUCKET_FEATURE_LABEL, probability);
+
+    if (m_Template->m_MultibucketFeatureModel != nullptr && params.useMultibucketFeatures()) {
+        result.s_FeatureProbabilities.emplace_back(MEAN_FEATURE_LABEL, probability);
+        probability = aggregateFeatureProbabilities({probability, probability}, 0.0);
+    }
+
+    if (m_Template->m_AnomalyModel != nullptr && params.useAnomalyModel()) {
+        if (probability < 2.0 * LARGEST_SIGNIFICANT_PROBABILITY) {
+            // The anomaly model would be updated.
+            return this->full().probability(params, time, value, result);
+        }
+        result.s_FeatureProbabilities.emplace_back(ANOMALY_FEATURE_LABEL, 1.0);
+    }
+
+    result.s_Probability = probability;
+    result.s_Tail = {maths_t::E_UndeterminedTail};
+
+    return true;
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec
+CNewbornTimeSeriesModel::winsorisationWeight(double derate,
+                                             core_t::TTime time,
+                                             const TDouble2Vec& value) const {
+    return m_Full != nullptr ? this->full().winsorisationWeight(derate, time, value)
+                             : TDouble2Vec{1.0};
+}
+
+CNewbornTimeSeriesModel::TDouble2Vec
+CNewbornTimeSeriesModel::seasonalWeight(double confidence, core_t::TTime time) const {
+    return m_Full != nullptr
+               ? this->full().seasonalWeight(confidence, time)
+               : TDouble2Vec{std::max(1.0, this->params().minimumSeasonalVarianceScale())};
+}
+
+uint64_t CNewbornTimeSeriesModel::checksum(uint64_t seed) const {
+    if (m_Full != nullptr) {
+        return this->full().checksum(seed);
+    }
+    TUnivariateTimeSeriesModelPtr full{this->replay()};
+    return full->checksum(seed);
+}
+
+void CNewbornTimeSeriesModel::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CNewbornTimeSeriesModel");
+    if (m_Full != nullptr) {
+        core::CMemoryDebug::dynamicSize("m_Full", m_Full, mem);
+    } else {
+        mem->addItem("promoted", m_Template->memoryUsage());
+    }
+    core::CMemoryDebug::dynamicSize("m_Updates", m_Updates, mem);
+}
+
+std::size_t CNewbornTimeSeriesModel::memoryUsage() const {
+    // We account for the memory the model will use once it's promoted. The
+    // resource monitor only stops creating new people when the usage reaches
+    // the memory limit, so if we didn't it would create far more than fit in
+    // the limit once they have all seen enough data to be promoted.
+    std::size_t full{m_Full != nullptr ? core::CMemory::dynamicSize(m_Full)
+                                       : m_Template->memoryUsage()};
+    return full + core::CMemory::dynamicSize(m_Updates);
+}
+
+void CNewbornTimeSeriesModel::acceptPersistInserter(core::CStatePersistInserter& inserter) const {
+    if (m_Full != nullptr) {
+        this->full().acceptPersistInserter(inserter);
+        return;
+    }
+    TUnivariateTimeSeriesModelPtr full{this->replay()};
+    full->acceptPersistInserter(inserter);
+}
+
+maths_t::EDataType CNewbornTimeSeriesModel::dataType() const {
+    if (m_Full != nullptr) {
+        return this->full().dataType();
+    }
+    for (auto update = m_Updates.rbegin(); update != m_Updates.rend(); ++update) {
+        if (update->s_Type == SUpdate::E_AddSamples) {
+            return update->s_DataType;
+        }
+    }
+    return m_Template->dataType();
+}
+
+CModel* CNewbornTimeSeriesModel::promote() {
+    if (m_Full != nullptr) {
+        m_Full->params().probabilityBucketEmpty(this->params().probabilityBucketEmpty());
+    }
+    return m_Full.release();
+}
+
+bool CNewbornTimeSeriesModel::isPromoted() const {
+    return m_Full != nullptr;
+}
+
+const CUnivariateTimeSeriesModel& CNewbornTimeSeriesModel::fullModel() const {
+    return this->full();
+}
+
+CNewbornTimeSeriesModel::SValue::SValue(core_t::TTime time,
+                                        double value,
+                                        std::size_t tag,
+                                        const TDoubleWeightsAry& trendWeight,
+                                        const TDoubleWeightsAry& priorWeight)
+    : s_Time(time), s_Value(value), s_Tag(tag), s_TrendWeight(trendWeight),
+      s_PriorWeight(priorWeight) {
+}
+
+CNewbornTimeSeriesModel::SUpdate::SUpdate(EType type)
+    : s_Type(type), s_DataType(maths_t::E_MixedData), s_IsNonNegative(false),
+      s_PropagationInterval(1.0), s_Gap(0) {
+}
+
+std::size_t CNewbornTimeSeriesModel::SUpdate::memoryUsage() const {
+    return core::CMemory::dynamicSize(s_Values);
+}
+
+CNewbornTimeSeriesModel::CNewbornTimeSeriesModel(const CNewbornTimeSeriesModel& other,
+                                                 std::size_t id)
+    : CModel(other.params()), m_Id(id), m_Template(other.m_Template),
+      m_Updates(other.m_Updates), m_NumberUpdates(other.m_NumberUpdates),
+      m_Count(other.m_Count) {
+}
+
+CUnivariateTimeSeriesModel* CNewbornTimeSeriesModel::replay() const {
+    TUnivariateTimeSeriesModelPtr result{m_Template->clone(m_Id)};
+    result->params().probabilityBucketEmpty(this->params().probabilityBucketEmpty());
+
+    TTimeDouble2VecSizeTrVec values;
+    CModelAddSamplesParams::TDouble2VecWeightsAryVec trendWeights;
+    CModelAddSamplesParams::TDouble2VecWeightsAryVec priorWeights;
+    auto pack = [](const TDoubleWeightsAry& weight) {
+        TDouble2VecWeightsAry result_{maths_t::CUnitWeights::unit<TDouble2Vec>(1)};
+        for (std::size_t i = 0u; i < weight.size(); ++i) {
+            result_[i][0] = weight[i];
+        }
+        return result_;
+    };
+
+    for (const auto& update : m_Updates) {
+        values.clear();
+        trendWeights.clear();
+        priorWeights.clear();
+        for (const auto& value : update.s_Values) {
+            values.emplace_back(value.s_Time, TDouble2Vec{value.s_Value}, value.s_Tag);
+            trendWeights.push_back(pack(value.s_TrendWeight));
+            priorWeights.push_back(pack(value.s_PriorWeight));
+        }
+        switch (update.s_Type) {
+        case SUpdate::E_AddBucketValue:
+            result->addBucketValue(values);
+            break;
+        case SUpdate::E_AddSamples: {
+            CModelAddSamplesParams params;
+            if (update.s_DataType != maths_t::E_MixedData) {
+                params.integer(update.s_DataType == maths_t::E_IntegerData);
+            }
+            params.nonNegative(update.s_IsNonNegative)
+                .propagationInterval(update.s_PropagationInterval)
+                .trendWeights(trendWeights)
+                .priorWeights(priorWeights);
+            result->addSamples(params, values);
+            break;
+        }
+        case SUpdate::E_SkipTime:
+            result->skipTime(update.s_Gap);
+            break;
+        }
+    }
+
+    return result.release();
+}
+
+CUnivariateTimeSeriesModel& CNewbornTimeSeriesModel::full() const {
+    if (m_Full == nullptr) {
+        m_Full.reset(this->replay());
+        TUpdateVec empty;
+        m_Updates.swap(empty);
+    }
+    m_Full->params().probabilityBucketEmpty(this->params().probabilityBucketEmpty());
+    return *m_Full;
+}
+
 CTimeSeriesCorrelations::CTimeSeriesCorrelations(double minimumSignificantCorrelation,
                                                  double decayRate)
     : m_MinimumSignificantCorrelation(minimumSignificantCorrelation),
@@ -2229,11 +2723,13 @@ void CMultivariateTimeSeriesModel::addBucketValue(const TTimeDouble2VecSizeTrVec
 
 CMultivariateTimeSeriesModel::EUpdateResult
 CMultivariateTimeSeriesModel::addSamples(const CModelAddSamplesParams& params,
-                                         TTimeDouble2VecSizeTrVec samples) {
-    if (samples.empty()) {
+                                         const TTimeDouble2VecSizeTrVec& values) {
+    if (values.empty()) {
         return E_Success;
     }
 
+    TTimeDouble2VecSizeTrVec samples{values};
+
     using TOptionalTimeDouble2VecPr = boost::optional<TTimeDouble2VecPr>;
 
     TSizeVec valueorder(samples.size());
@@ -2602,6 +3098,7 @@ bool CMultivariateTimeSeriesModel::probability(const CModelProbabilityParams& pa
 
     double probability{aggregateFeatureProbabilities(probabilities, correlation)};
 
+    bool anomalyModelUpdated{false};
     if (m_AnomalyModel != nullptr && params.useAnomalyModel()) {
         double residual{0.0};
         TDouble10Vec nearest(m_ResidualModel->nearestMarginalLikelihoodMean(sample[0]));
@@ -2609,7 +3106,8 @@ bool CMultivariateTimeSeriesModel::probability(const CModelProbabilityParams& pa
         for (std::size_t i = 0u; i < dimension; ++i) {
             residual += (sample[0][i] - nearest[i]) / std::max(std::sqrt(scale[i]), 1.0);
         }
-        m_AnomalyModel->sample(time, residual, probabilities[0], probability);
+        anomalyModelUpdated =
+            m_AnomalyModel->sample(time, residual, probabilities[0], probability);
         double anomalyProbability;
         std::tie(probability, anomalyProbability) =
             m_AnomalyModel->probability(time, probability);
@@ -2619,6 +3117,7 @@ bool CMultivariateTimeSeriesModel::probability(const CModelProbabilityParams& pa
 
     result.s_Probability = probability;
     result.s_FeatureProbabilities = std::move(featureProbabilities);
+    result.s_AnomalyModelUpdated = anomalyModelUpdated;
     result.s_Tail = tail;
 
     return true;
@@ -294,8 +294,9 @@ void CTrendComponent::decayRate(double decayRate) {
 }
 
 void CTrendComponent::propagateForwardsByTime(core_t::TTime interval) {
-    TDoubleVec factors(this->factors(interval));
-    double median{CBasicStatistics::median(factors)};
+    TDouble8Vec factors(this->factors(interval));
+    TDouble8Vec median_(factors);
+    double median{CBasicStatistics::medianInPlace(median_)};
     for (std::size_t i = 0u; i < NUMBER_MODELS; ++i) {
         m_TrendModels[i].s_Weight.age(median);
         m_TrendModels[i].s_Regression.age(factors[i]);
@@ -319,7 +320,7 @@ CTrendComponent::TDoubleDoublePr CTrendComponent::value(core_t::TTime time,
 
     TMeanAccumulator prediction_;
 
-    TDoubleVec weights(this->factors(std::abs(time - m_LastUpdate)));
+    TDouble8Vec weights(this->factors(std::abs(time - m_LastUpdate)));
     double Z{0.0};
     for (std::size_t i = 0u; i < NUMBER_MODELS; ++i) {
         weights[i] *= CBasicStatistics::mean(m_TrendModels[i].s_Weight);
@@ -389,7 +390,7 @@ void CTrendComponent::forecast(core_t::TTime startTime,
 
     LOG_TRACE(<< "forecasting = " << this->print());
 
-    TDoubleVec factors(this->factors(step));
+    TDouble8Vec factors(this->factors(step));
     TDoubleVec modelWeights(this->initialForecastModelWeights());
     TDoubleVec errorWeights(this->initialForecastErrorWeights());
     TRegressionArrayVec models(NUMBER_MODELS);
@@ -502,8 +503,8 @@ std::string CTrendComponent::print() const {
     return result.str();
 }
 
-CTrendComponent::TDoubleVec CTrendComponent::factors(core_t::TTime interval) const {
-    TDoubleVec result(NUMBER_MODELS);
+CTrendComponent::TDouble8Vec CTrendComponent::factors(core_t::TTime interval) const {
+    TDouble8Vec result(NUMBER_MODELS);
     double factor{m_DefaultDecayRate * static_cast<double>(interval) /
                   static_cast<double>(core::constants::DAY)};
     for (std::size_t i = 0u; i < NUMBER_MODELS; ++i) {
@@ -769,6 +769,79 @@ void CKMostCorrelatedTest::testScale() {
     }
 }
 
+void CKMostCorrelatedTest::testHashedSearch() {
+    // Test we find as many of the correlated pairs of a large number
+    // of variables using locality sensitive hashing as we do using the
+    // nearest neighbour search and benchmark the two.
+    //
+    // For 50000 variables create correlated pairs { (0, 1), (2, 3), ... }
+    // with correlations alternating between 0.9 and -0.9.
+
+    using TSizeSizePrVec = std::vector<std::pair<std::size_t, std::size_t>>;
+
+    test::CRandomNumbers rng;
+
+    std::size_t n = 50000;
+    double rho = 0.9;
+
+    TDoubleVec samples;
+    rng.generateNormalSamples(0.0, 1.0, 20 * n, samples);
+
+    std::string hashingParameters[] = {"default", "disabled"};
+    uint64_t elapsed[2];
+    double recall[2];
+
+    for (std::size_t t = 0u; t < 2; ++t) {
+        maths::CSampling::seed();
+
+        CKMostCorrelatedForTest mostCorrelated(n / 2, 0.0);
+        mostCorrelated.addVariables(n);
+        if (t == 1) {
+            mostCorrelated.setHashingParameters(0, 1);
+        }
+
+        core::CStopWatch watch;
+        watch.start();
+        for (std::size_t i = 0u, k = 0u; i < 20; ++i) {
+            for (std::size_t j = 0u; j < n; j += 2, k += 2) {
+                double x = samples[k];
+                double y = (j % 4 == 0 ? rho : -rho) * samples[k] +
+                           std::sqrt(1.0 - rho * rho) * samples[k + 1];
+                mostCorrelated.add(j, x);
+                mostCorrelated.add(j + 1, y);
+            }
+            mostCorrelated.capture();
+        }
+        elapsed[t] = watch.stop();
+
+        TSizeSizePrVec correlatedPairs;
+        mostCorrelated.mostCorrelated(n, correlatedPairs);
+
+        double found = 0.0;
+        for (const auto& pair : correlatedPairs) {
+            std::size_t X = std::min(pair.first, pair.second);
+            std::size_t Y = std::max(pair.first, pair.second);
+            if (X % 2 == 0 && Y == X + 1) {
+                found += 1.0;
+            }
+        }
+        recall[t] = found / static_cast<double>(n / 2);
+
+        LOG_DEBUG(<< "hashing " << hashingParameters[t] << ": elapsed time = "
+                  << elapsed[t] << "ms, recall = " << recall[t]);
+    }
+
+    // After one round of projections the correlations are estimated from
+    // only a few projected values so many uncorrelated pairs of the 1.25e9
+    // appear strongly correlated and crowd out the planted pairs. The seeds
+    // are fixed so we can check the recall of both searches exactly: the
+    // nearest neighbour search finds 21% of the planted pairs and hashing
+    // must find at least as many.
+    CPPUNIT_ASSERT(recall[1] > 0.2);
+    CPPUNIT_ASSERT(recall[0] > 0.23);
+    CPPUNIT_ASSERT(recall[0] >= recall[1]);
+}
+
 void CKMostCorrelatedTest::testPersistence() {
     // Check that persistence is idempotent.
 
@@ -789,6 +862,7 @@ void CKMostCorrelatedTest::testPersistence() {
     }
 
     maths::CKMostCorrelated origMostCorrelated(10, 0.001);
+    origMostCorrelated.setHashingParameters(8, 10);
     origMostCorrelated.addVariables(10);
 
     for (std::size_t i = 0u; i < samples.size(); i += 10) {
@@ -848,6 +922,8 @@ CppUnit::Test* CKMostCorrelatedTest::suite() {
         "CKMostCorrelatedTest::testMissingData", &CKMostCorrelatedTest::testMissingData));
     suiteOfTests->addTest(new CppUnit::TestCaller<CKMostCorrelatedTest>(
         "CKMostCorrelatedTest::testScale", &CKMostCorrelatedTest::testScale));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CKMostCorrelatedTest>(
+        "CKMostCorrelatedTest::testHashedSearch", &CKMostCorrelatedTest::testHashedSearch));
     suiteOfTests->addTest(new CppUnit::TestCaller<CKMostCorrelatedTest>(
         "CKMostCorrelatedTest::testPersistence", &CKMostCorrelatedTest::testPersistence));
 
@@ -7,12 +7,17 @@
 #include "CLinearAlgebraTest.h"
 
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
+#include <core/Constants.h>
 
+#include <maths/CBasicStatistics.h>
 #include <maths/CLinearAlgebra.h>
 #include <maths/CLinearAlgebraEigen.h>
 #include <maths/CLinearAlgebraPersist.h>
 #include <maths/CLinearAlgebraTools.h>
 
+#include <test/CRandomNumbers.h>
+
 #include <boost/range.hpp>
 
 #include <vector>
@@ -991,6 +996,244 @@ std::string print(const MATRIX& m) {
 }
 }
 
+namespace {
+
+template<std::size_t N>
+maths::CVectorNx1<double, N> randomVector(test::CRandomNumbers& rng) {
+    TDoubleVec x;
+    rng.generateNormalSamples(0.0, 1.0, N, x);
+    return maths::CVectorNx1<double, N>(x);
+}
+
+template<std::size_t N>
+maths::CDenseMatrix<double> toDense(const maths::CSymmetricMatrixNxN<double, N>& m) {
+    maths::CDenseMatrix<double> result(N, N);
+    for (std::size_t i = 0u; i < N; ++i) {
+        for (std::size_t j = 0u; j < N; ++j) {
+            result(i, j) = m(i, j);
+        }
+    }
+    return result;
+}
+
+template<std::size_t N>
+void testCholeskyNxN(test::CRandomNumbers& rng) {
+    using TVector = maths::CVectorNx1<double, N>;
+    using TMatrix = maths::CSymmetricMatrixNxN<double, N>;
+    using TFloatMatrix = maths::CSymmetricMatrixNxN<maths::CFloatStorage, N>;
+    using TFloatVector = maths::CVectorNx1<maths::CFloatStorage, N>;
+
+    for (std::size_t t = 0u; t < 50; ++t) {
+        // Random positive definite matrices with a range of conditions.
+        TMatrix m(TMatrix(maths::E_Diagonal, TVector(std::pow(10.0, -static_cast<double>(t % 6)))));
+        for (std::size_t i = 0u; i < 2 * N; ++i) {
+            m += TMatrix(maths::E_OuterProduct, randomVector<N>(rng));
+        }
+        TVector x(randomVector<N>(rng));
+
+        maths::CDenseMatrix<double> m_(toDense(m));
+        maths::CDenseVector<double> x_(N);
+        for (std::size_t i = 0u; i < N; ++i) {
+            x_(i) = x(i);
+        }
+        Eigen::JacobiSVD<maths::CDenseMatrix<double>> svd(
+            m_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+        double expectedQuadraticForm{x_.dot(svd.solve(x_))};
+        double expectedLogDeterminant{0.0};
+        for (std::size_t i = 0u; i < N; ++i) {
+            expectedLogDeterminant += std::log(svd.singularValues()(i));
+        }
+        maths::CDenseMatrix<double> expectedInverse(m_.inverse());
+
+        maths::CCholeskyNxN<N> cholesky(m);
+        CPPUNIT_ASSERT(cholesky.wellConditioned());
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedQuadraticForm, cholesky.inverseQuadraticForm(x),
+                                     1e-10 * expectedQuadraticForm);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLogDeterminant, cholesky.logDeterminant(),
+                                     1e-10 * std::fabs(expectedLogDeterminant) + 1e-12);
+        TMatrix inverse;
+        cholesky.inverse(inverse);
+        CPPUNIT_ASSERT((toDense(inverse) - expectedInverse).norm() <
+                       1e-10 * expectedInverse.norm());
+
+        // The tools, which use the factorization, agree with the SVD.
+        double quadraticForm;
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::inverseQuadraticForm(m, x, quadraticForm));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedQuadraticForm, quadraticForm,
+                                     1e-10 * expectedQuadraticForm);
+        double logLikelihood;
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::gaussianLogLikelihood(m, x, logLikelihood));
+        double expectedLogLikelihood{-0.5 * (expectedQuadraticForm +
+                                             static_cast<double>(N) * core::constants::LOG_TWO_PI +
+                                             expectedLogDeterminant)};
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLogLikelihood, logLikelihood,
+                                     1e-10 * std::fabs(expectedLogLikelihood));
+        double logDeterminant;
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::logDeterminant(m, logDeterminant, false));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedLogDeterminant, logDeterminant,
+                                     1e-10 * std::fabs(expectedLogDeterminant) + 1e-12);
+
+        // Single precision storage.
+        TFloatMatrix mf(m);
+        TFloatVector xf(x);
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::inverseQuadraticForm(mf, xf, quadraticForm));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expectedQuadraticForm, quadraticForm,
+                                     1e-4 * expectedQuadraticForm);
+    }
+
+    // Singular and indefinite matrices aren't well conditioned so the
+    // tools fall back to the SVD.
+    for (std::size_t t = 0u; t < 10; ++t) {
+        TMatrix singular(0.0);
+        for (std::size_t i = 0u; i + 1 < N; ++i) {
+            singular += TMatrix(maths::E_OuterProduct, randomVector<N>(rng));
+        }
+        CPPUNIT_ASSERT(maths::CCholeskyNxN<N>(singular).wellConditioned() == false);
+        double logDeterminant;
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpOverflowed,
+                             maths::logDeterminant(singular, logDeterminant, false));
+
+        TVector x(randomVector<N>(rng));
+        TMatrix indefinite(TMatrix(maths::E_Diagonal, TVector(1.0)) -
+                           TMatrix(maths::E_OuterProduct, x / x.euclidean() * std::sqrt(2.0)));
+        CPPUNIT_ASSERT(maths::CCholeskyNxN<N>(indefinite).wellConditioned() == false);
+        CPPUNIT_ASSERT_EQUAL(maths_t::E_FpNoErrors,
+                             maths::logDeterminant(indefinite, logDeterminant));
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, logDeterminant, 1e-10);
+    }
+}
+
+template<typename T, std::size_t N>
+void testUpdateCovariancesNxN(test::CRandomNumbers& rng) {
+    using TVector = maths::CVectorNx1<T, N>;
+    using TMatrix = maths::CSymmetricMatrixNxN<T, N>;
+
+    for (std::size_t t = 0u; t < 100; ++t) {
+        TVector alpha(randomVector<N>(rng));
+        alpha = maths::fabs(alpha) / (TVector(1.0) + maths::fabs(alpha));
+        TVector beta(TVector(1.0) - alpha);
+        TVector r(randomVector<N>(rng));
+        TVector dMean(randomVector<N>(rng));
+        TMatrix m(TMatrix(maths::E_OuterProduct, randomVector<N>(rng)) +
+                  TMatrix(maths::E_Diagonal, TVector(1.0)));
+
+        TMatrix expected(m);
+        expected += TMatrix(maths::E_OuterProduct, dMean);
+        maths::scaleCovariances(beta, expected);
+        TMatrix r2(maths::E_OuterProduct, r);
+        maths::scaleCovariances(alpha, r2);
+        expected += r2;
+
+        maths::updateCovariances(alpha, beta, r, dMean, m);
+
+        CPPUNIT_ASSERT_EQUAL(print(expected), print(m));
+        for (std::size_t i = 0u; i < N; ++i) {
+            for (std::size_t j = 0u; j <= i; ++j) {
+                CPPUNIT_ASSERT_EQUAL(static_cast<double>(expected(i, j)),
+                                     static_cast<double>(m(i, j)));
+            }
+        }
+    }
+}
+
+template<std::size_t N>
+void benchmark(test::CRandomNumbers& rng) {
+    using TVector = maths::CVectorNx1<double, N>;
+    using TMatrix = maths::CSymmetricMatrixNxN<double, N>;
+    using TDenseMatrix = typename maths::SDenseMatrix<TMatrix>::Type;
+    using TDenseVector = typename maths::SDenseVector<TVector>::Type;
+    using TMeanCovAccumulator = maths::CBasicStatistics::SSampleCovariances<double, N>;
+
+    std::size_t repeats{100000};
+
+    TMatrix m(TMatrix(maths::E_Diagonal, TVector(1.0)));
+    for (std::size_t i = 0u; i < 2 * N; ++i) {
+        m += TMatrix(maths::E_OuterProduct, randomVector<N>(rng));
+    }
+    std::vector<TVector> x;
+    for (std::size_t i = 0u; i < 100; ++i) {
+        x.push_back(randomVector<N>(rng));
+    }
+
+    core::CStopWatch watch;
+    double total{0.0};
+
+    watch.reset(true);
+    for (std::size_t t = 0u; t < repeats; ++t) {
+        Eigen::JacobiSVD<TDenseMatrix> svd(maths::toDenseMatrix(m),
+                                           Eigen::ComputeFullU | Eigen::ComputeFullV);
+        TDenseVector y(maths::toDenseVector(x[t % x.size()]));
+        total += y.dot(svd.solve(y));
+    }
+    std::uint64_t svdTime{watch.stop()};
+
+    watch.reset(true);
+    for (std::size_t t = 0u; t < repeats; ++t) {
+        double logLikelihood;
+        maths::gaussianLogLikelihood(m, x[t % x.size()], logLikelihood);
+        total += logLikelihood;
+    }
+    std::uint64_t logLikelihoodTime{watch.stop()};
+
+    TMeanCovAccumulator covariances;
+    watch.reset(true);
+    for (std::size_t t = 0u; t < repeats; ++t) {
+        covariances.add(x[t % x.size()]);
+    }
+    std::uint64_t addTime{watch.stop()};
+
+    LOG_DEBUG(<< "N = " << N << ": SVD solve "
+              << static_cast<double>(svdTime) * 1e6 / static_cast<double>(repeats)
+              << "ns, log-likelihood "
+              << static_cast<double>(logLikelihoodTime) * 1e6 / static_cast<double>(repeats)
+              << "ns, add covariances "
+              << static_cast<double>(addTime) * 1e6 / static_cast<double>(repeats)
+              << "ns (total = " << total << ")");
+    CPPUNIT_ASSERT_EQUAL(static_cast<double>(repeats), maths::CBasicStatistics::count(covariances));
+}
+}
+
+void CLinearAlgebraTest::testCholesky() {
+    // Test the factorization agrees with the SVD for positive definite
+    // matrices and detects the matrices where it doesn't.
+
+    test::CRandomNumbers rng;
+
+    testCholeskyNxN<2>(rng);
+    testCholeskyNxN<3>(rng);
+    testCholeskyNxN<4>(rng);
+    testCholeskyNxN<5>(rng);
+}
+
+void CLinearAlgebraTest::testUpdateCovariances() {
+    // Test the fused update is identical to the outer product updates.
+
+    test::CRandomNumbers rng;
+
+    testUpdateCovariancesNxN<double, 2>(rng);
+    testUpdateCovariancesNxN<double, 5>(rng);
+    testUpdateCovariancesNxN<maths::CFloatStorage, 2>(rng);
+    testUpdateCovariancesNxN<maths::CFloatStorage, 3>(rng);
+    testUpdateCovariancesNxN<maths::CFloatStorage, 4>(rng);
+    testUpdateCovariancesNxN<maths::CFloatStorage, 5>(rng);
+}
+
+void CLinearAlgebraTest::testSmallMatrixPerformance() {
+    // Benchmark the operations the multivariate priors perform for each
+    // sample against the SVD they used to use.
+
+    test::CRandomNumbers rng;
+
+    benchmark<2>(rng);
+    benchmark<3>(rng);
+    benchmark<4>(rng);
+    benchmark<5>(rng);
+}
+
 void CLinearAlgebraTest::testProjected() {
     using TSizeVec = std::vector<std::size_t>;
 
@@ -1119,6 +1362,13 @@ CppUnit::Test* CLinearAlgebraTest::suite() {
         "CLinearAlgebraTest::testSampleGaussian", &CLinearAlgebraTest::testSampleGaussian));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
         "CLinearAlgebraTest::testLogDeterminant", &CLinearAlgebraTest::testLogDeterminant));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
+        "CLinearAlgebraTest::testCholesky", &CLinearAlgebraTest::testCholesky));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
+        "CLinearAlgebraTest::testUpdateCovariances", &CLinearAlgebraTest::testUpdateCovariances));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
+        "CLinearAlgebraTest::testSmallMatrixPerformance",
+        &CLinearAlgebraTest::testSmallMatrixPerformance));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
         "CLinearAlgebraTest::testProjected", &CLinearAlgebraTest::testProjected));
     suiteOfTests->addTest(new CppUnit::TestCaller<CLinearAlgebraTest>(
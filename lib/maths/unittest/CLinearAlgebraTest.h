@@ -20,6 +20,9 @@ public:
     void testGaussianLogLikelihood();
     void testSampleGaussian();
     void testLogDeterminant();
+    void testCholesky();
+    void testUpdateCovariances();
+    void testSmallMatrixPerformance();
     void testProjected();
     void testPersist();
 
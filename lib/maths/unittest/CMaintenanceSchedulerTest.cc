@@ -0,0 +1,290 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#include "CMaintenanceSchedulerTest.h"
+
+#include <core/CContainerPrinter.h>
+#include <core/CLogger.h>
+#include <core/CRapidXmlParser.h>
+#include <core/CRapidXmlStatePersistInserter.h>
+#include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStatistics.h>
+#include <core/Constants.h>
+#include <core/CoreTypes.h>
+
+#include <maths/CMaintenanceScheduler.h>
+
+#include <test/CRandomNumbers.h>
+
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ml;
+
+namespace {
+using TSizeVec = std::vector<std::size_t>;
+using TTimeVec = std::vector<core_t::TTime>;
+const core_t::TTime HOUR{core::constants::HOUR};
+}
+
+void CMaintenanceSchedulerTest::testJitter() {
+    // Check that tasks aren't jittered if we're within budget and
+    // otherwise that the jitter is deterministic, a whole number of
+    // buckets, bounded and spreads tasks for different keys.
+
+    maths::CMaintenanceScheduler::reset();
+
+    maths::CMaintenanceScheduler::budget(2);
+    for (std::size_t i = 0u; i < 2; ++i) {
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200),
+                             maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+    }
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200 + 3 * HOUR),
+                         maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+
+    maths::CMaintenanceScheduler::budget(0);
+
+    test::CRandomNumbers rng;
+    TSizeVec keys;
+    rng.generateUniformSamples(0, 1000000000, 1000, keys);
+
+    for (auto bucketLength : {300, 3600, 86400}) {
+        TSizeVec counts(maths::CMaintenanceScheduler::MAXIMUM_JITTER + 1, 0);
+        core_t::TTime maxJitter{std::min(
+            maths::CMaintenanceScheduler::MAXIMUM_JITTER * bucketLength,
+            maths::CMaintenanceScheduler::MAXIMUM_JITTER_INTERVAL)};
+
+        for (auto key : keys) {
+            core_t::TTime time{100 * core::constants::DAY};
+            core_t::TTime scheduled{
+                maths::CMaintenanceScheduler::schedule(time, bucketLength, key)};
+            CPPUNIT_ASSERT_EQUAL(scheduled, maths::CMaintenanceScheduler::schedule(
+                                                time, bucketLength, key));
+            CPPUNIT_ASSERT_EQUAL(core_t::TTime(0), (scheduled - time) % bucketLength);
+            CPPUNIT_ASSERT(scheduled >= time);
+            CPPUNIT_ASSERT(scheduled <= time + maxJitter);
+            ++counts[(scheduled - time) / bucketLength];
+        }
+        LOG_DEBUG(<< "counts = " << core::CContainerPrinter::print(counts));
+
+        std::size_t buckets{static_cast<std::size_t>(maxJitter / bucketLength) + 1};
+        for (std::size_t i = 0u; i < buckets; ++i) {
+            CPPUNIT_ASSERT(counts[i] > 1000 / buckets / 2);
+        }
+    }
+
+    maths::CMaintenanceScheduler::reset();
+}
+
+void CMaintenanceSchedulerTest::testBudget() {
+    // Check that we don't run more than the budget in any bucket, that
+    // the queue depth is reported and that all tasks eventually run.
+
+    maths::CMaintenanceScheduler::reset();
+    maths::CMaintenanceScheduler::budget(10);
+
+    core_t::TTime bucketLength{HOUR};
+    TTimeVec tasks(35, 5 * bucketLength);
+
+    TSizeVec run;
+    for (core_t::TTime time = 5 * bucketLength; time < 10 * bucketLength;
+         time += bucketLength) {
+        std::size_t n{0};
+        for (auto& task : tasks) {
+            if (maths::CMaintenanceScheduler::run(task, time, bucketLength)) {
+                ++n;
+            }
+        }
+        run.push_back(n);
+        if (run.size() > 1 && run.size() < 5) {
+            // Running in the next bucket publishes the queue depth.
+            CPPUNIT_ASSERT_EQUAL(std::size_t(35 - 10 * (run.size() - 1)),
+                                 maths::CMaintenanceScheduler::queueDepth());
+            CPPUNIT_ASSERT_EQUAL(
+                std::uint64_t(maths::CMaintenanceScheduler::queueDepth()),
+                core::CStatistics::stat(stat_t::E_MaintenanceQueueDepth).value());
+        }
+    }
+    LOG_DEBUG(<< "run = " << core::CContainerPrinter::print(run));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("[10, 10, 10, 5, 0]"), core::CContainerPrinter::print(run));
+    CPPUNIT_ASSERT(std::all_of(tasks.begin(), tasks.end(), [](core_t::TTime task) {
+        return task == maths::CMaintenanceScheduler::NOT_SCHEDULED;
+    }));
+
+    maths::CMaintenanceScheduler::reset();
+}
+
+void CMaintenanceSchedulerTest::testDeferral() {
+    // Check that tasks aren't run before they're due and aren't deferred
+    // by more than the maximum deferral.
+
+    maths::CMaintenanceScheduler::reset();
+    maths::CMaintenanceScheduler::budget(0);
+
+    core_t::TTime bucketLength{HOUR};
+    core_t::TTime task{3 * bucketLength};
+
+    core_t::TTime time{0};
+    for (/**/; !maths::CMaintenanceScheduler::run(task, time, bucketLength);
+         time += bucketLength) {
+    }
+    LOG_DEBUG(<< "ran at " << time);
+    CPPUNIT_ASSERT_EQUAL(3 * bucketLength +
+                             maths::CMaintenanceScheduler::MAXIMUM_DEFERRAL * bucketLength,
+                         time);
+    CPPUNIT_ASSERT_EQUAL(maths::CMaintenanceScheduler::NOT_SCHEDULED, task);
+    CPPUNIT_ASSERT(!maths::CMaintenanceScheduler::run(task, time + bucketLength, bucketLength));
+
+    // Earlier buckets aren't subject to the budget.
+    task = 0;
+    CPPUNIT_ASSERT(maths::CMaintenanceScheduler::run(task, bucketLength, bucketLength));
+
+    maths::CMaintenanceScheduler::reset();
+}
+
+void CMaintenanceSchedulerTest::testContexts() {
+    // Check that the budgets of different contexts are independent and
+    // that the default context is restored when a scoped context ends.
+
+    maths::CMaintenanceScheduler::reset();
+    maths::CMaintenanceScheduler::budget(1);
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200),
+                         maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+
+    maths::CMaintenanceScheduler::CContext context1;
+    maths::CMaintenanceScheduler::CContext context2;
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{context1};
+        CPPUNIT_ASSERT_EQUAL(maths::CMaintenanceScheduler::DEFAULT_BUDGET,
+                             maths::CMaintenanceScheduler::budget());
+        maths::CMaintenanceScheduler::budget(1);
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200),
+                             maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+        {
+            maths::CMaintenanceScheduler::CScopedContext nested{context2};
+            maths::CMaintenanceScheduler::budget(1);
+            CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200),
+                                 maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+        }
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200 + 3 * HOUR),
+                             maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+    }
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{context2};
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200 + 3 * HOUR),
+                             maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+    }
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), maths::CMaintenanceScheduler::budget());
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200 + 3 * HOUR),
+                         maths::CMaintenanceScheduler::schedule(7200, HOUR, 3));
+
+    // Check the queue depth statistic is the total over the contexts.
+    std::uint64_t depth{core::CStatistics::stat(stat_t::E_MaintenanceQueueDepth).value()};
+    for (auto* context : {&context1, &context2}) {
+        maths::CMaintenanceScheduler::CScopedContext scope{*context};
+        TTimeVec tasks(3, 5 * HOUR);
+        for (auto& task : tasks) {
+            maths::CMaintenanceScheduler::run(task, 5 * HOUR, HOUR);
+        }
+        core_t::TTime next{6 * HOUR};
+        CPPUNIT_ASSERT(maths::CMaintenanceScheduler::run(next, 6 * HOUR, HOUR));
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), maths::CMaintenanceScheduler::queueDepth());
+    }
+    CPPUNIT_ASSERT_EQUAL(depth + 4,
+                         core::CStatistics::stat(stat_t::E_MaintenanceQueueDepth).value());
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{context1};
+        maths::CMaintenanceScheduler::reset();
+    }
+    CPPUNIT_ASSERT_EQUAL(depth + 2,
+                         core::CStatistics::stat(stat_t::E_MaintenanceQueueDepth).value());
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{context2};
+        maths::CMaintenanceScheduler::reset();
+    }
+
+    maths::CMaintenanceScheduler::reset();
+}
+
+void CMaintenanceSchedulerTest::testPersist() {
+    // Check that a context restored part way through a bucket makes the
+    // same decisions as the original.
+
+    maths::CMaintenanceScheduler::CContext origContext;
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{origContext};
+        maths::CMaintenanceScheduler::budget(3);
+        for (std::uint64_t key = 0; key < 5; ++key) {
+            maths::CMaintenanceScheduler::schedule(7200, HOUR, key);
+        }
+        core_t::TTime task{7200};
+        for (std::size_t i = 0; i < 2; ++i) {
+            task = 7200;
+            CPPUNIT_ASSERT(maths::CMaintenanceScheduler::run(task, 7200, HOUR));
+        }
+    }
+
+    std::string origXml;
+    {
+        core::CRapidXmlStatePersistInserter inserter("root");
+        origContext.acceptPersistInserter(inserter);
+        inserter.toXml(origXml);
+    }
+    LOG_DEBUG(<< "context XML = " << origXml);
+
+    maths::CMaintenanceScheduler::CContext restoredContext;
+    {
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        CPPUNIT_ASSERT(traverser.traverseSubLevel(boost::bind(
+            &maths::CMaintenanceScheduler::CContext::acceptRestoreTraverser,
+            &restoredContext, _1)));
+    }
+
+    std::string newXml;
+    {
+        core::CRapidXmlStatePersistInserter inserter("root");
+        restoredContext.acceptPersistInserter(inserter);
+        inserter.toXml(newXml);
+    }
+    CPPUNIT_ASSERT_EQUAL(origXml, newXml);
+
+    for (auto context : {&origContext, &restoredContext}) {
+        maths::CMaintenanceScheduler::CScopedContext scope{*context};
+        maths::CMaintenanceScheduler::budget(3);
+        CPPUNIT_ASSERT_EQUAL(core_t::TTime(7200 + 5 * HOUR),
+                             maths::CMaintenanceScheduler::schedule(7200, HOUR, 5));
+        core_t::TTime task{7200};
+        CPPUNIT_ASSERT(maths::CMaintenanceScheduler::run(task, 7200, HOUR));
+        task = 7200;
+        CPPUNIT_ASSERT(!maths::CMaintenanceScheduler::run(task, 7200, HOUR));
+        task = 7200;
+        CPPUNIT_ASSERT(maths::CMaintenanceScheduler::run(task, 7200 + HOUR, HOUR));
+        CPPUNIT_ASSERT_EQUAL(std::size_t(1), maths::CMaintenanceScheduler::queueDepth());
+    }
+}
+
+CppUnit::Test* CMaintenanceSchedulerTest::suite() {
+    CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CMaintenanceSchedulerTest");
+
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMaintenanceSchedulerTest>(
+        "CMaintenanceSchedulerTest::testJitter", &CMaintenanceSchedulerTest::testJitter));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMaintenanceSchedulerTest>(
+        "CMaintenanceSchedulerTest::testBudget", &CMaintenanceSchedulerTest::testBudget));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMaintenanceSchedulerTest>(
+        "CMaintenanceSchedulerTest::testDeferral", &CMaintenanceSchedulerTest::testDeferral));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMaintenanceSchedulerTest>(
+        "CMaintenanceSchedulerTest::testContexts", &CMaintenanceSchedulerTest::testContexts));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CMaintenanceSchedulerTest>(
+        "CMaintenanceSchedulerTest::testPersist", &CMaintenanceSchedulerTest::testPersist));
+
+    return suiteOfTests;
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright Elasticsearch B.V. and/or licensed to Elasticsearch B.V. under one
+ * or more contributor license agreements. Licensed under the Elastic License;
+ * you may not use this file except in compliance with the Elastic License.
+ */
+
+#ifndef INCLUDED_CMaintenanceSchedulerTest_h
+#define INCLUDED_CMaintenanceSchedulerTest_h
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class CMaintenanceSchedulerTest : public CppUnit::TestFixture {
+public:
+    void testJitter();
+    void testBudget();
+    void testDeferral();
+    void testContexts();
+    void testPersist();
+
+    static CppUnit::Test* suite();
+};
+
+#endif // INCLUDED_CMaintenanceSchedulerTest_h
@@ -11,6 +11,7 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStopWatch.h>
 
 #include <maths/CNaturalBreaksClassifier.h>
 #include <maths/CRestoreParams.h>
@@ -18,6 +19,9 @@
 #include <test/CRandomNumbers.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <vector>
 
 using namespace ml;
@@ -146,6 +150,65 @@ bool naturalBreaksBranchAndBound(const TTupleVec& categories,
 
     return true;
 }
+
+//! Exhaustive search for the minimum value of \p target over all
+//! partitions of \p categories into \p n classes with at least \p p
+//! values in each class.
+bool naturalBreaksExhaustive(const CNaturalBreaksClassifier::TDoubleTupleVec& categories,
+                             std::size_t n,
+                             std::size_t p,
+                             CNaturalBreaksClassifier::EObjective target,
+                             double& result) {
+    using TSizeVec = std::vector<std::size_t>;
+
+    std::size_t N = categories.size();
+
+    TSizeVec split;
+    for (std::size_t i = 1u; i < n; ++i) {
+        split.push_back(i);
+    }
+    split.push_back(N);
+
+    bool feasible = false;
+    result = std::numeric_limits<double>::max();
+    for (;;) {
+        double value = 0.0;
+        bool valid = true;
+        for (std::size_t i = 0u, j = 0u; valid && i < split.size(); ++i) {
+            CNaturalBreaksClassifier::TDoubleTuple category;
+            for (/**/; j < split[i]; ++j) {
+                category += categories[j];
+            }
+            double count = CBasicStatistics::count(category);
+            double variation = count * CBasicStatistics::maximumLikelihoodVariance(category);
+            valid = (count >= static_cast<double>(p));
+            value += target == CNaturalBreaksClassifier::E_TargetDeviation
+                         ? std::sqrt(variation)
+                         : variation;
+        }
+        if (valid && value < result) {
+            feasible = true;
+            result = value;
+        }
+
+        // Move to the next split in lexicographic order.
+        std::size_t i = n - 1;
+        for (/**/; i > 0; --i) {
+            if (split[i - 1] < N - n + i) {
+                break;
+            }
+        }
+        if (i == 0) {
+            break;
+        }
+        ++split[i - 1];
+        for (/**/; i < n - 1; ++i) {
+            split[i] = split[i - 1] + 1;
+        }
+    }
+
+    return feasible;
+}
 }
 
 void CNaturalBreaksClassifierTest::testCategories() {
@@ -664,6 +727,117 @@ void CNaturalBreaksClassifierTest::testPersist() {
     CPPUNIT_ASSERT_EQUAL(origXml, newXml);
 }
 
+void CNaturalBreaksClassifierTest::testNaturalBreaks() {
+    // Check that we find the minimum of both objectives, with and
+    // without a constraint on the minimum class count, against an
+    // exhaustive search of all partitions.
+
+    using TSizeVec = std::vector<std::size_t>;
+
+    test::CRandomNumbers rng;
+
+    TSizeVec sizes;
+    TDoubleVec means;
+    TDoubleVec counts;
+    TDoubleVec variances;
+    CNaturalBreaksClassifier::TDoubleTupleVec categories;
+    TSizeVec split;
+
+    for (std::size_t t = 0u; t < 500; ++t) {
+        std::size_t n = 2 + t % 4;
+        rng.generateUniformSamples(n + 1, 15, 1, sizes);
+        std::size_t N = sizes[0];
+
+        rng.generateNormalSamples(0.0, 100.0, N, means);
+        rng.generateUniformSamples(1.0, 20.0, N, counts);
+        rng.generateUniformSamples(0.0, 4.0, N, variances);
+        std::sort(means.begin(), means.end());
+        categories.assign(N, CNaturalBreaksClassifier::TDoubleTuple());
+        for (std::size_t i = 0u; i < N; ++i) {
+            categories[i] = CBasicStatistics::accumulator(counts[i], means[i], variances[i]);
+        }
+
+        double total = std::accumulate(counts.begin(), counts.end(), 0.0);
+        std::size_t p = t % 3 == 0 ? static_cast<std::size_t>(total / static_cast<double>(n + 1))
+                                   : 0;
+
+        for (auto target : {CNaturalBreaksClassifier::E_TargetDeviation,
+                            CNaturalBreaksClassifier::E_TargetVariation}) {
+            double expected;
+            bool expectSplit = naturalBreaksExhaustive(categories, n, p, target, expected);
+
+            bool haveSplit = CNaturalBreaksClassifier::naturalBreaks(categories, n, p,
+                                                                     target, split);
+            CPPUNIT_ASSERT_EQUAL(expectSplit, haveSplit);
+            if (haveSplit == false) {
+                continue;
+            }
+            CPPUNIT_ASSERT_EQUAL(n, split.size());
+            CPPUNIT_ASSERT_EQUAL(N, split.back());
+
+            double actual = 0.0;
+            for (std::size_t i = 0u, j = 0u; i < split.size(); ++i) {
+                CNaturalBreaksClassifier::TDoubleTuple category;
+                for (/**/; j < split[i]; ++j) {
+                    category += categories[j];
+                }
+                double count = CBasicStatistics::count(category);
+                double variation = count * CBasicStatistics::maximumLikelihoodVariance(category);
+                CPPUNIT_ASSERT(count >= static_cast<double>(p));
+                actual += target == CNaturalBreaksClassifier::E_TargetDeviation
+                              ? std::sqrt(variation)
+                              : variation;
+            }
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, actual, 1e-5 * expected);
+        }
+    }
+}
+
+void CNaturalBreaksClassifierTest::testNaturalBreaksPerformance() {
+    // Benchmark the splits at the number of categories the clusterers
+    // use, i.e. the 12 tuple structure of each CXMeansOnline1d cluster,
+    // and some larger numbers.
+
+    using TSizeVec = std::vector<std::size_t>;
+
+    test::CRandomNumbers rng;
+
+    core::CStopWatch watch;
+
+    CNaturalBreaksClassifier::TDoubleTupleVec categories;
+    TSizeVec split;
+
+    for (auto N : TSizeVec{12, 50, 200, 1000}) {
+        TDoubleVec means;
+        rng.generateNormalSamples(0.0, 100.0, N, means);
+        std::sort(means.begin(), means.end());
+        categories.assign(N, CNaturalBreaksClassifier::TDoubleTuple());
+        for (std::size_t i = 0u; i < N; ++i) {
+            categories[i] = CBasicStatistics::accumulator(2.0, means[i], 1.0);
+        }
+
+        std::size_t repeats = std::max(1000000 / (N * N), std::size_t(1));
+        for (auto n : TSizeVec{2, 4}) {
+            for (auto target : {CNaturalBreaksClassifier::E_TargetDeviation,
+                                CNaturalBreaksClassifier::E_TargetVariation}) {
+                watch.reset(true);
+                for (std::size_t t = 0u; t < repeats; ++t) {
+                    CNaturalBreaksClassifier::naturalBreaks(categories, n, 0, target, split);
+                }
+                std::uint64_t time{watch.stop()};
+                LOG_DEBUG(<< "N = " << N << ", n = " << n << ", "
+                          << (target == CNaturalBreaksClassifier::E_TargetDeviation
+                                  ? "deviation"
+                                  : "variation")
+                          << ": " << static_cast<double>(time) * 1000.0 /
+                                         static_cast<double>(repeats)
+                          << "us per split");
+                CPPUNIT_ASSERT_EQUAL(n, split.size());
+            }
+        }
+    }
+}
+
 CppUnit::Test* CNaturalBreaksClassifierTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CNaturalBreaksClassifierTest");
 
@@ -677,6 +851,12 @@ CppUnit::Test* CNaturalBreaksClassifierTest::suite() {
         "CNaturalBreaksClassifierTest::testSample", &CNaturalBreaksClassifierTest::testSample));
     suiteOfTests->addTest(new CppUnit::TestCaller<CNaturalBreaksClassifierTest>(
         "CNaturalBreaksClassifierTest::testPersist", &CNaturalBreaksClassifierTest::testPersist));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CNaturalBreaksClassifierTest>(
+        "CNaturalBreaksClassifierTest::testNaturalBreaks",
+        &CNaturalBreaksClassifierTest::testNaturalBreaks));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CNaturalBreaksClassifierTest>(
+        "CNaturalBreaksClassifierTest::testNaturalBreaksPerformance",
+        &CNaturalBreaksClassifierTest::testNaturalBreaksPerformance));
 
     return suiteOfTests;
 }
@@ -15,6 +15,8 @@ public:
     void testPropagateForwardsByTime();
     void testSample();
     void testPersist();
+    void testNaturalBreaks();
+    void testNaturalBreaksPerformance();
 
     static CppUnit::Test* suite();
 };
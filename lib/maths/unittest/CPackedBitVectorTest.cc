@@ -274,6 +274,19 @@ void CPackedBitVectorTest::testInner() {
 
     CPPUNIT_ASSERT_EQUAL(566.0, test5.inner(test6));
 
+    // Runs which end at the same position in the two vectors where the
+    // run in one vector is a continuation of a run longer than the maximum
+    // run length.
+    TBoolVec longRunBits1(267, true);
+    std::fill_n(longRunBits1.begin(), 4, false);
+    TBoolVec longRunBits2(267, false);
+    std::fill_n(longRunBits2.begin(), 259, true);
+    maths::CPackedBitVector longRuns1(longRunBits1);
+    maths::CPackedBitVector longRuns2(longRunBits2);
+    CPPUNIT_ASSERT_EQUAL(255.0, longRuns1.inner(longRuns2));
+    CPPUNIT_ASSERT_EQUAL(267.0, longRuns1.inner(longRuns2, maths::CPackedBitVector::E_OR));
+    CPPUNIT_ASSERT_EQUAL(12.0, longRuns1.inner(longRuns2, maths::CPackedBitVector::E_XOR));
+
     test::CRandomNumbers rng;
 
     TPackedBitVectorVec test7;
@@ -343,6 +356,115 @@ void CPackedBitVectorTest::testBitwiseOr() {
     }
 }
 
+void CPackedBitVectorTest::testPacked() {
+    // Test that dense vectors switch to the packed representation
+    // and that all operations are independent of the representation.
+
+    using TDoubleVec = std::vector<double>;
+
+    test::CRandomNumbers rng;
+
+    TPackedBitVectorVec test;
+    std::vector<TBoolVec> comparison;
+
+    TDoubleVec u;
+    for (std::size_t t = 0u; t < 20; ++t) {
+        double p = t % 4 == 0 ? 0.5 : (t % 4 == 1 ? 0.005 : (t % 4 == 2 ? 0.995 : 0.2));
+        rng.generateUniformSamples(0.0, 1.0, 700, u);
+        TBoolVec bits;
+        for (std::size_t i = 0u; i < u.size(); ++i) {
+            bits.push_back(u[i] < p);
+        }
+        if (t % 2 == 0) {
+            test.push_back(maths::CPackedBitVector(bits));
+        } else {
+            test.push_back(maths::CPackedBitVector());
+            for (std::size_t i = 0u; i < bits.size(); ++i) {
+                test.back().extend(bits[i]);
+            }
+        }
+        comparison.push_back(bits);
+    }
+
+    CPPUNIT_ASSERT(test[0].packed());
+    CPPUNIT_ASSERT(!test[1].packed());
+    CPPUNIT_ASSERT(test[0].memoryUsage() <= 700 / 8 + 8);
+
+    for (std::size_t i = 0u; i < test.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(comparison[i]),
+                             core::CContainerPrinter::print(test[i].toBitVector()));
+        for (std::size_t j = 0u; j < test.size(); ++j) {
+            double expected[3] = {0.0, 0.0, 0.0};
+            for (std::size_t k = 0u; k < comparison[i].size(); ++k) {
+                expected[0] += comparison[i][k] && comparison[j][k] ? 1.0 : 0.0;
+                expected[1] += comparison[i][k] || comparison[j][k] ? 1.0 : 0.0;
+                expected[2] += comparison[i][k] != comparison[j][k] ? 1.0 : 0.0;
+            }
+            CPPUNIT_ASSERT_EQUAL(expected[0], test[i].inner(test[j]));
+            CPPUNIT_ASSERT_EQUAL(
+                expected[1], test[i].inner(test[j], maths::CPackedBitVector::E_OR));
+            CPPUNIT_ASSERT_EQUAL(
+                expected[2], test[i].inner(test[j], maths::CPackedBitVector::E_XOR));
+        }
+    }
+
+    LOG_DEBUG(<< "Test equality and persistence");
+    for (std::size_t i = 0u; i < test.size(); ++i) {
+        maths::CPackedBitVector rle(comparison[i]);
+        std::string delimited = test[i].toDelimited();
+        CPPUNIT_ASSERT_EQUAL(rle.toDelimited(), delimited);
+        CPPUNIT_ASSERT_EQUAL(rle.checksum(), test[i].checksum());
+        maths::CPackedBitVector restored;
+        CPPUNIT_ASSERT(restored.fromDelimited(delimited));
+        CPPUNIT_ASSERT(restored == test[i]);
+        CPPUNIT_ASSERT_EQUAL(test[i].packed(), restored.packed());
+        CPPUNIT_ASSERT(!(test[i] < restored) && !(restored < test[i]));
+    }
+
+    LOG_DEBUG(<< "Test extend, contract and complement");
+    for (std::size_t i = 0u; i < test.size(); i += 3) {
+        maths::CPackedBitVector vector(test[i]);
+        TBoolVec bits(comparison[i]);
+        for (std::size_t j = 0u; j < 600; ++j) {
+            vector.contract();
+            bits.erase(bits.begin());
+            if (j % 2 == 0) {
+                vector.extend(j % 4 == 0);
+                bits.push_back(j % 4 == 0);
+            }
+        }
+        CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(bits),
+                             core::CContainerPrinter::print(vector.toBitVector()));
+        TBoolVec complement(bits);
+        complement.flip();
+        CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(complement),
+                             core::CContainerPrinter::print(
+                                 vector.complement().toBitVector()));
+    }
+
+    LOG_DEBUG(<< "Test copy and assignment between representations");
+    // The two representations share storage so a vector is no larger
+    // than the run length encoding alone.
+    CPPUNIT_ASSERT(sizeof(maths::CPackedBitVector) <=
+                   sizeof(uint64_t) + sizeof(std::vector<uint8_t>));
+    maths::CPackedBitVector vector(test[1]);
+    CPPUNIT_ASSERT(!vector.packed());
+    vector = test[0];
+    CPPUNIT_ASSERT(vector.packed());
+    CPPUNIT_ASSERT(vector == test[0]);
+    vector = test[1];
+    CPPUNIT_ASSERT(!vector.packed());
+    CPPUNIT_ASSERT(vector == test[1]);
+    maths::CPackedBitVector moved(std::move(test[0]));
+    CPPUNIT_ASSERT(moved.packed());
+    CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(comparison[0]),
+                         core::CContainerPrinter::print(moved.toBitVector()));
+    moved = std::move(vector);
+    CPPUNIT_ASSERT(!moved.packed());
+    CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(comparison[1]),
+                         core::CContainerPrinter::print(moved.toBitVector()));
+}
+
 void CPackedBitVectorTest::testPersist() {
     bool bits[] = {true,  true,  false, false, true,
                    false, false, false, true,  true};
@@ -376,6 +498,8 @@ CppUnit::Test* CPackedBitVectorTest::suite() {
         "CPackedBitVectorTest::testInner", &CPackedBitVectorTest::testInner));
     suiteOfTests->addTest(new CppUnit::TestCaller<CPackedBitVectorTest>(
         "CPackedBitVectorTest::testBitwiseOr", &CPackedBitVectorTest::testBitwiseOr));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CPackedBitVectorTest>(
+        "CPackedBitVectorTest::testPacked", &CPackedBitVectorTest::testPacked));
     suiteOfTests->addTest(new CppUnit::TestCaller<CPackedBitVectorTest>(
         "CPackedBitVectorTest::testPersist", &CPackedBitVectorTest::testPersist));
 
@@ -17,6 +17,7 @@ public:
     void testOperators();
     void testInner();
     void testBitwiseOr();
+    void testPacked();
     void testPersist();
 
     static CppUnit::Test* suite();
@@ -138,7 +138,40 @@ void CQDigestTest::testAdd() {
 }
 
 void CQDigestTest::testMerge() {
-    // TODO
+    // Test that merging q-digests of a partition of some data gives
+    // similar quantiles to a single q-digest of all the data.
+
+    CRandomNumbers generator;
+
+    TDoubleVec samples;
+    generator.generateUniformSamples(0.0, 5000.0, 5000u, samples);
+
+    CQDigest qDigest(100u);
+    CQDigest partitions[]{{100u}, {100u}, {100u}};
+    for (std::size_t i = 0u; i < samples.size(); ++i) {
+        uint32_t sample = static_cast<uint32_t>(std::floor(samples[i]));
+        qDigest.add(sample);
+        partitions[i % 3].add(sample);
+    }
+
+    CQDigest merged(100u);
+    for (const auto& partition : partitions) {
+        merged.merge(partition);
+        CPPUNIT_ASSERT(merged.checkInvariants());
+    }
+    LOG_DEBUG(<< "merged = " << merged.print());
+
+    CPPUNIT_ASSERT_EQUAL(qDigest.n(), merged.n());
+
+    for (double q = 0.05; q < 1.0; q += 0.05) {
+        uint32_t expected;
+        uint32_t actual;
+        CPPUNIT_ASSERT(qDigest.quantile(q, expected));
+        CPPUNIT_ASSERT(merged.quantile(q, actual));
+        LOG_DEBUG(<< "q = " << q << ", expected = " << expected << ", actual = " << actual);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(static_cast<double>(expected),
+                                     static_cast<double>(actual), 0.03 * 5000.0);
+    }
 }
 
 void CQDigestTest::testCdf() {
@@ -568,6 +601,44 @@ void CQDigestTest::testPersist() {
     CPPUNIT_ASSERT_EQUAL(origXml, newXml);
 }
 
+void CQDigestTest::testMemoryUsage() {
+    // Check that the memory used grows with the number of nodes in
+    // the q-digest and that it doesn't grow with repeated scaling.
+
+    CRandomNumbers generator;
+
+    CQDigest qDigest(200u);
+    std::size_t initial{qDigest.memoryUsage()};
+    LOG_DEBUG(<< "initial = " << initial);
+
+    for (uint32_t i = 0u; i < 100; ++i) {
+        qDigest.add(i % 5);
+    }
+    std::size_t fewValues{qDigest.memoryUsage()};
+    LOG_DEBUG(<< "few values = " << fewValues);
+    CPPUNIT_ASSERT(fewValues < 2 * initial);
+
+    TDoubleVec samples;
+    generator.generateUniformSamples(0.0, 5000.0, 5000u, samples);
+    for (std::size_t i = 0u; i < samples.size(); ++i) {
+        qDigest.add(static_cast<uint32_t>(std::floor(samples[i])));
+    }
+    std::size_t manyValues{qDigest.memoryUsage()};
+    LOG_DEBUG(<< "many values = " << manyValues);
+    CPPUNIT_ASSERT(manyValues > 20 * initial);
+
+    for (std::size_t i = 0u; i < 40; ++i) {
+        qDigest.scale(i % 2 == 0 ? 2.0 : 0.5);
+        CPPUNIT_ASSERT(qDigest.checkInvariants());
+    }
+    std::size_t scaled{qDigest.memoryUsage()};
+    LOG_DEBUG(<< "after scaling = " << scaled);
+    CPPUNIT_ASSERT(scaled < 2 * manyValues);
+
+    qDigest.clear();
+    CPPUNIT_ASSERT_EQUAL(scaled, qDigest.memoryUsage());
+}
+
 CppUnit::Test* CQDigestTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CQDigestTest");
 
@@ -585,6 +656,8 @@ CppUnit::Test* CQDigestTest::suite() {
         "CQDigestTest::testScale", &CQDigestTest::testScale));
     suiteOfTests->addTest(new CppUnit::TestCaller<CQDigestTest>(
         "CQDigestTest::testPersist", &CQDigestTest::testPersist));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CQDigestTest>(
+        "CQDigestTest::testMemoryUsage", &CQDigestTest::testMemoryUsage));
 
     return suiteOfTests;
 }
@@ -18,6 +18,7 @@ public:
     void testPropagateForwardByTime();
     void testScale();
     void testPersist();
+    void testMemoryUsage();
 
     static CppUnit::Test* suite();
 };
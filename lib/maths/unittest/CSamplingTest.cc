@@ -8,6 +8,9 @@
 
 #include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
+#include <core/CRapidXmlParser.h>
+#include <core/CRapidXmlStatePersistInserter.h>
+#include <core/CRapidXmlStateRestoreTraverser.h>
 
 #include <maths/CBasicStatistics.h>
 #include <maths/CSampling.h>
@@ -213,6 +216,64 @@ void CSamplingTest::testMultivariateNormalSample() {
     }
 }
 
+void CSamplingTest::testScopedContext() {
+    // Check that each context's random numbers don't depend on sampling
+    // in other contexts and that a context's generator is persisted and
+    // restored.
+
+    maths::CSampling::CContext context1;
+    maths::CSampling::CContext context2;
+
+    TDoubleVec expected;
+    {
+        maths::CSampling::CScopedContext scope(context1);
+        maths::CSampling::uniformSample(0.0, 1.0, 10, expected);
+    }
+
+    // Interleave sampling in the process's and another context.
+    TDoubleVec samples;
+    for (std::size_t i = 0u; i < 10; ++i) {
+        {
+            maths::CSampling::CScopedContext scope(context2);
+            samples.push_back(maths::CSampling::uniformSample(0.0, 1.0));
+        }
+        {
+            maths::CSampling::CScopedContext scope(context1);
+            maths::CSampling::normalSample(0.0, 1.0);
+        }
+        maths::CSampling::uniformSample(std::size_t(0), std::size_t(10));
+    }
+
+    std::string persistedXml;
+    {
+        maths::CSampling::CScopedContext scope(context2);
+        core::CRapidXmlStatePersistInserter inserter("root");
+        maths::CSampling::staticsAcceptPersistInserter(inserter);
+        inserter.toXml(persistedXml);
+    }
+    LOG_DEBUG(<< "expected = " << core::CContainerPrinter::print(expected));
+    LOG_DEBUG(<< "samples  = " << core::CContainerPrinter::print(samples));
+    CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(expected),
+                         core::CContainerPrinter::print(samples));
+
+    maths::CSampling::CContext restored;
+    {
+        maths::CSampling::CScopedContext scope(restored);
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(persistedXml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        CPPUNIT_ASSERT(traverser.traverseSubLevel(
+            &maths::CSampling::staticsAcceptRestoreTraverser));
+        maths::CSampling::uniformSample(0.0, 1.0, 5, samples);
+    }
+    {
+        maths::CSampling::CScopedContext scope(context2);
+        maths::CSampling::uniformSample(0.0, 1.0, 5, expected);
+    }
+    CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(expected),
+                         core::CContainerPrinter::print(samples));
+}
+
 CppUnit::Test* CSamplingTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CSamplingTest");
 
@@ -221,6 +282,8 @@ CppUnit::Test* CSamplingTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CSamplingTest>(
         "CSamplingTest::testMultivariateNormalSample",
         &CSamplingTest::testMultivariateNormalSample));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CSamplingTest>(
+        "CSamplingTest::testScopedContext", &CSamplingTest::testScopedContext));
 
     return suiteOfTests;
 }
@@ -798,6 +798,47 @@ void CSeasonalComponentAdaptiveBucketingTest::testName() {
                          bucketing.name());
 }
 
+void CSeasonalComponentAdaptiveBucketingTest::testMemoryUsage() {
+    // Test the memory used for each bucket and that the bucket update
+    // times are preserved exactly for times which don't fit in 32 bits.
+
+    maths::CDiurnalTime time(0, 0, core::constants::WEEK, core::constants::DAY);
+
+    for (std::size_t n : {10, 20, 40}) {
+        maths::CSeasonalComponentAdaptiveBucketing bucketing(time, 0.1, 1.0);
+        bucketing.initialize(n);
+
+        core_t::TTime start{5000000000};
+        for (core_t::TTime t = start; t < start + 10 * core::constants::DAY; t += 600) {
+            double x{static_cast<double>(t % core::constants::DAY) / 86400.0};
+            double y{20.0 + 10.0 * std::sin(boost::math::double_constants::two_pi * x)};
+            bucketing.add(t, y, y);
+        }
+
+        // The regression, variance and update times, the end point,
+        // centre and large error count.
+        std::size_t expectedMemoryPerBucket{24 + 4 + 4 + 8 + 3 * 4};
+        std::size_t memory{bucketing.memoryUsage()};
+        LOG_DEBUG(<< "memory = " << memory << ", buckets = " << bucketing.size());
+        CPPUNIT_ASSERT(memory <= expectedMemoryPerBucket * bucketing.size() + 4);
+
+        std::string origXml;
+        {
+            core::CRapidXmlStatePersistInserter inserter("root");
+            bucketing.acceptPersistInserter(inserter);
+            inserter.toXml(origXml);
+        }
+        CPPUNIT_ASSERT(origXml.find("<g>5000000000</g>") != std::string::npos);
+        CPPUNIT_ASSERT(origXml.find("<h>5000863400</h>") != std::string::npos);
+
+        core::CRapidXmlParser parser;
+        CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(origXml));
+        core::CRapidXmlStateRestoreTraverser traverser(parser);
+        maths::CSeasonalComponentAdaptiveBucketing restoredBucketing(0.1, 1.0, traverser);
+        CPPUNIT_ASSERT_EQUAL(bucketing.checksum(), restoredBucketing.checksum());
+    }
+}
+
 CppUnit::Test* CSeasonalComponentAdaptiveBucketingTest::suite() {
     CppUnit::TestSuite* suiteOfTests =
         new CppUnit::TestSuite("CSeasonalComponentAdaptiveBucketingTest");
@@ -841,6 +882,9 @@ CppUnit::Test* CSeasonalComponentAdaptiveBucketingTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CSeasonalComponentAdaptiveBucketingTest>(
         "CSeasonalComponentAdaptiveBucketingTest::testName",
         &CSeasonalComponentAdaptiveBucketingTest::testName));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CSeasonalComponentAdaptiveBucketingTest>(
+        "CSeasonalComponentAdaptiveBucketingTest::testMemoryUsage",
+        &CSeasonalComponentAdaptiveBucketingTest::testMemoryUsage));
 
     return suiteOfTests;
 }
@@ -24,6 +24,7 @@ public:
     void testPersist();
     void testUpgrade();
     void testName();
+    void testMemoryUsage();
 
     static CppUnit::Test* suite();
 };
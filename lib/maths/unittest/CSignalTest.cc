@@ -7,6 +7,7 @@
 #include "CSignalTest.h"
 
 #include <core/CLogger.h>
+#include <core/CStopWatch.h>
 #include <core/CoreTypes.h>
 
 #include <maths/CSignal.h>
@@ -323,6 +324,50 @@ void CSignalTest::testFFTIFFTIdempotency() {
     }
 }
 
+void CSignalTest::testRealFFT() {
+    // Test the real transforms versus the complex transforms for both
+    // odd and even lengths.
+
+    test::CRandomNumbers rng;
+
+    TSizeVec lengths;
+    rng.generateUniformSamples(1, 200, 100, lengths);
+
+    for (auto length : lengths) {
+        TDoubleVec x;
+        rng.generateUniformSamples(-100000.0, 100000.0, length, x);
+
+        maths::CSignal::TComplexVec expected(x.begin(), x.end());
+        maths::CSignal::fft(expected);
+
+        maths::CSignal::TComplexVec actual;
+        maths::CSignal::fft(x, actual);
+
+        CPPUNIT_ASSERT_EQUAL(length / 2 + 1, actual.size());
+        double error = 0.0;
+        for (std::size_t k = 0u; k < actual.size(); ++k) {
+            error += std::abs(actual[k] - expected[k]);
+        }
+        if (error >= 1e-5) {
+            LOG_DEBUG(<< "length = " << length << ", error  = " << error);
+        }
+        CPPUNIT_ASSERT(error < 1e-5);
+
+        TDoubleVec inverse;
+        maths::CSignal::ifft(actual, length, inverse);
+
+        CPPUNIT_ASSERT_EQUAL(length, inverse.size());
+        error = 0.0;
+        for (std::size_t i = 0u; i < inverse.size(); ++i) {
+            error += std::fabs(inverse[i] - x[i]);
+        }
+        if (error >= 1e-5) {
+            LOG_DEBUG(<< "length = " << length << ", error  = " << error);
+        }
+        CPPUNIT_ASSERT(error < 1e-5);
+    }
+}
+
 void CSignalTest::testAutocorrelations() {
     test::CRandomNumbers rng;
 
@@ -355,6 +400,54 @@ void CSignalTest::testAutocorrelations() {
     }
 }
 
+void CSignalTest::testFFTPerformance() {
+    // Benchmark the autocorrelation calculation at the window lengths the
+    // periodicity tests use, i.e. 336 buckets padded by one third, and
+    // compare with constructing a new plan for every transform.
+
+    test::CRandomNumbers rng;
+
+    core::CStopWatch watch;
+
+    for (auto length : TSizeVec{336, 448, 672, 1000}) {
+        TDoubleVec values_;
+        rng.generateUniformSamples(-10.0, 10.0, length, values_);
+
+        maths::CSignal::TFloatMeanAccumulatorVec values(length);
+        maths::CSignal::TComplexVec f;
+        for (std::size_t i = 0u; i < values_.size(); ++i) {
+            values[i].add(values_[i]);
+            f.emplace_back(values_[i], 0.0);
+        }
+
+        TDoubleVec correlations;
+        watch.reset(true);
+        for (std::size_t t = 0u; t < 1000; ++t) {
+            correlations.clear();
+            maths::CSignal::autocorrelations(values, correlations);
+        }
+        std::uint64_t autocorrelations{watch.stop()};
+
+        watch.reset(true);
+        for (std::size_t t = 0u; t < 1000; ++t) {
+            maths::CSignal::fft(f);
+            maths::CSignal::ifft(f);
+        }
+        std::uint64_t planned{watch.stop()};
+
+        watch.reset(true);
+        for (std::size_t t = 0u; t < 1000; ++t) {
+            maths::CSignal::CFftPlan plan(f.size());
+            plan.fft(f);
+            plan.ifft(f);
+        }
+        std::uint64_t unplanned{watch.stop()};
+
+        LOG_DEBUG(<< "length = " << length << ", autocorrelations = " << autocorrelations
+                  << "ms, cached plan = " << planned << "ms, new plan = " << unplanned << "ms");
+    }
+}
+
 CppUnit::Test* CSignalTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CSignalTest");
 
@@ -368,8 +461,12 @@ CppUnit::Test* CSignalTest::suite() {
         "CSignalTest::testIFFTRandomized", &CSignalTest::testIFFTRandomized));
     suiteOfTests->addTest(new CppUnit::TestCaller<CSignalTest>(
         "CSignalTest::testFFTIFFTIdempotency", &CSignalTest::testFFTIFFTIdempotency));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CSignalTest>(
+        "CSignalTest::testRealFFT", &CSignalTest::testRealFFT));
     suiteOfTests->addTest(new CppUnit::TestCaller<CSignalTest>(
         "CSignalTest::testAutocorrelations", &CSignalTest::testAutocorrelations));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CSignalTest>(
+        "CSignalTest::testFFTPerformance", &CSignalTest::testFFTPerformance));
 
     return suiteOfTests;
 }
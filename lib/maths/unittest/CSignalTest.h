@@ -16,7 +16,9 @@ public:
     void testFFTRandomized();
     void testIFFTRandomized();
     void testFFTIFFTIdempotency();
+    void testRealFFT();
     void testAutocorrelations();
+    void testFFTPerformance();
 
     static CppUnit::Test* suite();
 };
@@ -16,6 +16,7 @@
 
 #include <maths/CDecayRateController.h>
 #include <maths/CIntegerTools.h>
+#include <maths/CMaintenanceScheduler.h>
 #include <maths/CNormalMeanPrecConjugate.h>
 #include <maths/CRestoreParams.h>
 #include <maths/CSeasonalTime.h>
@@ -25,9 +26,11 @@
 #include <test/CRandomNumbers.h>
 #include <test/CTimeSeriesTestData.h>
 
+#include <boost/make_unique.hpp>
 #include <boost/math/constants/constants.hpp>
 
 #include <fstream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -2047,6 +2050,113 @@ void CTimeSeriesDecompositionTest::testPersist() {
     CPPUNIT_ASSERT_EQUAL(origXml, newXml);
 }
 
+void CTimeSeriesDecompositionTest::testPersistDelayedTest() {
+    // Check that restoring part way through a bucket in which a test
+    // has been deferred doesn't change when the test runs: the restored
+    // decomposition must detect the same components at the same time
+    // and make the same predictions as the original.
+
+    using TContextPtr = std::unique_ptr<maths::CMaintenanceScheduler::CContext>;
+
+    const double decayRate = 0.01;
+    const core_t::TTime bucketLength = HALF_HOUR;
+
+    test::CRandomNumbers rng;
+    TDoubleVec noise;
+    rng.generateNormalSamples(0.0, 4.0, 3 * (2 * WEEK / bucketLength), noise);
+
+    auto value = [](core_t::TTime time) {
+        return 15.0 + (time < DAY ? 0.0
+                                  : 10.0 * std::sin(boost::math::double_constants::two_pi *
+                                                    static_cast<double>(time) /
+                                                    static_cast<double>(DAY)));
+    };
+
+    // With no budget every test is deferred.
+    maths::CMaintenanceScheduler::CContext origContext;
+    {
+        maths::CMaintenanceScheduler::CScopedContext scope{origContext};
+        maths::CMaintenanceScheduler::budget(0);
+    }
+    maths::CTimeSeriesDecomposition origDecomposition(decayRate, bucketLength);
+    TContextPtr restoredContext;
+    std::unique_ptr<maths::CTimeSeriesDecomposition> restoredDecomposition;
+
+    core_t::TTime restoreTime{3 * DAY};
+    core_t::TTime detectionTime{0};
+    std::size_t i{0};
+    for (core_t::TTime time = 0; time < 2 * WEEK; time += bucketLength) {
+        // Add several values per bucket, as a population model would.
+        for (core_t::TTime offset : {0, 600, 1200}) {
+            {
+                maths::CMaintenanceScheduler::CScopedContext scope{origContext};
+                origDecomposition.addPoint(time + offset, value(time + offset) + noise[i]);
+            }
+            if (restoredDecomposition != nullptr) {
+                maths::CMaintenanceScheduler::CScopedContext scope{*restoredContext};
+                restoredDecomposition->addPoint(time + offset,
+                                                value(time + offset) + noise[i]);
+                CPPUNIT_ASSERT_EQUAL(origDecomposition.seasonalComponents().size(),
+                                     restoredDecomposition->seasonalComponents().size());
+            }
+            if (detectionTime == 0 && origDecomposition.seasonalComponents().size() > 0) {
+                detectionTime = time + offset;
+            }
+            ++i;
+
+            if (time + offset == restoreTime) {
+                std::string schedulerXml;
+                {
+                    core::CRapidXmlStatePersistInserter inserter("root");
+                    origContext.acceptPersistInserter(inserter);
+                    inserter.toXml(schedulerXml);
+                }
+                std::string decompositionXml;
+                {
+                    core::CRapidXmlStatePersistInserter inserter("root");
+                    origDecomposition.acceptPersistInserter(inserter);
+                    inserter.toXml(decompositionXml);
+                }
+                LOG_TRACE(<< "Scheduler XML representation:\n" << schedulerXml);
+
+                restoredContext = boost::make_unique<maths::CMaintenanceScheduler::CContext>();
+                {
+                    core::CRapidXmlParser parser;
+                    CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(schedulerXml));
+                    core::CRapidXmlStateRestoreTraverser traverser(parser);
+                    CPPUNIT_ASSERT(traverser.traverseSubLevel(boost::bind(
+                        &maths::CMaintenanceScheduler::CContext::acceptRestoreTraverser,
+                        restoredContext.get(), _1)));
+                    maths::CMaintenanceScheduler::CScopedContext scope{*restoredContext};
+                    maths::CMaintenanceScheduler::budget(0);
+                }
+                {
+                    core::CRapidXmlParser parser;
+                    CPPUNIT_ASSERT(parser.parseStringIgnoreCdata(decompositionXml));
+                    core::CRapidXmlStateRestoreTraverser traverser(parser);
+                    maths::STimeSeriesDecompositionRestoreParams params{
+                        decayRate, bucketLength,
+                        maths::SDistributionRestoreParams{maths_t::E_ContinuousData, decayRate}};
+                    restoredDecomposition =
+                        boost::make_unique<maths::CTimeSeriesDecomposition>(params, traverser);
+                }
+            }
+        }
+    }
+    LOG_DEBUG(<< "restored at " << restoreTime << ", detected at " << detectionTime);
+
+    CPPUNIT_ASSERT(restoredDecomposition != nullptr);
+    CPPUNIT_ASSERT(detectionTime > restoreTime + bucketLength);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), origDecomposition.seasonalComponents().size());
+
+    for (core_t::TTime time = 2 * WEEK; time < 2 * WEEK + DAY; time += bucketLength) {
+        TDoubleDoublePr expected{origDecomposition.value(time, 0.0)};
+        TDoubleDoublePr actual{restoredDecomposition->value(time, 0.0)};
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.first, actual.first, 1e-3);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(expected.second, actual.second, 1e-3);
+    }
+}
+
 void CTimeSeriesDecompositionTest::testUpgrade() {
     // Check we can validly upgrade existing state.
 
@@ -2350,6 +2460,9 @@ CppUnit::Test* CTimeSeriesDecompositionTest::suite() {
         "CTimeSeriesDecompositionTest::testSwap", &CTimeSeriesDecompositionTest::testSwap));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
         "CTimeSeriesDecompositionTest::testPersist", &CTimeSeriesDecompositionTest::testPersist));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
+        "CTimeSeriesDecompositionTest::testPersistDelayedTest",
+        &CTimeSeriesDecompositionTest::testPersistDelayedTest));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesDecompositionTest>(
         "CTimeSeriesDecompositionTest::testUpgrade", &CTimeSeriesDecompositionTest::testUpgrade));
 
@@ -32,6 +32,7 @@ public:
     void testComponentLifecycle();
     void testSwap();
     void testPersist();
+    void testPersistDelayedTest();
     void testUpgrade();
 
     static CppUnit::Test* suite();
@@ -7,11 +7,13 @@
 #include "CTimeSeriesModelTest.h"
 
 #include <core/CLogger.h>
+#include <core/CMemoryUsage.h>
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
 
 #include <maths/CDecayRateController.h>
+#include <maths/CGammaRateConjugate.h>
 #include <maths/CLogNormalMeanPrecConjugate.h>
 #include <maths/CMultimodalPrior.h>
 #include <maths/CMultivariateMultimodalPrior.h>
@@ -21,6 +23,7 @@
 #include <maths/CTimeSeriesDecomposition.h>
 #include <maths/CTimeSeriesDecompositionStub.h>
 #include <maths/CTimeSeriesModel.h>
+#include <maths/CTimeSeriesMultibucketFeatures.h>
 #include <maths/CXMeansOnline.h>
 #include <maths/CXMeansOnline1d.h>
 #include <maths/Constants.h>
@@ -31,10 +34,33 @@
 #include "TestUtils.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <memory>
+#include <new>
 
 using namespace ml;
 
+namespace {
+//! Set to count the calling thread's heap allocations.
+thread_local bool countingAllocations{false};
+//! The number of heap allocations counted.
+thread_local std::size_t numberAllocations{0};
+}
+
+void* operator new(std::size_t size) {
+    if (countingAllocations) {
+        ++numberAllocations;
+    }
+    if (void* result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
 namespace {
 using namespace handy_typedefs;
 using TBool2Vec = core::CSmallVector<bool, 2>;
@@ -865,6 +891,82 @@ void CTimeSeriesModelTest::testAddSamples() {
     }
 }
 
+void CTimeSeriesModelTest::testAddSamplesAllocations() {
+    // Test that once a model has warmed up adding samples and computing
+    // probabilities doesn't allocate, except for the occasional periodic
+    // work the trend model does.
+
+    core_t::TTime bucketLength{600};
+
+    test::CRandomNumbers rng;
+
+    TDoubleVec samples;
+    rng.generateNormalSamples(10.0, 4.0, 4000, samples);
+
+    TDouble2VecWeightsAryVec weights{maths_t::CUnitWeights::unit<TDouble2Vec>(1)};
+    maths::CModelAddSamplesParams addParams{addSampleParams(weights)};
+    maths::CModelProbabilityParams probabilityParams{computeProbabilityParams(weights[0])};
+
+    for (auto trended : {false, true}) {
+        LOG_DEBUG(<< (trended ? "Trend" : "No trend"));
+
+        auto controllers = decayRateControllers(1);
+        std::unique_ptr<maths::CTimeSeriesDecompositionInterface> trend;
+        if (trended) {
+            trend.reset(new maths::CTimeSeriesDecomposition{24.0 * DECAY_RATE, bucketLength});
+        } else {
+            trend.reset(new maths::CTimeSeriesDecompositionStub);
+        }
+        maths::CUnivariateTimeSeriesModel model{
+            modelParams(bucketLength), 1, *trend, univariateNormal(), &controllers,
+            nullptr, // no multi-bucket
+            false};
+
+        TTimeDouble2VecSizeTrVec sample{core::make_triple(core_t::TTime{0}, TDouble2Vec{0.0}, TAG)};
+        TTime2Vec1Vec time_{{0}};
+        TDouble2Vec1Vec value_{TDouble2Vec{0.0}};
+        maths::SModelProbabilityResult result;
+
+        std::size_t allocatingAdds{0};
+        std::size_t allocatingProbabilities{0};
+        std::size_t n{0};
+        core_t::TTime time{0};
+        for (std::size_t i = 0u; i < samples.size(); ++i, time += bucketLength) {
+            bool warm{i >= 3000};
+            double offset{trended ? 5.0 * std::sin(boost::math::double_constants::two_pi *
+                                                   static_cast<double>(time) / 86400.0)
+                                  : 0.0};
+
+            sample[0].first = time;
+            sample[0].second[0] = samples[i] + offset;
+            numberAllocations = 0;
+            countingAllocations = warm;
+            model.addSamples(addParams, sample);
+            countingAllocations = false;
+            allocatingAdds += numberAllocations > 0 ? 1 : 0;
+
+            time_[0][0] = time;
+            value_[0][0] = samples[i] + offset;
+            numberAllocations = 0;
+            countingAllocations = warm;
+            model.probability(probabilityParams, time_, value_, result);
+            countingAllocations = false;
+            allocatingProbabilities += numberAllocations > 0 ? 1 : 0;
+
+            n += warm ? 1 : 0;
+        }
+
+        LOG_DEBUG(<< "allocating adds = " << allocatingAdds << "/" << n);
+        LOG_DEBUG(<< "allocating probabilities = " << allocatingProbabilities << "/" << n);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), allocatingProbabilities);
+        if (trended) {
+            CPPUNIT_ASSERT(allocatingAdds < n / 10);
+        } else {
+            CPPUNIT_ASSERT_EQUAL(std::size_t(0), allocatingAdds);
+        }
+    }
+}
+
 void CTimeSeriesModelTest::testPredict() {
     // Test prediction with a trend and with multimodal data.
 
@@ -1196,6 +1298,44 @@ void CTimeSeriesModelTest::testProbability() {
                 }
             }
         }
+
+        LOG_DEBUG(<< "Batch");
+
+        TDouble2Vec1Vec values{{15.0}, {4.0}, {11.0}, {25.0}};
+        maths::CModel::TDouble2VecWeightsAry1Vec batchWeights{weights[0], weights[1],
+                                                              weights[0], weights[1]};
+        maths::CModel::TBool2Vec1Vec bucketEmpty{{false}, {true}, {false}, {false}};
+
+        for (auto calculation : calculations) {
+            for (auto confidence : confidences) {
+                maths::CModelProbabilityParams params;
+                params.addCalculation(calculation)
+                    .seasonalConfidenceInterval(confidence)
+                    .useMultibucketFeatures(false);
+                for (const auto& model : {&model0, &model1}) {
+                    maths::CModel::TModelProbabilityResultVec results;
+                    maths::CModel::TBoolVec successes;
+                    model->probabilities(params, time_, values, batchWeights,
+                                         bucketEmpty, results, successes);
+                    CPPUNIT_ASSERT_EQUAL(values.size(), results.size());
+
+                    for (std::size_t i = 0u; i < values.size(); ++i) {
+                        maths::CModelProbabilityParams params_;
+                        params_.addCalculation(calculation)
+                            .seasonalConfidenceInterval(confidence)
+                            .addBucketEmpty(bucketEmpty[i])
+                            .addWeights(batchWeights[i])
+                            .useMultibucketFeatures(false);
+                        maths::SModelProbabilityResult expected;
+                        model->probability(params_, time_, {values[i]}, expected);
+
+                        CPPUNIT_ASSERT(successes[i]);
+                        CPPUNIT_ASSERT_EQUAL(expected.s_Probability, results[i].s_Probability);
+                        CPPUNIT_ASSERT_EQUAL(expected.s_Tail[0], results[i].s_Tail[0]);
+                    }
+                }
+            }
+        }
     }
 
     LOG_DEBUG(<< "Multivariate");
@@ -2287,6 +2427,117 @@ void CTimeSeriesModelTest::testDaylightSaving() {
     }
 }
 
+void CTimeSeriesModelTest::testNewbornModel() {
+    // Test a newborn model gives the same results and has the same state
+    // as the model it stands in for, that it is promoted once it has seen
+    // enough data and that it is much smaller.
+
+    core_t::TTime bucketLength{600};
+
+    test::CRandomNumbers rng;
+
+    maths::CTimeSeriesDecomposition trend{24.0 * DECAY_RATE, bucketLength};
+    maths::COneOfNPrior::TPriorPtrVec priors;
+    priors.emplace_back(maths::CGammaRateConjugate::nonInformativePrior(
+                            maths_t::E_ContinuousData, 0.0, DECAY_RATE)
+                            .clone());
+    priors.emplace_back(univariateLogNormal().clone());
+    priors.emplace_back(univariateNormal().clone());
+    maths::COneOfNPrior prior{priors, maths_t::E_ContinuousData, DECAY_RATE};
+    auto controllers = decayRateControllers(1);
+    maths::CTimeSeriesMultibucketMean<double> multibucket{12};
+    auto model = std::make_shared<const maths::CUnivariateTimeSeriesModel>(
+        modelParams(bucketLength), 0, trend, prior, &controllers, &multibucket);
+
+    maths::CNewbornTimeSeriesModel prototype{model, 0};
+
+    TDoubleVec samples;
+    TDoubleVec counts;
+    for (std::size_t trial = 0; trial < 20; ++trial) {
+        std::unique_ptr<maths::CModel> newborn{prototype.clone(1)};
+        std::unique_ptr<maths::CModel> full{model->clone(1)};
+
+        rng.generateNormalSamples(10.0, 4.0, 8, samples);
+        rng.generateUniformSamples(0.2, 1.5, 8, counts);
+
+        bool promoted{false};
+        core_t::TTime time{0};
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            TDouble2Vec sample{samples[i]};
+            CPPUNIT_ASSERT_EQUAL(full->winsorisationWeight(0.0, time, sample)[0],
+                                 newborn->winsorisationWeight(0.0, time, sample)[0]);
+            CPPUNIT_ASSERT_EQUAL(full->seasonalWeight(0.0, time)[0],
+                                 newborn->seasonalWeight(0.0, time)[0]);
+
+            TTimeDouble2VecSizeTrVec value{core::make_triple(time, sample, TAG)};
+            TDouble2VecWeightsAryVec weights{maths_t::CUnitWeights::unit<TDouble2Vec>(1)};
+            maths_t::setCount(TDouble2Vec{counts[i]}, weights[0]);
+            full->addBucketValue(value);
+            newborn->addBucketValue(value);
+            CPPUNIT_ASSERT_EQUAL(full->addSamples(addSampleParams(weights), value),
+                                 newborn->addSamples(addSampleParams(weights), value));
+            if (maths::CModel* promoted_ = newborn->promote()) {
+                newborn.reset(promoted_);
+                promoted = true;
+            }
+            CPPUNIT_ASSERT_EQUAL(full->checksum(), newborn->checksum());
+
+            for (auto next : {samples[i], 100.0}) {
+                maths::CModelProbabilityParams params{
+                    computeProbabilityParams(maths_t::CUnitWeights::unit<TDouble2Vec>(1))};
+                params.useMultibucketFeatures(true).useAnomalyModel(true);
+                maths::SModelProbabilityResult expected;
+                maths::SModelProbabilityResult actual;
+                full->probability(params, {{time + bucketLength}}, {{next}}, expected);
+                newborn->probability(params, {{time + bucketLength}}, {{next}}, actual);
+                CPPUNIT_ASSERT_EQUAL(expected.s_Probability, actual.s_Probability);
+                CPPUNIT_ASSERT(expected.s_Tail == actual.s_Tail);
+                CPPUNIT_ASSERT_EQUAL(expected.s_FeatureProbabilities.size(),
+                                     actual.s_FeatureProbabilities.size());
+                for (std::size_t j = 0; j < expected.s_FeatureProbabilities.size(); ++j) {
+                    CPPUNIT_ASSERT_EQUAL(expected.s_FeatureProbabilities[j].s_Probability,
+                                         actual.s_FeatureProbabilities[j].s_Probability);
+                }
+            }
+            CPPUNIT_ASSERT_EQUAL(full->checksum(), newborn->checksum());
+
+            if (i == 1) {
+                // Check the newborn model persists the full model's state.
+                std::string expectedXml;
+                std::string actualXml;
+                {
+                    core::CRapidXmlStatePersistInserter inserter{"root"};
+                    full->acceptPersistInserter(inserter);
+                    inserter.toXml(expectedXml);
+                }
+                {
+                    core::CRapidXmlStatePersistInserter inserter{"root"};
+                    newborn->acceptPersistInserter(inserter);
+                    inserter.toXml(actualXml);
+                }
+                CPPUNIT_ASSERT_EQUAL(expectedXml, actualXml);
+            }
+
+            time += bucketLength;
+        }
+
+        CPPUNIT_ASSERT(promoted);
+        CPPUNIT_ASSERT(dynamic_cast<const maths::CUnivariateTimeSeriesModel*>(
+                           newborn.get()) != nullptr);
+    }
+
+    // Check the newborn models account for the memory they'll use once
+    // they're promoted.
+    std::unique_ptr<maths::CModel> newborn{prototype.clone(1)};
+    std::unique_ptr<maths::CModel> full{model->clone(1)};
+    LOG_DEBUG(<< "newborn size = " << newborn->memoryUsage()
+              << ", full model size = " << full->memoryUsage());
+    CPPUNIT_ASSERT(newborn->memoryUsage() >= full->memoryUsage());
+    std::unique_ptr<core::CMemoryUsage> mem{new core::CMemoryUsage};
+    newborn->debugMemoryUsage(mem.get());
+    CPPUNIT_ASSERT_EQUAL(newborn->memoryUsage(), mem->usage());
+}
+
 CppUnit::Test* CTimeSeriesModelTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CTimeSeriesModelTest");
 
@@ -2298,6 +2549,9 @@ CppUnit::Test* CTimeSeriesModelTest::suite() {
         "CTimeSeriesModelTest::testAddBucketValue", &CTimeSeriesModelTest::testAddBucketValue));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
         "CTimeSeriesModelTest::testAddSamples", &CTimeSeriesModelTest::testAddSamples));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
+        "CTimeSeriesModelTest::testAddSamplesAllocations",
+        &CTimeSeriesModelTest::testAddSamplesAllocations));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
         "CTimeSeriesModelTest::testPredict", &CTimeSeriesModelTest::testPredict));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
@@ -2325,6 +2579,8 @@ CppUnit::Test* CTimeSeriesModelTest::suite() {
         "CTimeSeriesModelTest::testLinearScaling", &CTimeSeriesModelTest::testLinearScaling));
     suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
         "CTimeSeriesModelTest::testDaylightSaving", &CTimeSeriesModelTest::testDaylightSaving));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CTimeSeriesModelTest>(
+        "CTimeSeriesModelTest::testNewbornModel", &CTimeSeriesModelTest::testNewbornModel));
 
     return suiteOfTests;
 }
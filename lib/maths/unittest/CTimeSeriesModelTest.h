@@ -15,6 +15,7 @@ public:
     void testMode();
     void testAddBucketValue();
     void testAddSamples();
+    void testAddSamplesAllocations();
     void testPredict();
     void testProbability();
     void testWeights();
@@ -27,6 +28,7 @@ public:
     void testStepChangeDiscontinuities();
     void testLinearScaling();
     void testDaylightSaving();
+    void testNewbornModel();
 
     static CppUnit::Test* suite();
 };
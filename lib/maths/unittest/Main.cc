@@ -37,6 +37,7 @@
 #include "CLinearAlgebraTest.h"
 #include "CLogNormalMeanPrecConjugateTest.h"
 #include "CLogTDistributionTest.h"
+#include "CMaintenanceSchedulerTest.h"
 #include "CMathsFuncsTest.h"
 #include "CMathsMemoryTest.h"
 #include "CMixtureDistributionTest.h"
@@ -118,6 +119,7 @@ int main(int argc, const char** argv) {
     runner.addTest(CLinearAlgebraTest::suite());
     runner.addTest(CLogNormalMeanPrecConjugateTest::suite());
     runner.addTest(CLogTDistributionTest::suite());
+    runner.addTest(CMaintenanceSchedulerTest::suite());
     runner.addTest(CMathsFuncsTest::suite());
     runner.addTest(CMathsMemoryTest::suite());
     runner.addTest(CMixtureDistributionTest::suite());
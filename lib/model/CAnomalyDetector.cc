@@ -59,6 +59,7 @@ const std::string SAMPLING_TAG("c");
 const std::string DATA_GATHERER_TAG("a");
 const std::string MODELS_TAG("b");
 const std::string MODEL_TAG("d");
+const std::string SCHEDULER_CONTEXT_TAG("f");
 
 CAnomalyDetector::TDataGathererPtr
 makeDataGatherer(const CAnomalyDetector::TModelFactoryCPtr& factory,
@@ -128,6 +129,7 @@ CAnomalyDetector::CAnomalyDetector(bool isForPersistence, const CAnomalyDetector
       m_DataGatherer(other.m_DataGatherer->cloneForPersistence()),
       m_ModelFactory(other.m_ModelFactory), // Shallow copy of model factory is OK
       m_Model(other.m_Model->cloneForPersistence()),
+      m_SchedulerContext(other.m_SchedulerContext),
       // Empty message propagation function is fine in this case
       m_IsForPersistence(isForPersistence) {
     if (!isForPersistence) {
@@ -159,6 +161,7 @@ void CAnomalyDetector::zeroModelsToTime(core_t::TTime time) {
     // have no iterations.
 
     core_t::TTime bucketLength = m_ModelConfig.bucketLength();
+    maths::CMaintenanceScheduler::CScopedContext scheduler(m_SchedulerContext);
 
     while (time >= (m_LastBucketEndTime + bucketLength)) {
         core_t::TTime bucketStartTime = m_LastBucketEndTime;
@@ -227,6 +230,14 @@ bool CAnomalyDetector::legacyModelEnsembleAcceptRestoreTraverser(const std::stri
                 LOG_ERROR(<< "Failed to restore live models from " << traverser.value());
                 return false;
             }
+        } else if (name == SCHEDULER_CONTEXT_TAG) {
+            if (traverser.traverseSubLevel(boost::bind(
+                    &maths::CMaintenanceScheduler::CContext::acceptRestoreTraverser,
+                    &m_SchedulerContext, _1)) == false) {
+                LOG_ERROR(<< "Failed to restore maintenance scheduler from "
+                          << traverser.value());
+                return false;
+            }
         }
     } while (traverser.next());
 
@@ -338,6 +349,9 @@ void CAnomalyDetector::legacyModelEnsembleAcceptPersistInserter(core::CStatePers
     // was around.
     inserter.insertLevel(MODELS_TAG, boost::bind(&CAnomalyDetector::legacyModelsAcceptPersistInserter,
                                                  this, _1));
+    inserter.insertLevel(SCHEDULER_CONTEXT_TAG,
+                         boost::bind(&maths::CMaintenanceScheduler::CContext::acceptPersistInserter,
+                                     &m_SchedulerContext, _1));
 }
 
 void CAnomalyDetector::legacyModelsAcceptPersistInserter(core::CStatePersistInserter& inserter) const {
@@ -394,6 +408,7 @@ void CAnomalyDetector::sample(core_t::TTime startTime,
     }
 
     core_t::TTime bucketLength = m_ModelConfig.bucketLength();
+    maths::CMaintenanceScheduler::CScopedContext scheduler(m_SchedulerContext);
 
     for (core_t::TTime time = startTime; time < endTime; time += bucketLength) {
         m_Model->sample(time, time + bucketLength, resourceMonitor);
@@ -451,6 +466,35 @@ void CAnomalyDetector::generateModelPlot(core_t::TTime bucketStartTime,
     }
 }
 
+void CAnomalyDetector::generateModelPlot(core_t::TTime bucketStartTime,
+                                         core_t::TTime bucketEndTime,
+                                         double boundsPercentile,
+                                         const TStrSet& terms,
+                                         const TOutputModelPlotRowFunc& output) const {
+    if (bucketEndTime <= bucketStartTime) {
+        return;
+    }
+    if (terms.empty() || m_DataGatherer->partitionFieldValue().empty() ||
+        terms.find(m_DataGatherer->partitionFieldValue()) != terms.end()) {
+        const CSearchKey& key = m_DataGatherer->searchKey();
+        TModelDetailsViewPtr view = m_Model.get()->details();
+        if (view.get()) {
+            core_t::TTime bucketLength = m_ModelConfig.bucketLength();
+            for (core_t::TTime time = bucketStartTime; time < bucketEndTime;
+                 time += bucketLength) {
+                CModelPlotData series(time, key.partitionFieldName(),
+                                      m_DataGatherer->partitionFieldValue(),
+                                      key.overFieldName(), key.byFieldName(),
+                                      bucketLength, m_DetectorIndex);
+                view->modelPlot(time, boundsPercentile, terms,
+                                [&series, &output](const CModelPlotData::SRow& row) {
+                                    output(series, row);
+                                });
+            }
+        }
+    }
+}
+
 CForecastDataSink::SForecastModelPrerequisites
 CAnomalyDetector::getForecastPrerequisites() const {
     CForecastDataSink::SForecastModelPrerequisites prerequisites{0, 0, 0, true, false};
@@ -308,6 +308,7 @@ void CAnomalyDetectorModel::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr
     core::CMemoryDebug::dynamicSize("m_Params", m_Params, mem);
     core::CMemoryDebug::dynamicSize("m_PersonBucketCounts", m_PersonBucketCounts, mem);
     core::CMemoryDebug::dynamicSize("m_InfluenceCalculators", m_InfluenceCalculators, mem);
+    core::CMemoryDebug::dynamicSize("m_RuleScopeCache", m_RuleScopeCache, mem);
 }
 
 std::size_t CAnomalyDetectorModel::memoryUsage() const {
@@ -315,6 +316,7 @@ std::size_t CAnomalyDetectorModel::memoryUsage() const {
     mem += core::CMemory::dynamicSize(m_DataGatherer);
     mem += core::CMemory::dynamicSize(m_PersonBucketCounts);
     mem += core::CMemory::dynamicSize(m_InfluenceCalculators);
+    mem += core::CMemory::dynamicSize(m_RuleScopeCache);
     return mem;
 }
 
@@ -431,6 +433,9 @@ void CAnomalyDetectorModel::updateRecycledModels() {
                       << m_PersonBucketCounts.size() << ")");
         }
     }
+    if (people.empty() == false) {
+        m_RuleScopeCache.clear();
+    }
     people.clear();
 }
 
@@ -469,6 +474,14 @@ CAnomalyDetectorModel::scheduledEventDescriptions(core_t::TTime /*time*/) const
     return EMPTY_STRING_LIST;
 }
 
+CRuleScope::CCache& CAnomalyDetectorModel::ruleScopeCache() const {
+    return m_RuleScopeCache;
+}
+
+void CAnomalyDetectorModel::clearRuleScopeCache() {
+    m_RuleScopeCache.clear();
+}
+
 maths::CModel* CAnomalyDetectorModel::tinyModel() {
     return new maths::CModelStub;
 }
@@ -10,6 +10,7 @@
 #include <core/CJsonStatePersistInserter.h>
 #include <core/CJsonStateRestoreTraverser.h>
 #include <core/CLogger.h>
+#include <core/CMemory.h>
 #include <core/CPersistUtils.h>
 #include <core/RestoreMacros.h>
 
@@ -28,6 +29,7 @@
 #include <boost/range.hpp>
 #include <boost/ref.hpp>
 
+#include <algorithm>
 #include <numeric>
 #include <vector>
 
@@ -307,6 +309,66 @@ bool CAnomalyScore::CNormalizer::normalize(double& score,
         return false;
     }
 
+    this->normalize(this->noiseCeiling(), score, partitionName,
+                    partitionValue, personName, personValue);
+
+    return true;
+}
+
+bool CAnomalyScore::CNormalizer::normalizeEach(TDoubleVec& scores,
+                                               const std::string& partitionName,
+                                               const TStrCRefVec& partitionValues,
+                                               const std::string& personName,
+                                               const TStrCRefVec& personValues) const {
+    if (scores.size() != partitionValues.size() || scores.size() != personValues.size()) {
+        LOG_ERROR(<< "Inconsistent input: # scores = " << scores.size() << ", # partitions = "
+                  << partitionValues.size() << ", # people = " << personValues.size());
+        return false;
+    }
+
+    if (std::all_of(scores.begin(), scores.end(),
+                    [](double score) { return score == 0.0; })) {
+        // Nothing to do.
+        return true;
+    }
+
+    if (m_RawScoreQuantileSummary.n() == 0) {
+        LOG_ERROR(<< "No scores have been added to the quantile summary");
+        return false;
+    }
+
+    SNoiseCeiling noiseCeiling{this->noiseCeiling()};
+    for (std::size_t i = 0u; i < scores.size(); ++i) {
+        if (scores[i] != 0.0) {
+            this->normalize(noiseCeiling, scores[i], partitionName,
+                            partitionValues[i], personName, personValues[i]);
+        }
+    }
+
+    return true;
+}
+
+CAnomalyScore::CNormalizer::SNoiseCeiling CAnomalyScore::CNormalizer::noiseCeiling() const {
+    // See normalize for a discussion of the noise ceiling.
+    uint32_t noiseScore;
+    m_RawScoreQuantileSummary.quantile(m_NoisePercentile / 100.0, noiseScore);
+    TDoubleDoublePrVecCItr knotPoint = std::lower_bound(
+        m_NormalizedScoreKnotPoints.begin(), m_NormalizedScoreKnotPoints.end(),
+        TDoubleDoublePr(m_NoisePercentile, 0.0));
+    double l0;
+    double u0;
+    m_RawScoreQuantileSummary.cdf(0, 0.0, l0, u0);
+    return {noiseScore, knotPoint->second,
+            m_MaximumNormalizedScore *
+                std::max(2.0 * std::min(50.0 * (l0 + u0) / m_NoisePercentile, 1.0) - 1.0, 0.0)};
+}
+
+void CAnomalyScore::CNormalizer::normalize(const SNoiseCeiling& noiseCeiling,
+                                           double& score,
+                                           const std::string& partitionName,
+                                           const std::string& partitionValue,
+                                           const std::string& personName,
+                                           const std::string& personValue) const {
     LOG_TRACE(<< "Normalising " << score);
 
     static const double CONFIDENCE_INTERVAL = 70.0;
@@ -353,25 +415,16 @@ bool CAnomalyScore::CNormalizer::normalize(double& score,
     // c.d.f. of the score and pn the noise percentile. We achieve
     // this by adding "max score" * min(F(0) / "noise percentile",
     // to the score.
-    uint32_t noiseScore;
-    m_RawScoreQuantileSummary.quantile(m_NoisePercentile / 100.0, noiseScore);
-    TDoubleDoublePrVecCItr knotPoint = std::lower_bound(
-        m_NormalizedScoreKnotPoints.begin(), m_NormalizedScoreKnotPoints.end(),
-        TDoubleDoublePr(m_NoisePercentile, 0.0));
     double signalStrength =
         m_NoiseMultiplier * 10.0 / DISCRETIZATION_FACTOR *
-        (static_cast<double>(discreteScore) - static_cast<double>(noiseScore));
-    double l0;
-    double u0;
-    m_RawScoreQuantileSummary.cdf(0, 0.0, l0, u0);
+        (static_cast<double>(discreteScore) - static_cast<double>(noiseCeiling.s_NoiseScore));
     normalizedScores[0] =
-        knotPoint->second * std::max(1.0 + signalStrength, 0.0) +
-        m_MaximumNormalizedScore *
-            std::max(2.0 * std::min(50.0 * (l0 + u0) / m_NoisePercentile, 1.0) - 1.0, 0.0);
-    LOG_TRACE(<< "normalizedScores[0] = " << normalizedScores[0]
-              << ", knotPoint = " << knotPoint->second << ", discreteScore = " << discreteScore
-              << ", noiseScore = " << noiseScore << ", l(0) = " << l0
-              << ", u(0) = " << u0 << ", signalStrength = " << signalStrength);
+        noiseCeiling.s_NoiseNormalizedScore * std::max(1.0 + signalStrength, 0.0) +
+        noiseCeiling.s_Offset;
+    LOG_TRACE(<< "normalizedScores[0] = " << normalizedScores[0] << ", noiseNormalizedScore = "
+              << noiseCeiling.s_NoiseNormalizedScore << ", discreteScore = " << discreteScore
+              << ", noiseScore = " << noiseCeiling.s_NoiseScore << ", offset = "
+              << noiseCeiling.s_Offset << ", signalStrength = " << signalStrength);
 
     // Compute the raw normalized score. Note we compute the probability
     // of seeing a lower score on the normal bucket length and convert
@@ -468,8 +521,6 @@ bool CAnomalyScore::CNormalizer::normalize(double& score,
     LOG_TRACE(<< "normalizedScore = " << score << ", partitionId = \""
               << (partitionName + "_" + partitionValue + "_" + personName + "_" + personValue)
               << "\"");
-
-    return true;
 }
 
 bool CAnomalyScore::CNormalizer::maxScore(const std::string& partitionName,
@@ -916,6 +967,25 @@ uint64_t CAnomalyScore::CNormalizer::checksum() const {
     return maths::CChecksum::calculate(seed, m_TimeToQuantileDecay);
 }
 
+void CAnomalyScore::CNormalizer::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CAnomalyScore::CNormalizer");
+    core::CMemoryDebug::dynamicSize("m_NormalizedScoreKnotPoints",
+                                    m_NormalizedScoreKnotPoints, mem);
+    core::CMemoryDebug::dynamicSize("m_MaxScores", m_MaxScores, mem);
+    core::CMemoryDebug::dynamicSize("m_RawScoreQuantileSummary",
+                                    m_RawScoreQuantileSummary, mem);
+    core::CMemoryDebug::dynamicSize("m_RawScoreHighQuantileSummary",
+                                    m_RawScoreHighQuantileSummary, mem);
+}
+
+std::size_t CAnomalyScore::CNormalizer::memoryUsage() const {
+    std::size_t mem = core::CMemory::dynamicSize(m_NormalizedScoreKnotPoints);
+    mem += core::CMemory::dynamicSize(m_MaxScores);
+    mem += core::CMemory::dynamicSize(m_RawScoreQuantileSummary);
+    mem += core::CMemory::dynamicSize(m_RawScoreHighQuantileSummary);
+    return mem;
+}
+
 uint32_t CAnomalyScore::CNormalizer::discreteScore(double rawScore) const {
     return static_cast<uint32_t>(DISCRETIZATION_FACTOR * rawScore + 0.5);
 }
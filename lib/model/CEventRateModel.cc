@@ -231,14 +231,10 @@ void CEventRateModel::sample(core_t::TTime startTime,
         gatherer.sampleNow(time);
         gatherer.featureData(time, bucketLength, m_CurrentBucketStats.s_FeatureData);
 
-        const CIndividualModel::TTimeVec& preSampleLastBucketTimes = this->lastBucketTimes();
-        CIndividualModel::TSizeTimeUMap lastBucketTimesMap;
-        for (const auto& featureData : m_CurrentBucketStats.s_FeatureData) {
-            for (const auto& data : featureData.second) {
-                std::size_t pid = data.first;
-                lastBucketTimesMap[pid] = preSampleLastBucketTimes[pid];
-            }
-        }
+        // The count features have a value for every active person so
+        // it is cheaper to copy all the last bucket times than to look
+        // up the people with data.
+        CIndividualModel::TTimeVec preSampleLastBucketTimes(this->lastBucketTimes());
 
         this->CIndividualModel::sample(time, time + bucketLength, resourceMonitor);
 
@@ -275,21 +271,26 @@ void CEventRateModel::sample(core_t::TTime startTime,
             for (const auto& data_ : data) {
                 std::size_t pid = data_.first;
 
-                maths::CModel* model = this->model(feature, pid);
-                if (!model) {
-                    LOG_ERROR(<< "Missing model for " << this->personName(pid));
+                // Most people in a high cardinality job are silent in any
+                // one bucket and we don't model the empty buckets of sparse
+                // people, so check this before touching their model.
+                core_t::TTime sampleTime = model_t::sampleTime(feature, time, bucketLength);
+                bool ignoreSample = this->shouldIgnoreSample(
+                    feature, pid, model_t::INDIVIDUAL_ANALYSIS_ATTRIBUTE_ID, sampleTime);
+                double emptyBucketWeight = this->emptyBucketWeight(feature, pid, time);
+                if (ignoreSample == false && emptyBucketWeight == 0.0) {
                     continue;
                 }
 
-                core_t::TTime sampleTime = model_t::sampleTime(feature, time, bucketLength);
-                if (this->shouldIgnoreSample(feature, pid, model_t::INDIVIDUAL_ANALYSIS_ATTRIBUTE_ID,
-                                             sampleTime)) {
-                    model->skipTime(sampleTime - lastBucketTimesMap[pid]);
+                maths::CModel* model = this->model(feature, pid);
+                if (!model) {
+                    LOG_ERROR(<< "Missing model for " << this->personName(pid));
                     continue;
                 }
 
-                double emptyBucketWeight = this->emptyBucketWeight(feature, pid, time);
-                if (emptyBucketWeight == 0.0) {
+                if (ignoreSample) {
+                    model->skipTime(sampleTime - preSampleLastBucketTimes[pid]);
+                    this->promoteModel(feature, pid);
                     continue;
                 }
 
@@ -327,6 +328,7 @@ void CEventRateModel::sample(core_t::TTime startTime,
                 if (model->addSamples(params, values) == maths::CModel::E_Reset) {
                     gatherer.resetSampleCount(pid);
                 }
+                this->promoteModel(feature, pid);
             }
         }
 
@@ -367,6 +369,7 @@ bool CEventRateModel::computeProbability(std::size_t pid,
     CProbabilityAndInfluenceCalculator pFeatures(this->params().s_InfluenceCutoff);
     pFeatures.addAggregator(maths::CJointProbabilityOfLessLikelySamples());
     pFeatures.addAggregator(maths::CProbabilityOfExtremeSample());
+    pFeatures.addCache(this->probabilityResultCache(), pid);
 
     bool addPersonProbability{false};
     bool skippedResults{false};
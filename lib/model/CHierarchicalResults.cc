@@ -161,33 +161,38 @@ void aggregateLayer(ITR beginLayer,
                     FACTORY newNode,
                     std::vector<SNode*>& newLayer) {
     using TNodePtrVec = std::vector<SNode*>;
-    using TNodeCPtrNodePtrVecMap = std::map<TNodeCPtr, TNodePtrVec, LESS>;
 
     newLayer.clear();
 
-    TNodeCPtrNodePtrVecMap aggregation;
+    // We group the nodes by sorting rather than using a map from the first
+    // node of each group to its nodes to avoid allocating for each group.
+    // The sort is stable so each group's nodes are in the layer order.
+    TNodePtrVec layer;
+    layer.reserve(std::distance(beginLayer, endLayer));
     for (ITR i = beginLayer; i != endLayer; ++i) {
-        aggregation[address(*i)].push_back(address(*i));
+        layer.push_back(address(*i));
     }
-
-    newLayer.reserve(aggregation.size());
-
-    for (const auto& children : aggregation) {
-        LOG_TRACE(<< "aggregating = " << core::CContainerPrinter::print(children.second));
-        if (children.second.size() > 1) {
+    LESS less;
+    std::stable_sort(layer.begin(), layer.end(), less);
+
+    for (auto i = layer.begin(), j = i; i != layer.end(); i = j) {
+        j = std::find_if(i + 1, layer.end(),
+                         [&](const SNode* node) { return less(*i, node); });
+        LOG_TRACE(<< "aggregating = " << core::CContainerPrinter::print(i, j));
+        if (j - i > 1) {
             SNode& aggregate = (results.*newNode)();
             bool population = false;
-            aggregate.s_Children.reserve(children.second.size());
-            for (const auto& child : children.second) {
-                aggregate.s_Children.push_back(child);
-                child->s_Parent = &aggregate;
-                population |= child->s_Spec.s_IsPopulation;
+            aggregate.s_Children.reserve(j - i);
+            for (auto child = i; child != j; ++child) {
+                aggregate.s_Children.push_back(*child);
+                (*child)->s_Parent = &aggregate;
+                population |= (*child)->s_Spec.s_IsPopulation;
             }
             aggregate.s_Spec.s_IsPopulation = population;
             aggregate.propagateFields();
             newLayer.push_back(&aggregate);
         } else {
-            newLayer.push_back(children.second[0]);
+            newLayer.push_back(*i);
         }
     }
 }
@@ -488,6 +493,58 @@ void swap(SNode& node1, SNode& node2) {
     node1.swap(node2);
 }
 
+const std::size_t CNodeStore::BLOCK_SIZE;
+
+CNodeStore::CNodeStore() : m_Size(0) {
+}
+
+CNodeStore::CNodeStore(const CNodeStore& other) : m_Size(0) {
+    for (const auto& node : other) {
+        this->emplace_back(node);
+    }
+}
+
+CNodeStore::CNodeStore(CNodeStore&& other)
+    : m_Blocks(std::move(other.m_Blocks)), m_Size(other.m_Size) {
+    other.m_Blocks.clear();
+    other.m_Size = 0;
+}
+
+CNodeStore::~CNodeStore() {
+    this->clear();
+}
+
+CNodeStore& CNodeStore::operator=(const CNodeStore& other) {
+    if (this != &other) {
+        this->clear();
+        for (const auto& node : other) {
+            this->emplace_back(node);
+        }
+    }
+    return *this;
+}
+
+CNodeStore& CNodeStore::operator=(CNodeStore&& other) {
+    if (this != &other) {
+        this->clear();
+        m_Blocks.swap(other.m_Blocks);
+        std::swap(m_Size, other.m_Size);
+    }
+    return *this;
+}
+
+void CNodeStore::erase(iterator first) {
+    std::size_t size = first - this->begin();
+    while (m_Size > size) {
+        this->back().~SNode();
+        --m_Size;
+    }
+}
+
+void CNodeStore::clear() {
+    this->erase(this->begin());
+}
+
 } // hierarchical_results_detail::
 
 using namespace hierarchical_results_detail;
@@ -558,8 +615,7 @@ void CHierarchicalResults::addInfluencer(const std::string& name) {
 void CHierarchicalResults::buildHierarchy() {
     using TNodePtrVec = std::vector<SNode*>;
 
-    m_Nodes.erase(std::remove_if(m_Nodes.begin(), m_Nodes.end(), isAggregate),
-                  m_Nodes.end());
+    m_Nodes.erase(std::remove_if(m_Nodes.begin(), m_Nodes.end(), isAggregate));
 
     // To make life easier for downstream code, bring a simple count node
     // to the front of the deque (if there is one).
@@ -725,6 +781,13 @@ std::size_t CHierarchicalResults::resultCount() const {
     return result;
 }
 
+void CHierarchicalResults::clear() {
+    m_Nodes.clear();
+    m_PivotNodes.clear();
+    m_PivotRootNodes.clear();
+    m_ResultType = model_t::CResultType(model_t::CResultType::E_Final);
+}
+
 void CHierarchicalResults::setInterim() {
     m_ResultType.set(model_t::CResultType::E_Interim);
 }
@@ -815,7 +878,7 @@ bool CHierarchicalResults::acceptRestoreTraverser(core::CStateRestoreTraverser&
     do {
         const std::string& name = traverser.name();
         RESTORE_SETUP_TEARDOWN(
-            NODES_1_TAG, m_Nodes.push_back(SNode()),
+            NODES_1_TAG, m_Nodes.emplace_back(),
             traverser.traverseSubLevel(boost::bind(&SNode::acceptRestoreTraverser1,
                                                    boost::ref(m_Nodes.back()),
                                                    _1, boost::ref(nodePointers))),
@@ -913,15 +976,13 @@ std::string CHierarchicalResults::print() const {
 }
 
 CHierarchicalResults::TNode& CHierarchicalResults::newNode() {
-    m_Nodes.push_back(TNode());
-    return m_Nodes.back();
+    return m_Nodes.emplace_back();
 }
 
 CHierarchicalResults::TNode&
 CHierarchicalResults::newLeaf(const TResultSpec& simpleSearch,
                               SAnnotatedProbability& annotatedProbability) {
-    m_Nodes.emplace_back(simpleSearch, annotatedProbability);
-    return m_Nodes.back();
+    return m_Nodes.emplace_back(simpleSearch, annotatedProbability);
 }
 
 CHierarchicalResults::TNode&
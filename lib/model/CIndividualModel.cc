@@ -19,6 +19,7 @@
 #include <maths/COrderings.h>
 #include <maths/CPrior.h>
 #include <maths/CTimeSeriesDecomposition.h>
+#include <maths/CTimeSeriesModel.h>
 
 #include <model/CAnnotatedProbabilityBuilder.h>
 #include <model/CDataGatherer.h>
@@ -68,6 +69,32 @@ const std::string FEATURE_CORRELATE_MODELS_TAG("f");
 //const std::string EXTRA_DATA_TAG("g");
 //const std::string INTERIM_BUCKET_CORRECTOR_TAG("h");
 const std::string MEMORY_ESTIMATOR_TAG("i");
+
+//! Create the model for the new person \p pid of \p feature.
+//!
+//! Where possible new people start with a lightweight newborn model which
+//! shares \p prototype and becomes a copy of it once they have enough data.
+maths::CModel* newModel(const SModelParams& params,
+                        model_t::EFeature feature,
+                        const CAnomalyDetectorModel::TMathsModelSPtr& prototype,
+                        std::size_t pid) {
+    using TUnivariateTimeSeriesModelCPtr =
+        maths::CNewbornTimeSeriesModel::TUnivariateTimeSeriesModelCPtr;
+
+    // Constant and diurnal features don't use a one of n prior and the
+    // multi-bucket feature must be empty whilst the model is newborn.
+    std::size_t windowLength{params.s_MultibucketFeaturesWindowLength};
+    if (model_t::isConstant(feature) || model_t::isDiurnal(feature) ||
+        model_t::isCategorical(feature) || params.s_MultivariateByFields ||
+        (windowLength > 0 &&
+         4 * maths::CNewbornTimeSeriesModel::MAXIMUM_NUMBER_UPDATES >= 3 * windowLength)) {
+        return prototype->clone(pid);
+    }
+    TUnivariateTimeSeriesModelCPtr univariate{
+        std::dynamic_pointer_cast<const maths::CUnivariateTimeSeriesModel>(prototype)};
+    return univariate != nullptr ? new maths::CNewbornTimeSeriesModel{univariate, pid}
+                                 : prototype->clone(pid);
+}
 }
 
 CIndividualModel::CIndividualModel(const SModelParams& params,
@@ -305,6 +332,7 @@ void CIndividualModel::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem)
     core::CMemoryDebug::dynamicSize("m_FeatureCorrelatesModels",
                                     m_FeatureCorrelatesModels, mem);
     core::CMemoryDebug::dynamicSize("m_MemoryEstimator", m_MemoryEstimator, mem);
+    core::CMemoryDebug::dynamicSize("m_ProbabilityResults", m_ProbabilityResults, mem);
 }
 
 std::size_t CIndividualModel::memoryUsage() const {
@@ -322,6 +350,7 @@ std::size_t CIndividualModel::computeMemoryUsage() const {
     mem += core::CMemory::dynamicSize(m_FeatureModels);
     mem += core::CMemory::dynamicSize(m_FeatureCorrelatesModels);
     mem += core::CMemory::dynamicSize(m_MemoryEstimator);
+    mem += core::CMemory::dynamicSize(m_ProbabilityResults);
     return mem;
 }
 
@@ -453,7 +482,8 @@ void CIndividualModel::createNewModels(std::size_t n, std::size_t m) {
         for (auto& feature : m_FeatureModels) {
             core::CAllocationStrategy::reserve(feature.s_Models, newN);
             for (std::size_t pid = feature.s_Models.size(); pid < newN; ++pid) {
-                feature.s_Models.emplace_back(feature.s_NewModel->clone(pid));
+                feature.s_Models.emplace_back(newModel(
+                    this->params(), feature.s_Feature, feature.s_NewModel, pid));
                 for (const auto& correlates : m_FeatureCorrelatesModels) {
                     if (feature.s_Feature == correlates.s_Feature) {
                         feature.s_Models.back()->modelCorrelations(*correlates.s_Models);
@@ -468,10 +498,14 @@ void CIndividualModel::createNewModels(std::size_t n, std::size_t m) {
 void CIndividualModel::updateRecycledModels() {
     for (auto pid : this->dataGatherer().recycledPersonIds()) {
         if (pid < m_FirstBucketTimes.size()) {
+            for (const auto& feature : m_FeatureModels) {
+                m_ProbabilityResults.invalidate(feature.s_Feature, pid);
+            }
             m_FirstBucketTimes[pid] = CAnomalyDetectorModel::TIME_UNSET;
             m_LastBucketTimes[pid] = CAnomalyDetectorModel::TIME_UNSET;
             for (auto& feature : m_FeatureModels) {
-                feature.s_Models[pid].reset(feature.s_NewModel->clone(pid));
+                feature.s_Models[pid].reset(newModel(
+                    this->params(), feature.s_Feature, feature.s_NewModel, pid));
                 for (const auto& correlates : m_FeatureCorrelatesModels) {
                     if (feature.s_Feature == correlates.s_Feature) {
                         feature.s_Models.back()->modelCorrelations(*correlates.s_Models);
@@ -503,6 +537,7 @@ void CIndividualModel::clearPrunedResources(const TSizeVec& people,
                                             const TSizeVec& /*attributes*/) {
     for (auto pid : people) {
         for (auto& feature : m_FeatureModels) {
+            m_ProbabilityResults.invalidate(feature.s_Feature, pid);
             if (pid < feature.s_Models.size()) {
                 feature.s_Models[pid].reset(this->tinyModel());
             }
@@ -538,10 +573,6 @@ double CIndividualModel::probabilityBucketEmpty(model_t::EFeature feature,
 }
 
 const maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pid) const {
-    return const_cast<CIndividualModel*>(this)->model(feature, pid);
-}
-
-maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pid) {
     auto i = std::find_if(m_FeatureModels.begin(), m_FeatureModels.end(),
                           [feature](const SFeatureModels& model) {
                               return model.s_Feature == feature;
@@ -551,6 +582,28 @@ maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pi
                : nullptr;
 }
 
+maths::CModel* CIndividualModel::model(model_t::EFeature feature, std::size_t pid) {
+    m_ProbabilityResults.invalidate(feature, pid);
+    return const_cast<maths::CModel*>(
+        static_cast<const CIndividualModel*>(this)->model(feature, pid));
+}
+
+void CIndividualModel::promoteModel(model_t::EFeature feature, std::size_t pid) {
+    auto i = std::find_if(m_FeatureModels.begin(), m_FeatureModels.end(),
+                          [feature](const SFeatureModels& model) {
+                              return model.s_Feature == feature;
+                          });
+    if (i != m_FeatureModels.end() && pid < i->s_Models.size()) {
+        if (maths::CModel* promoted = i->s_Models[pid]->promote()) {
+            i->s_Models[pid].reset(promoted);
+        }
+    }
+}
+
+CModelTools::CProbabilityResultCache& CIndividualModel::probabilityResultCache() const {
+    return m_ProbabilityResults;
+}
+
 void CIndividualModel::sampleCorrelateModels() {
     for (const auto& feature : m_FeatureCorrelatesModels) {
         feature.s_Models->processSamples();
@@ -628,6 +681,7 @@ void CIndividualModel::doSkipSampling(core_t::TTime startTime, core_t::TTime end
             model->skipTime(gap);
         }
     }
+    m_ProbabilityResults.clear();
 }
 }
 }
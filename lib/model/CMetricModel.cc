@@ -243,6 +243,7 @@ void CMetricModel::sample(core_t::TTime startTime,
                 if (this->shouldIgnoreSample(feature, pid, model_t::INDIVIDUAL_ANALYSIS_ATTRIBUTE_ID,
                                              sampleTime)) {
                     model->skipTime(time - lastBucketTimesMap[pid]);
+                    this->promoteModel(feature, pid);
                     continue;
                 }
 
@@ -313,6 +314,7 @@ void CMetricModel::sample(core_t::TTime startTime,
                 if (model->addSamples(params, values) == maths::CModel::E_Reset) {
                     gatherer.resetSampleCount(pid);
                 }
+                this->promoteModel(feature, pid);
             }
         }
 
@@ -346,6 +348,7 @@ bool CMetricModel::computeProbability(const std::size_t pid,
     CProbabilityAndInfluenceCalculator pJoint(this->params().s_InfluenceCutoff);
     pJoint.addAggregator(maths::CJointProbabilityOfLessLikelySamples());
     pJoint.addAggregator(maths::CProbabilityOfExtremeSample());
+    pJoint.addCache(this->probabilityResultCache(), pid);
 
     bool skippedResults{false};
     for (std::size_t i = 0u, n = gatherer.numberFeatures(); i < n; ++i) {
@@ -45,23 +45,46 @@ void CModelDetailsView::modelPlot(core_t::TTime time,
                                   double boundsPercentile,
                                   const TStrSet& terms,
                                   CModelPlotData& modelPlotData) const {
+    this->modelPlot(time, boundsPercentile, terms,
+                    [&modelPlotData](const CModelPlotData::SRow& row) {
+                        modelPlotData.addRow(row);
+                    });
+}
+
+void CModelDetailsView::modelPlot(core_t::TTime time,
+                                  double boundsPercentile,
+                                  const TStrSet& terms,
+                                  const CModelPlotData::TRowFunc& output) const {
+    TByFieldBoundsVec bounds;
     for (auto feature : this->features()) {
         if (!model_t::isConstant(feature) && !model_t::isCategorical(feature)) {
+            bounds.assign(this->maxByFieldId(), SByFieldBounds{});
             if (terms.empty() || !this->hasByField()) {
-                for (std::size_t byFieldId = 0; byFieldId < this->maxByFieldId(); ++byFieldId) {
+                for (std::size_t byFieldId = 0; byFieldId < bounds.size(); ++byFieldId) {
                     this->modelPlotForByFieldId(time, boundsPercentile, feature,
-                                                byFieldId, modelPlotData);
+                                                byFieldId, bounds[byFieldId]);
                 }
             } else {
                 for (const auto& term : terms) {
                     std::size_t byFieldId(0);
-                    if (this->byFieldId(term, byFieldId)) {
+                    if (this->byFieldId(term, byFieldId) && byFieldId < bounds.size()) {
                         this->modelPlotForByFieldId(time, boundsPercentile, feature,
-                                                    byFieldId, modelPlotData);
+                                                    byFieldId, bounds[byFieldId]);
                     }
                 }
             }
-            this->addCurrentBucketValues(time, feature, terms, modelPlotData);
+
+            this->addCurrentBucketValues(time, feature, terms, bounds, output);
+
+            // By field values without an actual value get a single row
+            // with just the model bounds.
+            for (std::size_t byFieldId = 0; byFieldId < bounds.size(); ++byFieldId) {
+                const SByFieldBounds& bound = bounds[byFieldId];
+                if (bound.s_Valid && !bound.s_HasActual) {
+                    output({feature, &this->byFieldValue(byFieldId), bound.s_LowerBound,
+                            bound.s_UpperBound, bound.s_Median, nullptr, 0.0});
+                }
+            }
         }
     }
 }
@@ -70,7 +93,7 @@ void CModelDetailsView::modelPlotForByFieldId(core_t::TTime time,
                                               double boundsPercentile,
                                               model_t::EFeature feature,
                                               std::size_t byFieldId,
-                                              CModelPlotData& modelPlotData) const {
+                                              SByFieldBounds& bounds) const {
     using TDouble1VecDouble1VecPr = std::pair<TDouble1Vec, TDouble1Vec>;
     using TDouble2Vec = core::CSmallVector<double, 2>;
     using TDouble2Vec3Vec = core::CSmallVector<TDouble2Vec, 3>;
@@ -102,8 +125,10 @@ void CModelDetailsView::modelPlotForByFieldId(core_t::TTime time,
             TDouble2Vec median = maths::CTools::truncate(interval[1], lower, upper);
 
             // TODO This data structure should support multivariate features.
-            modelPlotData.get(feature, this->byFieldValue(byFieldId)) =
-                CModelPlotData::SByFieldData(lower[0], upper[0], median[0]);
+            bounds.s_Valid = true;
+            bounds.s_LowerBound = lower[0];
+            bounds.s_UpperBound = upper[0];
+            bounds.s_Median = median[0];
         }
     }
 }
@@ -111,7 +136,8 @@ void CModelDetailsView::modelPlotForByFieldId(core_t::TTime time,
 void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
                                                model_t::EFeature feature,
                                                const TStrSet& terms,
-                                               CModelPlotData& modelPlotData) const {
+                                               TByFieldBoundsVec& bounds,
+                                               const CModelPlotData::TRowFunc& output) const {
     const CDataGatherer& gatherer = this->base().dataGatherer();
     if (!gatherer.dataAvailable(time)) {
         return;
@@ -126,7 +152,12 @@ void CModelDetailsView::addCurrentBucketValues(core_t::TTime time,
             if (!value.empty()) {
                 const std::string& overFieldValue{
                     isPopulation ? this->base().personName(pid) : EMPTY_STRING};
-                modelPlotData.get(feature, byFieldValue).addValue(overFieldValue, value[0]);
+                std::size_t byFieldId{this->byFieldId(pid, cid)};
+                SByFieldBounds none;
+                SByFieldBounds& bound = byFieldId < bounds.size() ? bounds[byFieldId] : none;
+                bound.s_HasActual = true;
+                output({feature, &byFieldValue, bound.s_LowerBound, bound.s_UpperBound,
+                        bound.s_Median, &overFieldValue, value[0]});
             }
         }
     };
@@ -177,6 +208,10 @@ bool CModelDetailsView::byFieldId(const std::string& byFieldValue, std::size_t&
                : this->base().dataGatherer().personId(byFieldValue, result);
 }
 
+std::size_t CModelDetailsView::byFieldId(std::size_t pid, std::size_t cid) const {
+    return this->base().isPopulation() ? cid : pid;
+}
+
 const std::string& CModelDetailsView::byFieldValue(std::size_t byFieldId) const {
     return this->base().isPopulation() ? this->base().attributeName(byFieldId)
                                        : this->base().personName(byFieldId);
@@ -186,6 +186,34 @@ CModelPlotData::SByFieldData& CModelPlotData::get(const model_t::EFeature& featu
     return m_DataPerFeature[feature][byFieldValue];
 }
 
+void CModelPlotData::addRow(const SRow& row) {
+    SByFieldData& data = this->get(row.s_Feature, *row.s_ByFieldValue);
+    data.s_LowerBound = row.s_LowerBound;
+    data.s_UpperBound = row.s_UpperBound;
+    data.s_Median = row.s_Median;
+    if (row.s_OverFieldValue != nullptr) {
+        data.addValue(*row.s_OverFieldValue, row.s_Actual);
+    }
+}
+
+void CModelPlotData::forEachRow(const TRowFunc& f) const {
+    for (const auto& featureData : m_DataPerFeature) {
+        for (const auto& byFieldData : featureData.second) {
+            const SByFieldData& data = byFieldData.second;
+            SRow row{featureData.first, &byFieldData.first, data.s_LowerBound,
+                     data.s_UpperBound, data.s_Median, nullptr, 0.0};
+            if (data.s_ValuesPerOverField.empty()) {
+                f(row);
+            }
+            for (const auto& value : data.s_ValuesPerOverField) {
+                row.s_OverFieldValue = &value.first;
+                row.s_Actual = value.second;
+                f(row);
+            }
+        }
+    }
+}
+
 std::string CModelPlotData::print() const {
     return "nothing";
 }
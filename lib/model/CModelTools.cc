@@ -6,6 +6,9 @@
 
 #include <model/CModelTools.h>
 
+#include <core/CMemory.h>
+#include <core/CStatistics.h>
+
 #include <maths/CBasicStatistics.h>
 #include <maths/CIntegerTools.h>
 #include <maths/CModel.h>
@@ -431,5 +434,119 @@ bool CModelTools::CProbabilityCache::canInterpolate(const TDouble1Vec& modes,
            (std::lower_bound(modes.begin(), modes.end(), (left - 1)->first) ==
             std::lower_bound(modes.begin(), modes.end(), (right + 1)->first));
 }
+
+void CModelTools::CProbabilityResultCache::clear() {
+    m_Results.clear();
+}
+
+void CModelTools::CProbabilityResultCache::invalidate(model_t::EFeature feature,
+                                                      std::size_t id) {
+    m_Results.erase({feature, id});
+}
+
+void CModelTools::CProbabilityResultCache::add(model_t::EFeature feature,
+                                               std::size_t id,
+                                               const maths::CModelProbabilityParams& params,
+                                               const TDouble2Vec1Vec& value,
+                                               const TDouble2Vec1Vec& detrended,
+                                               const maths::SModelProbabilityResult& result) {
+    // A calculation which updated the anomaly model means the next
+    // calculation for the same value won't necessarily be the same.
+    if (cacheable(params, value) == false || result.s_Conditional ||
+        result.s_AnomalyModelUpdated) {
+        this->invalidate(feature, id);
+        return;
+    }
+
+    SResult& cached = m_Results[{feature, id}];
+    cached.key(params, value[0][0], detrended[0][0]);
+    cached.s_Tail = result.s_Tail.empty() ? maths_t::E_UndeterminedTail : result.s_Tail[0];
+    cached.s_Probability = result.s_Probability;
+}
+
+bool CModelTools::CProbabilityResultCache::lookup(model_t::EFeature feature,
+                                                  std::size_t id,
+                                                  const maths::CModelProbabilityParams& params,
+                                                  const TDouble2Vec1Vec& value,
+                                                  const TDouble2Vec1Vec& detrended,
+                                                  maths::SModelProbabilityResult& result) const {
+    if (cacheable(params, value) == false) {
+        return false;
+    }
+
+    core::CStatistics::stat(stat_t::E_NumberProbabilityCacheLookups).increment();
+
+    auto cached = m_Results.find({feature, id});
+    if (cached == m_Results.end() ||
+        cached->second.matches(params, value[0][0], detrended[0][0]) == false) {
+        return false;
+    }
+
+    core::CStatistics::stat(stat_t::E_NumberProbabilityCacheHits).increment();
+    result = maths::SModelProbabilityResult{};
+    result.s_Probability = cached->second.s_Probability;
+    result.s_Tail.assign(1, cached->second.s_Tail);
+    return true;
+}
+
+bool CModelTools::CProbabilityResultCache::cacheable(const maths::CModelProbabilityParams& params,
+                                                     const TDouble2Vec1Vec& value) {
+    // Only uncorrelated univariate calculations are cached because the
+    // result of other calculations depends on the state of other models.
+    if (value.size() != 1 || value[0].size() != 1 || params.calculations() != 1 ||
+        params.bucketEmpty().size() != 1 || params.bucketEmpty()[0].size() != 1 ||
+        params.weights().size() != 1 || params.mostAnomalousCorrelate() != boost::none) {
+        return false;
+    }
+    return std::all_of(params.weights()[0].begin(), params.weights()[0].end(),
+                       [](const TDouble2Vec& weight) { return weight.size() == 1; });
+}
+
+std::size_t CModelTools::CProbabilityResultCache::size() const {
+    return m_Results.size();
+}
+
+void CModelTools::CProbabilityResultCache::debugMemoryUsage(
+    core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CModelTools::CProbabilityResultCache");
+    core::CMemoryDebug::dynamicSize("m_Results", m_Results, mem);
+}
+
+std::size_t CModelTools::CProbabilityResultCache::memoryUsage() const {
+    return core::CMemory::dynamicSize(m_Results);
+}
+
+void CModelTools::CProbabilityResultCache::SResult::key(
+    const maths::CModelProbabilityParams& params,
+    double value,
+    double detrended) {
+    s_Calculation = params.calculation(0);
+    s_BucketEmpty = params.bucketEmpty()[0][0];
+    s_UseMultibucketFeatures = params.useMultibucketFeatures();
+    s_UseAnomalyModel = params.useAnomalyModel();
+    s_SeasonalConfidenceInterval = params.seasonalConfidenceInterval();
+    for (std::size_t i = 0; i < maths_t::NUMBER_WEIGHT_STYLES; ++i) {
+        s_Weights[i] = params.weights()[0][i][0];
+    }
+    s_Value = value;
+    s_Detrended = detrended;
+}
+
+bool CModelTools::CProbabilityResultCache::SResult::matches(
+    const maths::CModelProbabilityParams& params,
+    double value,
+    double detrended) const {
+    for (std::size_t i = 0; i < maths_t::NUMBER_WEIGHT_STYLES; ++i) {
+        if (s_Weights[i] != params.weights()[0][i][0]) {
+            return false;
+        }
+    }
+    return s_Value == value && s_Detrended == detrended &&
+           s_Calculation == params.calculation(0) &&
+           s_BucketEmpty == params.bucketEmpty()[0][0] &&
+           s_SeasonalConfidenceInterval == params.seasonalConfidenceInterval() &&
+           s_UseMultibucketFeatures == params.useMultibucketFeatures() &&
+           s_UseAnomalyModel == params.useAnomalyModel();
+}
 }
 }
@@ -462,6 +462,9 @@ void CPopulationModel::updateRecycledModels() {
                       << m_AttributeFirstBucketTimes.size() << ")");
         }
     }
+    if (attributes.empty() == false) {
+        this->clearRuleScopeCache();
+    }
     attributes.clear();
 
     this->CAnomalyDetectorModel::updateRecycledModels();
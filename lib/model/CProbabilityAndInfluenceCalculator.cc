@@ -48,6 +48,14 @@ using TTail2Vec = core::CSmallVector<maths_t::ETail, 2>;
 using TProbabilityCalculation2Vec = core::CSmallVector<maths_t::EProbabilityCalculation, 2>;
 using TSizeDoublePr = std::pair<std::size_t, double>;
 using TSizeDoublePr1Vec = core::CSmallVector<TSizeDoublePr, 1>;
+using TSizeVec = std::vector<std::size_t>;
+using TBoolVec = maths::CModel::TBoolVec;
+using TBool2Vec1Vec = maths::CModel::TBool2Vec1Vec;
+using TModelProbabilityResultVec = maths::CModel::TModelProbabilityResultVec;
+
+//! The initial number of influencer values for which to compute
+//! probabilities together.
+const std::size_t MINIMUM_INFLUENCE_BLOCK_SIZE{4};
 
 //! Get the canonical influence string pointer.
 core::CStoredStringPtr canonical(const std::string& influence) {
@@ -428,56 +436,88 @@ void doComputeInfluences(model_t::EFeature feature,
 
     double logOverallProbability{maths::CTools::fastLog(overallProbability)};
 
+    // We compute the probabilities of the influenced values in blocks
+    // so the model can share work between them. For univariate features
+    // the influencer values are sorted in order of decreasing influence
+    // so we can stop as soon as one falls below the cutoff. The blocks
+    // start small and grow geometrically so we do little unnecessary
+    // work when only a few influencers are significant.
+
     // Declared outside the loop to minimize the number of times they are created.
     std::size_t dimension = model_t::dimension(feature);
     TDouble2Vec1Vec influencedValue{TDouble2Vec(dimension)};
-    maths::SModelProbabilityResult influenceResult;
-
-    for (auto i = influencerValues.begin(); i != influencerValues.end(); ++i) {
-        const auto& influenceValue = i->second.first;
-        const auto& influenceCount = i->second.second;
-        computeProbabilityParams.weights(weights);
-        if (computeInfluencedParamsAndValue(value, count, influenceValue,
-                                            influenceCount, computeProbabilityParams,
-                                            influencedValue[0]) == false) {
-            LOG_ERROR(<< "Failed to compute influencer value (value = " << value
-                      << " , count = " << count
-                      << " , influencer value = " << i->second.first
-                      << " , influencer count = " << i->second.second << ")");
-            continue;
+    TSizeVec indices;
+    TDouble2Vec1Vec influencedValues;
+    maths_t::TDouble2VecWeightsAry1Vec influencedWeights;
+    TBool2Vec1Vec influencedBucketEmpty;
+    TModelProbabilityResultVec influenceResults;
+    TBoolVec successes;
+
+    std::size_t n{influencerValues.size()};
+    std::size_t blockSize{dimension == 1 ? MINIMUM_INFLUENCE_BLOCK_SIZE : n};
+    for (std::size_t start = 0u; start < n; start += blockSize, blockSize *= 2) {
+        indices.clear();
+        influencedValues.clear();
+        influencedWeights.clear();
+        influencedBucketEmpty.clear();
+
+        for (std::size_t i = start; i < std::min(start + blockSize, n); ++i) {
+            const auto& influenceValue = influencerValues[i].second.first;
+            const auto& influenceCount = influencerValues[i].second.second;
+            computeProbabilityParams.weights(weights);
+            if (computeInfluencedParamsAndValue(value, count, influenceValue,
+                                                influenceCount, computeProbabilityParams,
+                                                influencedValue[0]) == false) {
+                LOG_ERROR(<< "Failed to compute influencer value (value = " << value
+                          << " , count = " << count << " , influencer value = "
+                          << influenceValue << " , influencer count = " << influenceCount
+                          << ")");
+                continue;
+            }
+            indices.push_back(i);
+            influencedValues.push_back(influencedValue[0]);
+            influencedWeights.push_back(computeProbabilityParams.weights()[0]);
+            influencedBucketEmpty.push_back(computeProbabilityParams.bucketEmpty()[0]);
         }
 
-        if (model.probability(computeProbabilityParams, time, influencedValue,
-                              influenceResult) == false) {
-            LOG_ERROR(<< "Failed to compute P(" << influencedValue[0]
-                      << " | influencer = " << core::CContainerPrinter::print(*i) << ")");
-            continue;
-        }
+        model.probabilities(computeProbabilityParams, time, influencedValues,
+                            influencedWeights, influencedBucketEmpty,
+                            influenceResults, successes);
 
-        double influenceProbability{probability(influenceResult)};
-        double logInfluenceProbability{maths::CTools::fastLog(influenceProbability)};
-        double influence{computeInfluence(logOverallProbability, logInfluenceProbability)};
+        for (std::size_t j = 0u; j < indices.size(); ++j) {
+            auto i = influencerValues.begin() + indices[j];
+            if (successes[j] == false) {
+                LOG_ERROR(<< "Failed to compute P(" << influencedValues[j]
+                          << " | influencer = " << core::CContainerPrinter::print(*i) << ")");
+                continue;
+            }
 
-        LOG_TRACE(<< "log(p) = " << logOverallProbability
-                  << ", v(i) = " << core::CContainerPrinter::print(influencedValue)
-                  << ", log(p(i)) = " << logInfluenceProbability << ", weight = "
-                  << core::CContainerPrinter::print(weights) << ", influence = " << influence
-                  << ", influencer field value = " << i->first.get());
+            double influenceProbability{probability(influenceResults[j])};
+            double logInfluenceProbability{maths::CTools::fastLog(influenceProbability)};
+            double influence{computeInfluence(logOverallProbability, logInfluenceProbability)};
+
+            LOG_TRACE(<< "log(p) = " << logOverallProbability
+                      << ", v(i) = " << influencedValues[j]
+                      << ", log(p(i)) = " << logInfluenceProbability << ", weight = "
+                      << core::CContainerPrinter::print(influencedWeights[j])
+                      << ", influence = " << influence
+                      << ", influencer field value = " << i->first.get());
 
-        if (dimension == 1 && influence >= cutoff) {
-            result.emplace_back(description(i->first), influence);
-        } else if (dimension == 1) {
-            if (includeCutoff) {
+            if (dimension == 1 && influence >= cutoff) {
                 result.emplace_back(description(i->first), influence);
-                for (++i; i != influencerValues.end(); ++i) {
-                    result.emplace_back(description(i->first), 0.5 * influence);
+            } else if (dimension == 1) {
+                if (includeCutoff) {
+                    result.emplace_back(description(i->first), influence);
+                    for (++i; i != influencerValues.end(); ++i) {
+                        result.emplace_back(description(i->first), 0.5 * influence);
+                    }
                 }
+                return;
+            } else if (influence >= cutoff) {
+                result.emplace_back(description(i->first), influence);
+            } else if (includeCutoff) {
+                result.emplace_back(description(i->first), 0.5 * influence);
             }
-            break;
-        } else if (influence >= cutoff) {
-            result.emplace_back(description(i->first), influence);
-        } else if (includeCutoff) {
-            result.emplace_back(description(i->first), 0.5 * influence);
         }
     }
 }
@@ -573,7 +613,8 @@ CProbabilityAndInfluenceCalculator::CProbabilityAndInfluenceCalculator(double cu
     : m_Cutoff(cutoff), m_InfluenceCalculator(nullptr),
       m_ProbabilityTemplate(CModelTools::CProbabilityAggregator::E_Min),
       m_Probability(CModelTools::CProbabilityAggregator::E_Min),
-      m_ProbabilityCache(nullptr) {
+      m_ProbabilityCache(nullptr), m_ProbabilityResultCache(nullptr),
+      m_ProbabilityResultCacheId(0) {
 }
 
 bool CProbabilityAndInfluenceCalculator::empty() const {
@@ -603,6 +644,12 @@ void CProbabilityAndInfluenceCalculator::addCache(CModelTools::CProbabilityCache
     m_ProbabilityCache = &cache;
 }
 
+void CProbabilityAndInfluenceCalculator::addCache(CModelTools::CProbabilityResultCache& cache,
+                                                  std::size_t id) {
+    m_ProbabilityResultCache = &cache;
+    m_ProbabilityResultCacheId = id;
+}
+
 void CProbabilityAndInfluenceCalculator::add(const CProbabilityAndInfluenceCalculator& other,
                                              double weight) {
     double p = 0.0;
@@ -710,10 +757,32 @@ bool CProbabilityAndInfluenceCalculator::addProbability(model_t::EFeature featur
     }
 
     // Either there isn't a cache or the accuracy isn't good enough
-    // so fall back to calculating.
+    // so fall back to calculating, unless the model hasn't changed
+    // since we last calculated the probability of this value.
     TDouble2Vec1Vec values(model_t::stripExtraStatistics(feature, values_));
     maths::SModelProbabilityResult result;
-    if (model.probability(computeProbabilityParams, time, values, result)) {
+    bool calculated{false};
+    if (m_ProbabilityResultCache != nullptr &&
+        CModelTools::CProbabilityResultCache::cacheable(computeProbabilityParams, values)) {
+        TDouble2Vec1Vec detrended(values);
+        model.detrend(time, computeProbabilityParams.seasonalConfidenceInterval(), detrended);
+        calculated = m_ProbabilityResultCache->lookup(feature, m_ProbabilityResultCacheId,
+                                                      computeProbabilityParams,
+                                                      values, detrended, result);
+        if (calculated == false &&
+            model.probability(computeProbabilityParams, time, values, result)) {
+            m_ProbabilityResultCache->add(feature, m_ProbabilityResultCacheId,
+                                          computeProbabilityParams, values,
+                                          detrended, result);
+            calculated = true;
+        }
+    } else {
+        if (m_ProbabilityResultCache != nullptr) {
+            m_ProbabilityResultCache->invalidate(feature, m_ProbabilityResultCacheId);
+        }
+        calculated = model.probability(computeProbabilityParams, time, values, result);
+    }
+    if (calculated) {
         if (model_t::isConstant(feature) == false) {
             probability = result.s_Probability;
             probability = model_t::adjustProbability(feature, elapsedTime, probability);
@@ -6,6 +6,7 @@
 
 #include <model/CResourceMonitor.h>
 
+#include <core/CProcessMemory.h>
 #include <core/CStatistics.h>
 #include <core/Constants.h>
 
@@ -28,7 +29,8 @@ const double CResourceMonitor::DEFAULT_BYTE_LIMIT_MARGIN(0.7);
 CResourceMonitor::CResourceMonitor(double byteLimitMargin)
     : m_AllowAllocations(true), m_ByteLimitMargin{byteLimitMargin},
       m_ByteLimitHigh(0), m_ByteLimitLow(0), m_CurrentAnomalyDetectorMemory(0),
-      m_ExtraMemory(0), m_PreviousTotal(this->totalMemory()), m_Peak(m_PreviousTotal),
+      m_ExtraMemory(0), m_IncludeStringStores(true),
+      m_PreviousTotal(this->totalMemory()), m_Peak(m_PreviousTotal),
       m_LastAllocationFailureReport(0), m_MemoryStatus(model_t::E_MemoryStatusOk),
       m_HasPruningStarted(false), m_PruneThreshold(0), m_LastPruneTime(0),
       m_PruneWindow(std::numeric_limits<std::size_t>::max()),
@@ -174,6 +176,13 @@ bool CResourceMonitor::pruneIfRequired(core_t::TTime endTime) {
         m_CurrentAnomalyDetectorMemory = usageAfter;
         total = this->totalMemory();
         this->updateAllowAllocations();
+
+        // Pruning frees many small objects scattered throughout the heap.
+        // Unless we hand the pages they occupied back the process's size
+        // never comes down to match the usage we report.
+        core::CProcessMemory::releaseFreeMemory();
+        LOG_DEBUG(<< "Pruned models to " << total << " bytes. Resident set size: "
+                  << core::CProcessMemory::residentSetSize());
     }
 
     LOG_TRACE(<< "Pruning models. Usage: " << total
@@ -305,6 +314,15 @@ void CResourceMonitor::clearExtraMemory() {
     }
 }
 
+void CResourceMonitor::includeStringStores(bool include) {
+    if (m_IncludeStringStores != include) {
+        m_IncludeStringStores = include;
+        m_PreviousTotal = this->totalMemory();
+        m_Peak = m_PreviousTotal;
+        this->updateAllowAllocations();
+    }
+}
+
 void CResourceMonitor::decreaseMargin(core_t::TTime elapsedTime) {
     // We choose to increase the margin to close to 1 on the order
     // time it takes to detect diurnal periodic components. These
@@ -325,9 +343,12 @@ std::size_t CResourceMonitor::lowLimit() const {
 }
 
 std::size_t CResourceMonitor::totalMemory() const {
-    return m_CurrentAnomalyDetectorMemory + m_ExtraMemory +
-           CStringStore::names().memoryUsage() +
-           CStringStore::influencers().memoryUsage();
+    std::size_t result{m_CurrentAnomalyDetectorMemory + m_ExtraMemory};
+    if (m_IncludeStringStores) {
+        result += CStringStore::names().memoryUsage() +
+                  CStringStore::influencers().memoryUsage();
+    }
+    return result;
 }
 
 } // model
@@ -36,6 +36,17 @@ void CResultsQueue::push(const CHierarchicalResults& result) {
     m_Results.push(result);
 }
 
+void CResultsQueue::pushEmpty(core_t::TTime time) {
+    if (m_Results.latestBucketEnd() + 1 - m_Results.bucketLength() == 0) {
+        m_Results.reset(time - m_Results.bucketLength());
+        LOG_TRACE(<< "Resetting results queue. Queue's latestBucketEnd is "
+                  << m_Results.latestBucketEnd());
+    }
+    if (m_Results.recycle(time)) {
+        m_Results.latest().clear();
+    }
+}
+
 const CHierarchicalResults& CResultsQueue::get(core_t::TTime time) const {
     return m_Results.get(time);
 }
@@ -6,6 +6,7 @@
 
 #include <model/CRuleScope.h>
 
+#include <core/CMemory.h>
 #include <core/CPatternSet.h>
 
 #include <model/CAnomalyDetectorModel.h>
@@ -25,14 +26,19 @@ void CRuleScope::exclude(const std::string& field, const core::CPatternSet& filt
 bool CRuleScope::check(const CAnomalyDetectorModel& model, std::size_t pid, std::size_t cid) const {
 
     const CDataGatherer& gatherer = model.dataGatherer();
+    CCache& cache = model.ruleScopeCache();
     for (const auto& scopeField : m_Scope) {
+        const core::CPatternSet& filter = scopeField.second.get();
         bool containsValue{false};
         if (scopeField.first == gatherer.partitionFieldName()) {
-            containsValue = scopeField.second.get().contains(gatherer.partitionFieldValue());
+            containsValue = cache.contains(filter, CCache::E_PartitionField, 0,
+                                           gatherer.partitionFieldValue());
         } else if (scopeField.first == gatherer.personFieldName()) {
-            containsValue = scopeField.second.get().contains(gatherer.personName(pid));
+            containsValue = cache.contains(filter, CCache::E_PersonField, pid,
+                                           gatherer.personName(pid));
         } else if (scopeField.first == gatherer.attributeFieldName()) {
-            containsValue = scopeField.second.get().contains(gatherer.attributeName(cid));
+            containsValue = cache.contains(filter, CCache::E_AttributeField, cid,
+                                           gatherer.attributeName(cid));
         } else {
             LOG_ERROR(<< "Unexpected scoped field = " << scopeField.first);
             return false;
@@ -65,5 +71,33 @@ std::string CRuleScope::print() const {
     }
     return result;
 }
+
+bool CRuleScope::CCache::contains(const core::CPatternSet& filter,
+                                  EField field,
+                                  std::size_t id,
+                                  const std::string& value) {
+    auto result = m_Contains.emplace(TUInt64FieldSizeTr{filter.uniqueId(), field, id}, false);
+    if (result.second) {
+        result.first->second = filter.contains(value);
+    }
+    return result.first->second;
+}
+
+void CRuleScope::CCache::clear() {
+    m_Contains.clear();
+}
+
+std::size_t CRuleScope::CCache::size() const {
+    return m_Contains.size();
+}
+
+void CRuleScope::CCache::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
+    mem->setName("CRuleScope::CCache");
+    core::CMemoryDebug::dynamicSize("m_Contains", m_Contains, mem);
+}
+
+std::size_t CRuleScope::CCache::memoryUsage() const {
+    return core::CMemory::dynamicSize(m_Contains);
+}
 }
 }
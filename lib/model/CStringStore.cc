@@ -14,6 +14,8 @@
 
 #include <boost/bind.hpp>
 
+#include <thread>
+
 namespace ml {
 namespace model {
 
@@ -42,9 +44,9 @@ const CStringStore& DO_NOT_USE_THIS_VARIABLE = CStringStore::names();
 const CStringStore& DO_NOT_USE_THIS_VARIABLE_EITHER = CStringStore::influencers();
 }
 
-void CStringStore::tidyUpNotThreadSafe() {
-    names().pruneRemovedNotThreadSafe();
-    influencers().pruneNotThreadSafe();
+void CStringStore::tidyUp() {
+    names().pruneRemoved();
+    influencers().prune();
 }
 
 CStringStore& CStringStore::names() {
@@ -125,8 +127,12 @@ void CStringStore::remove(const std::string& value) {
     m_Removed.push_back(value);
 }
 
-void CStringStore::pruneRemovedNotThreadSafe() {
+void CStringStore::pruneRemoved() {
     core::CScopedFastLock lock(m_Mutex);
+    if (m_Removed.empty()) {
+        return;
+    }
+    this->excludeReaders();
     for (const auto& removed : m_Removed) {
         auto i = m_Strings.find(removed, STR_HASH, STR_EQUAL);
         if (i != m_Strings.end() && i->isUnique()) {
@@ -135,10 +141,12 @@ void CStringStore::pruneRemovedNotThreadSafe() {
         }
     }
     m_Removed.clear();
+    this->stopExcludingReaders();
 }
 
-void CStringStore::pruneNotThreadSafe() {
+void CStringStore::prune() {
     core::CScopedFastLock lock(m_Mutex);
+    this->excludeReaders();
     for (auto i = m_Strings.begin(); i != m_Strings.end(); /**/) {
         if (i->isUnique()) {
             m_StoredStringsMemUse -= i->actualMemoryUsage();
@@ -147,6 +155,7 @@ void CStringStore::pruneNotThreadSafe() {
             ++i;
         }
     }
+    this->stopExcludingReaders();
 }
 
 void CStringStore::debugMemoryUsage(core::CMemoryUsage::TMemoryUsagePtr mem) const {
@@ -194,5 +203,20 @@ void CStringStore::clearEverythingTestOnly() {
     m_StoredStringsMemUse = 0;
 }
 
+void CStringStore::excludeReaders() {
+    // Erasing from the set isn't safe if another thread is finding a string
+    // in it. Readers which start after this bypass the set, exactly as they
+    // do if there's an insert in progress, so we need only wait for those
+    // already reading to finish.
+    m_Writing.fetch_add(1);
+    while (m_Reading.load() != 0) {
+        std::this_thread::yield();
+    }
+}
+
+void CStringStore::stopExcludingReaders() {
+    m_Writing.fetch_sub(1);
+}
+
 } // model
 } // ml
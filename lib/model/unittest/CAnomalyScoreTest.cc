@@ -10,6 +10,7 @@
 #include <core/CJsonStatePersistInserter.h>
 #include <core/CJsonStateRestoreTraverser.h>
 #include <core/CLogger.h>
+#include <core/CMemoryUsage.h>
 #include <core/CStringUtils.h>
 
 #include <maths/CTools.h>
@@ -795,6 +796,31 @@ void CAnomalyScoreTest::testPersistEmpty() {
     CPPUNIT_ASSERT_EQUAL(origJson, newJson);
 }
 
+void CAnomalyScoreTest::testMemoryUsage() {
+    // Check that the memory used by the quantile summaries is accounted.
+
+    model::CAnomalyDetectorModelConfig config =
+        model::CAnomalyDetectorModelConfig::defaultConfig();
+
+    model::CAnomalyScore::CNormalizer normalizer(config);
+    std::size_t emptyMemoryUsage{normalizer.memoryUsage()};
+
+    test::CRandomNumbers rng;
+    TDoubleVec scores;
+    rng.generateUniformSamples(0.0, 50.0, 10000, scores);
+    for (const auto& score : scores) {
+        normalizer.updateQuantiles(score, "p", "v", "q", "w");
+    }
+
+    std::size_t memoryUsage{normalizer.memoryUsage()};
+    LOG_DEBUG(<< "empty = " << emptyMemoryUsage << ", memory = " << memoryUsage);
+    CPPUNIT_ASSERT(memoryUsage > emptyMemoryUsage);
+
+    core::CMemoryUsage mem;
+    normalizer.debugMemoryUsage(mem.addChild());
+    CPPUNIT_ASSERT_EQUAL(memoryUsage, mem.usage());
+}
+
 CppUnit::Test* CAnomalyScoreTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CAnomalyScoreTest");
 
@@ -828,6 +854,8 @@ CppUnit::Test* CAnomalyScoreTest::suite() {
         "CAnomalyScoreTest::testJsonConversion", &CAnomalyScoreTest::testJsonConversion));
     suiteOfTests->addTest(new CppUnit::TestCaller<CAnomalyScoreTest>(
         "CAnomalyScoreTest::testPersistEmpty", &CAnomalyScoreTest::testPersistEmpty));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CAnomalyScoreTest>(
+        "CAnomalyScoreTest::testMemoryUsage", &CAnomalyScoreTest::testMemoryUsage));
 
     return suiteOfTests;
 }
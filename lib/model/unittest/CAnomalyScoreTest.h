@@ -27,6 +27,7 @@ public:
     void testNormalizerGetMaxScore();
     void testJsonConversion();
     void testPersistEmpty();
+    void testMemoryUsage();
 
     static CppUnit::Test* suite();
 };
@@ -89,6 +89,26 @@ void CBucketQueueTest::testClear() {
     CPPUNIT_ASSERT_EQUAL(std::size_t(3), queue.size());
 }
 
+void CBucketQueueTest::testRecycle() {
+    CBucketQueue<std::string> queue(2, 5, 0);
+    queue.push("a", 5);
+    queue.push("b", 10);
+    queue.push("c", 15);
+    const std::string* earliest = &queue.get(5);
+
+    CPPUNIT_ASSERT(queue.recycle(20));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), queue.size());
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(24), queue.latestBucketEnd());
+    CPPUNIT_ASSERT_EQUAL(std::string("b"), queue.get(10));
+    CPPUNIT_ASSERT_EQUAL(std::string("c"), queue.get(15));
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), queue.get(20));
+    CPPUNIT_ASSERT(earliest == &queue.latest());
+
+    CPPUNIT_ASSERT(queue.recycle(12) == false);
+    CPPUNIT_ASSERT_EQUAL(core_t::TTime(24), queue.latestBucketEnd());
+    CPPUNIT_ASSERT_EQUAL(std::string("a"), queue.get(20));
+}
+
 void CBucketQueueTest::testIterators() {
     using TStringQueueItr = CBucketQueue<std::string>::iterator;
 
@@ -187,6 +207,8 @@ CppUnit::Test* CBucketQueueTest::suite() {
         &CBucketQueueTest::testGetGivenFullQueueAfterPop));
     suiteOfTests->addTest(new CppUnit::TestCaller<CBucketQueueTest>(
         "CBucketQueueTest::testClear", &CBucketQueueTest::testClear));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CBucketQueueTest>(
+        "CBucketQueueTest::testRecycle", &CBucketQueueTest::testRecycle));
     suiteOfTests->addTest(new CppUnit::TestCaller<CBucketQueueTest>(
         "CBucketQueueTest::testIterators", &CBucketQueueTest::testIterators));
     suiteOfTests->addTest(new CppUnit::TestCaller<CBucketQueueTest>(
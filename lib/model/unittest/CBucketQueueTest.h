@@ -15,6 +15,7 @@ public:
     void testGetGivenFullQueueWithNoPop();
     void testGetGivenFullQueueAfterPop();
     void testClear();
+    void testRecycle();
     void testIterators();
     void testReverseIterators();
     void testBucketQueueUMap();
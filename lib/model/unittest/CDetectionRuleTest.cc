@@ -63,6 +63,8 @@ CppUnit::Test* CDetectionRuleTest::suite() {
         &CDetectionRuleTest::testApplyGivenTimeCondition));
     suiteOfTests->addTest(new CppUnit::TestCaller<CDetectionRuleTest>(
         "CDetectionRuleTest::testRuleActions", &CDetectionRuleTest::testRuleActions));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CDetectionRuleTest>(
+        "CDetectionRuleTest::testScopeCache", &CDetectionRuleTest::testScopeCache));
 
     return suiteOfTests;
 }
@@ -923,3 +925,53 @@ void CDetectionRuleTest::testRuleActions() {
     CPPUNIT_ASSERT(rule.apply(CDetectionRule::E_SkipModelUpdate, model,
                               model_t::E_IndividualMeanByPerson, resultType, 0, 0, 100));
 }
+
+void CDetectionRuleTest::testScopeCache() {
+    // Test the scope's filter lookups are memoised and that updating
+    // the filter means the memoised results are no longer used.
+
+    core_t::TTime bucketLength = 100;
+    core_t::TTime startTime = 100;
+    CSearchKey key;
+    SModelParams params(bucketLength);
+    CAnomalyDetectorModel::TFeatureInfluenceCalculatorCPtrPrVecVec influenceCalculators;
+
+    TFeatureVec features{model_t::E_IndividualMeanByPerson};
+    std::string personFieldName("series");
+    CAnomalyDetectorModel::TDataGathererPtr gathererPtr(std::make_shared<CDataGatherer>(
+        model_t::E_Metric, model_t::E_None, params, EMPTY_STRING, EMPTY_STRING, personFieldName,
+        EMPTY_STRING, EMPTY_STRING, TStrVec{}, key, features, startTime, 0));
+
+    bool addedPerson = false;
+    gathererPtr->addPerson("p1", m_ResourceMonitor, addedPerson);
+    gathererPtr->addPerson("p2", m_ResourceMonitor, addedPerson);
+
+    CMockModel model(params, gathererPtr, influenceCalculators);
+
+    core::CPatternSet valueFilter;
+    valueFilter.initFromJson("[\"p1\"]");
+    CDetectionRule rule;
+    rule.includeScope(personFieldName, valueFilter);
+
+    model_t::CResultType resultType(model_t::CResultType::E_Final);
+    auto apply = [&](std::size_t pid) {
+        return rule.apply(CDetectionRule::E_SkipResult, model,
+                          model_t::E_IndividualMeanByPerson, resultType, pid, 0, 100);
+    };
+
+    for (std::size_t i = 0; i < 2; ++i) {
+        CPPUNIT_ASSERT(apply(0));
+        CPPUNIT_ASSERT(apply(1) == false);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(2), model.ruleScopeCache().size());
+    }
+
+    valueFilter.initFromJson("[\"p2\"]");
+    CPPUNIT_ASSERT(apply(0) == false);
+    CPPUNIT_ASSERT(apply(1));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), model.ruleScopeCache().size());
+
+    model.clearRuleScopeCache();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), model.ruleScopeCache().size());
+    CPPUNIT_ASSERT(apply(0) == false);
+    CPPUNIT_ASSERT(apply(1));
+}
@@ -22,6 +22,7 @@ public:
     void testApplyGivenMultipleConditions();
     void testApplyGivenTimeCondition();
     void testRuleActions();
+    void testScopeCache();
 
     static CppUnit::Test* suite();
 
@@ -11,6 +11,7 @@
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
 #include <core/CSmallVector.h>
+#include <core/CStatistics.h>
 #include <core/Constants.h>
 #include <core/CoreTypes.h>
 
@@ -20,6 +21,7 @@
 #include <maths/CNormalMeanPrecConjugate.h>
 #include <maths/CPrior.h>
 #include <maths/CTimeSeriesDecompositionInterface.h>
+#include <maths/CTimeSeriesModel.h>
 
 #include <model/CAnnotatedProbability.h>
 #include <model/CAnomalyDetectorModelConfig.h>
@@ -77,6 +79,15 @@ using TMeanAccumulator = maths::CBasicStatistics::SSampleMean<double>::TAccumula
 
 const std::string EMPTY_STRING;
 
+//! Get the time series model \p model or, if it's newborn, the full
+//! model it stands in for.
+const maths::CUnivariateTimeSeriesModel* univariateModel(const maths::CModel* model) {
+    if (auto newborn = dynamic_cast<const maths::CNewbornTimeSeriesModel*>(model)) {
+        return &newborn->fullModel();
+    }
+    return dynamic_cast<const maths::CUnivariateTimeSeriesModel*>(model);
+}
+
 TUInt64Vec rawEventCounts(std::size_t copies = 1) {
     uint64_t counts[] = {54, 67, 39, 58, 46, 50, 42,
                          48, 53, 51, 50, 57, 53, 49};
@@ -2093,20 +2104,20 @@ void CEventRateModelTest::testSkipSampling() {
 
     // Check priors are the same
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelWithGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelNoGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum());
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelWithGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 1))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelNoGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 1))
             ->residualModel()
             .checksum());
@@ -2203,20 +2214,20 @@ void CEventRateModelTest::testExplicitNulls() {
 
     // Check priors are the same
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelExNullGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelSkipGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum());
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelExNullGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 1))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelSkipGap->details()->model(model_t::E_IndividualCountByBucketAndPerson, 1))
             ->residualModel()
             .checksum());
@@ -2816,12 +2827,12 @@ void CEventRateModelTest::testIgnoreSamplingGivenDetectionRules() {
     CAnomalyDetectorModel::CModelDetailsViewPtr modelNoSkipView = modelNoSkip->details();
 
     uint64_t withSkipChecksum =
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelWithSkipView->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum();
     uint64_t noSkipChecksum =
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelNoSkipView->model(model_t::E_IndividualCountByBucketAndPerson, 0))
             ->residualModel()
             .checksum();
@@ -2829,7 +2840,7 @@ void CEventRateModelTest::testIgnoreSamplingGivenDetectionRules() {
 
     // Check the last value times of the underlying models are the same
     const maths::CUnivariateTimeSeriesModel* timeSeriesModel =
-        dynamic_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelNoSkipView->model(model_t::E_IndividualCountByBucketAndPerson, 0));
     CPPUNIT_ASSERT(timeSeriesModel);
 
@@ -2839,11 +2850,66 @@ void CEventRateModelTest::testIgnoreSamplingGivenDetectionRules() {
                          time);
 
     // The last times of model with a skip should be the same
-    timeSeriesModel = dynamic_cast<const maths::CUnivariateTimeSeriesModel*>(
+    timeSeriesModel = univariateModel(
         modelWithSkipView->model(model_t::E_IndividualCountByBucketAndPerson, 0));
     CPPUNIT_ASSERT_EQUAL(time, timeSeriesModel->trendModel().lastValueTime());
 }
 
+void CEventRateModelTest::testSilentSparsePeopleAreNotTouched() {
+    // Check that sampling a bucket in which a person, whose empty buckets
+    // aren't modelled, is silent doesn't touch their model. The result of
+    // their last probability calculation should then stay cached, whereas
+    // the model of a person who is present is updated and its result is
+    // recomputed.
+
+    core_t::TTime startTime{0};
+    core_t::TTime bucketLength{600};
+    SModelParams params(bucketLength);
+    this->makeModel(params, {model_t::E_IndividualCountByBucketAndPerson}, startTime, 2);
+    CEventRateModel* model = dynamic_cast<CEventRateModel*>(m_Model.get());
+
+    auto hits = [] {
+        return core::CStatistics::stat(stat_t::E_NumberProbabilityCacheHits).value();
+    };
+    auto computeProbability = [&](std::size_t pid, core_t::TTime time) {
+        CPartitioningFields partitioningFields(EMPTY_STRING, EMPTY_STRING);
+        SAnnotatedProbability annotatedProbability;
+        CPPUNIT_ASSERT(model->computeProbability(pid, time, time + bucketLength,
+                                                 partitioningFields, 1,
+                                                 annotatedProbability));
+    };
+
+    core_t::TTime time{startTime};
+    for (std::size_t i = 0; i < 50; ++i, time += bucketLength) {
+        addArrival(*m_Gatherer, m_ResourceMonitor, time, "p1");
+        if (i % 20 == 0) {
+            addArrival(*m_Gatherer, m_ResourceMonitor, time, "p2");
+        }
+        model->sample(time, time + bucketLength, m_ResourceMonitor);
+    }
+
+    auto checksum = [&](std::size_t pid) {
+        return model->details()
+            ->model(model_t::E_IndividualCountByBucketAndPerson, pid)
+            ->checksum();
+    };
+    std::uint64_t denseChecksum{checksum(0)};
+    std::uint64_t sparseChecksum{checksum(1)};
+    computeProbability(0, time - bucketLength);
+    computeProbability(1, time - bucketLength);
+
+    addArrival(*m_Gatherer, m_ResourceMonitor, time, "p1");
+    model->sample(time, time + bucketLength, m_ResourceMonitor);
+    CPPUNIT_ASSERT(checksum(0) != denseChecksum);
+    CPPUNIT_ASSERT_EQUAL(sparseChecksum, checksum(1));
+
+    std::uint64_t hits0{hits()};
+    computeProbability(0, time);
+    CPPUNIT_ASSERT_EQUAL(hits0, hits());
+    computeProbability(1, time);
+    CPPUNIT_ASSERT_EQUAL(hits0 + 1, hits());
+}
+
 CppUnit::Test* CEventRateModelTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CEventRateModelTest");
 
@@ -2909,6 +2975,9 @@ CppUnit::Test* CEventRateModelTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
         "CEventRateModelTest::testIgnoreSamplingGivenDetectionRules",
         &CEventRateModelTest::testIgnoreSamplingGivenDetectionRules));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CEventRateModelTest>(
+        "CEventRateModelTest::testSilentSparsePeopleAreNotTouched",
+        &CEventRateModelTest::testSilentSparsePeopleAreNotTouched));
     return suiteOfTests;
 }
 
@@ -47,6 +47,7 @@ public:
     void testComputeProbabilityGivenDetectionRule();
     void testDecayRateControl();
     void testIgnoreSamplingGivenDetectionRules();
+    void testSilentSparsePeopleAreNotTouched();
 
     virtual void setUp();
     static CppUnit::Test* suite();
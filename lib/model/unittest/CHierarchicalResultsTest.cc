@@ -11,6 +11,7 @@
 #include <core/CRapidXmlParser.h>
 #include <core/CRapidXmlStatePersistInserter.h>
 #include <core/CRapidXmlStateRestoreTraverser.h>
+#include <core/CStringUtils.h>
 
 #include <maths/CStatisticalTests.h>
 #include <maths/CTools.h>
@@ -1980,6 +1981,61 @@ void CHierarchicalResultsTest::testShouldWritePartition() {
         limits, results, *extract.partitionNodes()[1], false));
 }
 
+void CHierarchicalResultsTest::testClear() {
+    // Check that reusing cleared results gives the same hierarchy as new
+    // results. We use enough results that the nodes span several blocks.
+
+    static const std::string PERS("PERS");
+    static const std::string FUNC("mean");
+    static const ml::model::function_t::EFunction function(
+        ml::model::function_t::E_IndividualMetricMean);
+
+    std::vector<std::string> people;
+    for (std::size_t i = 0; i < 150; ++i) {
+        people.push_back("pers" + core::CStringUtils::typeToString(i));
+    }
+
+    auto addResults = [&](std::size_t n, ml::model::CHierarchicalResults& results) {
+        for (std::size_t i = 0; i < n; ++i) {
+            addResult(1, true, FUNC, function, EMPTY_STRING, EMPTY_STRING, PERS,
+                      people[i], EMPTY_STRING, 0.01 * static_cast<double>(i % 10 + 1), results);
+            addResult(2, false, FUNC, function, EMPTY_STRING, EMPTY_STRING, PERS,
+                      people[i], EMPTY_STRING, 0.5, results);
+        }
+    };
+
+    model::CHierarchicalResults reused;
+    for (auto n : {150, 20, 120}) {
+        reused.clear();
+        CPPUNIT_ASSERT(reused.empty());
+        addResults(n, reused);
+        reused.setInterim();
+        reused.buildHierarchy();
+        reused.createPivots();
+
+        model::CHierarchicalResults expected;
+        addResults(n, expected);
+        expected.setInterim();
+        expected.buildHierarchy();
+        expected.createPivots();
+
+        CPrinter reusedPrinter;
+        reused.postorderDepthFirst(reusedPrinter);
+        reused.pivotsBottomUpBreadthFirst(reusedPrinter);
+        CPrinter expectedPrinter;
+        expected.postorderDepthFirst(expectedPrinter);
+        expected.pivotsBottomUpBreadthFirst(expectedPrinter);
+        LOG_TRACE(<< "\nhierarchy:\n" << reusedPrinter.result());
+
+        CPPUNIT_ASSERT_EQUAL(expected.resultCount(), reused.resultCount());
+        CPPUNIT_ASSERT_EQUAL(expectedPrinter.result(), reusedPrinter.result());
+    }
+
+    // Check clear resets the result type.
+    reused.clear();
+    CPPUNIT_ASSERT(reused.resultType().isInterim() == false);
+}
+
 CppUnit::Test* CHierarchicalResultsTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CHierarchicalResultsTest");
 
@@ -2013,6 +2069,8 @@ CppUnit::Test* CHierarchicalResultsTest::suite() {
     suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsTest>(
         "CHierarchicalResultsTest::testShouldWritePartition",
         &CHierarchicalResultsTest::testShouldWritePartition));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CHierarchicalResultsTest>(
+        "CHierarchicalResultsTest::testClear", &CHierarchicalResultsTest::testClear));
 
     return suiteOfTests;
 }
@@ -21,6 +21,7 @@
 #include <maths/CPrior.h>
 #include <maths/CSampling.h>
 #include <maths/CTimeSeriesDecompositionInterface.h>
+#include <maths/CTimeSeriesModel.h>
 
 #include <model/CAnnotatedProbability.h>
 #include <model/CAnomalyDetectorModelConfig.h>
@@ -88,6 +89,15 @@ using TTimeStrVecPrVec = std::vector<TTimeStrVecPr>;
 
 const std::string EMPTY_STRING;
 
+//! Get the time series model \p model or, if it's newborn, the full
+//! model it stands in for.
+const maths::CUnivariateTimeSeriesModel* univariateModel(const maths::CModel* model) {
+    if (auto newborn = dynamic_cast<const maths::CNewbornTimeSeriesModel*>(model)) {
+        return &newborn->fullModel();
+    }
+    return dynamic_cast<const maths::CUnivariateTimeSeriesModel*>(model);
+}
+
 class CTimeLess {
 public:
     bool operator()(const CEventData& lhs, const CEventData& rhs) const {
@@ -1547,11 +1557,11 @@ void CMetricModelTest::testSkipSampling() {
     }
 
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelNoGap.details()->model(model_t::E_IndividualSumByBucketAndPerson, 0))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelWithGap.details()->model(model_t::E_IndividualSumByBucketAndPerson, 0))
             ->residualModel()
             .checksum());
@@ -1636,11 +1646,11 @@ void CMetricModelTest::testExplicitNulls() {
     modelExNullGap.sample(600, 700, m_ResourceMonitor);
 
     CPPUNIT_ASSERT_EQUAL(
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelSkipGap.details()->model(model_t::E_IndividualSumByBucketAndPerson, 0))
             ->residualModel()
             .checksum(),
-        static_cast<const maths::CUnivariateTimeSeriesModel*>(
+        univariateModel(
             modelExNullGap.details()->model(model_t::E_IndividualSumByBucketAndPerson, 0))
             ->residualModel()
             .checksum());
@@ -6,6 +6,7 @@
 
 #include "CModelDetailsViewTest.h"
 
+#include <core/CContainerPrinter.h>
 #include <core/CLogger.h>
 #include <core/Constants.h>
 
@@ -19,6 +20,7 @@
 
 #include "Mocks.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -130,6 +132,52 @@ void CModelDetailsViewTest::testModelPlot() {
             }
         }
     }
+
+    LOG_DEBUG(<< "Streamed rows with terms");
+    {
+        features.assign(1, model_t::E_IndividualCountByBucketAndPerson);
+        setupTest();
+
+        TDoubleVec values{1.0, 2.0, 3.0, 4.0};
+        std::size_t pid{0};
+        for (auto value : values) {
+            model->mockAddBucketValue(model_t::E_IndividualCountByBucketAndPerson,
+                                      pid++, 0, 0, {value});
+        }
+
+        model::CModelDetailsView::TStrSet terms{"p12", "p22"};
+        TStrVec byFieldValues;
+        model::CModelPlotData streamed;
+        model->details()->modelPlot(0, 90.0, terms, [&](const model::CModelPlotData::SRow& row) {
+            CPPUNIT_ASSERT(row.s_OverFieldValue != nullptr);
+            CPPUNIT_ASSERT(gatherer->personId(*row.s_ByFieldValue, pid));
+            CPPUNIT_ASSERT_EQUAL(values[pid], row.s_Actual);
+            CPPUNIT_ASSERT(row.s_LowerBound <= row.s_Median);
+            CPPUNIT_ASSERT(row.s_Median <= row.s_UpperBound);
+            byFieldValues.push_back(*row.s_ByFieldValue);
+            streamed.addRow(row);
+        });
+        std::sort(byFieldValues.begin(), byFieldValues.end());
+        CPPUNIT_ASSERT_EQUAL(std::string("[p12, p22]"),
+                             core::CContainerPrinter::print(byFieldValues));
+
+        model::CModelPlotData plotData;
+        model->details()->modelPlot(0, 90.0, terms, plotData);
+        CPPUNIT_ASSERT(plotData.begin() != plotData.end());
+        for (const auto& featureByFieldData : plotData) {
+            CPPUNIT_ASSERT_EQUAL(std::size_t(2), featureByFieldData.second.size());
+            for (const auto& byFieldData : featureByFieldData.second) {
+                const auto& expected = byFieldData.second;
+                const auto& actual = streamed.get(featureByFieldData.first,
+                                                  byFieldData.first);
+                CPPUNIT_ASSERT_EQUAL(expected.s_LowerBound, actual.s_LowerBound);
+                CPPUNIT_ASSERT_EQUAL(expected.s_UpperBound, actual.s_UpperBound);
+                CPPUNIT_ASSERT_EQUAL(expected.s_Median, actual.s_Median);
+                CPPUNIT_ASSERT_EQUAL(core::CContainerPrinter::print(expected.s_ValuesPerOverField),
+                                     core::CContainerPrinter::print(actual.s_ValuesPerOverField));
+            }
+        }
+    }
 }
 
 CppUnit::Test* CModelDetailsViewTest::suite() {
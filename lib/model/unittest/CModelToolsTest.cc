@@ -8,6 +8,7 @@
 
 #include <core/CLogger.h>
 #include <core/CSmallVector.h>
+#include <core/CStatistics.h>
 #include <core/Constants.h>
 
 #include <maths/CMultimodalPrior.h>
@@ -15,6 +16,7 @@
 #include <maths/CTimeSeriesDecomposition.h>
 #include <maths/CTimeSeriesModel.h>
 #include <maths/CXMeansOnline1d.h>
+#include <maths/Constants.h>
 
 #include <model/CModelTools.h>
 
@@ -282,6 +284,150 @@ void CModelToolsTest::testProbabilityCache() {
     }
 }
 
+void CModelToolsTest::testProbabilityResultCache() {
+    // Test we get exactly the calculated result if and only if the
+    // calculation is the same and the model hasn't been invalidated.
+
+    using TTime2Vec = core::CSmallVector<core_t::TTime, 2>;
+    using TTime2Vec1Vec = core::CSmallVector<TTime2Vec, 1>;
+    using TDouble2Vec1Vec = core::CSmallVector<TDouble2Vec, 1>;
+
+    core_t::TTime bucketLength{1800};
+
+    maths::CTimeSeriesDecomposition trend{DECAY_RATE, bucketLength};
+    maths::CUnivariateTimeSeriesModel model{params(bucketLength), 0, trend, normal()};
+    test::CRandomNumbers rng;
+
+    maths_t::TDouble2VecWeightsAry weight{maths_t::CUnitWeights::unit<TDouble2Vec>(1)};
+    std::vector<maths_t::TDouble2VecWeightsAry> weights{weight};
+
+    TDoubleVec samples;
+    rng.generateNormalSamples(10.0, 4.0, 200, samples);
+    core_t::TTime time_{0};
+    for (auto sample : samples) {
+        maths::CModelAddSamplesParams params;
+        params.integer(false).propagationInterval(1.0).trendWeights(weights).priorWeights(weights);
+        model.addSamples(params, {core::make_triple(time_, TDouble2Vec(1, sample), TAG)});
+        time_ += bucketLength;
+    }
+
+    model_t::EFeature feature{model_t::E_IndividualMeanByPerson};
+    std::size_t id{0};
+    TTime2Vec1Vec time{TTime2Vec{time_}};
+
+    auto makeParams = [&](const maths_t::TDouble2VecWeightsAry& weight_, bool empty) {
+        maths::CModelProbabilityParams params;
+        params.addCalculation(maths_t::E_TwoSided).addBucketEmpty({empty}).addWeights(weight_);
+        return params;
+    };
+    auto detrend = [&](const maths::CModelProbabilityParams& params,
+                       const TDouble2Vec1Vec& value) {
+        TDouble2Vec1Vec result(value);
+        model.detrend(time, params.seasonalConfidenceInterval(), result);
+        return result;
+    };
+
+    uint64_t lookups{core::CStatistics::stat(stat_t::E_NumberProbabilityCacheLookups).value()};
+    uint64_t hits{core::CStatistics::stat(stat_t::E_NumberProbabilityCacheHits).value()};
+
+    model::CModelTools::CProbabilityResultCache cache;
+    maths::CModelProbabilityParams params{makeParams(weight, false)};
+    TDouble2Vec1Vec value{TDouble2Vec{11.0}};
+    maths::SModelProbabilityResult expected;
+    maths::SModelProbabilityResult result;
+
+    CPPUNIT_ASSERT(cache.lookup(feature, id, params, value,
+                                detrend(params, value), result) == false);
+    CPPUNIT_ASSERT(model.probability(params, time, value, expected));
+    CPPUNIT_ASSERT(expected.s_AnomalyModelUpdated == false);
+    cache.add(feature, id, params, value, detrend(params, value), expected);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.size());
+
+    LOG_DEBUG(<< "Test hit");
+    CPPUNIT_ASSERT(cache.lookup(feature, id, params, value, detrend(params, value), result));
+    CPPUNIT_ASSERT_EQUAL(expected.s_Probability, result.s_Probability);
+    CPPUNIT_ASSERT_EQUAL(expected.s_Tail[0], result.s_Tail[0]);
+    CPPUNIT_ASSERT(result.s_Conditional == false);
+    CPPUNIT_ASSERT(result.s_MostAnomalousCorrelate.empty());
+
+    LOG_DEBUG(<< "Test different calculations miss");
+    {
+        TDouble2Vec1Vec other{TDouble2Vec{11.5}};
+        CPPUNIT_ASSERT(cache.lookup(feature, id, params, other,
+                                    detrend(params, other), result) == false);
+        maths_t::TDouble2VecWeightsAry scaled(weight);
+        maths_t::setSeasonalVarianceScale(TDouble2Vec{2.0}, scaled);
+        maths::CModelProbabilityParams scaledParams{makeParams(scaled, false)};
+        CPPUNIT_ASSERT(cache.lookup(feature, id, scaledParams, value,
+                                    detrend(scaledParams, value), result) == false);
+        maths::CModelProbabilityParams emptyParams{makeParams(weight, true)};
+        CPPUNIT_ASSERT(cache.lookup(feature, id, emptyParams, value,
+                                    detrend(emptyParams, value), result) == false);
+        CPPUNIT_ASSERT(cache.lookup(model_t::E_IndividualMinByPerson, id, params,
+                                    value, detrend(params, value), result) == false);
+        CPPUNIT_ASSERT(cache.lookup(feature, id + 1, params, value,
+                                    detrend(params, value), result) == false);
+    }
+
+    LOG_DEBUG(<< "Test invalidate");
+    cache.invalidate(feature, id);
+    CPPUNIT_ASSERT(cache.lookup(feature, id, params, value,
+                                detrend(params, value), result) == false);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.size());
+
+    LOG_DEBUG(<< "Test significant results");
+    {
+        // These update the anomaly model so mustn't be cached unless
+        // it isn't being used.
+        TDouble2Vec1Vec anomaly{TDouble2Vec{40.0}};
+        CPPUNIT_ASSERT(model.probability(params, time, anomaly, expected));
+        LOG_DEBUG(<< "p = " << expected.s_Probability);
+        CPPUNIT_ASSERT(expected.s_Probability < maths::LARGEST_SIGNIFICANT_PROBABILITY);
+        CPPUNIT_ASSERT(expected.s_AnomalyModelUpdated);
+        cache.add(feature, id, params, anomaly, detrend(params, anomaly), expected);
+        CPPUNIT_ASSERT(cache.lookup(feature, id, params, anomaly,
+                                    detrend(params, anomaly), result) == false);
+
+        // This holds even if the anomaly model raised the probability.
+        maths::SModelProbabilityResult raised{expected};
+        raised.s_Probability = 0.5;
+        cache.add(feature, id, params, anomaly, detrend(params, anomaly), raised);
+        CPPUNIT_ASSERT(cache.lookup(feature, id, params, anomaly,
+                                    detrend(params, anomaly), result) == false);
+
+        maths::CModelProbabilityParams noAnomalyParams{makeParams(weight, false)};
+        noAnomalyParams.useAnomalyModel(false);
+        CPPUNIT_ASSERT(model.probability(noAnomalyParams, time, anomaly, expected));
+        CPPUNIT_ASSERT(expected.s_AnomalyModelUpdated == false);
+        cache.add(feature, id, noAnomalyParams, anomaly,
+                  detrend(noAnomalyParams, anomaly), expected);
+        CPPUNIT_ASSERT(cache.lookup(feature, id, noAnomalyParams, anomaly,
+                                    detrend(noAnomalyParams, anomaly), result));
+        CPPUNIT_ASSERT(cache.lookup(feature, id, params, anomaly,
+                                    detrend(params, anomaly), result) == false);
+
+        // A significant result also removes the existing result.
+        cache.add(feature, id, params, anomaly, detrend(params, anomaly), raised);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.size());
+    }
+
+    LOG_DEBUG(<< "Test correlated calculations aren't cached");
+    {
+        TDouble2Vec1Vec correlated{TDouble2Vec{11.0, 12.0}};
+        CPPUNIT_ASSERT(model::CModelTools::CProbabilityResultCache::cacheable(
+                           params, correlated) == false);
+        cache.add(feature, id, params, correlated, correlated, expected);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.size());
+    }
+
+    LOG_DEBUG(<< "Test statistics");
+    lookups = core::CStatistics::stat(stat_t::E_NumberProbabilityCacheLookups).value() - lookups;
+    hits = core::CStatistics::stat(stat_t::E_NumberProbabilityCacheHits).value() - hits;
+    LOG_DEBUG(<< "lookups = " << lookups << ", hits = " << hits);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(12), lookups);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), hits);
+}
+
 CppUnit::Test* CModelToolsTest::suite() {
     CppUnit::TestSuite* suiteOfTests = new CppUnit::TestSuite("CModelToolsTest");
 
@@ -289,6 +435,9 @@ CppUnit::Test* CModelToolsTest::suite() {
         "CModelToolsTest::testFuzzyDeduplicate", &CModelToolsTest::testFuzzyDeduplicate));
     suiteOfTests->addTest(new CppUnit::TestCaller<CModelToolsTest>(
         "CModelToolsTest::testProbabilityCache", &CModelToolsTest::testProbabilityCache));
+    suiteOfTests->addTest(new CppUnit::TestCaller<CModelToolsTest>(
+        "CModelToolsTest::testProbabilityResultCache",
+        &CModelToolsTest::testProbabilityResultCache));
 
     return suiteOfTests;
 }
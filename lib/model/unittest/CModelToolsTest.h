@@ -13,6 +13,7 @@ class CModelToolsTest : public CppUnit::TestFixture {
 public:
     void testFuzzyDeduplicate();
     void testProbabilityCache();
+    void testProbabilityResultCache();
 
     static CppUnit::Test* suite();
 };
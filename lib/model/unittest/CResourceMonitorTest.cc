@@ -121,6 +121,30 @@ void CResourceMonitorTest::testMonitor() {
         mon.unRegisterComponent(detector1);
         CPPUNIT_ASSERT_EQUAL(std::size_t(0), mon.m_Detectors.size());
     }
+    {
+        // Check that the string stores can be left out of the total
+        std::size_t stringStoresMem = CStringStore::names().memoryUsage() +
+                                      CStringStore::influencers().memoryUsage();
+        CPPUNIT_ASSERT(stringStoresMem > 0);
+
+        CResourceMonitor mon;
+        mon.includeStringStores(false);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(0), mon.m_PreviousTotal);
+
+        mon.registerComponent(detector1);
+        mon.registerComponent(detector2);
+        mon.refresh(detector1);
+        mon.refresh(detector2);
+        mon.sendMemoryUsageReportIfSignificantlyChanged(0);
+        CPPUNIT_ASSERT_EQUAL(mem - stringStoresMem, mon.totalMemory());
+        CPPUNIT_ASSERT_EQUAL(mem - stringStoresMem, mon.m_PreviousTotal);
+
+        mon.includeStringStores(true);
+        CPPUNIT_ASSERT_EQUAL(mem, mon.totalMemory());
+
+        mon.unRegisterComponent(detector2);
+        mon.unRegisterComponent(detector1);
+    }
     {
         // Check that High limit can be breached and then gone back
         CResourceMonitor mon(1.0);
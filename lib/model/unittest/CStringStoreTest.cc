@@ -124,7 +124,7 @@ void CStringStoreTest::testStringStore() {
         CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().m_Strings.size());
     }
     CPPUNIT_ASSERT_EQUAL(std::size_t(1), CStringStore::names().m_Strings.size());
-    CStringStore::names().pruneNotThreadSafe();
+    CStringStore::names().prune();
     CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
 
     {
@@ -144,7 +144,7 @@ void CStringStoreTest::testStringStore() {
         }
 
         CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
-        CStringStore::names().pruneNotThreadSafe();
+        CStringStore::names().prune();
         CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
         CPPUNIT_ASSERT_EQUAL(std::size_t(0),
                              CStringStore::influencers().m_Strings.size());
@@ -159,7 +159,7 @@ void CStringStoreTest::testStringStore() {
         }
 
         CPPUNIT_ASSERT_EQUAL(strings.size(), CStringStore::names().m_Strings.size());
-        CStringStore::names().pruneNotThreadSafe();
+        CStringStore::names().prune();
         CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
         threads.clear();
         CPPUNIT_ASSERT_EQUAL(std::size_t(0), CStringStore::names().m_Strings.size());
@@ -202,7 +202,7 @@ void CStringStoreTest::testStringStore() {
         for (std::size_t i = 0; i < threads.size(); ++i) {
             threads[i]->clearPtrs();
         }
-        CStringStore::names().pruneNotThreadSafe();
+        CStringStore::names().prune();
     }
 }
 
@@ -225,7 +225,7 @@ void CStringStoreTest::testMemUsage() {
 
         // This pruning should have no effect, as there are external pointers to
         // the contents
-        CStringStore::names().pruneNotThreadSafe();
+        CStringStore::names().prune();
         CPPUNIT_ASSERT_EQUAL(inUseMemUse, CStringStore::names().memoryUsage());
     }
 
@@ -234,7 +234,7 @@ void CStringStoreTest::testMemUsage() {
     CPPUNIT_ASSERT_EQUAL(inUseMemUse, CStringStore::names().memoryUsage());
 
     // There are no external references, so this should remove values
-    CStringStore::names().pruneNotThreadSafe();
+    CStringStore::names().prune();
     std::size_t prunedMemUse = CStringStore::names().memoryUsage();
     LOG_DEBUG(<< "Pruned memory usage: " << prunedMemUse);
     CPPUNIT_ASSERT(prunedMemUse < inUseMemUse - shortStr.length() - longStr.length());